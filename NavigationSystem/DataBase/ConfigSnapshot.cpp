@@ -0,0 +1,72 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		ConfigSnapshot.cpp
+ *
+ * Purpose:
+ *		Holds the values of every config_* table of the database as they were at one
+ *		moment.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/ConfigSnapshot.h"
+#include <cstdlib>
+
+
+ConfigSnapshot::ConfigSnapshot(uint64_t version)
+	:m_version(version)
+{ }
+
+double ConfigSnapshot::getDouble(const std::string& table, const std::string& column, double fallback) const
+{
+	const Value* value = find(table, column);
+	return (value != NULL) ? value->number : fallback;
+}
+
+int ConfigSnapshot::getInt(const std::string& table, const std::string& column, int fallback) const
+{
+	const Value* value = find(table, column);
+	return (value != NULL) ? (int)strtol(value->text.c_str(), NULL, 10) : fallback;
+}
+
+std::string ConfigSnapshot::getString(const std::string& table, const std::string& column, const std::string& fallback) const
+{
+	const Value* value = find(table, column);
+	return (value != NULL) ? value->text : fallback;
+}
+
+const ConfigSnapshot::Value* ConfigSnapshot::find(const std::string& table, const std::string& column) const
+{
+	auto foundTable = m_tables.find(table);
+	if(foundTable == m_tables.end())
+	{
+		return NULL;
+	}
+
+	auto foundValue = foundTable->second.values.find(column);
+	if(foundValue == foundTable->second.values.end())
+	{
+		return NULL;
+	}
+	return &foundValue->second;
+}
+
+const std::vector<std::string>& ConfigSnapshot::columns(const std::string& table) const
+{
+	static const std::vector<std::string> NO_COLUMNS;
+
+	auto foundTable = m_tables.find(table);
+	return (foundTable != m_tables.end()) ? foundTable->second.columns : NO_COLUMNS;
+}
+
+void ConfigSnapshot::addTable(const std::string& table, const std::vector<std::string>& columns)
+{
+	m_tables[table].columns = columns;
+}
+
+void ConfigSnapshot::setValue(const std::string& table, const std::string& column, const std::string& text)
+{
+	Value& value = m_tables[table].values[column];
+	value.text = text;
+	value.number = strtod(text.c_str(), NULL);
+}
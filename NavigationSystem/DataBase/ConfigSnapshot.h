@@ -0,0 +1,79 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		ConfigSnapshot.h
+ *
+ * Purpose:
+ *		Holds the values of every config_* table of the database, the row with id 1, as
+ *		they were at one moment. Looking a value up is a map lookup, no SQL.
+ *
+ * Developer Notes:
+ *		Built by DBHandler::reloadConfigs() and never changed after that, so it can be
+ *		read from any thread without a lock. Get the current one from
+ *		DBHandler::configs(), a reload publishes a new snapshot and leaves the old one
+ *		as it is.
+ *
+ *		The numbers are converted when the snapshot is loaded, the text is kept too for
+ *		DBHandler::retrieveCell(). A NULL in the database is left out of the snapshot.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+class ConfigSnapshot {
+public:
+	struct Value {
+		Value() : number(0) { }
+
+		std::string text;		// As SQLite gives it as text
+		double number;			// The text read as a number, 0 if it isn't one
+	};
+
+	ConfigSnapshot(uint64_t version);
+
+	///----------------------------------------------------------------------------------
+	/// Returns a value, or the fallback if the table or the column doesn't exist or the
+	/// value is NULL.
+	///----------------------------------------------------------------------------------
+	double getDouble(const std::string& table, const std::string& column, double fallback = 0) const;
+	int getInt(const std::string& table, const std::string& column, int fallback = 0) const;
+	std::string getString(const std::string& table, const std::string& column, const std::string& fallback = "") const;
+
+	///----------------------------------------------------------------------------------
+	/// Returns the value, NULL if the table or the column doesn't exist or the value is
+	/// NULL.
+	///----------------------------------------------------------------------------------
+	const Value* find(const std::string& table, const std::string& column) const;
+
+	///----------------------------------------------------------------------------------
+	/// Returns the columns of a table in the order of the schema, empty for a table that
+	/// doesn't exist.
+	///----------------------------------------------------------------------------------
+	const std::vector<std::string>& columns(const std::string& table) const;
+
+	///----------------------------------------------------------------------------------
+	/// Counts the reloads, the first snapshot of a DBHandler is version 1.
+	///----------------------------------------------------------------------------------
+	uint64_t version() const { return m_version; }
+
+	///----------------------------------------------------------------------------------
+	/// Only used while the snapshot is built.
+	///----------------------------------------------------------------------------------
+	void addTable(const std::string& table, const std::vector<std::string>& columns);
+	void setValue(const std::string& table, const std::string& column, const std::string& text);
+
+private:
+	struct Table {
+		std::vector<std::string> columns;
+		std::map<std::string, Value> values;
+	};
+
+	uint64_t m_version;
+	std::map<std::string, Table> m_tables;
+};
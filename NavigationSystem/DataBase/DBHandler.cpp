@@ -3,30 +3,53 @@
 #include <string>
 #include <cstdlib>
 #include <cstdio>
-#include "SystemServices/Timer.h"
+#include "SystemServices/SysClock.h"
 #include <thread>
 
 
+// Prepared statements kept per connection, any further ones are finalized after use
+#define MAX_CACHED_STATEMENTS 64
+
+// Read-only connections of the WAL mode, a read waits when all of them are in use
+#define READER_CONNECTIONS 3
+
+// How often the time spent waiting for a connection is logged
+#define LOCK_STATISTICS_INTERVAL_S 300
+
+
 std::mutex DBHandler::m_databaseLock;
 
 
-DBHandler::DBHandler(std::string filePath) :
-	m_filePath(filePath)
+DBHandler::DBHandler(std::string filePath, DBAccessMode accessMode) :
+	m_filePath(filePath), m_accessMode(accessMode), m_writerOpened(false),
+	m_lastStatisticsLog(SysClock::monotonicMicros())
 {
 	m_latestDataLogId = 0;
 }
 
 DBHandler::~DBHandler(void) {
-	m_databaseLock.unlock();
+	{
+		std::lock_guard<std::mutex> lock(m_readerLock);
+		for(Connection& reader : m_readers)
+		{
+			closeConnection(reader);
+		}
+		m_readers.clear();
+		m_freeReaders.clear();
+	}
+
+	std::lock_guard<std::mutex> lock(m_databaseLock);
+	closeConnection(m_writer);
 }
 
 bool DBHandler::initialise()
 {
-	sqlite3* connection = openDatabase();
+	Connection* connection = openDatabase();
 
 	if(connection != 0)
 	{
 		closeDatabase(connection);
+		reloadConfigs();
 		return true;
 	}
 	else
@@ -46,7 +69,7 @@ void DBHandler::getDataAsJson(std::string select, std::string table, std::string
 		if(id == "")
 			results = retrieveFromTable("SELECT " + select + " FROM " + table + ";", rows, columns);
 		else
-			results = retrieveFromTable("SELECT " + select + " FROM " + table + " WHERE ID = " + id + ";", rows, columns);
+			results = retrieveFromTable("SELECT " + select + " FROM " + table + " WHERE ID = ?;", { id }, rows, columns);
 	} catch(const char * error) {
 		Logger::error("%s, %s table: %s Error: %s", __PRETTY_FUNCTION__, select.c_str(), table.c_str(), error);
 	}
@@ -80,239 +103,202 @@ void DBHandler::getDataAsJson(std::string select, std::string table, std::string
 	columnNames.clear();
 }
 
-void DBHandler::insertDataLogs(std::vector<LogItem>& logs)
+bool DBHandler::insertDataLogs(std::vector<LogItem>& logs)
 {
-		std::stringstream actuatorFeedbackValues;
-		std::stringstream compassModelValues;
-		std::stringstream courseCalculationValues;
-		std::stringstream currentSensorsValues;
-		std::stringstream gpsValues;
-		std::stringstream marineSensorsValues;
-		std::stringstream vesselStateValues;
-		std::stringstream windStateValues;
-		std::stringstream windsensorValues;
-		std::stringstream systemValues;
-		std::stringstream ss;
-		int actuatorFeedbackId=0;
-		int compassModelId=0;
-		int courceCalculationId=0;
-		int currentMissionId=0;
-		int currentSensorsId=0;
-		int gpsId=0;
-		int marineSensorsId=0;
-		int vesselStateId=0;
-		int windStateId=0;
-		int windsensorId=0;
-		int logNumber =0;
-		std::string tableId;
-
-		sqlite3* db = openDatabase();
-
-		if(db == NULL)
-		{
-			Logger::error("%s Database is null!", __PRETTY_FUNCTION__);
-			closeDatabase(db);
-			return;
-		}
+	if(logs.empty())
+	{
+		return true;
+	}
 
-    if (logs.size()>0)
-		{
-		  Logger::info("Writing in the database last value: %s size logs %d",logs[0].m_timestamp_str.c_str(),logs.size());
-    	}
+	Connection* db = openDatabase();
 
-		tableId = getIdFromTable("dataLogs_actuator_feedback",true,db);
-		if(tableId.size() > 0)
-		{
-			actuatorFeedbackId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_compass",true,db);
-		if(tableId.size() > 0)
-		{
-			compassModelId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_course_calculation",true,db);
-		if(tableId.size() > 0)
-		{
-			courceCalculationId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_current_sensors",true,db);
-		if(tableId.size() > 0)
-		{
-			currentSensorsId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_gps",true,db);
-		if(tableId.size() > 0)
-		{
-			gpsId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_marine_sensors",true,db);
-		if(tableId.size() > 0)
-		{
-			marineSensorsId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_vessel_state",true,db);
-		if(tableId.size() > 0)
-		{
-			vesselStateId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_wind_state",true,db);
-		if(tableId.size() > 0)
-		{
-			windStateId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		tableId = getIdFromTable("dataLogs_windsensor",true,db);
-		if(tableId.size() > 0)
-		{
-			windsensorId = (int)strtol(tableId.c_str(), NULL, 10);
-		}
-		// NOTE : Marc : To update the id of current_Mission in the DB
-		tableId = getIdFromTable("current_Mission",true,db);
-		if(tableId.size() > 0)
+	if(db == NULL)
+	{
+		Logger::error("%s Database is null!", __PRETTY_FUNCTION__);
+		return false;
+	}
+
+	Logger::info("Writing in the database last value: %s size logs %d",logs[0].m_timestamp_str.c_str(),logs.size());
+
+	int resultcode = SQLITE_OK;
+	do {
+		resultcode = insertLogBatch(*db, logs);
+	} while(resultcode == SQLITE_BUSY);
+
+	if(resultcode != SQLITE_OK)
+	{
+		m_latestDataLogId = 0;
+		Logger::error("%s Error, failed to insert %d logs: %s", __PRETTY_FUNCTION__, logs.size(), sqlite3_errstr(resultcode));
+	}
+
+	closeDatabase(db);
+	return (resultcode == SQLITE_OK);
+}
+
+///----------------------------------------------------------------------------------
+/// Binds the values of a log row to an INSERT statement in column order, keeps the
+/// first error.
+///----------------------------------------------------------------------------------
+class LogRow {
+public:
+	LogRow(sqlite3_stmt* statement) : m_statement(statement), m_column(1), m_resultcode(SQLITE_OK) { }
+
+	LogRow& operator<<(double value) { return check(sqlite3_bind_double(m_statement, m_column++, value)); }
+	LogRow& operator<<(int value) { return check(sqlite3_bind_int(m_statement, m_column++, value)); }
+	LogRow& operator<<(bool value) { return check(sqlite3_bind_int(m_statement, m_column++, value ? 1 : 0)); }
+	LogRow& operator<<(sqlite3_int64 value) { return check(sqlite3_bind_int64(m_statement, m_column++, value)); }
+
+	// the text has to outlive the insert, it isn't copied
+	LogRow& operator<<(const std::string& text)
+	{
+		return check(sqlite3_bind_text(m_statement, m_column++, text.c_str(), text.size(), SQLITE_STATIC));
+	}
+
+	int resultcode() const { return m_resultcode; }
+
+private:
+	LogRow& check(int resultcode)
+	{
+		if(m_resultcode == SQLITE_OK)
 		{
-			currentMissionId = (int)strtol(tableId.c_str(), NULL, 10);
+			m_resultcode = resultcode;
 		}
+		return *this;
+	}
 
+	sqlite3_stmt* m_statement;
+	int m_column;
+	int m_resultcode;
+};
 
-		for(auto log: logs)
-		{
+template<class BindValues>
+int DBHandler::insertRow(Connection& connection, const std::string& sqlINSERT, BindValues bindValues, sqlite3_int64& rowId)
+{
+	sqlite3_stmt* statement = NULL;
+	bool cached = false;
 
-      logNumber++;
-			actuatorFeedbackValues.str("");
-			compassModelValues.str("");
-			courseCalculationValues.str("");
-			currentSensorsValues.str("");
-			gpsValues.str("");
-			marineSensorsValues.str("");
-			vesselStateValues.str("");
-			windStateValues.str("");
-			windsensorValues.str("");
-			systemValues.str("");
-
-		  actuatorFeedbackValues << std::setprecision(10)
-			  << log.m_rudderPosition << ", "
-			  << log.m_wingsailPosition << ", "
-			  << log.m_radioControllerOn << ", "
-			  << log.m_windVaneAngle << ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_actuator_feedback" << " VALUES(NULL, " << actuatorFeedbackValues.str() << "'); \n";
-
-		  compassModelValues << std::setprecision(10)
-			  << log.m_compassHeading << ", "
-			  << log.m_compassPitch << ", "
-			  << log.m_compassRoll<< ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_compass" << " VALUES(NULL, " << compassModelValues.str() << "'); \n";
-
-		  courseCalculationValues << std::setprecision(10)
-			  << log.m_distanceToWaypoint << ", "
-			  << log.m_bearingToWaypoint << ", "
-			  << log.m_courseToSteer << ", "
-			  << log.m_tack << ", "
-			  << log.m_goingStarboard<< ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_course_calculation" << " VALUES(NULL, " << courseCalculationValues.str() << "'); \n";
-
-		  currentSensorsValues << std::setprecision(10)
-			  << log.m_currentActuatorUnit << ", "
-			  << log.m_currentNavigationUnit << ", "
-			  << log.m_currentWindVaneAngle << ", "
-			  << log.m_currentWindVaneClutch << ", "
-			  << log.m_currentSailboatDrive << ",'"
-			  << log.m_timestamp_str.c_str();
-
-	      ss << "INSERT INTO " << "dataLogs_current_sensors" << " VALUES(NULL, " << currentSensorsValues.str() << "'); \n";
-
-		  gpsValues << std::setprecision(10)
-			  << log.m_gpsHasFix << ", "
-			  << log.m_gpsOnline <<",'"
-			  << log.m_timestamp_str.c_str() << "', "
-			  << log.m_gpsLat << ", "
-			  << log.m_gpsLon << ", "
-			  << log.m_gpsSpeed << ", "
-			  << log.m_gpsCourse << ", "
-			  << log.m_gpsSatellite << ", "
-			  << log.m_routeStarted << ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_gps" << " VALUES(NULL, " << gpsValues.str() << "'); \n";
-
-		  marineSensorsValues << std::setprecision(10)
-  			  << log.m_temperature << ", "
-  			  << log.m_conductivity << ", "
-			  	<< log.m_ph << ", "
-          << log.m_salinity << ",'"
-			  	<< log.m_timestamp_str.c_str();
-
-	      ss << "INSERT INTO " << "dataLogs_marine_sensors" << " VALUES(NULL, " << marineSensorsValues.str() << "'); \n";
-
-		  vesselStateValues << std::setprecision(10)
-			  << log.m_vesselHeading << ", "
-			  << log.m_vesselLat << ", "
-		      << log.m_vesselLon << ", "
-			  << log.m_vesselSpeed << ", "
-			  << log.m_vesselCourse << ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_vessel_state" << " VALUES(NULL, " << vesselStateValues.str() << "'); \n";
-
-		  windStateValues << std::setprecision(10)
-			  << log.m_trueWindSpeed << ", "
-			  << log.m_trueWindDir << ", "
-			  << log.m_apparentWindSpeed << ", "
-			  << log.m_apparentWindDir << ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_wind_state" << " VALUES(NULL, " << windStateValues.str() << "'); \n";
-
-
-		  windsensorValues << std::setprecision(10)
-			  << log.m_windDir << ", "
-			  << log.m_windSpeed << ", "
-			  << log.m_windTemp << ",'"
-			  << log.m_timestamp_str.c_str();
-
-		  ss << "INSERT INTO " << "dataLogs_windsensor" << " VALUES(NULL, " << windsensorValues.str() << "'); \n";
-
-		  systemValues << std::setprecision(10)
-			  << actuatorFeedbackId+logNumber << ", "
-		      << compassModelId+logNumber << ", "
-			  << courceCalculationId+logNumber << ", "
-			  << currentSensorsId+logNumber << ", "
-			  << gpsId+logNumber << ", "
-			  << marineSensorsId+logNumber << ", "
-			  << vesselStateId+logNumber << ", "
-		  	  << windStateId+logNumber << ", "
-			  << windsensorId+logNumber << ", "
-			  << currentMissionId;
-
-		  ss << "INSERT INTO " << "dataLogs_system" << " VALUES(NULL, " << systemValues.str() << "); \n";
-		}
+	int resultcode = prepareStatement(connection, sqlINSERT, statement, cached);
+	if(resultcode != SQLITE_OK)
+	{
+		return resultcode;
+	}
+
+	LogRow row(statement);
+	bindValues(row);
+	resultcode = row.resultcode();
 
-		if(queryTable(ss.str(), db))
+	if(resultcode == SQLITE_OK)
+	{
+		resultcode = sqlite3_step(statement);
+		if(resultcode == SQLITE_DONE)
 		{
-			tableId = getIdFromTable("dataLogs_system",true,db);
-			if(tableId.size() > 0)
-			{
-				m_latestDataLogId = (int)strtol(tableId.c_str(), NULL, 10);
-			}
-			else
-			{
-				m_latestDataLogId = 0;
-			}
+			rowId = sqlite3_last_insert_rowid(connection.db);
+			resultcode = SQLITE_OK;
 		}
-		else
+	}
+
+	finishStatement(statement, cached);
+	return resultcode;
+}
+
+int DBHandler::insertLogBatch(Connection& connection, const std::vector<LogItem>& logs)
+{
+	static const std::string ACTUATOR_FEEDBACK = "INSERT INTO dataLogs_actuator_feedback VALUES(NULL, ?, ?, ?, ?, ?);";
+	static const std::string COMPASS = "INSERT INTO dataLogs_compass VALUES(NULL, ?, ?, ?, ?);";
+	static const std::string COURSE_CALCULATION = "INSERT INTO dataLogs_course_calculation VALUES(NULL, ?, ?, ?, ?, ?, ?);";
+	static const std::string CURRENT_SENSORS = "INSERT INTO dataLogs_current_sensors VALUES(NULL, ?, ?, ?, ?, ?, ?);";
+	static const std::string GPS = "INSERT INTO dataLogs_gps VALUES(NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+	static const std::string MARINE_SENSORS = "INSERT INTO dataLogs_marine_sensors VALUES(NULL, ?, ?, ?, ?, ?);";
+	static const std::string VESSEL_STATE = "INSERT INTO dataLogs_vessel_state VALUES(NULL, ?, ?, ?, ?, ?, ?);";
+	static const std::string WIND_STATE = "INSERT INTO dataLogs_wind_state VALUES(NULL, ?, ?, ?, ?, ?);";
+	static const std::string WINDSENSOR = "INSERT INTO dataLogs_windsensor VALUES(NULL, ?, ?, ?, ?);";
+	static const std::string SYSTEM = "INSERT INTO dataLogs_system VALUES(NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+	// NOTE : Marc : To update the id of current_Mission in the DB
+	int currentMissionId = 0;
+	std::string tableId = getIdFromTable("current_Mission",true,connection);
+	if(tableId.size() > 0)
+	{
+		currentMissionId = (int)strtol(tableId.c_str(), NULL, 10);
+	}
+
+	// one transaction for the batch, the rows are only written to the file on the commit
+	int resultcode = sqlite3_exec(connection.db, "BEGIN IMMEDIATE;", NULL, NULL, NULL);
+	if(resultcode != SQLITE_OK)
+	{
+		return resultcode;
+	}
+
+	sqlite3_int64 systemId = 0;
+
+	for(const LogItem& log : logs)
+	{
+		sqlite3_int64 actuatorFeedbackId = 0;
+		sqlite3_int64 compassModelId = 0;
+		sqlite3_int64 courseCalculationId = 0;
+		sqlite3_int64 currentSensorsId = 0;
+		sqlite3_int64 gpsId = 0;
+		sqlite3_int64 marineSensorsId = 0;
+		sqlite3_int64 vesselStateId = 0;
+		sqlite3_int64 windStateId = 0;
+		sqlite3_int64 windsensorId = 0;
+
+		// the ids of the rows are kept for the dataLogs_system row that ties them together
+		if((resultcode = insertRow(connection, ACTUATOR_FEEDBACK, [&](LogRow& row) {
+				row << log.m_rudderPosition << log.m_wingsailPosition << log.m_radioControllerOn
+					<< log.m_windVaneAngle << log.m_timestamp_str;
+			}, actuatorFeedbackId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, COMPASS, [&](LogRow& row) {
+				row << log.m_compassHeading << log.m_compassPitch << log.m_compassRoll << log.m_timestamp_str;
+			}, compassModelId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, COURSE_CALCULATION, [&](LogRow& row) {
+				row << log.m_distanceToWaypoint << log.m_bearingToWaypoint << log.m_courseToSteer
+					<< log.m_tack << log.m_goingStarboard << log.m_timestamp_str;
+			}, courseCalculationId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, CURRENT_SENSORS, [&](LogRow& row) {
+				row << log.m_currentActuatorUnit << log.m_currentNavigationUnit << log.m_currentWindVaneAngle
+					<< log.m_currentWindVaneClutch << log.m_currentSailboatDrive << log.m_timestamp_str;
+			}, currentSensorsId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, GPS, [&](LogRow& row) {
+				row << log.m_gpsHasFix << log.m_gpsOnline << log.m_timestamp_str << log.m_gpsLat << log.m_gpsLon
+					<< log.m_gpsSpeed << log.m_gpsCourse << log.m_gpsSatellite << log.m_routeStarted
+					<< log.m_timestamp_str;
+			}, gpsId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, MARINE_SENSORS, [&](LogRow& row) {
+				row << log.m_temperature << log.m_conductivity << log.m_ph << log.m_salinity << log.m_timestamp_str;
+			}, marineSensorsId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, VESSEL_STATE, [&](LogRow& row) {
+				row << log.m_vesselHeading << log.m_vesselLat << log.m_vesselLon << log.m_vesselSpeed
+					<< log.m_vesselCourse << log.m_timestamp_str;
+			}, vesselStateId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, WIND_STATE, [&](LogRow& row) {
+				row << log.m_trueWindSpeed << log.m_trueWindDir << log.m_apparentWindSpeed
+					<< log.m_apparentWindDir << log.m_timestamp_str;
+			}, windStateId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, WINDSENSOR, [&](LogRow& row) {
+				row << log.m_windDir << log.m_windSpeed << log.m_windTemp << log.m_timestamp_str;
+			}, windsensorId)) != SQLITE_OK ||
+			(resultcode = insertRow(connection, SYSTEM, [&](LogRow& row) {
+				row << actuatorFeedbackId << compassModelId << courseCalculationId << currentSensorsId << gpsId
+					<< marineSensorsId << vesselStateId << windStateId << windsensorId << currentMissionId;
+			}, systemId)) != SQLITE_OK)
 		{
-			m_latestDataLogId = 0;
-			Logger::error("%s Error, failed to insert log Request: %s", __PRETTY_FUNCTION__,ss.str().c_str());
+			sqlite3_exec(connection.db, "ROLLBACK;", NULL, NULL, NULL);
+			return resultcode;
 		}
+	}
 
+	resultcode = sqlite3_exec(connection.db, "COMMIT;", NULL, NULL, NULL);
+	if(resultcode != SQLITE_OK)
+	{
+		sqlite3_exec(connection.db, "ROLLBACK;", NULL, NULL, NULL);
+		return resultcode;
+	}
 
-	  closeDatabase(db);
-
+	m_latestDataLogId = (int)systemId;
+	return SQLITE_OK;
 }
+
 //TODO -Oliver: make private
 void DBHandler::insertMessageLog(std::string gps_time, std::string type, std::string msg) {
 	//std::string result;
@@ -336,27 +322,12 @@ bool DBHandler::updateTableJson(std::string table, std::string data) {
 
 	Json js = Json::parse(data);
 
-	std::stringstream ss;
-
-	//start at i = 1 to skip the id
-	ss << "SET ";
-	int fixedSize = js.size(); //Size would sometimes change, added this variable
-	for (auto i = 1; i < fixedSize; i++) {
-		if (fixedSize > 1){
-			ss << columns.at(i) << " = " << js[columns.at(i)] << ","; //This crashes if the local database has fewer fields than the web database  (field out of range)
-		}
-	}
-
-	std::string values = ss.str();
-	values = values.substr(0, values.size()-1);
-
-	std::string id = js["id"];
-
-	if(not queryTable("UPDATE " + table + " " + values + " WHERE ID = " + id + ";"))
+	if(not queryTable(jsonUpdateQuery(table, columns, js)))
 	{
 		Logger::error("%s Error: ", __PRETTY_FUNCTION__);
 		return false;
 	}
+	tableChanged(table);
 	return true;
 }
 
@@ -371,8 +342,16 @@ bool DBHandler::updateTableJsonObject(std::string table, Json data) {
 		return false;
 	}
 
+	if(not queryTable(jsonUpdateQuery(table, columns, data)))
+	{
+		Logger::error("%s Error: ", __PRETTY_FUNCTION__);
+		return false;
+	}
+	tableChanged(table);
+	return true;
+}
 
-	//Json json = data;
+std::string DBHandler::jsonUpdateQuery(std::string table, const std::vector<std::string>& columns, Json& data) {
 
 	std::stringstream ss;
 
@@ -390,12 +369,7 @@ bool DBHandler::updateTableJsonObject(std::string table, Json data) {
 
 	std::string id = data["id"];
 
-	if(not queryTable("UPDATE " + table + " " + values + " WHERE ID = " + id + ";"))
-	{
-		Logger::error("%s Error: ", __PRETTY_FUNCTION__);
-		return false;
-	}
-	return true;
+	return "UPDATE " + table + " " + values + " WHERE ID = " + id + ";";
 }
 
 bool DBHandler::updateTable(std::string table, std::string column, std::string value, std::string id) {
@@ -405,17 +379,23 @@ bool DBHandler::updateTable(std::string table, std::string column, std::string v
 		Logger::error("%s Error updating table", __PRETTY_FUNCTION__);
 		return false;
 	}
+	tableChanged(table);
 	return true;
 }
 
 std::string DBHandler::retrieveCell(std::string table, std::string id, std::string column) {
 
-	std::string query = "SELECT " + column + " FROM " + table +" WHERE id=" + id + ";";
+	ConfigSnapshot::Value config;
+	if(configValue(table, id, column, config)) {
+		return config.text;
+	}
+
+	std::string query = "SELECT " + column + " FROM " + table +" WHERE id=?;";
 
 	int rows, columns;
     std::vector<std::string> results;
     try {
-    	results = retrieveFromTable(query, rows, columns);
+    	results = retrieveFromTable(query, { id }, rows, columns);
     }
     catch(const char* error) {
     	rows = 0;
@@ -423,12 +403,12 @@ std::string DBHandler::retrieveCell(std::string table, std::string id, std::stri
     }
 
     if (columns < 1) {
-    	Logger::error("%s No columns from Query: %s", __PRETTY_FUNCTION__, query.c_str());
+    	Logger::error("%s No columns from Query: %s id: %s", __PRETTY_FUNCTION__, query.c_str(), id.c_str());
     	return "";
     }
 
     if (rows < 1) {
-		Logger::error("%s No rows from Query: %s", __PRETTY_FUNCTION__, query.c_str());
+		Logger::error("%s No rows from Query: %s id: %s", __PRETTY_FUNCTION__, query.c_str(), id.c_str());
 		return "";
     }
 
@@ -446,11 +426,33 @@ void DBHandler::updateConfigs(std::string configs) {
 
 	//tables = sailing_config config_buffer etc
 
+	//the columns of the config tables are known from the snapshot, no need to ask the database
+	std::shared_ptr<const ConfigSnapshot> current = this->configs();
+	std::stringstream updates;
+
 	for (auto table : tables) { //for each table in there
 		if(js[table] != NULL){
-			updateTableJson(table,js[table].dump()); //eg updatetablejson("sailing_config", configs['sailing_config'] as json)
+			const std::vector<std::string>& columns = current->columns(table);
+			if(columns.empty()) {
+				Logger::error("%s Error: no such table %s", __PRETTY_FUNCTION__, table.c_str());
+				continue;
+			}
+			updates << jsonUpdateQuery(table, columns, js[table]) << "\n"; //eg configs['sailing_config'] as UPDATE sailing_config
 		}
 	}
+
+	if(updates.str().empty()) {
+		return;
+	}
+
+	//all the tables in one transaction
+	Connection* db = openDatabase();
+	if(db == NULL || not queryTable(updates.str(), db->db)) {
+		Logger::error("%s Error: failed to update the configs", __PRETTY_FUNCTION__);
+	}
+	closeDatabase(db);
+
+	reloadConfigs();
 }
 
 bool DBHandler::updateWaypoints(std::string waypoints){
@@ -518,6 +520,11 @@ bool DBHandler::updateWaypoints(std::string waypoints){
 
 int DBHandler::retrieveCellAsInt(std::string table, std::string id, std::string column) {
 
+	ConfigSnapshot::Value config;
+	if(configValue(table, id, column, config)) {
+		return strtol(config.text.c_str(), NULL, 10);
+	}
+
 	std::string data = retrieveCell(table, id, column);
 	if (data.size() > 0)
 	{
@@ -533,6 +540,11 @@ int DBHandler::retrieveCellAsInt(std::string table, std::string id, std::string
 
 double DBHandler::retrieveCellAsDouble(std::string table, std::string id, std::string column) {
 
+	ConfigSnapshot::Value config;
+	if(configValue(table, id, column, config)) {
+		return config.number;
+	}
+
 	std::string data = retrieveCell(table, id, column);
 	if (data.size() > 0)
 	{
@@ -549,6 +561,7 @@ double DBHandler::retrieveCellAsDouble(std::string table, std::string id, std::s
 void DBHandler::clearTable(std::string table) {
 	//If no table to delete, doesn't matter
 	queryTable("DELETE FROM " + table + ";");
+	tableChanged(table);
 }
 
 int DBHandler::getRows(std::string table) {
@@ -600,6 +613,7 @@ void DBHandler::clearLogs() {
 
 void DBHandler::deleteRow(std::string table, std::string id) {
 	queryTable("DELETE FROM " + table + " WHERE id = " + id + ";");
+	tableChanged(table);
 }
 
 bool DBHandler::insert(std::string table, std::string fields, std::string values)
@@ -609,6 +623,7 @@ bool DBHandler::insert(std::string table, std::string fields, std::string values
 		Logger::error("%s, Failed to insert into table", __PRETTY_FUNCTION__);
 		return false;
 	}
+	tableChanged(table);
 	return true;
 }
 //TODO - Oliver/Jordan - REMOVE this function if not needed
@@ -695,14 +710,14 @@ std::string DBHandler::getIdFromTable(std::string table, bool max) {
     }
 }
 
-std::string DBHandler::getIdFromTable(std::string table, bool max, sqlite3* db) {
+std::string DBHandler::getIdFromTable(std::string table, bool max, Connection& connection) {
 	int rows, columns;
     std::vector<std::string> results;
     try {
 		if(max) {
-			results = retrieveFromTable("SELECT MAX(id) FROM " + table + ";", rows, columns,db);
+			results = retrieveFromTable("SELECT MAX(id) FROM " + table + ";", rows, columns, connection);
 		} else {
-			results = retrieveFromTable("SELECT MIN(id) FROM " + table + ";", rows, columns,db);
+			results = retrieveFromTable("SELECT MIN(id) FROM " + table + ";", rows, columns, connection);
 		}
 	}
     catch(const char* error) {
@@ -725,60 +740,204 @@ std::string DBHandler::getIdFromTable(std::string table, bool max, sqlite3* db)
 // private helpers
 ////////////////////////////////////////////////////////////////////
 
-sqlite3* DBHandler::openDatabase() {
+bool DBHandler::openConnection(Connection& connection, int flags) {
 
-	m_databaseLock.lock();
-	sqlite3* connection;
+	// without SQLITE_OPEN_CREATE a missing file fails instead of creating an empty database
 	int resultcode = 0;
+	do {
+		resultcode = sqlite3_open_v2(m_filePath.c_str(), &connection.db, flags, NULL);
+	} while(resultcode == SQLITE_BUSY);
 
-	// check if file exists
-	FILE* db_file = fopen(m_filePath.c_str(), "r");
-	if (db_file == NULL) {
-		Logger::error("%s %s not found", __PRETTY_FUNCTION__, m_filePath.c_str());
-		m_databaseLock.unlock();
-		return NULL;
+	if (resultcode != SQLITE_OK) {
+		Logger::error("%s Failed to open the database %s Error %s", __PRETTY_FUNCTION__, m_filePath.c_str(), sqlite3_errmsg(connection.db));
+		sqlite3_close(connection.db);
+		connection.db = NULL;
+		return false;
 	}
-	fclose(db_file);
 
-	do {
-		resultcode = sqlite3_open(m_filePath.c_str(), &connection);
-	} while(resultcode == SQLITE_BUSY);
+	// set a 10 millisecond timeout
+	sqlite3_busy_timeout(connection.db, 10);
+	return true;
+}
+
+void DBHandler::closeConnection(Connection& connection) {
+	for(auto& statement : connection.statements) {
+		sqlite3_finalize(statement.second);
+	}
+	connection.statements.clear();
+
+	if(connection.db != NULL) {
+		sqlite3_close(connection.db);
+		connection.db = NULL;
+	}
+}
+
+DBHandler::Connection* DBHandler::openDatabase() {
+	return lockWriter(m_writeWait);
+}
 
-	if (resultcode) {
-		Logger::error("%s Failed to open the database Error %s", __PRETTY_FUNCTION__, sqlite3_errmsg(connection));
+DBHandler::Connection* DBHandler::lockWriter(LatencyHistogram& waitTime) {
+
+	uint64_t start = SysClock::monotonicMicros();
+	m_databaseLock.lock();
+	waitTime.record(SysClock::monotonicMicros() - start);
+
+	if(m_writer.db != NULL) {
+		return &m_writer;
+	}
+
+	if(not openConnection(m_writer, SQLITE_OPEN_READWRITE)) {
 		m_databaseLock.unlock();
-		return 0;
+		return NULL;
 	}
 
-	// set a 10 millisecond timeout
-	sqlite3_busy_timeout(connection, 10);
-	return connection;
+	if(m_accessMode == DBAccessMode::WAL) {
+		// the journal mode is kept in the file, the readers opened after this use it too.
+		// synchronous NORMAL only syncs the log at checkpoints, a power loss can lose the
+		// last transactions but not corrupt the database
+		if(sqlite3_exec(m_writer.db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", NULL, NULL, NULL) != SQLITE_OK) {
+			Logger::error("%s Failed to use WAL on %s Error %s", __PRETTY_FUNCTION__, m_filePath.c_str(), sqlite3_errmsg(m_writer.db));
+		}
+	}
+
+	m_writerOpened.store(true);
+	return &m_writer;
 }
 
 
-void DBHandler::closeDatabase(sqlite3* connection) {
+void DBHandler::closeDatabase(Connection* connection) {
+	// openDatabase() doesn't hold the lock when it fails
 	if(connection != NULL) {
-		sqlite3_close(connection);
-		connection = NULL;
-		// ENsure it closes properly
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		m_databaseLock.unlock();
+		logLockStatisticsIfDue();
+	}
+}
+
+DBHandler::Connection* DBHandler::openReader() {
+
+	if(m_accessMode == DBAccessMode::Exclusive) {
+		return lockWriter(m_readWait);
+	}
+
+	// the writer switches the database to WAL, before that a reader would block the writes
+	if(not m_writerOpened.load()) {
+		Connection* writer = openDatabase();
+		if(writer == NULL) {
+			return NULL;
+		}
+		closeDatabase(writer);
+	}
+
+	uint64_t start = SysClock::monotonicMicros();
+	std::unique_lock<std::mutex> lock(m_readerLock);
+
+	while(m_freeReaders.empty() && m_readers.size() >= READER_CONNECTIONS) {
+		m_readerReleased.wait(lock);
+	}
+
+	Connection* reader = NULL;
+	if(not m_freeReaders.empty()) {
+		reader = m_freeReaders.back();
+		m_freeReaders.pop_back();
 	} else {
-		m_databaseLock.unlock();
-		throw "DBHandler::closeDatabase() : connection is already null";
+		m_readers.emplace_back();
+		if(not openConnection(m_readers.back(), SQLITE_OPEN_READONLY)) {
+			m_readers.pop_back();
+			return NULL;
+		}
+		reader = &m_readers.back();
 	}
+
+	m_readWait.record(SysClock::monotonicMicros() - start);
+	return reader;
 }
 
-int DBHandler::getTable(sqlite3* db, const std::string &sql, std::vector<std::string> &results, int &rows, int &columns) {
+void DBHandler::closeReader(Connection* connection) {
+	if(connection == NULL) {
+		return;
+	}
+
+	if(m_accessMode == DBAccessMode::Exclusive) {
+		closeDatabase(connection);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_readerLock);
+		m_freeReaders.push_back(connection);
+	}
+	m_readerReleased.notify_one();
+}
+
+void DBHandler::logLockStatistics() const {
+	Logger::info("Database %s writes waited: %s", m_filePath.c_str(), m_writeWait.toString().c_str());
+	Logger::info("Database %s reads waited: %s", m_filePath.c_str(), m_readWait.toString().c_str());
+}
+
+void DBHandler::logLockStatisticsIfDue() {
+	uint64_t now = SysClock::monotonicMicros();
+	uint64_t last = m_lastStatisticsLog.load();
+
+	if(now - last > (uint64_t)LOCK_STATISTICS_INTERVAL_S * 1000000 &&
+		m_lastStatisticsLog.compare_exchange_strong(last, now)) {
+		logLockStatistics();
+	}
+}
+
+int DBHandler::prepareStatement(Connection& connection, const std::string &sql, sqlite3_stmt*& statement, bool& cached) {
+	auto found = connection.statements.find(sql);
+	if(found != connection.statements.end()) {
+		statement = found->second;
+		cached = true;
+		return SQLITE_OK;
+	}
+
+	statement = NULL;
+	int resultcode = sqlite3_prepare_v2(connection.db, sql.c_str(), sql.size(), &statement, NULL);
+	if(resultcode != SQLITE_OK) {
+		sqlite3_finalize(statement);
+		statement = NULL;
+		return resultcode;
+	}
+
+	cached = (connection.statements.size() < MAX_CACHED_STATEMENTS);
+	if(cached) {
+		connection.statements[sql] = statement;
+	}
+	return SQLITE_OK;
+}
+
+void DBHandler::finishStatement(sqlite3_stmt* statement, bool cached) {
+	if(cached) {
+		// ends the read of the statement so it doesn't keep the database locked
+		sqlite3_reset(statement);
+		sqlite3_clear_bindings(statement);
+	} else {
+		sqlite3_finalize(statement);
+	}
+}
+
+int DBHandler::getTable(Connection& connection, const std::string &sql, std::vector<std::string> &results, int &rows, int &columns) {
+	return getTable(connection, sql, std::vector<std::string>(), results, rows, columns);
+}
+
+int DBHandler::getTable(Connection& connection, const std::string &sql, const std::vector<std::string> &parameters, std::vector<std::string> &results, int &rows, int &columns) {
 	int resultcode = -1;
 	sqlite3_stmt* statement = NULL;
+	bool cached = false;
 
-	// prepare the statement sql code in byte form for query request
-	if((resultcode = sqlite3_prepare_v2(db, sql.c_str(), sql.size(), &statement, NULL)) != SQLITE_OK) { // if not OK, return error
-		sqlite3_finalize(statement);
+	// prepare the statement sql code in byte form for query request, or reuse it
+	if((resultcode = prepareStatement(connection, sql, statement, cached)) != SQLITE_OK) { // if not OK, return error
 		return resultcode;
 	}
 
+	for(unsigned int i = 0; i < parameters.size(); i++) {
+		if((resultcode = sqlite3_bind_text(statement, i + 1, parameters[i].c_str(), -1, SQLITE_TRANSIENT)) != SQLITE_OK) {
+			finishStatement(statement, cached);
+			return resultcode;
+		}
+	}
+
 	// get the number of columns int the table called in the statement
 	columns = sqlite3_column_count(statement);
 	rows = 0;
@@ -788,7 +947,7 @@ int DBHandler::getTable(sqlite3* db, const std::string &sql, std::vector<std::st
 
 		// if column name is NULL, return error
 		if(!sqlite3_column_name(statement, i)) {
-			sqlite3_finalize(statement);
+			finishStatement(statement, cached);
 			return SQLITE_EMPTY;
 		}
 
@@ -805,7 +964,7 @@ int DBHandler::getTable(sqlite3* db, const std::string &sql, std::vector<std::st
 			{
 				// Get the value in the column
 				if(!sqlite3_column_text(statement, i)) {
-					sqlite3_finalize(statement);
+					finishStatement(statement, cached);
 					rows = 0;
 					columns = 0;
 					return SQLITE_EMPTY;
@@ -820,7 +979,7 @@ int DBHandler::getTable(sqlite3* db, const std::string &sql, std::vector<std::st
 		rows++;
 	}
 
-	sqlite3_finalize(statement); //destruct the statement
+	finishStatement(statement, cached); //destruct or reset the statement
 
 	if(resultcode != SQLITE_DONE) {
 		return resultcode;
@@ -829,32 +988,8 @@ int DBHandler::getTable(sqlite3* db, const std::string &sql, std::vector<std::st
 }
 
 
-int DBHandler::insertLog(std::string table, std::string values, sqlite3* db) {
-	std::stringstream ss;
-	ss << "INSERT INTO " << table << " VALUES(NULL, " << values << ");";
-
-	if(queryTable(ss.str(), db))
-	{
-		Timer time_;
-		time_.start();
-		std::string tableId = getIdFromTable(table,true,db);
-		time_.stop();
-		Logger::info("Time passed writing %.5f",time_.timePassed());
-		if(tableId.size() > 0)
-		{
-			return (int)strtol(tableId.c_str(), NULL, 10);
-		}
-	}
-	else
-	{
-		Logger::error("%s Error, failed to insert log Request: %s", __PRETTY_FUNCTION__,ss.str().c_str());
-	}
-
-	return 0;
-}
-
 bool DBHandler::queryTable(std::string sqlINSERT) {
-	sqlite3* db = openDatabase();
+	Connection* db = openDatabase();
 	m_error = NULL;
 
 	if (db != NULL) {
@@ -866,10 +1001,10 @@ bool DBHandler::queryTable(std::string sqlINSERT) {
 				m_error = NULL;
 			}
 
-			resultcode = sqlite3_exec(db, sqlINSERT.c_str(), NULL, NULL, &m_error);
+			resultcode = sqlite3_exec(db->db, sqlINSERT.c_str(), NULL, NULL, &m_error);
 		} while(resultcode == SQLITE_BUSY);
 		if (m_error != NULL) {
-			Logger::error("%s Error: %s", __PRETTY_FUNCTION__, sqlite3_errmsg(db));
+			Logger::error("%s Error: %s", __PRETTY_FUNCTION__, sqlite3_errmsg(db->db));
 
 			sqlite3_free(m_error);
 			closeDatabase(db);
@@ -918,8 +1053,12 @@ bool DBHandler::queryTable(std::string sqlINSERT, sqlite3* db) {
 }
 
 std::vector<std::string> DBHandler::retrieveFromTable(std::string sqlSELECT, int &rows, int &columns) {
+	return retrieveFromTable(sqlSELECT, std::vector<std::string>(), rows, columns);
+}
 
-	sqlite3* db = openDatabase();
+std::vector<std::string> DBHandler::retrieveFromTable(std::string sqlSELECT, const std::vector<std::string>& parameters, int &rows, int &columns) {
+
+	Connection* db = openReader();
 	std::vector<std::string> results;
 
 	if (db != NULL) {
@@ -928,39 +1067,38 @@ std::vector<std::string> DBHandler::retrieveFromTable(std::string sqlSELECT, int
 		do {
 			results = std::vector<std::string>();
 			//resultcode = sqlite3_get_table(db, sqlSELECT.c_str(), &results, &rows, &columns, &m_error);
-			resultcode = getTable(db, sqlSELECT, results, rows, columns);
+			resultcode = getTable(*db, sqlSELECT, parameters, results, rows, columns);
 		} while(resultcode == SQLITE_BUSY);
 
 		if(resultcode == SQLITE_EMPTY) {
 			std::vector<std::string> s;
-			closeDatabase(db);
+			closeReader(db);
 			return s;
 		}
 
 		if (resultcode != SQLITE_OK) {
 			Logger::error("%s SQL statement: %s Error: %s", __PRETTY_FUNCTION__, sqlSELECT.c_str(), sqlite3_errstr(resultcode));
-			closeDatabase(db);
+			closeReader(db);
 			throw "retrieveFromTable";
 		}
 	}
 	else {
-		closeDatabase(db);
 		throw "DBHandler::retrieveFromTable(), no db connection";
 	}
-	closeDatabase(db);
+	closeReader(db);
 	return results;
 }
 
-std::vector<std::string> DBHandler::retrieveFromTable(std::string sqlSELECT, int &rows, int &columns,sqlite3* db) {
+std::vector<std::string> DBHandler::retrieveFromTable(std::string sqlSELECT, int &rows, int &columns, Connection& connection) {
 	std::vector<std::string> results;
 
-	if (db != NULL) {
+	if (connection.db != NULL) {
 		int resultcode = 0;
 
 		do {
 			results = std::vector<std::string>();
 			//resultcode = sqlite3_get_table(db, sqlSELECT.c_str(), &results, &rows, &columns, &m_error);
-			resultcode = getTable(db, sqlSELECT, results, rows, columns);
+			resultcode = getTable(connection, sqlSELECT, results, rows, columns);
 		} while(resultcode == SQLITE_BUSY);
 
 		if(resultcode == SQLITE_EMPTY) {
@@ -1000,7 +1138,7 @@ std::vector<std::string> DBHandler::getTableNames(std::string like) {
 	int rows, columns;
     std::vector<std::string> results;
     try {
-    results = retrieveFromTable("SELECT name FROM sqlite_master WHERE type='table' AND name LIKE '"+ like +"';", rows, columns);
+    results = retrieveFromTable("SELECT name FROM sqlite_master WHERE type='table' AND name LIKE ?;", { like }, rows, columns);
 	}
     catch(const char* error) {
 
@@ -1114,5 +1252,104 @@ bool DBHandler::changeOneValue(std::string table, std::string id,std::string new
 		Logger::error("Error %s", __PRETTY_FUNCTION__);
 		return false;
 	}
+	tableChanged(table);
+	return true;
+}
+
+std::shared_ptr<const ConfigSnapshot> DBHandler::configs() {
+	std::shared_ptr<const ConfigSnapshot> snapshot = std::atomic_load(&m_configs);
+	if(not snapshot) {
+		reloadConfigs();
+		snapshot = std::atomic_load(&m_configs);
+	}
+
+	if(not snapshot) {
+		static const std::shared_ptr<const ConfigSnapshot> NO_CONFIGS = std::make_shared<ConfigSnapshot>(0);
+		return NO_CONFIGS;
+	}
+	return snapshot;
+}
+
+bool DBHandler::reloadConfigs() {
+	std::lock_guard<std::mutex> reloadLock(m_configReloadLock);
+
+	std::shared_ptr<const ConfigSnapshot> current = std::atomic_load(&m_configs);
+	std::shared_ptr<ConfigSnapshot> snapshot = std::make_shared<ConfigSnapshot>(current ? current->version() + 1 : 1);
+
+	Connection* db = openReader();
+	if(db == NULL) {
+		return false;
+	}
+
+	//one read transaction so the tables are all from the same moment
+	bool success = (sqlite3_exec(db->db, "BEGIN;", NULL, NULL, NULL) == SQLITE_OK);
+
+	std::vector<std::string> tables;
+	int rows = 0, columns = 0;
+	std::vector<std::string> names;
+	if(success && getTable(*db, "SELECT name FROM sqlite_master WHERE type='table' AND name LIKE 'config_%';", names, rows, columns) == SQLITE_OK) {
+		for (unsigned int i = 1; i < names.size(); i++) {
+			tables.push_back(names[i]);
+		}
+	}
+	else {
+		success = false;
+	}
+
+	for (auto table : tables) {
+		sqlite3_stmt* statement = NULL;
+		bool cached = false;
+		if(prepareStatement(*db, "SELECT * FROM " + table + " WHERE id = 1;", statement, cached) != SQLITE_OK) {
+			Logger::error("%s Failed to read %s Error: %s", __PRETTY_FUNCTION__, table.c_str(), sqlite3_errmsg(db->db));
+			success = false;
+			continue;
+		}
+
+		std::vector<std::string> columnNames;
+		for(int i = 0; i < sqlite3_column_count(statement); i++) {
+			columnNames.emplace_back(sqlite3_column_name(statement, i));
+		}
+		snapshot->addTable(table, columnNames);
+
+		if(sqlite3_step(statement) == SQLITE_ROW) {
+			for(unsigned int i = 0; i < columnNames.size(); i++) {
+				const unsigned char* text = sqlite3_column_text(statement, i);
+				if(text != NULL) {
+					snapshot->setValue(table, columnNames[i], reinterpret_cast<const char*>(text));
+				}
+			}
+		}
+		finishStatement(statement, cached);
+	}
+
+	sqlite3_exec(db->db, "COMMIT;", NULL, NULL, NULL);
+	closeReader(db);
+
+	if(not success) {
+		Logger::error("%s Failed to load the configs, keeping the previous ones", __PRETTY_FUNCTION__);
+		return false;
+	}
+
+	std::atomic_store(&m_configs, std::shared_ptr<const ConfigSnapshot>(std::move(snapshot)));
+	return true;
+}
+
+void DBHandler::tableChanged(const std::string& table) {
+	if(table.compare(0, 7, "config_") == 0) {
+		reloadConfigs();
+	}
+}
+
+bool DBHandler::configValue(const std::string& table, const std::string& id, const std::string& column, ConfigSnapshot::Value& value) {
+	if(id != "1" || table.compare(0, 7, "config_") != 0) {
+		return false;
+	}
+
+	std::shared_ptr<const ConfigSnapshot> snapshot = configs();
+	const ConfigSnapshot::Value* config = snapshot->find(table, column);
+	if(config == NULL) {
+		return false;
+	}
+	value = *config;
 	return true;
 }
@@ -2,12 +2,19 @@
 #define __DBHANDLER_H__ //__DATACOLLECT_H__
 
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <sqlite3.h>
+#include "DataBase/ConfigSnapshot.h"
 #include "SystemServices/Logger.h"
+#include "SystemServices/LatencyHistogram.h"
 #include "Messages/WindStateMsg.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 
 #include "Libs/json/src/json.hpp"
@@ -59,16 +66,61 @@ struct LogItem {
 		std::string m_timestamp_str;
 	};
 
+// How a DBHandler shares the database between the threads using it
+enum class DBAccessMode {
+	Exclusive,		// One connection, every query holds the database lock
+	WAL				// Write-ahead log, the writes hold the database lock on one connection and
+					// the reads take a read-only connection from a pool, they never wait on a write
+};
+
+#if DATABASE_WAL == 1
+#define DB_DEFAULT_ACCESS_MODE DBAccessMode::WAL
+#else
+#define DB_DEFAULT_ACCESS_MODE DBAccessMode::Exclusive
+#endif
+
 class DBHandler {
 
 private:
 
+	// A connection and its prepared statements, keyed by their SQL. The values of a query
+	// are bound as parameters so one statement serves every call of the same shape.
+	struct Connection {
+		Connection() : db(NULL) { }
+
+		sqlite3* db;
+		std::map<std::string, sqlite3_stmt*> statements;
+	};
+
 	char* m_error;
 	int m_latestDataLogId;
 	std::string m_currentWaypointId = "";
 	std::string m_filePath;
+	DBAccessMode m_accessMode;
 	static std::mutex m_databaseLock;
 
+	// Kept open for the life time of the handler, guarded by m_databaseLock. Every query
+	// uses it in the Exclusive mode, only the writes in the WAL mode
+	Connection m_writer;
+	std::atomic<bool> m_writerOpened;
+
+	// The read-only connections of the WAL mode, guarded by m_readerLock
+	std::deque<Connection> m_readers;
+	std::vector<Connection*> m_freeReaders;
+	std::mutex m_readerLock;
+	std::condition_variable m_readerReleased;
+
+	// Time spent waiting for a connection, in microseconds
+	LatencyHistogram m_writeWait;
+	LatencyHistogram m_readWait;
+	std::atomic<uint64_t> m_lastStatisticsLog;
+
+	// The config tables as they were at the last reload, only accessed through
+	// std::atomic_load() and std::atomic_store(). An old snapshot is freed when the
+	// last reader holding it lets go of it
+	std::shared_ptr<const ConfigSnapshot> m_configs;
+	std::mutex m_configReloadLock;
+
 	//execute INSERT query and add new row into table
 	bool queryTable(std::string sqlINSERT);
 	bool queryTable(std::string sqlINSERT, sqlite3* db);
@@ -76,7 +128,10 @@ private:
 	//retrieve data from given table/tables, return value is a C 2D char array
 	//rows and columns also return values (through a reference) about rows and columns in the result set
 	std::vector<std::string> retrieveFromTable(std::string sqlSELECT, int &rows, int &columns);
-	std::vector<std::string> retrieveFromTable(std::string sqlSELECT, int &rows, int &columns,sqlite3* db);
+	std::vector<std::string> retrieveFromTable(std::string sqlSELECT, int &rows, int &columns, Connection& connection);
+
+	//same as above, the parameters are bound to the ? in the query in order
+	std::vector<std::string> retrieveFromTable(std::string sqlSELECT, const std::vector<std::string>& parameters, int &rows, int &columns);
 
 	//adds a table row into the json object as a array if array flag is true,
 	//otherwise it adds the table row as a json object
@@ -93,27 +148,64 @@ private:
 	//gets information(for instance: name/datatype) about all columns
 	std::vector<std::string> getColumnInfo(std::string info, std::string table);
 
-	//help function used in insertDataLog
-	int insertLog(std::string table, std::string values, sqlite3* db);
+	//inserts the logs in one transaction, returns the sqlite result code
+	int insertLogBatch(Connection& connection, const std::vector<LogItem>& logs);
+
+	//runs a prepared INSERT with the values bindValues binds, returns the id of the row through rowId
+	template<class BindValues>
+	int insertRow(Connection& connection, const std::string& sqlINSERT, BindValues bindValues, sqlite3_int64& rowId);
+
+	//get id from table on a connection already held
+	std::string getIdFromTable(std::string table, bool max, Connection& connection);
 
 	// own implementation of deprecated sqlite3_get_table()
-	int getTable(sqlite3* db, const std::string &sql, std::vector<std::string> &results, int &rows, int &columns);
+	int getTable(Connection& connection, const std::string &sql, std::vector<std::string> &results, int &rows, int &columns);
+	int getTable(Connection& connection, const std::string &sql, const std::vector<std::string> &parameters, std::vector<std::string> &results, int &rows, int &columns);
 
-	sqlite3* openDatabase();
+	// returns the cached statement for the sql, or prepares it. cached is false when the
+	// cache is full, the statement is then finalized by finishStatement()
+	int prepareStatement(Connection& connection, const std::string &sql, sqlite3_stmt*& statement, bool& cached);
+	void finishStatement(sqlite3_stmt* statement, bool cached);
 
-	void closeDatabase(sqlite3* connection);
+	bool openConnection(Connection& connection, int flags);
+	void closeConnection(Connection& connection);
+
+	// takes the database lock and returns the writer connection, opening it on the first
+	// call. Returns NULL without holding the lock if the database can't be opened
+	Connection* openDatabase();
+	Connection* lockWriter(LatencyHistogram& waitTime);
+
+	// releases the database lock, the connection stays open
+	void closeDatabase(Connection* connection);
+
+	// returns a connection for reading, a read-only one from the pool in the WAL mode
+	// and the writer in the Exclusive mode. Returns NULL if the database can't be opened
+	Connection* openReader();
+	void closeReader(Connection* connection);
+
+	void logLockStatisticsIfDue();
+
+	//builds the UPDATE of one row of a table from its json
+	std::string jsonUpdateQuery(std::string table, const std::vector<std::string>& columns, Json& data);
+
+	//reloads the config snapshot if the table is a config table
+	void tableChanged(const std::string& table);
+
+	//copies the value from the config snapshot, false if it isn't a config value
+	bool configValue(const std::string& table, const std::string& id, const std::string& column, ConfigSnapshot::Value& value);
 
 
 public:
 
-	DBHandler(std::string filePath);
+	DBHandler(std::string filePath, DBAccessMode accessMode = DB_DEFAULT_ACCESS_MODE);
 	~DBHandler(void);
 
 	bool initialise();
 
 	int getRows(std::string table);
 
-	void insertDataLogs(std::vector<LogItem>& logs);
+	//returns false if the logs could not be written
+	bool insertDataLogs(std::vector<LogItem>& logs);
 
 	void insertMessageLog(std::string gps_time, std::string type, std::string msg);
 
@@ -126,6 +218,7 @@ public:
 
 	void clearTable(std::string table);
 
+	//updates the config tables in one transaction and reloads the config snapshot
 	void updateConfigs(std::string configs);
 	bool updateWaypoints(std::string waypoints);
 
@@ -141,15 +234,12 @@ public:
 	// returns all logs in database as json; supply onlyLatest to get only the ones with the highest id
 	std::string getLogs(bool onlyLatest);
 
-	void forceUnlock() { m_databaseLock.unlock(); }
-
 	void clearLogs();
 
 	//get id from table returns either max or min id from table.
 	//max = false -> min id
 	//max = true -> max id
 	std::string getIdFromTable(std::string table, bool max);
-	std::string getIdFromTable(std::string table, bool max,sqlite3* db);
 
 	void deleteRow(std::string table, std::string id);
 
@@ -168,6 +258,22 @@ public:
 
 	std::string getConfigs();
 
+	DBAccessMode accessMode() const { return m_accessMode; }
+
+	// returns the latest snapshot of the config tables, loading it on the first call.
+	// Can be called from any thread, it doesn't touch the database after the first load.
+	// The snapshot stays valid for as long as the pointer is held
+	std::shared_ptr<const ConfigSnapshot> configs();
+
+	// reads every config table again and publishes the new snapshot
+	bool reloadConfigs();
+
+	// time the writes and the reads waited for a connection, in microseconds
+	const LatencyHistogram& writeWait() const { return m_writeWait; }
+	const LatencyHistogram& readWait() const { return m_readWait; }
+
+	void logLockStatistics() const;
+
 };
 
 #endif
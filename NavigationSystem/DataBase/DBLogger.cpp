@@ -17,7 +17,18 @@
 
 
 DBLogger::DBLogger(unsigned int logBufferSize, DBHandler& dbHandler)
-	:m_dbHandler(dbHandler), m_bufferSize(logBufferSize)
+	:m_dbHandler(&dbHandler), m_logStore(NULL), m_bufferSize(logBufferSize)
+{
+	m_logBufferFront = new std::vector<LogItem>();
+	m_logBufferFront->reserve(logBufferSize);
+
+	m_logBufferBack = new std::vector<LogItem>();
+	m_logBufferBack->reserve(logBufferSize);
+	m_working = false;
+}
+
+DBLogger::DBLogger(unsigned int logBufferSize, LogStore& logStore)
+	:m_dbHandler(NULL), m_logStore(&logStore), m_bufferSize(logBufferSize)
 {
 	m_logBufferFront = new std::vector<LogItem>();
 	m_logBufferFront->reserve(logBufferSize);
@@ -56,13 +67,12 @@ void DBLogger::log(LogItem& item)
 	// Kick off the worker thread
 	if(m_logBufferFront->size() >= m_bufferSize)
 	{
-		std::vector<LogItem>* tmp = m_logBufferBack;
-		m_logBufferBack = m_logBufferFront;
-		m_logBufferFront = tmp;
-
-		// Wait for the mutex to be unlocked.
+		// Wait for the worker thread to be done with the back buffer before swapping.
 		{
 			std::lock_guard<std::mutex> lk(m_mutex);
+			std::vector<LogItem>* tmp = m_logBufferBack;
+			m_logBufferBack = m_logBufferFront;
+			m_logBufferFront = tmp;
 		}
 		// instruct the worker thread to work
 		m_cv.notify_one();
@@ -88,7 +98,14 @@ void DBLogger::workerThread(DBLogger* ptr)
 		ptr->m_cv.wait(lk);
 		if(ptr->m_logBufferBack->size() > 0)
 		{
-			ptr->m_dbHandler.insertDataLogs(*ptr->m_logBufferBack);
+			if(ptr->m_logStore != NULL)
+			{
+				ptr->m_logStore->append(*ptr->m_logBufferBack);
+			}
+			else
+			{
+				ptr->m_dbHandler->insertDataLogs(*ptr->m_logBufferBack);
+			}
 			ptr->m_logBufferBack->clear();
 		}
 	}
@@ -8,7 +8,7 @@
  *		worker thread.
  *
  * Developer Notes:
- *
+ *		Writes the dataLogs to the database, or to a LogStore when it is given one.
  *
  ***************************************************************************************/
 
@@ -17,6 +17,7 @@
 
 
 #include "DBHandler.h"
+#include "LogStore.h"
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -29,6 +30,7 @@ public:
 
 
 	DBLogger(unsigned int LogBufferSize, DBHandler& dbHandler);
+	DBLogger(unsigned int LogBufferSize, LogStore& logStore);
 	~DBLogger();
 
 	void startWorkerThread();
@@ -47,7 +49,8 @@ private:
 	std::atomic<bool>		m_working;
 	std::mutex				m_mutex;
 	std::condition_variable m_cv;
-	DBHandler& 				m_dbHandler;
+	DBHandler* 				m_dbHandler;
+	LogStore* 				m_logStore;
 	unsigned int 			m_bufferSize;
 	std::vector<LogItem>* 	m_logBufferFront;
 	std::vector<LogItem>* 	m_logBufferBack;
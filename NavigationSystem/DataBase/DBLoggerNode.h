@@ -7,13 +7,26 @@
 
 #include <mutex>
 #include <iostream>
+#include <vector>
 
 class DBLoggerNode: public ActiveNode {
 public:
     DBLoggerNode(MessageBus& msgBus, DBHandler& db, int queueSize);
 
+    ///----------------------------------------------------------------------------------
+    /// Logs to a LogStore instead of the database, an item for every sensor message
+    /// instead of one every loop_time.
+    ///----------------------------------------------------------------------------------
+    DBLoggerNode(MessageBus& msgBus, DBHandler& db, LogStore& logStore, int queueSize);
+
     void processMessage(const Message* message);
 
+    ///----------------------------------------------------------------------------------
+    /// The message types the node listens to, the fields it logs are mapped to the
+    /// LogItem in Messages/messages.json.
+    ///----------------------------------------------------------------------------------
+    static std::vector<MessageType> messageTypes();
+
     void updateConfigsFromDB();
 
     void start();
@@ -24,6 +37,13 @@ public:
 
 private:
 
+    void registerMessages(MessageBus& msgBus);
+
+    ///----------------------------------------------------------------------------------
+    /// Stamps the item with the time and logs it, m_lock has to be held.
+    ///----------------------------------------------------------------------------------
+    void logItem();
+
     static void DBLoggerNodeThreadFunc(ActiveNode* nodePtr);
 
 
@@ -81,6 +101,7 @@ private:
 
     double m_loopTime;
     int m_queueSize;
+    bool m_logEveryMessage;
 
     std::mutex m_lock;
     std::atomic<bool> m_Running;
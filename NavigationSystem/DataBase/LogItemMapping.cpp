@@ -0,0 +1,142 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogItemMapping.cpp
+ *
+ * Purpose:
+ *		Copies the logged fields of the messages into a LogItem.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ *		The "log" of a field in the schema names the LogItem member it goes to.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/LogItemMapping.h"
+#include "Messages/ASPireActuatorFeedbackMsg.h"
+#include "Messages/CompassDataMsg.h"
+#include "Messages/CourseDataMsg.h"
+#include "Messages/GPSDataMsg.h"
+#include "Messages/LocalNavigationMsg.h"
+#include "Messages/MarineSensorDataMsg.h"
+#include "Messages/StateMessage.h"
+#include "Messages/WindDataMsg.h"
+#include "Messages/WindStateMsg.h"
+
+
+bool LogItemMapping::update(LogItem& item, const Message* msg)
+{
+	switch(msg->messageType())
+	{
+		case MessageType::WindData:
+		{
+			const WindDataMsg* message = static_cast<const WindDataMsg*>(msg);
+			item.m_windDir = message->windDirection();
+			item.m_windSpeed = message->windSpeed();
+			item.m_windTemp = message->windTemp();
+		}
+		return true;
+
+		case MessageType::CompassData:
+		{
+			const CompassDataMsg* message = static_cast<const CompassDataMsg*>(msg);
+			item.m_compassHeading = message->heading();
+			item.m_compassPitch = message->pitch();
+			item.m_compassRoll = message->roll();
+		}
+		return true;
+
+		case MessageType::GPSData:
+		{
+			const GPSDataMsg* message = static_cast<const GPSDataMsg*>(msg);
+			item.m_gpsHasFix = message->hasFix();
+			item.m_gpsOnline = message->gpsOnline();
+			item.m_gpsLat = message->latitude();
+			item.m_gpsLon = message->longitude();
+			item.m_gpsUnixTime = message->unixTime();
+			item.m_gpsSpeed = message->speed();
+			item.m_gpsCourse = message->course();
+			item.m_gpsSatellite = message->satelliteCount();
+		}
+		return true;
+
+		case MessageType::CourseData:
+		{
+			const CourseDataMsg* message = static_cast<const CourseDataMsg*>(msg);
+			item.m_distanceToWaypoint = message->distanceToWP();
+			item.m_bearingToWaypoint = message->courseToWP();
+		}
+		return true;
+
+		case MessageType::StateMessage:
+		{
+			const StateMessage* message = static_cast<const StateMessage*>(msg);
+			item.m_vesselHeading = message->heading();
+			item.m_vesselLat = message->latitude();
+			item.m_vesselLon = message->longitude();
+			item.m_vesselCourse = message->course();
+			item.m_vesselSpeed = message->speed();
+		}
+		return true;
+
+		case MessageType::WindState:
+		{
+			const WindStateMsg* message = static_cast<const WindStateMsg*>(msg);
+			item.m_trueWindSpeed = message->trueWindSpeed();
+			item.m_trueWindDir = message->trueWindDirection();
+			item.m_apparentWindSpeed = message->apparentWindSpeed();
+			item.m_apparentWindDir = message->apparentWindDirection();
+		}
+		return true;
+
+		case MessageType::LocalNavigation:
+		{
+			const LocalNavigationMsg* message = static_cast<const LocalNavigationMsg*>(msg);
+			item.m_courseToSteer = message->targetCourse();
+			item.m_tack = message->beatingMode();
+			item.m_goingStarboard = message->targetTackStarboard();
+		}
+		return true;
+
+		case MessageType::ASPireActuatorFeedback:
+		{
+			const ASPireActuatorFeedbackMsg* message = static_cast<const ASPireActuatorFeedbackMsg*>(msg);
+			item.m_wingsailPosition = message->wingsailFeedback();
+			item.m_rudderPosition = message->rudderFeedback();
+			item.m_windVaneAngle = message->windvaneSelfSteeringAngle();
+			item.m_radioControllerOn = message->radioControllerOn();
+		}
+		return true;
+
+		case MessageType::MarineSensorData:
+		{
+			const MarineSensorDataMsg* message = static_cast<const MarineSensorDataMsg*>(msg);
+			item.m_temperature = message->temperature();
+			item.m_conductivity = message->conductivity();
+			item.m_ph = message->ph();
+			item.m_salinity = message->salinity();
+		}
+		return true;
+
+		default:
+		return false;
+	}
+}
+
+const std::vector<MessageType>& LogItemMapping::messageTypes()
+{
+	static const std::vector<MessageType> types = {
+		MessageType::WindData,
+		MessageType::CompassData,
+		MessageType::GPSData,
+		MessageType::CourseData,
+		MessageType::StateMessage,
+		MessageType::WindState,
+		MessageType::LocalNavigation,
+		MessageType::ASPireActuatorFeedback,
+		MessageType::MarineSensorData
+	};
+	return types;
+}
@@ -0,0 +1,34 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogItemMapping.h
+ *
+ * Purpose:
+ *		Copies the logged fields of the messages into a LogItem.
+ *
+ * Developer Notes:
+ *		LogItemMapping.cpp is generated from Messages/messages.json, a field of a
+ *		message is logged by naming its LogItem member in the schema.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "DataBase/DBHandler.h"
+#include "MessageBus/Message.h"
+#include <vector>
+
+
+class LogItemMapping {
+public:
+	///----------------------------------------------------------------------------------
+	/// Copies the logged fields of the message into the item. Returns false if the
+	/// message has no logged fields, the item is left as it was then.
+	///----------------------------------------------------------------------------------
+	static bool update(LogItem& item, const Message* msg);
+
+	///----------------------------------------------------------------------------------
+	/// The types of the messages that have logged fields.
+	///----------------------------------------------------------------------------------
+	static const std::vector<MessageType>& messageTypes();
+};
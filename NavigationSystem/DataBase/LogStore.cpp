@@ -0,0 +1,577 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogStore.cpp
+ *
+ * Purpose:
+ *		An append-only store for the dataLogs, the LogItems are written as fixed width
+ *		records to memory mapped segment files.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/LogStore.h"
+#include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+#define SEGMENT_MAGIC 			0x534c5253		// "SRLS"
+#define SEGMENT_HEADER_SIZE 	4096
+#define SEGMENT_PREFIX 			"datalogs-"
+#define SEGMENT_SUFFIX 			".seg"
+#define TIME_WIDTH 				sizeof(int64_t)
+
+
+struct LogStore::SegmentHeader {
+	uint32_t magic;
+	uint32_t layout;			// The columns the segment was written with
+	uint32_t capacity;
+	uint32_t count;				// Records on the disk
+	uint32_t removed;			// Records removed from the start of the segment
+	uint32_t reserved;
+	uint64_t firstSequence;
+	int64_t minTime;
+	int64_t maxTime;
+};
+
+
+LogColumn::LogColumn(const char* name, double LogItem::* member)
+	:name(name), type(Type::Double), doubleMember(member), floatMember(NULL), intMember(NULL), boolMember(NULL), textMember(NULL)
+{ }
+
+LogColumn::LogColumn(const char* name, float LogItem::* member)
+	:name(name), type(Type::Float), doubleMember(NULL), floatMember(member), intMember(NULL), boolMember(NULL), textMember(NULL)
+{ }
+
+LogColumn::LogColumn(const char* name, int LogItem::* member)
+	:name(name), type(Type::Int), doubleMember(NULL), floatMember(NULL), intMember(member), boolMember(NULL), textMember(NULL)
+{ }
+
+LogColumn::LogColumn(const char* name, bool LogItem::* member)
+	:name(name), type(Type::Bool), doubleMember(NULL), floatMember(NULL), intMember(NULL), boolMember(member), textMember(NULL)
+{ }
+
+LogColumn::LogColumn(const char* name, std::string LogItem::* member)
+	:name(name), type(Type::Text), doubleMember(NULL), floatMember(NULL), intMember(NULL), boolMember(NULL), textMember(member)
+{ }
+
+unsigned int LogColumn::width() const
+{
+	switch(type)
+	{
+		case Type::Double:	return sizeof(double);
+		case Type::Float:	return sizeof(float);
+		case Type::Int:		return sizeof(int32_t);
+		case Type::Bool:	return 1;
+		case Type::Text:	return LOG_STORE_TEXT_WIDTH;
+	}
+	return 0;
+}
+
+void LogColumn::store(const LogItem& item, uint8_t* value) const
+{
+	switch(type)
+	{
+		case Type::Double:
+			memcpy(value, &(item.*doubleMember), sizeof(double));
+			break;
+		case Type::Float:
+			memcpy(value, &(item.*floatMember), sizeof(float));
+			break;
+		case Type::Int:
+		{
+			int32_t number = item.*intMember;
+			memcpy(value, &number, sizeof(int32_t));
+		}
+			break;
+		case Type::Bool:
+			*value = (item.*boolMember) ? 1 : 0;
+			break;
+		case Type::Text:
+		{
+			const std::string& text = item.*textMember;
+			size_t length = std::min(text.size(), (size_t)LOG_STORE_TEXT_WIDTH);
+			memcpy(value, text.data(), length);
+			memset(value + length, 0, LOG_STORE_TEXT_WIDTH - length);
+		}
+			break;
+	}
+}
+
+void LogColumn::load(const uint8_t* value, LogItem& item) const
+{
+	switch(type)
+	{
+		case Type::Double:
+			memcpy(&(item.*doubleMember), value, sizeof(double));
+			break;
+		case Type::Float:
+			memcpy(&(item.*floatMember), value, sizeof(float));
+			break;
+		case Type::Int:
+		{
+			int32_t number = 0;
+			memcpy(&number, value, sizeof(int32_t));
+			item.*intMember = number;
+		}
+			break;
+		case Type::Bool:
+			item.*boolMember = (*value != 0);
+			break;
+		case Type::Text:
+		{
+			const char* text = reinterpret_cast<const char*>(value);
+			item.*textMember = std::string(text, strnlen(text, LOG_STORE_TEXT_WIDTH));
+		}
+			break;
+	}
+}
+
+const std::vector<LogColumn>& LogStore::columns()
+{
+	static const std::vector<LogColumn> COLUMNS = {
+		{ "rudder_position", &LogItem::m_rudderPosition },
+		{ "wingsail_position", &LogItem::m_wingsailPosition },
+		{ "rc_on", &LogItem::m_radioControllerOn },
+		{ "wind_vane_angle", &LogItem::m_windVaneAngle },
+		{ "heading", &LogItem::m_compassHeading },
+		{ "pitch", &LogItem::m_compassPitch },
+		{ "roll", &LogItem::m_compassRoll },
+		{ "distance_to_waypoint", &LogItem::m_distanceToWaypoint },
+		{ "bearing_to_waypoint", &LogItem::m_bearingToWaypoint },
+		{ "course_to_steer", &LogItem::m_courseToSteer },
+		{ "tack", &LogItem::m_tack },
+		{ "going_starboard", &LogItem::m_goingStarboard },
+		{ "actuator_unit", &LogItem::m_currentActuatorUnit },
+		{ "navigation_unit", &LogItem::m_currentNavigationUnit },
+		{ "wind_vane_angle_current", &LogItem::m_currentWindVaneAngle },
+		{ "wind_vane_clutch", &LogItem::m_currentWindVaneClutch },
+		{ "sailboat_drive", &LogItem::m_currentSailboatDrive },
+		{ "has_fix", &LogItem::m_gpsHasFix },
+		{ "online", &LogItem::m_gpsOnline },
+		{ "latitude", &LogItem::m_gpsLat },
+		{ "longitude", &LogItem::m_gpsLon },
+		{ "unix_time", &LogItem::m_gpsUnixTime },
+		{ "speed", &LogItem::m_gpsSpeed },
+		{ "course", &LogItem::m_gpsCourse },
+		{ "satellites_used", &LogItem::m_gpsSatellite },
+		{ "route_started", &LogItem::m_routeStarted },
+		{ "temperature", &LogItem::m_temperature },
+		{ "conductivity", &LogItem::m_conductivity },
+		{ "ph", &LogItem::m_ph },
+		{ "salinity", &LogItem::m_salinity },
+		{ "vessel_heading", &LogItem::m_vesselHeading },
+		{ "vessel_latitude", &LogItem::m_vesselLat },
+		{ "vessel_longitude", &LogItem::m_vesselLon },
+		{ "vessel_speed", &LogItem::m_vesselSpeed },
+		{ "vessel_course", &LogItem::m_vesselCourse },
+		{ "true_wind_speed", &LogItem::m_trueWindSpeed },
+		{ "true_wind_direction", &LogItem::m_trueWindDir },
+		{ "apparent_wind_speed", &LogItem::m_apparentWindSpeed },
+		{ "apparent_wind_direction", &LogItem::m_apparentWindDir },
+		{ "wind_direction", &LogItem::m_windDir },
+		{ "wind_speed", &LogItem::m_windSpeed },
+		{ "wind_temperature", &LogItem::m_windTemp },
+		{ "t_timestamp", &LogItem::m_timestamp_str }
+	};
+	return COLUMNS;
+}
+
+LogStore::LogStore(std::string directory, unsigned int recordsPerSegment)
+	:m_directory(directory), m_layout(2166136261u)
+{
+	// whole blocks in a segment
+	unsigned int blocks = std::max(1u, (recordsPerSegment + LOG_STORE_BLOCK_RECORDS - 1) / LOG_STORE_BLOCK_RECORDS);
+	m_capacity = blocks * LOG_STORE_BLOCK_RECORDS;
+
+	m_columnWidths.push_back(TIME_WIDTH);
+	for(const LogColumn& column : columns())
+	{
+		m_columnWidths.push_back(column.width());
+	}
+
+	// the values of a column are next to each other in a block, every column starts at a
+	// multiple of LOG_STORE_BLOCK_RECORDS so the numbers are aligned
+	m_recordWidth = 0;
+	for(unsigned int width : m_columnWidths)
+	{
+		m_columnOffsets.push_back(m_recordWidth * LOG_STORE_BLOCK_RECORDS);
+		m_recordWidth += width;
+	}
+	m_blockSize = m_recordWidth * LOG_STORE_BLOCK_RECORDS;
+
+	// FNV-1a of the columns, a segment is only read with the columns it was written with
+	auto hash = [this](const char* data, size_t length) {
+		for(size_t i = 0; i < length; i++)
+		{
+			m_layout = (m_layout ^ (uint8_t)data[i]) * 16777619u;
+		}
+	};
+	for(const LogColumn& column : columns())
+	{
+		unsigned int width = column.width();
+		hash(column.name, strlen(column.name) + 1);
+		hash(reinterpret_cast<const char*>(&width), sizeof(width));
+	}
+}
+
+LogStore::~LogStore()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	for(Segment& segment : m_segments)
+	{
+		unmapSegment(segment);
+	}
+}
+
+bool LogStore::open()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	if(mkdir(m_directory.c_str(), 0755) != 0 && errno != EEXIST)
+	{
+		Logger::error("%s Failed to create %s: %s", __PRETTY_FUNCTION__, m_directory.c_str(), strerror(errno));
+		return false;
+	}
+
+	DIR* directory = opendir(m_directory.c_str());
+	if(directory == NULL)
+	{
+		Logger::error("%s Failed to open %s: %s", __PRETTY_FUNCTION__, m_directory.c_str(), strerror(errno));
+		return false;
+	}
+
+	std::vector<std::string> names;
+	while(dirent* entry = readdir(directory))
+	{
+		std::string name = entry->d_name;
+		if(name.compare(0, strlen(SEGMENT_PREFIX), SEGMENT_PREFIX) == 0 && name.size() > strlen(SEGMENT_SUFFIX) &&
+			name.compare(name.size() - strlen(SEGMENT_SUFFIX), std::string::npos, SEGMENT_SUFFIX) == 0)
+		{
+			names.push_back(name);
+		}
+	}
+	closedir(directory);
+
+	for(const std::string& name : names)
+	{
+		Segment segment;
+		if(mapSegment(m_directory + "/" + name, false, 0, segment))
+		{
+			m_segments.push_back(segment);
+		}
+	}
+	std::sort(m_segments.begin(), m_segments.end(), [](const Segment& a, const Segment& b) {
+		return a.header->firstSequence < b.header->firstSequence;
+	});
+	return true;
+}
+
+bool LogStore::append(const std::vector<LogItem>& logs)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	const std::vector<LogColumn>& logColumns = columns();
+	size_t written = 0;
+
+	while(written < logs.size())
+	{
+		if(m_segments.empty() || m_segments.back().header->count >= m_segments.back().header->capacity)
+		{
+			uint64_t firstSequence = 1;
+			if(not m_segments.empty())
+			{
+				firstSequence = m_segments.back().header->firstSequence + m_segments.back().header->count;
+			}
+
+			char name[64];
+			snprintf(name, sizeof(name), SEGMENT_PREFIX "%012" PRIu64 SEGMENT_SUFFIX, firstSequence);
+
+			Segment segment;
+			if(not mapSegment(m_directory + "/" + name, true, firstSequence, segment))
+			{
+				return false;
+			}
+			m_segments.push_back(segment);
+		}
+
+		Segment& segment = m_segments.back();
+		SegmentHeader* header = segment.header;
+
+		uint32_t first = header->count;
+		uint32_t end = std::min((size_t)header->capacity, first + (logs.size() - written));
+		int64_t minTime = header->minTime;
+		int64_t maxTime = header->maxTime;
+
+		for(uint32_t record = first; record < end; record++, written++)
+		{
+			const LogItem& item = logs[written];
+
+			int64_t time = (int64_t)SysClock::timeSource().unixMicros();
+			memcpy(value(segment, record, 0), &time, TIME_WIDTH);
+			minTime = std::min(minTime, time);
+			maxTime = std::max(maxTime, time);
+
+			for(unsigned int column = 0; column < logColumns.size(); column++)
+			{
+				logColumns[column].store(item, value(segment, record, column + 1));
+			}
+		}
+
+		// the records first, the count only says they are there once they are on the disk
+		size_t firstBlock = first / LOG_STORE_BLOCK_RECORDS;
+		size_t endBlock = (end + LOG_STORE_BLOCK_RECORDS - 1) / LOG_STORE_BLOCK_RECORDS;
+		if(not sync(segment, SEGMENT_HEADER_SIZE + firstBlock * m_blockSize, (endBlock - firstBlock) * m_blockSize))
+		{
+			return false;
+		}
+
+		header->minTime = minTime;
+		header->maxTime = maxTime;
+		header->count = end;
+		if(not sync(segment, 0, SEGMENT_HEADER_SIZE))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void LogStore::read(std::vector<LogRecord>& records, int64_t fromTime, int64_t toTime)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for(Segment& segment : m_segments)
+	{
+		const SegmentHeader* header = segment.header;
+		if(header->removed >= header->count || header->maxTime < fromTime || header->minTime > toTime)
+		{
+			continue;
+		}
+
+		for(uint32_t record = header->removed; record < header->count; record++)
+		{
+			int64_t time = 0;
+			memcpy(&time, value(segment, record, 0), TIME_WIDTH);
+			if(time >= fromTime && time <= toTime)
+			{
+				records.emplace_back();
+				readRecord(segment, record, records.back());
+			}
+		}
+	}
+}
+
+void LogStore::readBatch(std::vector<LogRecord>& records, uint64_t fromSequence, size_t maxRecords)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	size_t added = 0;
+	for(Segment& segment : m_segments)
+	{
+		const SegmentHeader* header = segment.header;
+		if(header->firstSequence + header->count <= fromSequence)
+		{
+			continue;
+		}
+
+		uint32_t record = header->removed;
+		if(fromSequence > header->firstSequence)
+		{
+			record = std::max(record, (uint32_t)(fromSequence - header->firstSequence));
+		}
+
+		for(; record < header->count; record++)
+		{
+			if(added == maxRecords)
+			{
+				return;
+			}
+			records.emplace_back();
+			readRecord(segment, record, records.back());
+			added++;
+		}
+	}
+}
+
+bool LogStore::readLatest(LogRecord& record)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for(auto segment = m_segments.rbegin(); segment != m_segments.rend(); ++segment)
+	{
+		if(segment->header->count > segment->header->removed)
+		{
+			readRecord(*segment, segment->header->count - 1, record);
+			return true;
+		}
+	}
+	return false;
+}
+
+void LogStore::remove(uint64_t endSequence)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for(auto segment = m_segments.begin(); segment != m_segments.end();)
+	{
+		SegmentHeader* header = segment->header;
+		if(endSequence <= header->firstSequence)
+		{
+			break;
+		}
+
+		uint64_t removed = std::min((uint64_t)header->count, endSequence - header->firstSequence);
+		if(removed > header->removed)
+		{
+			header->removed = (uint32_t)removed;
+			msync(segment->map, SEGMENT_HEADER_SIZE, MS_ASYNC);
+		}
+
+		// the last segment is kept for the sequence numbers of the next appends
+		bool last = (segment + 1 == m_segments.end());
+		if(header->removed >= header->count && not last)
+		{
+			std::string path = segment->path;
+			unmapSegment(*segment);
+			unlink(path.c_str());
+			segment = m_segments.erase(segment);
+		}
+		else
+		{
+			++segment;
+		}
+	}
+}
+
+uint64_t LogStore::count()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	uint64_t records = 0;
+	for(const Segment& segment : m_segments)
+	{
+		records += segment.header->count - std::min(segment.header->count, segment.header->removed);
+	}
+	return records;
+}
+
+bool LogStore::mapSegment(const std::string& path, bool create, uint64_t firstSequence, Segment& segment)
+{
+	size_t size = SEGMENT_HEADER_SIZE + (m_capacity / LOG_STORE_BLOCK_RECORDS) * m_blockSize;
+
+	int file = ::open(path.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0644);
+	if(file < 0)
+	{
+		Logger::error("%s Failed to open %s: %s", __PRETTY_FUNCTION__, path.c_str(), strerror(errno));
+		return false;
+	}
+
+	if(not create)
+	{
+		// the capacity of an existing segment is the one it was created with
+		SegmentHeader header;
+		struct stat status;
+		if(pread(file, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || fstat(file, &status) != 0 ||
+			header.magic != SEGMENT_MAGIC || header.layout != m_layout || header.capacity % LOG_STORE_BLOCK_RECORDS != 0 ||
+			header.count > header.capacity ||
+			(size_t)status.st_size != SEGMENT_HEADER_SIZE + (header.capacity / LOG_STORE_BLOCK_RECORDS) * m_blockSize)
+		{
+			Logger::error("%s %s is not a segment of this log store, it is not read", __PRETTY_FUNCTION__, path.c_str());
+			::close(file);
+			return false;
+		}
+		size = status.st_size;
+	}
+	else if(ftruncate(file, size) != 0)
+	{
+		Logger::error("%s Failed to size %s: %s", __PRETTY_FUNCTION__, path.c_str(), strerror(errno));
+		::close(file);
+		unlink(path.c_str());
+		return false;
+	}
+
+	void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	if(map == MAP_FAILED)
+	{
+		Logger::error("%s Failed to map %s: %s", __PRETTY_FUNCTION__, path.c_str(), strerror(errno));
+		::close(file);
+		if(create)
+		{
+			unlink(path.c_str());
+		}
+		return false;
+	}
+
+	segment.path = path;
+	segment.file = file;
+	segment.map = static_cast<uint8_t*>(map);
+	segment.size = size;
+	segment.header = reinterpret_cast<SegmentHeader*>(map);
+
+	if(create)
+	{
+		SegmentHeader* header = segment.header;
+		header->magic = SEGMENT_MAGIC;
+		header->layout = m_layout;
+		header->capacity = m_capacity;
+		header->count = 0;
+		header->removed = 0;
+		header->reserved = 0;
+		header->firstSequence = firstSequence;
+		header->minTime = std::numeric_limits<int64_t>::max();
+		header->maxTime = std::numeric_limits<int64_t>::min();
+	}
+	return true;
+}
+
+void LogStore::unmapSegment(Segment& segment)
+{
+	munmap(segment.map, segment.size);
+	::close(segment.file);
+	segment.map = NULL;
+	segment.header = NULL;
+}
+
+bool LogStore::sync(Segment& segment, size_t offset, size_t length)
+{
+	static const size_t PAGE_SIZE = sysconf(_SC_PAGESIZE);
+
+	size_t start = (offset / PAGE_SIZE) * PAGE_SIZE;
+	size_t end = std::min(segment.size, offset + length);
+	if(msync(segment.map + start, end - start, MS_SYNC) != 0)
+	{
+		Logger::error("%s Failed to write %s: %s", __PRETTY_FUNCTION__, segment.path.c_str(), strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+uint8_t* LogStore::value(Segment& segment, uint32_t record, unsigned int column)
+{
+	uint32_t block = record / LOG_STORE_BLOCK_RECORDS;
+	uint32_t slot = record % LOG_STORE_BLOCK_RECORDS;
+	return segment.map + SEGMENT_HEADER_SIZE + block * m_blockSize + m_columnOffsets[column] + slot * m_columnWidths[column];
+}
+
+void LogStore::readRecord(Segment& segment, uint32_t record, LogRecord& logRecord)
+{
+	const std::vector<LogColumn>& logColumns = columns();
+
+	logRecord.sequence = segment.header->firstSequence + record;
+	memcpy(&logRecord.time, value(segment, record, 0), TIME_WIDTH);
+	for(unsigned int column = 0; column < logColumns.size(); column++)
+	{
+		logColumns[column].load(value(segment, record, column + 1), logRecord.item);
+	}
+}
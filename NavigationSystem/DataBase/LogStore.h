@@ -0,0 +1,182 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogStore.h
+ *
+ * Purpose:
+ *		An append-only store for the dataLogs, made to keep up with the sensors at full
+ *		rate. The LogItems are written as fixed width records to memory mapped segment
+ *		files, LogStoreExporter turns them into the dataLogs_* tables of the database or
+ *		into the JSON HTTPSyncNode sends.
+ *
+ * Developer Notes:
+ *		A segment is one file of the store directory, named after the sequence number of
+ *		its first record. It starts with a header page and then holds blocks of
+ *		LOG_STORE_BLOCK_RECORDS records, inside a block the values are stored column by
+ *		column. An append only dirties the pages of the blocks it writes to, and reading
+ *		one column of a segment doesn't read the rest of the record.
+ *
+ *		The header keeps the count of records written, it is only updated once the
+ *		records are on the disk, so a crash loses the last append at most. It also keeps
+ *		the lowest and highest time of the segment, reading a time range skips the
+ *		segments outside of it without looking at the records.
+ *
+ *		Removing records marks them in the header, a segment is deleted when all its
+ *		records are removed and it isn't the one being appended to.
+ *
+ *		One LogStore per directory, the threads of a process can share it. Another
+ *		process can't write to the same directory.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "DataBase/DBHandler.h"
+
+#include <limits>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+#define LOG_STORE_BLOCK_RECORDS 		64
+#define LOG_STORE_SEGMENT_RECORDS 		65536
+#define LOG_STORE_TEXT_WIDTH 			32
+
+
+///----------------------------------------------------------------------------------
+/// A field of the LogItem and the column it is stored in or exported to.
+///----------------------------------------------------------------------------------
+struct LogColumn {
+	enum class Type { Double, Float, Int, Bool, Text };
+
+	LogColumn(const char* name, double LogItem::* member);
+	LogColumn(const char* name, float LogItem::* member);
+	LogColumn(const char* name, int LogItem::* member);
+	LogColumn(const char* name, bool LogItem::* member);
+	LogColumn(const char* name, std::string LogItem::* member);
+
+	///----------------------------------------------------------------------------------
+	/// Returns the bytes a value takes in a record.
+	///----------------------------------------------------------------------------------
+	unsigned int width() const;
+
+	///----------------------------------------------------------------------------------
+	/// Copies the field between a LogItem and a record, a text longer than
+	/// LOG_STORE_TEXT_WIDTH is cut.
+	///----------------------------------------------------------------------------------
+	void store(const LogItem& item, uint8_t* value) const;
+	void load(const uint8_t* value, LogItem& item) const;
+
+	const char* name;
+	Type type;
+	double LogItem::* doubleMember;
+	float LogItem::* floatMember;
+	int LogItem::* intMember;
+	bool LogItem::* boolMember;
+	std::string LogItem::* textMember;
+};
+
+struct LogRecord {
+	uint64_t sequence;		// Counts the records of the store from 1, never reused
+	int64_t time;			// Unix time of the append in microseconds
+	LogItem item;
+};
+
+
+class LogStore {
+public:
+	LogStore(std::string directory, unsigned int recordsPerSegment = LOG_STORE_SEGMENT_RECORDS);
+	~LogStore();
+
+	///----------------------------------------------------------------------------------
+	/// Creates the directory if it doesn't exist and maps the segments already in it.
+	/// A segment written with other columns is left alone and not read.
+	///----------------------------------------------------------------------------------
+	bool open();
+
+	///----------------------------------------------------------------------------------
+	/// Appends the logs and waits until they are on the disk, a new segment is started
+	/// when the last one is full. Returns false if a log could not be written, the ones
+	/// before it are kept.
+	///----------------------------------------------------------------------------------
+	bool append(const std::vector<LogItem>& logs);
+
+	///----------------------------------------------------------------------------------
+	/// Adds the records appended between the two unix times, in microseconds, to the
+	/// vector in the order they were appended. The removed records are left out.
+	///----------------------------------------------------------------------------------
+	void read(std::vector<LogRecord>& records,
+		int64_t fromTime = std::numeric_limits<int64_t>::min(),
+		int64_t toTime = std::numeric_limits<int64_t>::max());
+
+	///----------------------------------------------------------------------------------
+	/// Adds up to maxRecords records to the vector, the oldest ones with a sequence
+	/// number from the one given, in the order they were appended. The removed records
+	/// are left out.
+	///----------------------------------------------------------------------------------
+	void readBatch(std::vector<LogRecord>& records, uint64_t fromSequence, size_t maxRecords);
+
+	///----------------------------------------------------------------------------------
+	/// Gets the record appended last, false if there are none.
+	///----------------------------------------------------------------------------------
+	bool readLatest(LogRecord& record);
+
+	///----------------------------------------------------------------------------------
+	/// Removes the records with a sequence number lower than the one given.
+	///----------------------------------------------------------------------------------
+	void remove(uint64_t endSequence);
+
+	///----------------------------------------------------------------------------------
+	/// Returns the records that are not removed.
+	///----------------------------------------------------------------------------------
+	uint64_t count();
+
+	///----------------------------------------------------------------------------------
+	/// Returns the bytes of a record, the columns of the LogItem and the time.
+	///----------------------------------------------------------------------------------
+	unsigned int recordWidth() const { return m_recordWidth; }
+
+	///----------------------------------------------------------------------------------
+	/// The fields of the LogItem the store keeps, in the order of the record.
+	///----------------------------------------------------------------------------------
+	static const std::vector<LogColumn>& columns();
+
+private:
+	struct SegmentHeader;
+
+	struct Segment {
+		std::string path;
+		int file;
+		uint8_t* map;
+		size_t size;
+		SegmentHeader* header;
+	};
+
+	bool mapSegment(const std::string& path, bool create, uint64_t firstSequence, Segment& segment);
+	void unmapSegment(Segment& segment);
+
+	///----------------------------------------------------------------------------------
+	/// Writes a range of the mapping to the disk and waits for it.
+	///----------------------------------------------------------------------------------
+	bool sync(Segment& segment, size_t offset, size_t length);
+
+	///----------------------------------------------------------------------------------
+	/// Returns the address of a value in a segment, column 0 is the time.
+	///----------------------------------------------------------------------------------
+	uint8_t* value(Segment& segment, uint32_t record, unsigned int column);
+
+	void readRecord(Segment& segment, uint32_t record, LogRecord& logRecord);
+
+	std::string m_directory;
+	uint32_t m_capacity;
+	uint32_t m_layout;
+	unsigned int m_recordWidth;
+	size_t m_blockSize;
+	std::vector<size_t> m_columnOffsets;		// In a block, the time column first
+	std::vector<unsigned int> m_columnWidths;
+
+	std::vector<Segment> m_segments;			// In the order of the sequence numbers
+	std::mutex m_lock;
+};
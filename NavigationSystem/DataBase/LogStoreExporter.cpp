@@ -0,0 +1,191 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogStoreExporter.cpp
+ *
+ * Purpose:
+ *		Turns the records of a LogStore into the dataLogs_* tables of the database, or
+ *		into the JSON DBHandler::getLogs() makes of those tables for the server.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/LogStoreExporter.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+
+struct ExportTable {
+	const char* name;
+	std::vector<LogColumn> columns;
+};
+
+///----------------------------------------------------------------------------------
+/// The dataLogs_* tables and the fields of the LogItem in their columns, the same as
+/// DBHandler::insertDataLogs writes.
+///----------------------------------------------------------------------------------
+static const std::vector<ExportTable>& exportTables()
+{
+	static const std::vector<ExportTable> TABLES = {
+		{ "dataLogs_actuator_feedback", {
+			{ "rudder_position", &LogItem::m_rudderPosition },
+			{ "wingsail_position", &LogItem::m_wingsailPosition },
+			{ "rc_on", &LogItem::m_radioControllerOn },
+			{ "wind_vane_angle", &LogItem::m_windVaneAngle },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_compass", {
+			{ "heading", &LogItem::m_compassHeading },
+			{ "pitch", &LogItem::m_compassPitch },
+			{ "roll", &LogItem::m_compassRoll },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_course_calculation", {
+			{ "distance_to_waypoint", &LogItem::m_distanceToWaypoint },
+			{ "bearing_to_waypoint", &LogItem::m_bearingToWaypoint },
+			{ "course_to_steer", &LogItem::m_courseToSteer },
+			{ "tack", &LogItem::m_tack },
+			{ "going_starboard", &LogItem::m_goingStarboard },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_current_sensors", {
+			{ "actuator_unit", &LogItem::m_currentActuatorUnit },
+			{ "navigation_unit", &LogItem::m_currentNavigationUnit },
+			{ "wind_vane_angle", &LogItem::m_currentWindVaneAngle },
+			{ "wind_vane_clutch", &LogItem::m_currentWindVaneClutch },
+			{ "sailboat_drive", &LogItem::m_currentSailboatDrive },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_gps", {
+			{ "has_fix", &LogItem::m_gpsHasFix },
+			{ "online", &LogItem::m_gpsOnline },
+			{ "time", &LogItem::m_timestamp_str },
+			{ "latitude", &LogItem::m_gpsLat },
+			{ "longitude", &LogItem::m_gpsLon },
+			{ "speed", &LogItem::m_gpsSpeed },
+			{ "course", &LogItem::m_gpsCourse },
+			{ "satellites_used", &LogItem::m_gpsSatellite },
+			{ "route_started", &LogItem::m_routeStarted },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_marine_sensors", {
+			{ "temperature", &LogItem::m_temperature },
+			{ "conductivity", &LogItem::m_conductivity },
+			{ "ph", &LogItem::m_ph },
+			{ "salinity", &LogItem::m_salinity },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_vessel_state", {
+			{ "heading", &LogItem::m_vesselHeading },
+			{ "latitude", &LogItem::m_vesselLat },
+			{ "longitude", &LogItem::m_vesselLon },
+			{ "speed", &LogItem::m_vesselSpeed },
+			{ "course", &LogItem::m_vesselCourse },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_wind_state", {
+			{ "true_wind_speed", &LogItem::m_trueWindSpeed },
+			{ "true_wind_direction", &LogItem::m_trueWindDir },
+			{ "apparent_wind_speed", &LogItem::m_apparentWindSpeed },
+			{ "apparent_wind_direction", &LogItem::m_apparentWindDir },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } },
+		{ "dataLogs_windsensor", {
+			{ "direction", &LogItem::m_windDir },
+			{ "speed", &LogItem::m_windSpeed },
+			{ "temperature", &LogItem::m_windTemp },
+			{ "t_timestamp", &LogItem::m_timestamp_str } } }
+	};
+	return TABLES;
+}
+
+///----------------------------------------------------------------------------------
+/// Returns a number as SQLite gives a REAL as text, a whole number keeps a ".0".
+///----------------------------------------------------------------------------------
+static std::string realText(double value)
+{
+	char text[32];
+	snprintf(text, sizeof(text), "%.15g", value);
+	if(strpbrk(text, ".eEin") == NULL)
+	{
+		strcat(text, ".0");
+	}
+	return text;
+}
+
+static std::string valueText(const LogColumn& column, const LogItem& item)
+{
+	switch(column.type)
+	{
+		case LogColumn::Type::Double:	return realText(item.*column.doubleMember);
+		case LogColumn::Type::Float:	return realText(item.*column.floatMember);
+		case LogColumn::Type::Int:		return std::to_string(item.*column.intMember);
+		case LogColumn::Type::Bool:		return (item.*column.boolMember) ? "1" : "0";
+		case LogColumn::Type::Text:		return item.*column.textMember;
+	}
+	return "";
+}
+
+bool LogStoreExporter::toDatabase(LogStore& logStore, DBHandler& dbHandler)
+{
+	std::vector<LogRecord> records;
+	std::vector<LogItem> batch;
+	records.reserve(LOG_STORE_EXPORT_BATCH);
+	batch.reserve(LOG_STORE_EXPORT_BATCH);
+
+	// The removed records are skipped, so every batch starts at the oldest record left
+	do
+	{
+		records.clear();
+		logStore.readBatch(records, 0, LOG_STORE_EXPORT_BATCH);
+		if(records.empty())
+		{
+			break;
+		}
+
+		batch.clear();
+		for(const LogRecord& record : records)
+		{
+			batch.push_back(record.item);
+		}
+
+		if(not dbHandler.insertDataLogs(batch))
+		{
+			return false;
+		}
+		logStore.remove(records.back().sequence + 1);
+	}
+	while(records.size() == LOG_STORE_EXPORT_BATCH);
+	return true;
+}
+
+std::string LogStoreExporter::toJson(const std::vector<LogRecord>& records, int currentMissionId)
+{
+	static const char* SYSTEM_IDS[] = {
+		"actuator_feedback_id", "compass_id", "course_calculation_id", "current_sensors_id", "gps_id",
+		"marine_sensors_id", "vessel_state_id", "wind_state_id", "windsensor_id"
+	};
+
+	Json js;
+
+	for(const LogRecord& record : records)
+	{
+		std::string id = std::to_string(record.sequence);
+
+		for(const ExportTable& table : exportTables())
+		{
+			Json row;
+			row["id"] = id;
+			for(const LogColumn& column : table.columns)
+			{
+				row[column.name] = valueText(column, record.item);
+			}
+			js[table.name].push_back(row);
+		}
+
+		// the rows of a record all have its sequence number as id
+		Json system;
+		system["id"] = id;
+		for(const char* column : SYSTEM_IDS)
+		{
+			system[column] = id;
+		}
+		system["current_mission_id"] = std::to_string(currentMissionId);
+		js["dataLogs_system"].push_back(system);
+	}
+
+	return js.dump();
+}
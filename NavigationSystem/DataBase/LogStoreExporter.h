@@ -0,0 +1,44 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogStoreExporter.h
+ *
+ * Purpose:
+ *		Turns the records of a LogStore into the dataLogs_* tables of the database, or
+ *		into the JSON DBHandler::getLogs() makes of those tables for the server.
+ *
+ * Developer Notes:
+ *		The JSON has the same tables and columns as the one from the database, with the
+ *		values as text the way SQLite gives them. The id of every row of a record is the
+ *		sequence number of the record in the store.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "DataBase/DBHandler.h"
+#include "DataBase/LogStore.h"
+
+#include <string>
+#include <vector>
+
+
+#define LOG_STORE_EXPORT_BATCH 		500
+
+
+class LogStoreExporter {
+public:
+	///----------------------------------------------------------------------------------
+	/// Moves every record of the store to the dataLogs_* tables, in batches of
+	/// LOG_STORE_EXPORT_BATCH. The records are removed from the store once they are
+	/// in the database. Returns false if a batch could not be written, it stays in the
+	/// store with the ones after it.
+	///----------------------------------------------------------------------------------
+	static bool toDatabase(LogStore& logStore, DBHandler& dbHandler);
+
+	///----------------------------------------------------------------------------------
+	/// Returns the records as JSON, an array per dataLogs_* table with a row for every
+	/// record. The rows of dataLogs_system get the current mission.
+	///----------------------------------------------------------------------------------
+	static std::string toJson(const std::vector<LogRecord>& records, int currentMissionId);
+};
@@ -14,6 +14,7 @@
  ***************************************************************************************/
 
 #include "HTTPSyncNode.h"
+#include "DataBase/LogStoreExporter.h"
 #include "Messages/LocalConfigChangeMsg.h"
 #include "Messages/LocalWaypointChangeMsg.h"
 #include "Messages/ServerConfigsReceivedMsg.h"
@@ -28,8 +29,8 @@ size_t write_to_string(void *ptr, size_t size, size_t count, void *stream) {
     return size*count;
 }
 
-HTTPSyncNode::HTTPSyncNode(MessageBus& msgBus, DBHandler *dbhandler)
-	:ActiveNode(NodeID::HTTPSync, msgBus), m_removeLogs(1), m_LoopTime(0.5), m_dbHandler(dbhandler)
+HTTPSyncNode::HTTPSyncNode(MessageBus& msgBus, DBHandler *dbhandler, LogStore *logStore)
+	:ActiveNode(NodeID::HTTPSync, msgBus), m_removeLogs(1), m_LoopTime(0.5), m_dbHandler(dbhandler), m_logStore(logStore)
 {
     msgBus.registerNode( *this, MessageType::LocalWaypointChange);
     msgBus.registerNode( *this, MessageType::LocalConfigChange);
@@ -133,6 +134,11 @@ void HTTPSyncNode::HTTPSyncThread(ActiveNode* nodePtr){
 bool HTTPSyncNode::pushDatalogs() {
     std::string response = "";
 
+    if(m_logStore != NULL)
+    {
+        return pushStoredLogs();
+    }
+
     if(performCURLCall(m_dbHandler->getLogs(m_pushOnlyLatestLogs), "pushAllLogs", response))
     {
          //remove logs after push
@@ -149,6 +155,54 @@ bool HTTPSyncNode::pushDatalogs() {
     return false;
 }
 
+bool HTTPSyncNode::pushStoredLogs() {
+    std::string response = "";
+    std::vector<LogRecord> records;
+    int currentMissionId = (int)strtol(m_dbHandler->getIdFromTable("current_Mission", true).c_str(), NULL, 10);
+
+    if(m_pushOnlyLatestLogs) {
+        LogRecord latest;
+        if(m_logStore->readLatest(latest)) {
+            records.push_back(latest);
+        }
+        return pushStoredLogs(records, currentMissionId);
+    }
+
+    //a batch at a time so a long time offline doesn't load the whole store at once
+    uint64_t nextSequence = 0;
+    do {
+        records.clear();
+        m_logStore->readBatch(records, nextSequence, LOG_STORE_EXPORT_BATCH);
+        if(not pushStoredLogs(records, currentMissionId)) {
+            return false;
+        }
+        if(not records.empty()) {
+            nextSequence = records.back().sequence + 1;
+        }
+    } while(records.size() == LOG_STORE_EXPORT_BATCH);
+
+    return true;
+}
+
+bool HTTPSyncNode::pushStoredLogs(const std::vector<LogRecord>& records, int currentMissionId) {
+    std::string response = "";
+
+    if(performCURLCall(LogStoreExporter::toJson(records, currentMissionId), "pushAllLogs", response))
+    {
+        //remove the logs that were pushed, not the ones logged since
+        if(m_removeLogs && not records.empty()) {
+            m_logStore->remove(records.back().sequence + 1);
+        }
+        return true;
+    }
+    else if(!m_reportedConnectError)
+    {
+        Logger::warning("%s Could not push logs to server:", __PRETTY_FUNCTION__);
+    }
+
+    return false;
+}
+
 bool HTTPSyncNode::pushWaypoints()
 {
 	std::string waypointsData = m_dbHandler->getWaypoints();
@@ -3,6 +3,7 @@
 
 #include "MessageBus/ActiveNode.h"
 #include "DataBase/DBHandler.h"
+#include "DataBase/LogStore.h"
 #include "SystemServices/Logger.h"
 
 
@@ -16,7 +17,10 @@
 class HTTPSyncNode : public ActiveNode{
 	public:
 
-		HTTPSyncNode(MessageBus& msgBus, DBHandler *dbhandler);
+		///----------------------------------------------------------------------------------
+		/// With a log store the datalogs are pushed from it instead of the database
+		///----------------------------------------------------------------------------------
+		HTTPSyncNode(MessageBus& msgBus, DBHandler *dbhandler, LogStore *logStore = NULL);
 
 		virtual ~HTTPSyncNode() { }
 
@@ -57,6 +61,17 @@ class HTTPSyncNode : public ActiveNode{
 		///----------------------------------------------------------------------------------
 		bool performCURLCall(std::string data, std::string call, std::string& response);
 
+		///----------------------------------------------------------------------------------
+		/// Pushes the datalogs of the log store LOG_STORE_EXPORT_BATCH at a time, removes
+		/// only the ones that were pushed
+		///----------------------------------------------------------------------------------
+		bool pushStoredLogs();
+
+		///----------------------------------------------------------------------------------
+		/// Pushes one batch, removes it from the log store once the server took it
+		///----------------------------------------------------------------------------------
+		bool pushStoredLogs(const std::vector<LogRecord>& records, int currentMissionId);
+
 
 
         bool checkIfNewConfigs();
@@ -96,5 +111,6 @@ class HTTPSyncNode : public ActiveNode{
 
 		std::atomic<bool> m_Running;
 		DBHandler *m_dbHandler;
+		LogStore *m_logStore;
 
 };
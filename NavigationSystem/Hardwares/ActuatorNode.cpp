@@ -66,6 +66,10 @@ void ActuatorNode::processMessage(const Message* message)
 		{
 			Logger::error("%s Actuator: %d Failed to write position command", __PRETTY_FUNCTION__, (int)nodeID());
 		}
+		else
+		{
+			m_MsgBus.causalTracer().record(*message, nodeID());
+		}
 	}
 
 }
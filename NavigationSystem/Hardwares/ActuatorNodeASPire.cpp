@@ -48,10 +48,17 @@ void ActuatorNodeASPire::processMessage(const Message* message)
 		m_rudderAngle = -actMsg->rudderAngle();
     }
 
-    sendCommandMessage();
+    if(not sendCommandMessage())
+    {
+        Logger::error("%s Failed to send the actuator command", __PRETTY_FUNCTION__);
+    }
+    else
+    {
+        m_MsgBus.causalTracer().record(*message, nodeID());
+    }
 }
 
-void ActuatorNodeASPire::sendCommandMessage()
+bool ActuatorNodeASPire::sendCommandMessage()
 {
 	uint16_t rudderAngle16 = Utility::mapInterval (m_rudderAngle, -MAX_RUDDER_ANGLE, MAX_RUDDER_ANGLE, 0 , INT16_SIZE);
 	uint16_t wingsailAngle16 = Utility::mapInterval (m_wingsailAngle, -MAX_WINGSAIL_ANGLE, MAX_WINGSAIL_ANGLE, 0 , INT16_SIZE);
@@ -70,6 +77,6 @@ void ActuatorNodeASPire::sendCommandMessage()
 	(Cmsg.data[6] = m_windvaneSelfSteeringOn);
 	(Cmsg.data[7] = 0);
 
-	m_CANService->sendCANMessage(Cmsg);
+	return m_CANService->sendCANMessage(Cmsg);
 }
 
@@ -27,7 +27,7 @@ public:
 	~ActuatorNodeASPire();
 	bool init();
 	void processMessage(const Message* message);
-	void sendCommandMessage();
+	bool sendCommandMessage();
 
 private:
 	CANService* m_CANService;
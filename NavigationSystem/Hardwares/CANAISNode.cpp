@@ -141,7 +141,8 @@ void CANAISNode::CANAISThreadFunc(ActiveNode* nodePtr) {
 
     node->m_lock.lock();
     if (node->m_VesselList.size() != 0 || node->m_VesselInfoList.size() != 0) {
-      MessagePtr AISList = std::make_unique<AISDataMsg>(node->m_VesselList, node->m_VesselInfoList, node->m_PosLat, node->m_PosLon);
+      // The lists are handed over to the message, clear() makes them usable again
+      MessagePtr AISList = std::make_unique<AISDataMsg>(std::move(node->m_VesselList), std::move(node->m_VesselInfoList), node->m_PosLat, node->m_PosLon);
       node->m_MsgBus.sendMessage(std::move(AISList));
       node->m_lock.unlock();
       node->m_VesselList.clear();
@@ -40,10 +40,11 @@ bool CANService::registerForReading(CANFrameReceiver& receiver, uint32_t ID)
 
 }
 
-void CANService::sendCANMessage(CanMsg& msg)
+bool CANService::sendCANMessage(CanMsg& msg)
 {
   std::lock_guard<std::mutex> lock (m_QueueMutex);
   m_MsgQueue.push(msg);
+  return m_Running.load();
 }
 
 CanMsg CANService::getCANMessage()
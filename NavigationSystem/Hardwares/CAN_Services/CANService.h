@@ -39,7 +39,7 @@ struct FastPKGInfo {
 class CANService
 {
 public:
-  CANService() {}
+  CANService() : m_Running(false) {}
 
   ~CANService() {}
 
@@ -52,8 +52,10 @@ public:
 
 /* Sends a NMEA2000 message onto the service, which will  *
  * then either be sent to another receiver, or if no such *
- * receiver is registered, will be discarded.             */
-  void sendCANMessage(CanMsg& msg);
+ * receiver is registered, will be discarded. Returns     *
+ * false if the service isn't running, the message is     *
+ * then sent once it is started.                          */
+  bool sendCANMessage(CanMsg& msg);
 
   CanMsg getCANMessage();
 
@@ -15,6 +15,7 @@
 #include "SystemServices/Logger.h"
 #include "Messages/GPSDataMsg.h"
 #include "SystemServices/Timer.h"
+#include "SystemServices/SysClock.h"
 
 
 GPSDNode::GPSDNode(MessageBus& msgBus, DBHandler& dbhandler)
@@ -125,7 +126,7 @@ void GPSDNode::GPSThreadFunc(ActiveNode* nodePtr)
 		GPSMode mode = GPSMode::NoUpdate;
 		mode = static_cast<GPSMode>(newData->fix.mode);
 
-		MessagePtr msg = std::make_unique<GPSDataMsg>(gps_hasFix, gps_online, node->m_Lat, node->m_Lon, unixTime, node->m_Speed, node->m_Course, satCount, mode);
+		MessagePtr msg = MessageBus::make<GPSDataMsg>(gps_hasFix, gps_online, node->m_Lat, node->m_Lon, unixTime, node->m_Speed, node->m_Course, satCount, mode);
 		node->m_MsgBus.sendMessage(std::move(msg));
 
 		// Controls how often we pump out messages
@@ -12,27 +12,31 @@
  ***************************************************************************************/
 
 #include "CourseRegulatorNode.h"
+#include "SystemServices/SysClock.h"
 
 
 #define DATA_OUT_OF_RANGE -2000
 const int INITIAL_SLEEP = 2000; // milliseconds
 const float NO_COMMAND = -1000;
+const size_t RESERVED_COMMANDS = 128; // messages allocated before the loop starts
 
 
 ///----------------------------------------------------------------------------------
 CourseRegulatorNode::CourseRegulatorNode( MessageBus& msgBus,  DBHandler& dbhandler)
 :ActiveNode(NodeID::CourseRegulatorNode,msgBus), m_db(dbhandler), m_Running(0), 
 m_LoopTime(0.5), m_MaxRudderAngle(30), m_pGain(1), m_iGain(1), m_dGain(1),
-m_VesselCourse(DATA_OUT_OF_RANGE), m_VesselSpeed(DATA_OUT_OF_RANGE), m_DesiredCourse(DATA_OUT_OF_RANGE)
+m_DesiredCourse(DATA_OUT_OF_RANGE)
 
 {
-    msgBus.registerNode( *this, MessageType::StateMessage);
-    msgBus.registerNode( *this, MessageType::LocalNavigation);
-    msgBus.registerNode( *this, MessageType::ServerConfigsReceived);
+    msgBus.subscribe(*this, &CourseRegulatorNode::processLocalNavigationMessage);
+    msgBus.subscribe(*this, &CourseRegulatorNode::processServerConfigsReceivedMessage);
 }
 
 ///----------------------------------------------------------------------------------
-CourseRegulatorNode::~CourseRegulatorNode(){}
+CourseRegulatorNode::~CourseRegulatorNode()
+{
+    m_MsgBus.removeControlLoop(m_LoopTimer);
+}
 
 ///----------------------------------------------------------------------------------
 bool CourseRegulatorNode::init()
@@ -45,6 +49,8 @@ bool CourseRegulatorNode::init()
 void CourseRegulatorNode::start()
 {
     m_Running.store(true);
+    MessageBus::reserve<RudderCommandMsg>(RESERVED_COMMANDS);
+    m_MsgBus.addControlLoop(nodeID(), m_LoopTimer);
     runThread(CourseRegulatorNodeThreadFunc);
 }
 
@@ -53,62 +59,50 @@ void CourseRegulatorNode::stop()
 {
     m_Running.store(false);
     stopThread(this);
-}
-
-///----------------------------------------------------------------------------------
-void CourseRegulatorNode::processMessage( const Message* msg )
-{
-    switch(msg->messageType())
-    {
-    case MessageType::StateMessage:
-        processStateMessage(static_cast< const StateMessage*>(msg));
-        break;
-    case MessageType::LocalNavigation:
-        processLocalNavigationMessage(static_cast< const LocalNavigationMsg*>(msg));
-        break;
-    case MessageType::ServerConfigsReceived:
-        updateConfigsFromDB();
-        break;
-    default:
-        return;
-    }
+    m_MsgBus.removeControlLoop(m_LoopTimer);
 }
 
 ///----------------------------------------------------------------------------------
 void CourseRegulatorNode::updateConfigsFromDB()
 {
-    m_LoopTime = m_db.retrieveCellAsDouble("config_course_regulator","1","loop_time");
-    m_MaxRudderAngle = m_db.retrieveCellAsInt("config_course_regulator","1","max_rudder_angle");
-    m_pGain = m_db.retrieveCellAsDouble("config_course_regulator","1","p_gain");
-    m_iGain = m_db.retrieveCellAsDouble("config_course_regulator","1","i_gain");
-    m_dGain = m_db.retrieveCellAsDouble("config_course_regulator","1","d_gain");
+    std::shared_ptr<const ConfigSnapshot> configs = m_db.configs();
+    m_LoopTime = configs->getDouble("config_course_regulator","loop_time");
+    m_LoopTimer.setPeriod(m_LoopTime);
+    m_MaxRudderAngle = configs->getInt("config_course_regulator","max_rudder_angle");
+    m_pGain = configs->getDouble("config_course_regulator","p_gain");
+    m_iGain = configs->getDouble("config_course_regulator","i_gain");
+    m_dGain = configs->getDouble("config_course_regulator","d_gain");
 }
 
 ///----------------------------------------------------------------------------------
-void CourseRegulatorNode::processStateMessage(const StateMessage* msg)
+void CourseRegulatorNode::processServerConfigsReceivedMessage(const ServerConfigsReceivedMsg& msg)
 {
-    std::lock_guard<std::mutex> lock_guard(m_lock);
-
-    m_VesselCourse = msg->course();
-    m_VesselSpeed = msg->speed();
+    updateConfigsFromDB();
 }
 
 ///----------------------------------------------------------------------------------
-void CourseRegulatorNode::processLocalNavigationMessage(const LocalNavigationMsg* msg)
+void CourseRegulatorNode::processLocalNavigationMessage(const LocalNavigationMsg& msg)
 {
     std::lock_guard<std::mutex> lock_guard(m_lock);
 
-    m_DesiredCourse = msg->targetCourse();
+    m_DesiredCourse = msg.targetCourse();
+    m_DesiredCourseCause = msg.asCause();
 }
 
 ///----------------------------------------------------------------------------------
-float CourseRegulatorNode::calculateRudderAngle()
+float CourseRegulatorNode::calculateRudderAngle(MessageCause& cause)
 {
+    StateMessage::Snapshot vessel;
+    MessageCause vesselCause;
+    bool haveState = m_MsgBus.blackboard().read(MessageType::StateMessage, vessel, vesselCause);
+
     std::lock_guard<std::mutex> lock_guard(m_lock);
+    cause = MessageCause::oldest(m_DesiredCourseCause, vesselCause);
 
-    if((m_DesiredCourse != DATA_OUT_OF_RANGE) and (m_VesselCourse != DATA_OUT_OF_RANGE))
+    if((m_DesiredCourse != DATA_OUT_OF_RANGE) and haveState)
     {
-        float difference_Heading = Utility::degreeToRadian(m_VesselCourse - m_DesiredCourse);
+        float vesselCourse = vessel.course;
+        float difference_Heading = Utility::degreeToRadian(vesselCourse - m_DesiredCourse);
 
         if(cos(difference_Heading) < 0) // Wrong sense because over +/- 90°
         {   // Max Rudder angle in the opposite way
@@ -133,20 +127,20 @@ void CourseRegulatorNode::CourseRegulatorNodeThreadFunc(ActiveNode* nodePtr)
 
     // An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
     // at the start before we send out the state message.
-    std::this_thread::sleep_for(std::chrono::milliseconds(INITIAL_SLEEP));
+    SysClock::sleepFor(std::chrono::milliseconds(INITIAL_SLEEP));
 
-    Timer timer;
-    timer.start();
+    node->m_LoopTimer.start(node->m_LoopTime);
 
     while(node->m_Running.load() == true)
     {
-        float rudderCommand = node->calculateRudderAngle();
+        MessageCause cause;
+        float rudderCommand = node->calculateRudderAngle(cause);
         if (rudderCommand != NO_COMMAND)
         {
-            MessagePtr rudderCommandMsg = std::make_unique<RudderCommandMsg>(rudderCommand);
+            MessagePtr rudderCommandMsg = MessageBus::make<RudderCommandMsg>(rudderCommand);
+            rudderCommandMsg->setCause(cause);
             node->m_MsgBus.sendMessage(std::move(rudderCommandMsg));
         }
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
+        node->m_LoopTimer.sleepUntilNextDeadline();
     }
 }
@@ -27,7 +27,8 @@
 #include "Messages/StateMessage.h"
 #include "Messages/LocalNavigationMsg.h"
 #include "Messages/RudderCommandMsg.h"
-#include "SystemServices/Timer.h"
+#include "Messages/ServerConfigsReceivedMsg.h"
+#include "SystemServices/DeadlineTimer.h"
 
 
 class CourseRegulatorNode : public ActiveNode{
@@ -38,7 +39,11 @@ public:
     bool init();
     void start();
     void stop();
-    void processMessage(const Message* message);
+
+    ///----------------------------------------------------------------------------------
+    /// Every message the node takes goes to a typed handler.
+    ///----------------------------------------------------------------------------------
+    void processMessage(const Message*) { }
 
 private:
 
@@ -48,20 +53,22 @@ private:
     void updateConfigsFromDB();
 
     ///----------------------------------------------------------------------------------
-    /// Stores vessel speed and course datas from a StateMessage.
+    /// Reloads the parameters when the server sent new ones.
     ///----------------------------------------------------------------------------------
-    void processStateMessage( const StateMessage* msg);
+    void processServerConfigsReceivedMessage(const ServerConfigsReceivedMsg& msg);
 
     ///----------------------------------------------------------------------------------
     /// Stores target course data from a LocalNavigationMsg.
     ///----------------------------------------------------------------------------------
-    void processLocalNavigationMessage( const LocalNavigationMsg* msg);
+    void processLocalNavigationMessage(const LocalNavigationMsg& msg);
 
     ///----------------------------------------------------------------------------------
-    /// Calculates the command rudder angle according to the course difference.
+    /// Calculates the command rudder angle according to the course difference, the
+    /// vessel course comes from the message bus blackboard. The command is as old as the
+    /// older of the target course and the vessel state, cause is set to that one.
     /// Equation from book "Robotic Sailing 2015 ", page 141.
     ///----------------------------------------------------------------------------------
-    float calculateRudderAngle();
+    float calculateRudderAngle(MessageCause& cause);
 
     ///----------------------------------------------------------------------------------
     /// Starts the CourseRegulatorNode's thread that pumps out RudderCommandMsg.
@@ -73,15 +80,14 @@ private:
     std::atomic<bool> m_Running;
 
     double  m_LoopTime;             // seconds
+    DeadlineTimer m_LoopTimer;
     double  m_MaxRudderAngle;       // degrees
 
     double  m_pGain;
     double  m_iGain;
     double  m_dGain;
 
-    float   m_VesselCourse;         // degree [0, 360[ in North-East reference frame (clockwise)
-    float   m_VesselSpeed;          // m/s
-
     float   m_DesiredCourse;        // degree [0, 360[ in North-East reference frame (clockwise)
+    MessageCause m_DesiredCourseCause;
 
 };
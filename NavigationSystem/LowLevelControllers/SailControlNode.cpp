@@ -17,26 +17,28 @@
  ***************************************************************************************/
 
 #include "SailControlNode.h"
+#include "SystemServices/SysClock.h"
 
 
-#define DATA_OUT_OF_RANGE -2000
 const int INITIAL_SLEEP = 2000; // milliseconds
 const float NO_COMMAND = -1000;
+const size_t RESERVED_COMMANDS = 128; // messages allocated before the loop starts
 
 
 ///----------------------------------------------------------------------------------
 SailControlNode::SailControlNode(MessageBus& msgBus, DBHandler& dbhandler)
     :ActiveNode(NodeID::SailControlNode,msgBus),m_db(dbhandler), m_Running(0),
-    m_LoopTime(0.5), m_MaxSailAngle(90), m_MinSailAngle(10),
-    m_ApparentWindDir(DATA_OUT_OF_RANGE)
+    m_LoopTime(0.5), m_MaxSailAngle(90), m_MinSailAngle(10)
 {
-    msgBus.registerNode( *this, MessageType::WindState);
     msgBus.registerNode( *this, MessageType::LocalNavigation);
     msgBus.registerNode( *this, MessageType::ServerConfigsReceived);
 }
 
 ///----------------------------------------------------------------------------------
-SailControlNode::~SailControlNode(){}
+SailControlNode::~SailControlNode()
+{
+    m_MsgBus.removeControlLoop(m_LoopTimer);
+}
 
 ///----------------------------------------------------------------------------------
 bool SailControlNode::init()
@@ -49,6 +51,8 @@ bool SailControlNode::init()
 void SailControlNode::start()
 {
     m_Running.store(true);
+    MessageBus::reserve<SailCommandMsg>(RESERVED_COMMANDS);
+    m_MsgBus.addControlLoop(nodeID(), m_LoopTimer);
     runThread(SailControlNodeThreadFunc);
 }
 
@@ -57,6 +61,7 @@ void SailControlNode::stop()
 {
     m_Running.store(false);
     stopThread(this);
+    m_MsgBus.removeControlLoop(m_LoopTimer);
 }
 
 ///----------------------------------------------------------------------------------
@@ -64,9 +69,6 @@ void SailControlNode::processMessage( const Message* msg)
 {
     switch( msg->messageType() )
     {
-    case MessageType::WindState:
-        processWindStateMessage(static_cast< const WindStateMsg*>(msg));
-        break;
     case MessageType::ServerConfigsReceived:
         updateConfigsFromDB();
         break;
@@ -79,18 +81,11 @@ void SailControlNode::processMessage( const Message* msg)
 void SailControlNode::updateConfigsFromDB()
 {
     m_LoopTime = m_db.retrieveCellAsDouble("config_sail_control","1","loop_time");
+    m_LoopTimer.setPeriod(m_LoopTime);
     m_MaxSailAngle = m_db.retrieveCellAsInt("config_sail_control","1","max_sail_angle");
     m_MinSailAngle = m_db.retrieveCellAsInt("config_sail_control","1","min_sail_angle");
 }
 
-///----------------------------------------------------------------------------------
-void SailControlNode::processWindStateMessage(const WindStateMsg* msg)
-{
-    std::lock_guard<std::mutex> lock_guard(m_lock);
-
-    m_ApparentWindDir = msg->apparentWindDirection();
-}
-
 ///----------------------------------------------------------------------------------
 float SailControlNode::restrictSailAngle(float val)
 {
@@ -102,12 +97,12 @@ float SailControlNode::restrictSailAngle(float val)
 ///----------------------------------------------------------------------------------
 float SailControlNode::calculateSailAngleLinear()
 {
-    std::lock_guard<std::mutex> lock_guard(m_lock);
+    WindStateMsg::Snapshot wind;
 
-    if(m_ApparentWindDir != DATA_OUT_OF_RANGE)
+    if(m_MsgBus.blackboard().read(MessageType::WindState, wind))
     {
         // Equation from book "Robotic Sailing 2015", page 141
-        return (m_MaxSailAngle-m_MinSailAngle)*std::fabs(Utility::limitAngleRange180(m_ApparentWindDir))/180 + m_MinSailAngle; //!!! on some pc abs only ouptut an int (ubuntu 14.04 gcc 4.9.3)
+        return (m_MaxSailAngle-m_MinSailAngle)*std::fabs(Utility::limitAngleRange180(wind.apparentWindDirection))/180 + m_MinSailAngle; //!!! on some pc abs only ouptut an int (ubuntu 14.04 gcc 4.9.3)
     }
     else
     {
@@ -118,11 +113,11 @@ float SailControlNode::calculateSailAngleLinear()
 ///----------------------------------------------------------------------------------
 float SailControlNode::calculateSailAngleCardioid()
 {
-    std::lock_guard<std::mutex> lock_guard(m_lock);
+    WindStateMsg::Snapshot wind;
 
-    if(m_ApparentWindDir != DATA_OUT_OF_RANGE)
+    if(m_MsgBus.blackboard().read(MessageType::WindState, wind))
     {
-        float sailAngle = 90*(-cos(Utility::degreeToRadian(m_ApparentWindDir))+1)/2;
+        float sailAngle = 90*(-cos(Utility::degreeToRadian(wind.apparentWindDirection))+1)/2;
         return restrictSailAngle(sailAngle);
     }
     else
@@ -138,10 +133,9 @@ void SailControlNode::SailControlNodeThreadFunc(ActiveNode* nodePtr)
 
     // An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
     // at the start before we send out the state message.
-    std::this_thread::sleep_for(std::chrono::milliseconds(INITIAL_SLEEP));
+    SysClock::sleepFor(std::chrono::milliseconds(INITIAL_SLEEP));
 
-    Timer timer;
-    timer.start();
+    node->m_LoopTimer.start(node->m_LoopTime);
 
     while(node->m_Running.load() == true)
     {
@@ -149,10 +143,9 @@ void SailControlNode::SailControlNodeThreadFunc(ActiveNode* nodePtr)
         float sailAngle = node->calculateSailAngleCardioid();
         if(sailAngle != NO_COMMAND)
         {
-            MessagePtr sailCommandMsg = std::make_unique<SailCommandMsg>(sailAngle);
+            MessagePtr sailCommandMsg = MessageBus::make<SailCommandMsg>(sailAngle);
             node->m_MsgBus.sendMessage(std::move(sailCommandMsg));
         }
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
+        node->m_LoopTimer.sleepUntilNextDeadline();
     }
 }
\ No newline at end of file
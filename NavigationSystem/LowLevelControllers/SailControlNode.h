@@ -30,8 +30,9 @@
 #include "MessageBus/ActiveNode.h"
 #include "MessageBus/MessageBus.h"
 #include "Messages/WindDataMsg.h"
+#include "Messages/WindStateMsg.h"
 #include "Messages/SailCommandMsg.h"
-#include "SystemServices/Timer.h"
+#include "SystemServices/DeadlineTimer.h"
 
 
 class SailControlNode : public ActiveNode {
@@ -51,11 +52,6 @@ private:
     ///----------------------------------------------------------------------------------
     void updateConfigsFromDB();
 
-    ///----------------------------------------------------------------------------------
-    /// Stores apparent wind direction from a WindStateMsg.
-    ///----------------------------------------------------------------------------------
-    void processWindStateMessage(const WindStateMsg* msg);
-
     ///----------------------------------------------------------------------------------
     /// Limits the command sail angle between m_MaxSailAngle and m_MinSailAngle.
     ///----------------------------------------------------------------------------------
@@ -63,11 +59,13 @@ private:
 
     ///----------------------------------------------------------------------------------
     /// Calculate the sail angle according to a linear relation to the apparent wind direction.
+    /// The wind state comes from the message bus blackboard.
     ///----------------------------------------------------------------------------------
     float calculateSailAngleLinear();
 
     ///----------------------------------------------------------------------------------
     /// Calculate the sail angle according to a cardioid relation to the apparent wind direction.
+    /// The wind state comes from the message bus blackboard.
     ///----------------------------------------------------------------------------------
     float calculateSailAngleCardioid();
 
@@ -77,13 +75,11 @@ private:
     static void SailControlNodeThreadFunc(ActiveNode* nodePtr);
 
     DBHandler &m_db;
-    std::mutex m_lock;
     std::atomic<bool> m_Running;
 
     double  m_LoopTime;             // seconds
+    DeadlineTimer m_LoopTimer;
     double  m_MaxSailAngle;         // degrees
     double  m_MinSailAngle;         // degrees
 
-    double  m_ApparentWindDir;      // degrees [0, 360[ in North-East reference frame (clockwise)
-
 };
@@ -42,7 +42,10 @@ SailSpeedRegulatorNode::SailSpeedRegulatorNode(MessageBus& msgBus, DBHandler& db
 }
 
 ///----------------------------------------------------------------------------------
-SailSpeedRegulatorNode::~SailSpeedRegulatorNode(){}
+SailSpeedRegulatorNode::~SailSpeedRegulatorNode()
+{
+    stopPeriodic();
+}
 
 ///----------------------------------------------------------------------------------
 bool SailSpeedRegulatorNode::init()
@@ -55,14 +58,16 @@ bool SailSpeedRegulatorNode::init()
 void SailSpeedRegulatorNode::start()
 {
     m_Running.store(true);
-    runThread(SailSpeedRegulatorNodeThreadFunc);
+    // The initial delay ensures that most if not all the sensor data arrives at the start
+    // before we send out the sail command.
+    runPeriodic(m_LoopTime, INITIAL_SLEEP);
 }
 
 ///----------------------------------------------------------------------------------
 void SailSpeedRegulatorNode::stop()
 {
     m_Running.store(false);
-    stopThread(this);
+    stopPeriodic();
 }
 
 ///----------------------------------------------------------------------------------
@@ -183,27 +188,13 @@ float SailSpeedRegulatorNode::calculateSailAngleCardioid()
 }
 
 ///----------------------------------------------------------------------------------
-void SailSpeedRegulatorNode::SailSpeedRegulatorNodeThreadFunc(ActiveNode* nodePtr)
+void SailSpeedRegulatorNode::tick()
 {
-    SailSpeedRegulatorNode* node = dynamic_cast<SailSpeedRegulatorNode*> (nodePtr);
-
-    // An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
-    // at the start before we send out the state message.
-    std::this_thread::sleep_for(std::chrono::milliseconds(INITIAL_SLEEP));
-
-    Timer timer;
-    timer.start();
-
-    while(node->m_Running.load() == true)
+    //float sailAngle = calculateSailAngleLinear();
+    float sailAngle = calculateSailAngleCardioid();
+    if(sailAngle != NO_COMMAND)
     {
-        //float sailAngle = node->calculateSailAngleLinear();
-        float sailAngle = node->calculateSailAngleCardioid();
-        if(sailAngle != NO_COMMAND)
-        {
-            MessagePtr sailCommandMsg = std::make_unique<SailCommandMsg>(sailAngle);
-            node->m_MsgBus.sendMessage(std::move(sailCommandMsg));
-        }
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
+        MessagePtr sailCommandMsg = std::make_unique<SailCommandMsg>(sailAngle);
+        m_MsgBus.sendMessage(std::move(sailCommandMsg));
     }
 }
\ No newline at end of file
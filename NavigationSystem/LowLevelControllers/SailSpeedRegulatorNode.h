@@ -77,9 +77,10 @@ private:
     float calculateSailAngleCardioid();
 
     ///----------------------------------------------------------------------------------
-    /// Starts the SailSpeedRegulatorNode's thread that pumps out SailCommandMsg.
+    /// Pumps out a SailCommandMsg, called every loop time by the message bus's tick
+    /// scheduler.
     ///----------------------------------------------------------------------------------
-    static void SailSpeedRegulatorNodeThreadFunc(ActiveNode* nodePtr);
+    void tick();
 
     DBHandler &m_db;
     std::mutex m_lock;
@@ -17,10 +17,12 @@
  ***************************************************************************************/
 
 #include "WingsailControlNode.h"
+#include "SystemServices/SysClock.h"
 
 #define DATA_OUT_OF_RANGE -2000
 const int INITIAL_SLEEP = 2000; // milliseconds
 const float NO_COMMAND = -1000;
+const size_t RESERVED_COMMANDS = 128; // messages allocated before the loop starts
 
 const double LIFTS[53] = {15.964797400676879, 15.350766731420075, 14.736736062163272, 14.122705392906468, 13.508674723649664, 12.894644054392863, 12.280613385136059, 11.666582715879256, 11.052552046622454, 10.438521377365651, 9.8244907081088488, 9.2104600388520446, 8.5964293695952421, 7.9823987003384396, 7.3683680310816362, 6.7543373618248319, 6.1403066925680294, 5.5262760233112269, 4.9122453540544244, 4.298214684797621, 3.6841840155408181, 3.0701533462840147, 2.4561226770272122, 1.842092007770409, 1.2280613385136061, 0.61403066925680305, 0.0, -0.61403066925680305, -1.2280613385136061, -1.842092007770409, -2.4561226770272122, -3.0701533462840147, -3.6841840155408181, -4.298214684797621, -4.9122453540544244, -5.5262760233112269, -6.1403066925680294, -6.7543373618248319, -7.3683680310816362, -7.9823987003384396, -8.5964293695952421, -9.2104600388520446, -9.8244907081088488, -10.438521377365651, -11.052552046622454, -11.666582715879256, -12.280613385136059, -12.894644054392863, -13.508674723649664, -14.122705392906468, -14.736736062163272, -15.350766731420075, -15.964797400676879};
 const double  DRAGS[53] = {-3.6222976277233707, -3.3490177771111052, -3.0864547833855935, -2.8346086465468385, -2.5934793665948392, -2.3630669435295952, -2.1433713773511069, -1.9343926680593737, -1.7361308156543964, -1.5485858201361751, -1.3717576815047086, -1.2056463997599975, -1.0502519749020425, -0.90557440693084268, -0.77161369584639838, -0.64836984164870981, -0.53584284433777674, -0.4340327039135991, -0.34293942037617714, -0.26256299372551062, -0.1929034239615996, -0.13396071108444418, -0.085734855094044285, -0.048225855990399899, -0.021433713773511071, -0.0053584284433777678, -0.0, -0.0053584284433777678, -0.021433713773511071, -0.048225855990399899, -0.085734855094044285, -0.13396071108444418, -0.1929034239615996, -0.26256299372551062, -0.34293942037617714, -0.4340327039135991, -0.53584284433777674, -0.64836984164870981, -0.77161369584639838, -0.90557440693084268, -1.0502519749020425, -1.2056463997599975, -1.3717576815047086, -1.5485858201361751, -1.7361308156543964, -1.9343926680593737, -2.1433713773511069, -2.3630669435295952, -2.5934793665948392, -2.8346086465468385, -3.0864547833855935, -3.3490177771111052, -3.6222976277233707};
@@ -38,7 +40,10 @@ WingsailControlNode::WingsailControlNode(MessageBus& msgBus, DBHandler& dbhandle
 }
 
 ///----------------------------------------------------------------------------------
-WingsailControlNode::~WingsailControlNode(){}
+WingsailControlNode::~WingsailControlNode()
+{
+    m_MsgBus.removeControlLoop(m_LoopTimer);
+}
 
 ///----------------------------------------------------------------------------------
 bool WingsailControlNode::init(){
@@ -49,6 +54,8 @@ bool WingsailControlNode::init(){
 ///----------------------------------------------------------------------------------
 void WingsailControlNode::start()
 {
+    MessageBus::reserve<WingSailCommandMsg>(RESERVED_COMMANDS);
+    m_MsgBus.addControlLoop(nodeID(), m_LoopTimer);
     runThread(WingsailControlNodeThreadFunc);
 }
 
@@ -75,6 +82,7 @@ void WingsailControlNode::processMessage( const Message* msg)
 void WingsailControlNode::updateConfigsFromDB()
 {
     m_LoopTime = m_db.retrieveCellAsDouble("config_wingsail_control","1","loop_time");
+    m_LoopTimer.setPeriod(m_LoopTime);
     m_MaxCommandAngle = m_db.retrieveCellAsDouble("config_wingsail_control","1","max_cmd_angle");
 }
 
@@ -93,6 +101,7 @@ void WingsailControlNode::processLocalNavigationMessage(const LocalNavigationMsg
 
     m_TargetCourse = msg->targetCourse();
     m_TargetTackStarboard = msg->targetTackStarboard();
+    m_TargetCause = msg->asCause();
 }
 
 ///----------------------------------------------------------------------------------
@@ -141,9 +150,10 @@ float WingsailControlNode::calculateTailAngle()
 }
 
 ///----------------------------------------------------------------------------------
-float WingsailControlNode::simpleCalculateTailAngle()
+float WingsailControlNode::simpleCalculateTailAngle(MessageCause& cause)
 {
     std::lock_guard<std::mutex> lock_guard(m_lock);
+    cause = m_TargetCause;
 
     if(m_TargetCourse != DATA_OUT_OF_RANGE && m_TargetCourse != NO_COMMAND)
     {
@@ -169,21 +179,21 @@ void WingsailControlNode::WingsailControlNodeThreadFunc(ActiveNode* nodePtr)
 
     // An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
     // at the start before we send out the state message.
-    std::this_thread::sleep_for(std::chrono::milliseconds(INITIAL_SLEEP));
+    SysClock::sleepFor(std::chrono::milliseconds(INITIAL_SLEEP));
 
-    Timer timer;
-    timer.start();
+    node->m_LoopTimer.start(node->m_LoopTime);
 
     while(true)
     {
         //float wingSailCommand = (float)node->calculateTailAngle();
-        float wingSailCommand = (float)node->simpleCalculateTailAngle();
+        MessageCause cause;
+        float wingSailCommand = (float)node->simpleCalculateTailAngle(cause);
         if (wingSailCommand != NO_COMMAND)
         {
-            MessagePtr wingSailCommandMsg = std::make_unique<WingSailCommandMsg>(wingSailCommand);
+            MessagePtr wingSailCommandMsg = MessageBus::make<WingSailCommandMsg>(wingSailCommand);
+            wingSailCommandMsg->setCause(cause);
             node->m_MsgBus.sendMessage(std::move(wingSailCommandMsg));
         }
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
+        node->m_LoopTimer.sleepUntilNextDeadline();
     }
 }
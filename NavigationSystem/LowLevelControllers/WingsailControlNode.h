@@ -32,7 +32,7 @@
 #include "Messages/StateMessage.h"
 #include "Messages/LocalNavigationMsg.h"
 #include "Messages/WingSailCommandMsg.h"
-#include "SystemServices/Timer.h"
+#include "SystemServices/DeadlineTimer.h"
 
 
 class WingsailControlNode : public ActiveNode {
@@ -76,8 +76,9 @@ private:
 
     ///----------------------------------------------------------------------------------
     /// Sets the tail command angle to +/- m_MaxCommandAngle in function of the desired tack of the vessel.
+    /// cause is set to the cause of the target it was calculated from.
     ///----------------------------------------------------------------------------------
-    float simpleCalculateTailAngle();
+    float simpleCalculateTailAngle(MessageCause& cause);
 
     ///----------------------------------------------------------------------------------
     /// Starts the WingsailControlNode's thread that pumps out WingSailCommandMsg.
@@ -89,10 +90,12 @@ private:
     std::mutex m_lock;
 
     double  m_LoopTime;             // seconds
+    DeadlineTimer m_LoopTimer;
     double  m_MaxCommandAngle;      // degrees
 
     double  m_ApparentWindDir;      // degrees [0, 360[ in North-East reference frame (clockwise)
     float   m_TargetCourse;         // degree [0, 360[ in North-East reference frame (clockwise)
     bool    m_TargetTackStarboard;  // True if the desired tack of the vessel is starboard.
+    MessageCause m_TargetCause;     // Of the LocalNavigationMsg the target came from
 
 };
@@ -12,14 +12,73 @@
  ***************************************************************************************/
 
 #include "MessageBus/ActiveNode.h"
+#include "SystemServices/SysClock.h"
 
 #include <iostream>
-void ActiveNode::runThread(void(*func)(ActiveNode*))
+
+
+ActiveNode::~ActiveNode()
+{
+	stopPeriodic();
+}
+
+void ActiveNode::runThread(void(*func)(ActiveNode*), bool followsClock)
+{
+	RealTimeProfile profile = m_RealTimeProfile;
+
+	if(not followsClock)
+	{
+		m_Thread = new std::thread([func, profile](ActiveNode* node) {
+			applyRealTimeProfile(node, profile);
+			func(node);
+		}, this);
+		return;
+	}
+
+	// Attached before the thread starts so a simulated time can't run ahead of it
+	TimeSource* clock = &SysClock::timeSource();
+	clock->attachThread();
+
+	m_Thread = new std::thread([func, clock, profile](ActiveNode* node) {
+		clock->enterThread();
+		applyRealTimeProfile(node, profile);
+		func(node);
+		clock->leaveThread();
+	}, this);
+}
+
+void ActiveNode::applyRealTimeProfile(ActiveNode* node, const RealTimeProfile& profile)
 {
-	m_Thread = new std::thread(func, this);
+	if(profile.enabled())
+	{
+		RealTime::applyToThisThread(profile, nodeToString(node->nodeID()));
+	}
 }
 
 void ActiveNode::stopThread(ActiveNode* node)
 {
     node->m_Thread->join();
 }
+
+void ActiveNode::runPeriodic(double periodSeconds, unsigned int initialDelayMs)
+{
+	m_TickId = m_MsgBus.tickScheduler().schedule(nodeID(), [this]() { tick(); },
+		periodSeconds * 1000000, (uint64_t)initialDelayMs * 1000);
+}
+
+void ActiveNode::setTickPeriod(double periodSeconds)
+{
+	if(m_TickId >= 0)
+	{
+		m_MsgBus.tickScheduler().setPeriod(m_TickId, periodSeconds * 1000000);
+	}
+}
+
+void ActiveNode::stopPeriodic()
+{
+	if(m_TickId >= 0)
+	{
+		m_MsgBus.tickScheduler().cancel(m_TickId);
+		m_TickId = -1;
+	}
+}
@@ -7,7 +7,12 @@
  *		A active node is a base(passive) node that has a thread.
  *
  * Developer Notes:
+ *		A node that only does the same work at a fixed rate can use runPeriodic()
+ *		instead of a thread of its own, its tick() is then called by the message bus's
+ *		TickScheduler.
  *
+ *		A node with a thread of its own can be given a real-time profile before it is
+ *		started, its thread then runs under SCHED_FIFO, see RealTime.h.
  *
  ***************************************************************************************/
 
@@ -15,21 +20,67 @@
 
 
 #include "Node.h"
+#include "SystemServices/RealTime.h"
 #include <thread>
 
 class ActiveNode : public Node {
 public:
-	ActiveNode(NodeID id, MessageBus& msgBus) : Node(id, msgBus)
+	ActiveNode(NodeID id, MessageBus& msgBus) : Node(id, msgBus), m_Thread(NULL), m_TickId(-1)
 	{ }
 
+	///----------------------------------------------------------------------------------
+ 	/// Stops the node's ticks if it uses runPeriodic().
+ 	///----------------------------------------------------------------------------------
+	virtual ~ActiveNode();
+
 	///----------------------------------------------------------------------------------
  	/// This function should be used to start the active nodes thread.
  	///
  	///----------------------------------------------------------------------------------
 	virtual void start() = 0;
+
+	///----------------------------------------------------------------------------------
+ 	/// Sets the scheduling of the thread started with runThread(), has to be called
+ 	/// before start().
+ 	///----------------------------------------------------------------------------------
+	void setRealTimeProfile(const RealTimeProfile& profile) { m_RealTimeProfile = profile; }
 protected:
-	void runThread(void(*func)(ActiveNode*));
+	///----------------------------------------------------------------------------------
+ 	/// Starts the node's thread. The thread loops on the SysClock time source unless
+ 	/// followsClock is false, which is for a thread paced by something else, like a
+ 	/// socket, so it doesn't hold back a simulated time.
+ 	///----------------------------------------------------------------------------------
+	void runThread(void(*func)(ActiveNode*), bool followsClock = true);
 	void stopThread(ActiveNode* node);
+
+	///----------------------------------------------------------------------------------
+ 	/// Calls tick() every period on the message bus's TickScheduler instead of running
+ 	/// a thread. The deadlines are absolute so a slow tick doesn't shift later ones.
+ 	///
+ 	/// @param periodSeconds 	Time between two ticks.
+ 	/// @param initialDelayMs 	Time until the first tick.
+ 	///----------------------------------------------------------------------------------
+	void runPeriodic(double periodSeconds, unsigned int initialDelayMs);
+
+	///----------------------------------------------------------------------------------
+ 	/// Changes the period of a node started with runPeriodic(), does nothing otherwise.
+ 	///----------------------------------------------------------------------------------
+	void setTickPeriod(double periodSeconds);
+
+	///----------------------------------------------------------------------------------
+ 	/// Stops the ticks, waits for a running tick to finish. Must not be called from
+ 	/// tick().
+ 	///----------------------------------------------------------------------------------
+	void stopPeriodic();
+
+	///----------------------------------------------------------------------------------
+ 	/// The periodic work of a node started with runPeriodic().
+ 	///----------------------------------------------------------------------------------
+	virtual void tick() { }
 private:
+	static void applyRealTimeProfile(ActiveNode* node, const RealTimeProfile& profile);
+
 	std::thread* m_Thread;
+	int m_TickId;
+	RealTimeProfile m_RealTimeProfile;
 };
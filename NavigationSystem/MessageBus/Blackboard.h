@@ -0,0 +1,166 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		Blackboard.h
+ *
+ * Purpose:
+ *		Holds the latest value of the world state messages, keyed by message type. The
+ *		message bus writes to it when one of these messages is sent, a periodic node
+ *		can then read the newest vessel or wind state whenever its loop runs instead of
+ *		subscribing and keeping its own copy under a mutex.
+ *
+ * Developer Notes:
+ *		Every entry is a seqlock. A writer makes the entry's sequence number odd, copies
+ *		the value in and makes it even again. A reader copies the value out and tries
+ *		again if the sequence number was odd or changed meanwhile, so readers never
+ *		block writers or each other and always get a value from a single write.
+ *
+ *		The values are copied word by word through relaxed atomics, they have to be
+ *		trivially copyable and at most MAX_VALUE_SIZE bytes. A reader has to use the
+ *		same value type as the writer of that message type, see MessageBus::share().
+ *
+ *		The cause of the message a value came from is kept with it, a node that makes a
+ *		message from the value passes it on, see MessageCause.h.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/MessageCause.h"
+#include "MessageBus/MessageTypes.h"
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <type_traits>
+
+
+class Blackboard {
+public:
+	static const size_t MAX_VALUE_SIZE = 64;
+
+	Blackboard()
+	{
+		for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+		{
+			m_Entries[type].sequence.store(0, std::memory_order_relaxed);
+			for(size_t i = 0; i < ENTRY_WORDS; i++)
+			{
+				m_Entries[type].words[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Replaces the value of a message type, can be called from any thread.
+ 	///----------------------------------------------------------------------------------
+	template<class T>
+	void write(MessageType msgType, const T& value, const MessageCause& cause = MessageCause())
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Blackboard values are copied as raw memory");
+		static_assert(sizeof(T) <= MAX_VALUE_SIZE, "Blackboard values are at most MAX_VALUE_SIZE bytes");
+
+		uint64_t words[ENTRY_WORDS] = { 0 };
+		memcpy(words, &value, sizeof(T));
+		memcpy(words + VALUE_WORDS, &cause, sizeof(cause));
+
+		Entry& entry = m_Entries[static_cast<int>(msgType)];
+
+		// Two writers of the same type take turns
+		uint64_t sequence = entry.sequence.load(std::memory_order_relaxed);
+		while((sequence & 1) != 0 ||
+			not entry.sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire))
+		{
+			if((sequence & 1) != 0)
+			{
+				std::this_thread::yield();
+				sequence = entry.sequence.load(std::memory_order_relaxed);
+			}
+		}
+
+		// Keeps the odd sequence number ahead of the new value
+		std::atomic_thread_fence(std::memory_order_release);
+		for(size_t i = 0; i < ENTRY_WORDS; i++)
+		{
+			entry.words[i].store(words[i], std::memory_order_relaxed);
+		}
+		entry.sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Copies out the latest value of a message type. Returns false if nothing has been
+ 	/// written for that type yet.
+ 	///----------------------------------------------------------------------------------
+	template<class T>
+	bool read(MessageType msgType, T& value) const
+	{
+		MessageCause cause;
+		return read(msgType, value, cause);
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Copies out the latest value of a message type and the cause of the message it
+ 	/// came from.
+ 	///----------------------------------------------------------------------------------
+	template<class T>
+	bool read(MessageType msgType, T& value, MessageCause& cause) const
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Blackboard values are copied as raw memory");
+		static_assert(sizeof(T) <= MAX_VALUE_SIZE, "Blackboard values are at most MAX_VALUE_SIZE bytes");
+
+		const Entry& entry = m_Entries[static_cast<int>(msgType)];
+		uint64_t words[ENTRY_WORDS];
+		uint64_t sequence;
+
+		while(true)
+		{
+			sequence = entry.sequence.load(std::memory_order_acquire);
+			if(sequence == 0)
+			{
+				return false;
+			}
+			if((sequence & 1) != 0)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			for(size_t i = 0; i < ENTRY_WORDS; i++)
+			{
+				words[i] = entry.words[i].load(std::memory_order_relaxed);
+			}
+
+			// Keeps the copy ahead of the second look at the sequence number
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(entry.sequence.load(std::memory_order_relaxed) == sequence)
+			{
+				break;
+			}
+		}
+
+		memcpy(&value, words, sizeof(T));
+		memcpy(static_cast<void*>(&cause), words + VALUE_WORDS, sizeof(cause));
+		return true;
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Number of times a message type has been written, lets a reader tell whether the
+ 	/// value changed since it last looked.
+ 	///----------------------------------------------------------------------------------
+	uint64_t version(MessageType msgType) const
+	{
+		return m_Entries[static_cast<int>(msgType)].sequence.load(std::memory_order_acquire) / 2;
+	}
+
+private:
+	static const size_t VALUE_WORDS = MAX_VALUE_SIZE / sizeof(uint64_t);
+	static const size_t ENTRY_WORDS = VALUE_WORDS + (sizeof(MessageCause) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	// Cache line aligned so writers of different types don't get in each other's way
+	struct alignas(64) Entry {
+		std::atomic<uint64_t> 	sequence;			// Odd while being written
+		std::atomic<uint64_t> 	words[ENTRY_WORDS];		// The value, then its cause
+	};
+
+	Entry m_Entries[MESSAGE_TYPE_COUNT];
+};
@@ -0,0 +1,331 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		BridgeNode.cpp
+ *
+ * Purpose:
+ *		Connects the message bus of this process to the message bus of another process.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/BridgeNode.h"
+#include "MessageBus/MessageFactory.h"
+#include "MessageBus/MessageSerialiser.h"
+#include "MessageBus/MessageView.h"
+#include "SystemServices/Logger.h"
+#include <chrono>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+extern char** environ;
+
+
+// How long the thread sleeps when the incoming ring is empty
+#define POLL_INTERVAL_US 		1000
+// How long a child waits for the parent to create the rings
+#define CONNECT_TIMEOUT_MS 		5000
+#define STATISTICS_INTERVAL_S 	60
+// Keeps a child that exits straight away from being restarted in a tight loop
+#define RESTART_DELAY_MS 		1000
+
+
+BridgeNode::BridgeNode(MessageBus& msgBus, const std::string& name, Side side,
+	const std::vector<MessageType>& mirrored)
+	:ActiveNode(NodeID::MessageBridge, msgBus), m_Name(name), m_Side(side), m_Mirrored(mirrored),
+	m_ChildPID(-1), m_ParentPID(getppid()), m_RestartTime(0), m_Running(false), m_Started(false), m_Sent(0),
+	m_SentBytes(0), m_Received(0), m_ReceivedBytes(0), m_Rejected(0), m_ChildRestarts(0),
+	m_LastLogTime(0), m_LastLogSent(0), m_LastLogReceived(0)
+{ }
+
+BridgeNode::~BridgeNode()
+{
+	stop();
+}
+
+bool BridgeNode::init()
+{
+	std::string down = "/" + m_Name + ".down";
+	std::string up = "/" + m_Name + ".up";
+
+	if(m_Side == Side::Parent)
+	{
+		if(not m_Outgoing.create(down, RING_CAPACITY) || not m_Incoming.create(up, RING_CAPACITY))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		uint64_t giveUp = monotonicMicros() + (uint64_t)CONNECT_TIMEOUT_MS * 1000;
+		while(not m_Incoming.open(down) || not m_Outgoing.open(up))
+		{
+			if(monotonicMicros() > giveUp)
+			{
+				Logger::error("%s: Bridge %s not found", __PRETTY_FUNCTION__, m_Name.c_str());
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(POLL_INTERVAL_US));
+		}
+	}
+
+	for(MessageType type : m_Mirrored)
+	{
+		m_MsgBus.registerNode(*this, type);
+	}
+
+	Logger::info("Bridge %s connected as %s, mirroring %u message types", m_Name.c_str(),
+		(m_Side == Side::Parent ? "parent" : "child"), (unsigned int)m_Mirrored.size());
+	return true;
+}
+
+void BridgeNode::setChildProcess(const std::string& path, const std::vector<std::string>& args)
+{
+	m_ChildPath = path;
+	m_ChildArgs = args;
+}
+
+void BridgeNode::start()
+{
+	if(m_Started)
+	{
+		return;
+	}
+
+	m_Running.store(true);
+	m_Started = true;
+	m_LastLogTime = monotonicMicros();
+
+	if(m_Side == Side::Parent && not m_ChildPath.empty())
+	{
+		startChild();
+	}
+
+	// Paced by the ring, not by the message bus's clock
+	runThread(BridgeThreadFunc, false);
+}
+
+void BridgeNode::stop()
+{
+	if(not m_Started)
+	{
+		return;
+	}
+
+	m_Running.store(false);
+	stopThread(this);
+	m_Started = false;
+
+	stopChild();
+	logStatistics();
+}
+
+void BridgeNode::processMessage(const Message* message)
+{
+	if(not m_Outgoing.isOpen())
+	{
+		return;
+	}
+
+	MessageSerialiser serialiser;
+	message->Serialise(serialiser);
+
+	if(m_Outgoing.write(serialiser.data(), serialiser.size(), monotonicMicros()))
+	{
+		m_Sent.fetch_add(1, std::memory_order_relaxed);
+		m_SentBytes.fetch_add(serialiser.size(), std::memory_order_relaxed);
+	}
+}
+
+unsigned int BridgeNode::pollIncoming()
+{
+	uint8_t buffer[MAX_MESSAGE_SIZE];
+	uint32_t size;
+	uint64_t time;
+	unsigned int count = 0;
+
+	while(m_Incoming.read(buffer, sizeof(buffer), size, time))
+	{
+		count++;
+
+		// The header is enough to drop a message that only echoes one sent from here,
+		// it isn't deserialised then
+		MessagePtr msg;
+		if(size <= sizeof(buffer))
+		{
+			MessageView header(buffer, size);
+			if(header.isValid() && not isMirrored(header.messageType()))
+			{
+				msg = MessageFactory::deserialise(buffer, size);
+			}
+		}
+
+		if(not msg)
+		{
+			m_Rejected.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		uint64_t now = monotonicMicros();
+		m_Latency.record(now > time ? now - time : 0);
+		m_Received.fetch_add(1, std::memory_order_relaxed);
+		m_ReceivedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		m_MsgBus.sendMessage(std::move(msg));
+	}
+
+	return count;
+}
+
+bool BridgeNode::isMirrored(MessageType type) const
+{
+	for(MessageType mirrored : m_Mirrored)
+	{
+		if(mirrored == type)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+BridgeNode::BridgeStats BridgeNode::statistics() const
+{
+	BridgeStats stats;
+	stats.sent = m_Sent.load(std::memory_order_relaxed);
+	stats.sentBytes = m_SentBytes.load(std::memory_order_relaxed);
+	stats.dropped = m_Outgoing.isOpen() ? m_Outgoing.dropped() : 0;
+	stats.received = m_Received.load(std::memory_order_relaxed);
+	stats.receivedBytes = m_ReceivedBytes.load(std::memory_order_relaxed);
+	stats.rejected = m_Rejected.load(std::memory_order_relaxed);
+	stats.latencyP50Us = m_Latency.percentile(50);
+	stats.latencyP99Us = m_Latency.percentile(99);
+	stats.latencyMaxUs = m_Latency.max();
+	stats.childRestarts = m_ChildRestarts.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void BridgeNode::logStatistics()
+{
+	BridgeStats stats = statistics();
+
+	uint64_t now = monotonicMicros();
+	double seconds = (now - m_LastLogTime) / 1000000.0;
+	if(seconds <= 0)
+	{
+		seconds = 1;
+	}
+
+	Logger::info("Bridge %s: sent %llu (%.1f/s, %llu bytes) dropped %llu, received %llu (%.1f/s, "
+		"%llu bytes) rejected %llu, latency p50=%lluus p99=%lluus max=%lluus, child restarts %u",
+		m_Name.c_str(), (unsigned long long)stats.sent, (stats.sent - m_LastLogSent) / seconds,
+		(unsigned long long)stats.sentBytes, (unsigned long long)stats.dropped,
+		(unsigned long long)stats.received, (stats.received - m_LastLogReceived) / seconds,
+		(unsigned long long)stats.receivedBytes, (unsigned long long)stats.rejected,
+		(unsigned long long)stats.latencyP50Us, (unsigned long long)stats.latencyP99Us,
+		(unsigned long long)stats.latencyMaxUs, stats.childRestarts);
+
+	m_LastLogTime = now;
+	m_LastLogSent = stats.sent;
+	m_LastLogReceived = stats.received;
+}
+
+void BridgeNode::startChild()
+{
+	std::vector<char*> argv;
+	argv.push_back(const_cast<char*>(m_ChildPath.c_str()));
+	for(std::string& arg : m_ChildArgs)
+	{
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	}
+	argv.push_back(NULL);
+
+	m_RestartTime = monotonicMicros() + (uint64_t)RESTART_DELAY_MS * 1000;
+
+	int error = posix_spawn(&m_ChildPID, m_ChildPath.c_str(), NULL, NULL, argv.data(), environ);
+	if(error != 0)
+	{
+		Logger::error("%s: Could not start %s: %s", __PRETTY_FUNCTION__, m_ChildPath.c_str(),
+			strerror(error));
+		m_ChildPID = -1;
+		return;
+	}
+
+	Logger::info("Bridge %s started %s, pid %d", m_Name.c_str(), m_ChildPath.c_str(), (int)m_ChildPID);
+}
+
+void BridgeNode::checkChild()
+{
+	if(m_ChildPath.empty())
+	{
+		return;
+	}
+
+	int status;
+	if(m_ChildPID > 0 && waitpid(m_ChildPID, &status, WNOHANG) == m_ChildPID)
+	{
+		Logger::warning("Bridge %s: %s exited with status %d, restarting it", m_Name.c_str(),
+			m_ChildPath.c_str(), status);
+		m_ChildPID = -1;
+	}
+
+	if(m_ChildPID <= 0 && monotonicMicros() >= m_RestartTime)
+	{
+		m_ChildRestarts.fetch_add(1, std::memory_order_relaxed);
+		startChild();
+	}
+}
+
+void BridgeNode::stopChild()
+{
+	if(m_ChildPID <= 0)
+	{
+		return;
+	}
+
+	kill(m_ChildPID, SIGTERM);
+	waitpid(m_ChildPID, NULL, 0);
+	m_ChildPID = -1;
+}
+
+uint64_t BridgeNode::monotonicMicros()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+void BridgeNode::BridgeThreadFunc(ActiveNode* nodePtr)
+{
+	BridgeNode* node = dynamic_cast<BridgeNode*> (nodePtr);
+
+	while(node->m_Running.load())
+	{
+		if(node->pollIncoming() == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(POLL_INTERVAL_US));
+		}
+
+		if(node->m_Side == Side::Parent)
+		{
+			node->checkChild();
+		}
+		else if(getppid() != node->m_ParentPID)
+		{
+			Logger::warning("Bridge %s: Parent process has gone, stopping", node->m_Name.c_str());
+			node->m_Running.store(false);
+		}
+
+		if(monotonicMicros() - node->m_LastLogTime > (uint64_t)STATISTICS_INTERVAL_S * 1000000)
+		{
+			node->logStatistics();
+		}
+	}
+}
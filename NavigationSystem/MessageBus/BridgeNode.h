@@ -0,0 +1,163 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		BridgeNode.h
+ *
+ * Purpose:
+ *		Connects the message bus of this process to the message bus of another process,
+ *		so a heavy node, like the DBLoggerNode, can run in a process of its own without
+ *		holding up the control loops.
+ *
+ * Developer Notes:
+ *		The two processes each have a BridgeNode, the parent's creates two shared memory
+ *		rings, see SharedMemoryRing.h, one for each direction:
+ *
+ *			/<name>.down 	Parent to child
+ *			/<name>.up 		Child to parent
+ *
+ *		A bridge subscribes to the message types it is given and writes every message of
+ *		those types it gets to its outgoing ring, as written by Message::Serialise(). Its
+ *		thread polls the incoming ring and sends the messages it finds on its own message
+ *		bus, with their original source and destination. A message of a type the bridge
+ *		mirrors itself is not sent on, so a type mirrored by both sides doesn't go round.
+ *
+ *		When the outgoing ring is full the message is dropped, the bus thread never waits
+ *		for the other process.
+ *
+ *		The parent can start the child program itself, it is started again if it exits.
+ *		A child bridge stops when its parent process is gone.
+ *
+ *		The latency is taken from the monotonic clock, which both processes share, even
+ *		when the message bus runs on a simulated time.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/ActiveNode.h"
+#include "MessageBus/MessageTypes.h"
+#include "MessageBus/SharedMemoryRing.h"
+#include "SystemServices/LatencyHistogram.h"
+#include <atomic>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+
+class BridgeNode : public ActiveNode {
+public:
+	enum class Side {
+		Parent,		// Creates the rings
+		Child		// Opens the rings the parent created
+	};
+
+	struct BridgeStats {
+		uint64_t sent;				// Messages written to the outgoing ring
+		uint64_t sentBytes;
+		uint64_t dropped;			// Outgoing messages dropped because the ring was full
+		uint64_t received;			// Messages read from the incoming ring and sent on
+		uint64_t receivedBytes;
+		uint64_t rejected;			// Incoming messages that were invalid or mirrored
+		uint64_t latencyP50Us;		// From writing a message to sending it on
+		uint64_t latencyP99Us;
+		uint64_t latencyMaxUs;
+		uint32_t childRestarts;
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// @param msgBus 			The message bus of this process.
+ 	/// @param name 			Name of the bridge, both processes have to use the same.
+ 	/// @param side 			Which end of the bridge this is.
+ 	/// @param mirrored 		The message types sent to the other process.
+ 	///----------------------------------------------------------------------------------
+	BridgeNode(MessageBus& msgBus, const std::string& name, Side side,
+		const std::vector<MessageType>& mirrored);
+
+	///----------------------------------------------------------------------------------
+ 	/// Stops the bridge, see stop().
+ 	///----------------------------------------------------------------------------------
+	~BridgeNode();
+
+	///----------------------------------------------------------------------------------
+ 	/// Creates or opens the rings and subscribes to the mirrored types. A child waits
+ 	/// a few seconds for its parent to create the rings.
+ 	///----------------------------------------------------------------------------------
+	bool init();
+
+	void start();
+
+	///----------------------------------------------------------------------------------
+ 	/// Stops the thread and, on the parent, terminates the child program.
+ 	///----------------------------------------------------------------------------------
+	void stop();
+
+	///----------------------------------------------------------------------------------
+ 	/// Has the parent start a child program when the bridge starts, has to be called
+ 	/// before start().
+ 	///
+ 	/// @param path 			The program to run.
+ 	/// @param args 			Its arguments, without the program name.
+ 	///----------------------------------------------------------------------------------
+	void setChildProcess(const std::string& path, const std::vector<std::string>& args);
+
+	///----------------------------------------------------------------------------------
+ 	/// False once the bridge has stopped, on a child also when the parent has gone.
+ 	///----------------------------------------------------------------------------------
+	bool isRunning() const { return m_Running.load(); }
+
+	void processMessage(const Message* message);
+
+	BridgeStats statistics() const;
+
+	static const uint32_t RING_CAPACITY = 256 * 1024;
+
+private:
+	///----------------------------------------------------------------------------------
+ 	/// Reads the incoming ring until it is empty, returns the number of messages read.
+ 	///----------------------------------------------------------------------------------
+	unsigned int pollIncoming();
+
+	bool isMirrored(MessageType type) const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Logs the throughput since the last call and the statistics, called by the
+ 	/// bridge's thread every minute.
+ 	///----------------------------------------------------------------------------------
+	void logStatistics();
+
+	void startChild();
+	void checkChild();
+	void stopChild();
+
+	static void BridgeThreadFunc(ActiveNode* nodePtr);
+
+	static uint64_t monotonicMicros();
+
+	std::string 			m_Name;
+	Side 					m_Side;
+	std::vector<MessageType> m_Mirrored;
+
+	SharedMemoryRing 		m_Outgoing;
+	SharedMemoryRing 		m_Incoming;
+
+	std::string 			m_ChildPath;
+	std::vector<std::string> m_ChildArgs;
+	pid_t 					m_ChildPID;
+	pid_t 					m_ParentPID;
+	uint64_t 				m_RestartTime;		// Earliest time the child may be started again
+
+	std::atomic<bool> 		m_Running;
+	bool 					m_Started;
+
+	std::atomic<uint64_t> 	m_Sent;
+	std::atomic<uint64_t> 	m_SentBytes;
+	std::atomic<uint64_t> 	m_Received;
+	std::atomic<uint64_t> 	m_ReceivedBytes;
+	std::atomic<uint64_t> 	m_Rejected;
+	std::atomic<uint32_t> 	m_ChildRestarts;
+	LatencyHistogram 		m_Latency;
+
+	uint64_t 				m_LastLogTime;
+	uint64_t 				m_LastLogSent;
+	uint64_t 				m_LastLogReceived;
+};
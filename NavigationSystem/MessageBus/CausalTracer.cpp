@@ -0,0 +1,116 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		CausalTracer.cpp
+ *
+ * Purpose:
+ *		Measures how old the sensor data is by the time it reaches an actuator.
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/CausalTracer.h"
+#include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
+
+
+CausalTracer::CausalTracer()
+	:m_Untraced(0)
+{ }
+
+void CausalTracer::record(const Message& command, NodeID actuator)
+{
+	uint64_t now = SysClock::monotonicMicros();
+	uint64_t origin = command.originTime();
+	MessageCause chain = command.asCause();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	Path* path = NULL;
+	for(Path& known : m_Paths)
+	{
+		if(known.matches(chain, actuator))
+		{
+			path = &known;
+			break;
+		}
+	}
+
+	if(path == NULL)
+	{
+		if(m_Paths.size() >= MAX_PATHS)
+		{
+			m_Untraced.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		m_Paths.emplace_back(chain, actuator);
+		path = &m_Paths.back();
+	}
+
+	path->latency.record(now > origin ? now - origin : 0);
+}
+
+std::vector<CausalTracer::PathStats> CausalTracer::statistics() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::vector<PathStats> stats;
+	for(const Path& path : m_Paths)
+	{
+		PathStats pathStats;
+		pathStats.path = path.toString();
+		pathStats.count = path.latency.count();
+		pathStats.latencyP50Us = path.latency.percentile(50);
+		pathStats.latencyP90Us = path.latency.percentile(90);
+		pathStats.latencyP99Us = path.latency.percentile(99);
+		pathStats.latencyMaxUs = path.latency.max();
+		stats.push_back(pathStats);
+	}
+	return stats;
+}
+
+void CausalTracer::logStatistics() const
+{
+	for(const PathStats& path : statistics())
+	{
+		Logger::info("Sensor to actuator %s: count=%llu p50=%lluus p90=%lluus p99=%lluus max=%lluus",
+			path.path.c_str(), (unsigned long long)path.count, (unsigned long long)path.latencyP50Us,
+			(unsigned long long)path.latencyP90Us, (unsigned long long)path.latencyP99Us,
+			(unsigned long long)path.latencyMaxUs);
+	}
+
+	if(untraced() > 0)
+	{
+		Logger::warning("Sensor to actuator: %llu commands on untraced paths", (unsigned long long)untraced());
+	}
+}
+
+bool CausalTracer::Path::matches(const MessageCause& other, NodeID actuatorID) const
+{
+	if(actuator != actuatorID || cause.chainLength != other.chainLength)
+	{
+		return false;
+	}
+
+	for(int i = 0; i < cause.chainLength && i < MessageCause::MAX_CHAIN; i++)
+	{
+		if(cause.chain[i] != other.chain[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string CausalTracer::Path::toString() const
+{
+	std::string text;
+	for(int i = 0; i < cause.chainLength && i < MessageCause::MAX_CHAIN; i++)
+	{
+		text += msgToString(static_cast<MessageType>(cause.chain[i])) + " > ";
+	}
+	if(cause.chainLength > MessageCause::MAX_CHAIN)
+	{
+		text += "... > ";
+	}
+	return text + nodeToString(actuator);
+}
@@ -0,0 +1,92 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		CausalTracer.h
+ *
+ * Purpose:
+ *		Measures how old the sensor data is by the time it reaches an actuator. An
+ *		actuator node records every command it puts out on its link, the latency from
+ *		the origin time of the command's cause chain until then goes into a histogram
+ *		for that path, for example
+ *
+ *			CompassData > StateMessage > LocalNavigation > RudderCommand > Actuator
+ *
+ * Developer Notes:
+ *		Owned by the MessageBus, see MessageBus::causalTracer(). The paths are found as
+ *		commands come in, at most MAX_PATHS of them. Recording takes a short lock to
+ *		look the path up, the actuators only record a few times a second.
+ *
+ *		The origin time and the time of recording both come from the SysClock, on a
+ *		simulated time source the latency is in simulated time.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/Message.h"
+#include "MessageBus/NodeIDs.h"
+#include "SystemServices/LatencyHistogram.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+class CausalTracer {
+public:
+	struct PathStats {
+		std::string 	path;			// The message types and the actuator, separated by " > "
+		uint64_t 		count;
+		uint64_t 		latencyP50Us;	// From the origin time to the actuator
+		uint64_t 		latencyP90Us;
+		uint64_t 		latencyP99Us;
+		uint64_t 		latencyMaxUs;
+	};
+
+	CausalTracer();
+
+	///----------------------------------------------------------------------------------
+ 	/// Records that an actuator has acted on a command, called once the command has
+ 	/// gone out on the actuator's link. Can be called from any thread.
+ 	///
+ 	/// @param command 			The message the actuator acted on.
+ 	/// @param actuator 		The actuator node.
+ 	///----------------------------------------------------------------------------------
+	void record(const Message& command, NodeID actuator);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the latencies of every path seen so far, in the order they were first
+ 	/// seen.
+ 	///----------------------------------------------------------------------------------
+	std::vector<PathStats> statistics() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Commands that weren't recorded because there were already MAX_PATHS paths.
+ 	///----------------------------------------------------------------------------------
+	uint64_t untraced() const { return m_Untraced.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+ 	/// Writes the latency of every path to the Logger.
+ 	///----------------------------------------------------------------------------------
+	void logStatistics() const;
+
+	static const size_t MAX_PATHS = 32;
+
+private:
+	struct Path {
+		Path(const MessageCause& chain, NodeID actuatorID) : cause(chain), actuator(actuatorID) { }
+
+		bool matches(const MessageCause& other, NodeID actuatorID) const;
+		std::string toString() const;
+
+		MessageCause 		cause;			// Only the chain of message types is used
+		NodeID 				actuator;
+		LatencyHistogram 	latency;
+	};
+
+	mutable std::mutex 		m_Mutex;		// Guards m_Paths
+	std::deque<Path> 		m_Paths;
+	std::atomic<uint64_t> 	m_Untraced;
+};
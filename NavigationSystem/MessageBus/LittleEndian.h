@@ -0,0 +1,131 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LittleEndian.h
+ *
+ * Purpose:
+ *		Reads and writes the values of a serialised message at a given address.
+ *
+ * Developer Notes:
+ *		Values are stored little endian whatever the host, floats and doubles as their
+ *		IEEE 754 bits, ints as two's complement. Nothing is aligned, the functions work
+ *		a byte at a time so they can be pointed anywhere into a message.
+ *
+ *		The MessageSerialiser, the MessageDeserialiser, the generated message classes
+ *		and the message views all go through these, so they agree on the format.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+
+class LittleEndian {
+public:
+	///----------------------------------------------------------------------------------
+	/// Writes a value to the given address, returns the address after it.
+	///----------------------------------------------------------------------------------
+	static inline uint8_t* write(uint8_t* data, uint8_t value)
+	{
+		data[0] = value;
+		return data + 1;
+	}
+
+	static inline uint8_t* write(uint8_t* data, bool value)
+	{
+		return write(data, (uint8_t)value);
+	}
+
+	static inline uint8_t* write(uint8_t* data, uint16_t value)
+	{
+		data[0] = (uint8_t)value;
+		data[1] = (uint8_t)(value >> 8);
+		return data + 2;
+	}
+
+	static inline uint8_t* write(uint8_t* data, uint32_t value)
+	{
+		data[0] = (uint8_t)value;
+		data[1] = (uint8_t)(value >> 8);
+		data[2] = (uint8_t)(value >> 16);
+		data[3] = (uint8_t)(value >> 24);
+		return data + 4;
+	}
+
+	static inline uint8_t* write(uint8_t* data, uint64_t value)
+	{
+		data = write(data, (uint32_t)value);
+		return write(data, (uint32_t)(value >> 32));
+	}
+
+	static inline uint8_t* write(uint8_t* data, int value)
+	{
+		return write(data, (uint32_t)value);
+	}
+
+	static inline uint8_t* write(uint8_t* data, float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return write(data, bits);
+	}
+
+	static inline uint8_t* write(uint8_t* data, double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return write(data, bits);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Reads a value from the given address.
+	///----------------------------------------------------------------------------------
+	static inline uint8_t readUint8(const uint8_t* data)
+	{
+		return data[0];
+	}
+
+	static inline bool readBool(const uint8_t* data)
+	{
+		return data[0] != 0;
+	}
+
+	static inline uint16_t readUint16(const uint8_t* data)
+	{
+		return (uint16_t)(data[0] | (data[1] << 8));
+	}
+
+	static inline uint32_t readUint32(const uint8_t* data)
+	{
+		return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+			((uint32_t)data[3] << 24);
+	}
+
+	static inline uint64_t readUint64(const uint8_t* data)
+	{
+		return (uint64_t)readUint32(data) | ((uint64_t)readUint32(data + 4) << 32);
+	}
+
+	static inline int readInt(const uint8_t* data)
+	{
+		return (int)readUint32(data);
+	}
+
+	static inline float readFloat(const uint8_t* data)
+	{
+		uint32_t bits = readUint32(data);
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	static inline double readDouble(const uint8_t* data)
+	{
+		uint64_t bits = readUint64(data);
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+};
@@ -7,25 +7,60 @@
  *		Provides the base message class
  *
  * Developer Notes:
+ *		Every message class declares its message type as a static TYPE constant, the
+ *		typed subscriptions of MessageBus::subscribe() look it up from the class.
  *
+ *		The message bus gives every message it is sent an ID. A node that makes a
+ *		message from another one passes the other one to setCause(), the new message
+ *		then carries the time the first message of the chain was sent, see
+ *		MessageCause.h. A message sent without a cause starts a chain of its own. The
+ *		ID and the cause aren't serialised, a message that comes in from outside starts
+ *		a new chain.
  *
  ***************************************************************************************/
 
 #pragma once
 
+#include "MessageBus/MessageCause.h"
 #include "MessageBus/MessageTypes.h"
 #include "MessageBus/NodeIDs.h"
 #include "MessageBus/MessageSerialiser.h"
 #include "MessageBus/MessageDeserialiser.h"
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+///----------------------------------------------------------------------------------
+/// The link used by LockFreeMessageQueue to chain messages together without
+/// allocating list nodes. Copying a message doesn't copy its link.
+///----------------------------------------------------------------------------------
+struct MessageQueueLink {
+	MessageQueueLink() : m_QueueNext(NULL) { }
+	MessageQueueLink(const MessageQueueLink&) : m_QueueNext(NULL) { }
+	MessageQueueLink& operator=(const MessageQueueLink&) { return *this; }
+
+	std::atomic<MessageQueueLink*> m_QueueNext;
+};
+
+
+class Message;
 
+///----------------------------------------------------------------------------------
+/// Set on messages that were allocated by a MessagePool, tells MessageDeleter how to
+/// give the memory back. Copying a message doesn't copy it.
+///----------------------------------------------------------------------------------
+struct MessageRecycler {
+	typedef void (*RecycleFunction)(Message*);
 
-#define LOG_MESSAGES
+	MessageRecycler() : m_Recycle(NULL) { }
+	MessageRecycler(const MessageRecycler&) : m_Recycle(NULL) { }
+	MessageRecycler& operator=(const MessageRecycler&) { return *this; }
+
+	RecycleFunction m_Recycle;
+};
 
-#ifdef LOG_MESSAGES
-#include "SystemServices/SysClock.h"
-#endif
 
-class Message {
+class Message : public MessageQueueLink, public MessageRecycler {
 public:
 	///----------------------------------------------------------------------------------
  	/// Default constructor
@@ -36,7 +71,8 @@ public:
  	///							NodeIDS::NONE for no specific destination.
  	///----------------------------------------------------------------------------------
 	Message(MessageType msgType, NodeID msgSource, NodeID msgDest)
-		:m_valid(true), m_MessageType(msgType), m_SourceID(msgSource), m_DestinationID(msgDest)
+		:timeEnqueued(0), m_valid(true), m_MessageType(msgType), m_SourceID(msgSource),
+		m_DestinationID(msgDest), m_MessageID(0)
 	{ }
 
 	///----------------------------------------------------------------------------------
@@ -46,7 +82,8 @@ public:
  	/// @param msgSource		Which node posted this message.
  	///----------------------------------------------------------------------------------
 	Message(MessageType msgType, NodeID msgSource)
-		:m_valid(true), m_MessageType(msgType), m_SourceID(msgSource), m_DestinationID(NodeID::None)
+		:timeEnqueued(0), m_valid(true), m_MessageType(msgType), m_SourceID(msgSource),
+		m_DestinationID(NodeID::None), m_MessageID(0)
 	{ }
 
 	///----------------------------------------------------------------------------------
@@ -55,11 +92,12 @@ public:
  	/// @param msgType 			The type of message this is.
  	///----------------------------------------------------------------------------------
 	Message(MessageType msgType)
-		:m_MessageType(msgType), m_SourceID(NodeID::None), m_DestinationID(NodeID::None)
+		:timeEnqueued(0), m_valid(true), m_MessageType(msgType), m_SourceID(NodeID::None),
+		m_DestinationID(NodeID::None), m_MessageID(0)
 	{ }
 
 	Message(MessageDeserialiser& deserialiser)
-		:m_valid(true)
+		:timeEnqueued(0), m_valid(true), m_MessageID(0)
 	{
 		if(	!deserialiser.readMessageType(m_MessageType) ||
 			!deserialiser.readNodeID(m_SourceID) ||
@@ -104,9 +142,60 @@ public:
 		serialiser.serialise(m_DestinationID);
 	}
 
-#ifdef LOG_MESSAGES
-	TimeStamp timeReceived;
-#endif
+	///----------------------------------------------------------------------------------
+	/// Returns the ID the message bus gave the message, zero until it is sent.
+	///----------------------------------------------------------------------------------
+	uint64_t messageID() const { return m_MessageID; }
+
+	///----------------------------------------------------------------------------------
+	/// Returns where the data of this message came from.
+	///----------------------------------------------------------------------------------
+	const MessageCause& cause() const { return m_Cause; }
+
+	///----------------------------------------------------------------------------------
+	/// Monotonic time in microseconds the first message of the chain was sent.
+	///----------------------------------------------------------------------------------
+	uint64_t originTime() const { return m_Cause.originTime; }
+
+	///----------------------------------------------------------------------------------
+	/// Returns the cause of a message made from this one. A node that uses the data
+	/// later, like in a periodic loop, keeps this instead of the message.
+	///----------------------------------------------------------------------------------
+	MessageCause asCause() const
+	{
+		MessageCause cause = m_Cause;
+		cause.causeID = m_MessageID;
+		if(cause.chainLength < MessageCause::MAX_CHAIN)
+		{
+			cause.chain[cause.chainLength] = static_cast<uint8_t>(m_MessageType);
+		}
+		if(cause.chainLength < UINT8_MAX)
+		{
+			cause.chainLength++;
+		}
+		return cause;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Marks this message as made from another one, has to be called before it is sent.
+	///----------------------------------------------------------------------------------
+	void setCause(const Message& cause) { m_Cause = cause.asCause(); }
+	void setCause(const MessageCause& cause) { m_Cause = cause; }
+
+	///----------------------------------------------------------------------------------
+	/// Called by the MessageBus when the message is sent, a message without a cause
+	/// starts its chain now.
+	///----------------------------------------------------------------------------------
+	void markSent(uint64_t messageID, uint64_t now)
+	{
+		m_MessageID = messageID;
+		if(not m_Cause.known())
+		{
+			m_Cause.originTime = now;
+		}
+	}
+
+	uint64_t timeEnqueued;			// Monotonic time in microseconds, set by the MessageBus
 
 protected:
 	bool m_valid;					// Indicates that the message was correctl created
@@ -115,4 +204,33 @@ private:
 	MessageType m_MessageType;		// The message type
 	NodeID m_SourceID;				// Which node generated the message
 	NodeID m_DestinationID;			// The desintation of the message
+	uint64_t m_MessageID;			// Given by the MessageBus
+	MessageCause m_Cause;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Deletes a message, or hands it back to the pool it came from. The deleter has no
+/// state so a MessagePtr is still the size of a pointer.
+///----------------------------------------------------------------------------------
+struct MessageDeleter {
+	MessageDeleter() { }
+
+	// Lets the result of std::make_unique<XxxMsg>() be stored in a MessagePtr
+	template<class T>
+	MessageDeleter(const std::default_delete<T>&) { }
+
+	void operator()(Message* msg) const
+	{
+		if(msg->m_Recycle != NULL)
+		{
+			msg->m_Recycle(msg);
+		}
+		else
+		{
+			delete msg;
+		}
+	}
 };
+
+typedef std::unique_ptr<Message, MessageDeleter> MessagePtr;
@@ -10,33 +10,81 @@
  ***************************************************************************************/
 
 #include "MessageBus/MessageBus.h"
+#include "Messages/StateMessage.h"
+#include "Messages/WindStateMsg.h"
 #include "SystemServices/Logger.h"
-#include <sys/time.h>
 #include "SystemServices/SysClock.h"
 
 // For std::this_thread
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iostream>
 
-#define SLEEP_TIME_MS	50
 
+// How many messages a worker takes from a mailbox before moving on to the next node
+#define MAILBOX_BATCH 	8
+// The longest a sender of a Block type waits for room before its message is dropped
+#define SEND_BLOCK_TIMEOUT_MS 	1000
+
+
+///----------------------------------------------------------------------------------
+/// Raises a high water mark, only the message bus thread writes them.
+///----------------------------------------------------------------------------------
+static void updateHighWater(std::atomic<size_t>& highWater, size_t value)
+{
+	if(value > highWater.load(std::memory_order_relaxed))
+	{
+		highWater.store(value, std::memory_order_relaxed);
+	}
+}
 
 MessageBus::MessageBus()
-	:m_Running(false)
+	:m_BlockedSenders(0), m_ConflationPass(0), m_Sleeping(false), m_Running(false), m_BatchingWindowMs(0),
+	 m_NextMessageID(1), m_Distributed(0), m_FrontHighWater(0), m_BackHighWater(0), m_StatisticsIntervalS(0), m_WorkerCount(0),
+	 m_WorkersRunning(false)
 {
-	m_FrontMessages = new std::queue<MessagePtr>();
-	m_BackMessages = new std::queue<MessagePtr>();
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		m_Published[type].count.store(0);
+		m_Published[type].queued.store(0);
+		m_Priorities[type] = MessagePriority::Normal;
+		m_Conflate[type] = false;
+		m_Conflated[type].store(0);
+		m_BlackboardWriters[type] = NULL;
+		m_QueueLimits[type].capacity = 0;
+		m_QueueLimits[type].policy = OverflowPolicy::DropOldest;
+		m_Dropped[type].store(0);
+		m_BusOverloaded[type].store(false);
+		m_OverloadedQueues[type].store(0);
+	}
+
+	// Control commands shouldn't wait behind sensor data
+	m_Priorities[static_cast<int>(MessageType::RudderCommand)] = MessagePriority::High;
+	m_Priorities[static_cast<int>(MessageType::SailCommand)] = MessagePriority::High;
+	m_Priorities[static_cast<int>(MessageType::WingSailCommand)] = MessagePriority::High;
+	m_Priorities[static_cast<int>(MessageType::LocalNavigation)] = MessagePriority::High;
+
+	// Only the newest value of these matters
+	m_Conflate[static_cast<int>(MessageType::CompassData)] = true;
+	m_Conflate[static_cast<int>(MessageType::StateMessage)] = true;
+	m_Conflate[static_cast<int>(MessageType::WindState)] = true;
+	m_Conflate[static_cast<int>(MessageType::GPSData)] = true;
+	m_Conflate[static_cast<int>(MessageType::WindData)] = true;
+
+	// Read by most of the control loops
+	share<StateMessage>(MessageType::StateMessage);
+	share<WindStateMsg>(MessageType::WindState);
 }
 
 MessageBus::~MessageBus()
 {
+	// The ticks send messages
+	m_TickScheduler.stop();
+
 	for (auto it = m_RegisteredNodes.begin(); it != m_RegisteredNodes.end(); ++it) {
     	delete *it;
 	}
-
-	delete m_FrontMessages;
-	delete m_BackMessages;
 }
 
 // TODO - Jordan: Log warning if node tries to register after start
@@ -69,11 +117,37 @@ void MessageBus::sendMessage(MessagePtr msg)
 {
 	if(msg != NULL)
 	{
-		m_FrontQueueMutex.lock();
-		Message* logMsg = msg.get();
-		m_FrontMessages->push(std::move(msg));
-		logMessageReceived(logMsg);
-		m_FrontQueueMutex.unlock();
+		msg->timeEnqueued = SysClock::monotonicMicros();
+
+		MessagePriority lane = MessagePriority::Normal;
+		int type = static_cast<int>(msg->messageType());
+		if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+		{
+			if(not admit(type))
+			{
+				return;
+			}
+
+			m_Published[type].count.fetch_add(1, std::memory_order_relaxed);
+			lane = m_Priorities[type];
+			msg->markSent(m_NextMessageID.fetch_add(1, std::memory_order_relaxed), msg->timeEnqueued);
+
+			if(m_BlackboardWriters[type] != NULL)
+			{
+				m_BlackboardWriters[type](m_Blackboard, msg.get());
+			}
+		}
+
+		m_FrontMessages[static_cast<int>(lane)].push(std::move(msg));
+
+		// Only bother with the lock when the bus thread is going to sleep. The bus sets
+		// m_Sleeping before it checks the queue one last time, so either it sees this
+		// message or we see that it is sleeping.
+		if(m_Sleeping.load() == true)
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_WakeCondition.notify_one();
+		}
 	}
 }
 
@@ -81,34 +155,421 @@ void MessageBus::run()
 {
 	// Prevent nodes from being registered now
 	m_Running.store(true);
-	startMessageLog();
+	m_BusThread = std::this_thread::get_id();
+	buildDispatchTables();
+	startMessageTrace();
+	startWorkers();
+
+	std::chrono::steady_clock::time_point nextDump = std::chrono::steady_clock::now();
 
 	while(m_Running.load() == true)
 	{
-		// TODO - Jordan: Wake up only when messages have been pushed into the queue.
+		if(not hasFrontMessages())
+		{
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+			m_Sleeping.store(true);
+			auto wakeUp = [this]() {
+				return hasFrontMessages() || m_Running.load() == false;
+			};
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(SLEEP_TIME_MS));
+			// Wake up for the statistics dump too
+			if(m_StatisticsIntervalS.load() > 0)
+			{
+				m_WakeCondition.wait_until(lock, nextDump, wakeUp);
+			}
+			else
+			{
+				m_WakeCondition.wait(lock, wakeUp);
+			}
+			m_Sleeping.store(false);
+		}
 
-		// If we have messages, flip the two queues and begin processing messages
-		if(m_FrontMessages->size() > 0)
+		unsigned int batchingWindow = m_BatchingWindowMs.load();
+		if(batchingWindow > 0 && m_Running.load() == true)
 		{
-			std::queue<MessagePtr>* tmpPtr;
-
-			m_FrontQueueMutex.lock();
+			// Let more messages arrive before waking up the nodes
+			std::this_thread::sleep_for(std::chrono::milliseconds(batchingWindow));
+		}
 
-			tmpPtr = m_FrontMessages;
-			m_FrontMessages = m_BackMessages;
-			m_FrontQueueMutex.unlock();
+		// Take everything out of the front queues and begin processing messages. The
+		// front queues only grow between two pops so their high water mark is the
+		// largest batch taken out.
+		size_t popped = 0;
+		size_t waiting = 0;
+		for(int lane = 0; lane < MESSAGE_PRIORITY_COUNT; lane++)
+		{
+			size_t backBefore = m_BackMessages[lane].size();
+			m_FrontMessages[lane].popAll(m_BackMessages[lane]);
+			popped += m_BackMessages[lane].size() - backBefore;
 
-			m_BackMessages = tmpPtr;
-			processMessages();
+			conflate(m_BackMessages[lane]);
+			waiting += m_BackMessages[lane].size();
 		}
+		updateHighWater(m_FrontHighWater, popped);
+		updateHighWater(m_BackHighWater, waiting);
+		processMessages();
+
+		logStatisticsIfDue(nextDump);
 	}
+
+	stopWorkers();
+	m_Recorder.close();
+#if MESSAGE_BUS_TRACE == 1
+	m_Trace.stop();
+#endif
+	logStatistics();
 }
 
 void MessageBus::stop()
 {
-	m_Running.store(false);
+	// Take the lock so the bus thread can't miss the wake up between checking
+	// m_Running and going to sleep.
+	{
+		std::lock_guard<std::mutex> lock(m_WakeMutex);
+		m_Running.store(false);
+		m_WakeCondition.notify_all();
+	}
+
+	// Blocked senders give up
+	std::lock_guard<std::mutex> lock(m_SpaceMutex);
+	m_SpaceCondition.notify_all();
+}
+
+void MessageBus::setBatchingWindow(unsigned int milliseconds)
+{
+	m_BatchingWindowMs.store(milliseconds);
+}
+
+bool MessageBus::setPriority(MessageType msgType, MessagePriority priority)
+{
+	int type = static_cast<int>(msgType);
+	if(not m_Running && type >= 0 && type < MESSAGE_TYPE_COUNT)
+	{
+		m_Priorities[type] = priority;
+		return true;
+	}
+	return false;
+}
+
+MessagePriority MessageBus::priority(MessageType msgType) const
+{
+	int type = static_cast<int>(msgType);
+	if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+	{
+		return m_Priorities[type];
+	}
+	return MessagePriority::Normal;
+}
+
+bool MessageBus::setConflation(MessageType msgType, bool conflate)
+{
+	int type = static_cast<int>(msgType);
+	if(not m_Running && type >= 0 && type < MESSAGE_TYPE_COUNT)
+	{
+		m_Conflate[type] = conflate;
+		return true;
+	}
+	return false;
+}
+
+bool MessageBus::conflates(MessageType msgType) const
+{
+	int type = static_cast<int>(msgType);
+	return type >= 0 && type < MESSAGE_TYPE_COUNT && m_Conflate[type];
+}
+
+bool MessageBus::setQueueLimit(MessageType msgType, size_t capacity, OverflowPolicy policy)
+{
+	int type = static_cast<int>(msgType);
+	if(not m_Running && type >= 0 && type < MESSAGE_TYPE_COUNT)
+	{
+		m_QueueLimits[type].capacity = capacity;
+		m_QueueLimits[type].policy = policy;
+		return true;
+	}
+	return false;
+}
+
+size_t MessageBus::queueLimit(MessageType msgType) const
+{
+	int type = static_cast<int>(msgType);
+	if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+	{
+		return m_QueueLimits[type].capacity;
+	}
+	return 0;
+}
+
+bool MessageBus::isOverloaded(MessageType msgType) const
+{
+	int type = static_cast<int>(msgType);
+	return type >= 0 && type < MESSAGE_TYPE_COUNT && m_OverloadedQueues[type].load() > 0;
+}
+
+bool MessageBus::isOverloaded() const
+{
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		if(m_OverloadedQueues[type].load() > 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool MessageBus::enableWorkerPool(unsigned int workerCount)
+{
+	if(not m_Running)
+	{
+		m_WorkerCount = workerCount;
+		return true;
+	}
+	return false;
+}
+
+bool MessageBus::startRecording(const std::string& filePath)
+{
+	if(not m_Running)
+	{
+		return m_Recorder.open(filePath);
+	}
+	return false;
+}
+
+uint64_t MessageBus::pendingMessages() const
+{
+	// Read before the publish counters, which are always ahead of it
+	uint64_t distributed = m_Distributed.load(std::memory_order_acquire);
+
+	uint64_t published = 0;
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		published += m_Published[type].count.load(std::memory_order_relaxed);
+	}
+
+	// runMailbox() counts a message as handled before it leaves the mailbox, so reading
+	// the depth first can count it twice but never misses it
+	uint64_t inMailboxes = 0;
+	for(auto regNode : m_RegisteredNodes)
+	{
+		inMailboxes += regNode->mailboxDepth.load();
+		inMailboxes += regNode->handling.load();
+	}
+
+	return published - distributed + inMailboxes;
+}
+
+void MessageBus::setStatisticsInterval(unsigned int seconds)
+{
+	std::lock_guard<std::mutex> lock(m_WakeMutex);
+	m_StatisticsIntervalS.store(seconds);
+	m_WakeCondition.notify_one();
+}
+
+MessageBus::Stats MessageBus::statistics() const
+{
+	Stats stats;
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		stats.published.push_back(m_Published[type].count.load(std::memory_order_relaxed));
+		stats.conflated.push_back(m_Conflated[type].load(std::memory_order_relaxed));
+		stats.dropped.push_back(m_Dropped[type].load(std::memory_order_relaxed));
+		if(m_OverloadedQueues[type].load() > 0)
+		{
+			stats.overloaded.push_back(static_cast<MessageType>(type));
+		}
+	}
+	stats.nodes = nodeStats();
+	stats.frontQueueHighWater = m_FrontHighWater.load();
+	stats.backQueueHighWater = m_BackHighWater.load();
+
+	stats.latencyCount = m_DispatchLatency.count();
+	stats.latencyMeanUs = m_DispatchLatency.mean();
+	stats.latencyP50Us = m_DispatchLatency.percentile(50);
+	stats.latencyP90Us = m_DispatchLatency.percentile(90);
+	stats.latencyP99Us = m_DispatchLatency.percentile(99);
+	stats.latencyMaxUs = m_DispatchLatency.max();
+
+	for(int lane = 0; lane < MESSAGE_PRIORITY_COUNT; lane++)
+	{
+		stats.laneLatencyP99Us[lane] = m_LaneLatency[lane].percentile(99);
+		stats.laneLatencyMaxUs[lane] = m_LaneLatency[lane].max();
+	}
+
+	MessagePoolBase::totals(stats.poolHits, stats.poolMisses);
+
+#if MESSAGE_BUS_TRACE == 1
+	stats.traceDropped = m_Trace.dropped();
+#else
+	stats.traceDropped = 0;
+#endif
+	stats.ticks = m_TickScheduler.statistics();
+	stats.causalPaths = m_CausalTracer.statistics();
+
+	std::lock_guard<std::mutex> lock(m_ControlLoopMutex);
+	for(auto& loop : m_ControlLoops)
+	{
+		const DeadlineTimer* timer = loop.second;
+
+		LoopStats loopStats;
+		loopStats.id = loop.first;
+		loopStats.periodUs = timer->periodUs();
+		loopStats.loops = timer->jitter().count();
+		loopStats.missed = timer->missed().count();
+		loopStats.skipped = timer->skipped();
+		loopStats.jitterP99Us = timer->jitter().percentile(99);
+		loopStats.jitterMaxUs = timer->jitter().max();
+		loopStats.missedByMaxUs = timer->missed().max();
+		stats.loops.push_back(loopStats);
+	}
+	return stats;
+}
+
+void MessageBus::logStatistics() const
+{
+	Stats stats = statistics();
+
+	Logger::info("MessageBus queue high water: front=%zu back=%zu, dispatch latency: %s",
+		stats.frontQueueHighWater, stats.backQueueHighWater, m_DispatchLatency.toString().c_str());
+	Logger::info("MessageBus high priority lane latency: %s",
+		m_LaneLatency[static_cast<int>(MessagePriority::High)].toString().c_str());
+	Logger::info("MessageBus normal priority lane latency: %s",
+		m_LaneLatency[static_cast<int>(MessagePriority::Normal)].toString().c_str());
+	Logger::info("MessageBus message pools: hits=%llu misses=%llu, trace records dropped: %llu",
+		(unsigned long long)stats.poolHits, (unsigned long long)stats.poolMisses,
+		(unsigned long long)stats.traceDropped);
+
+	std::string published;
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		if(stats.published[type] > 0)
+		{
+			published += " " + msgToString(static_cast<MessageType>(type)) + "=" +
+				std::to_string(stats.published[type]);
+		}
+	}
+	Logger::info("MessageBus published:%s", published.c_str());
+
+	std::string conflated;
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		if(stats.conflated[type] > 0)
+		{
+			conflated += " " + msgToString(static_cast<MessageType>(type)) + "=" +
+				std::to_string(stats.conflated[type]);
+		}
+	}
+	if(not conflated.empty())
+	{
+		Logger::info("MessageBus conflated:%s", conflated.c_str());
+	}
+
+	std::string dropped;
+	for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+	{
+		if(stats.dropped[type] > 0)
+		{
+			dropped += " " + msgToString(static_cast<MessageType>(type)) + "=" +
+				std::to_string(stats.dropped[type]);
+		}
+	}
+	if(not dropped.empty())
+	{
+		Logger::warning("MessageBus dropped over the queue limit:%s", dropped.c_str());
+	}
+
+	std::string overloaded;
+	for(MessageType type : stats.overloaded)
+	{
+		overloaded += " " + msgToString(type);
+	}
+	if(not overloaded.empty())
+	{
+		Logger::warning("MessageBus overloaded:%s", overloaded.c_str());
+	}
+
+	for(auto& node : stats.nodes)
+	{
+		Logger::info("MessageBus node %s: handled=%llu handler time total=%lluus max=%lluus queued=%zu dropped=%llu",
+			nodeToString(node.id).c_str(), (unsigned long long)node.messagesHandled,
+			(unsigned long long)node.handlerTimeTotalUs, (unsigned long long)node.handlerTimeMaxUs,
+			node.queueDepth, (unsigned long long)node.dropped);
+	}
+
+	for(auto& tick : stats.ticks)
+	{
+		Logger::info("MessageBus tick %s: period=%lluus ticks=%llu overruns=%llu skipped=%llu lateness p99=%lluus max=%lluus duration max=%lluus",
+			nodeToString(tick.id).c_str(), (unsigned long long)tick.periodUs, (unsigned long long)tick.ticks,
+			(unsigned long long)tick.overruns, (unsigned long long)tick.skipped,
+			(unsigned long long)tick.latenessP99Us, (unsigned long long)tick.latenessMaxUs,
+			(unsigned long long)tick.durationMaxUs);
+	}
+
+	m_CausalTracer.logStatistics();
+
+	std::lock_guard<std::mutex> lock(m_ControlLoopMutex);
+	for(auto& loop : m_ControlLoops)
+	{
+		const DeadlineTimer* timer = loop.second;
+		Logger::info("MessageBus control loop %s: period=%lluus skipped=%llu jitter: %s",
+			nodeToString(loop.first).c_str(), (unsigned long long)timer->periodUs(),
+			(unsigned long long)timer->skipped(), timer->jitter().toString().c_str());
+		Logger::info("MessageBus control loop %s missed deadlines: %s",
+			nodeToString(loop.first).c_str(), timer->missed().toString().c_str());
+	}
+}
+
+void MessageBus::addControlLoop(NodeID id, const DeadlineTimer& timer)
+{
+	std::lock_guard<std::mutex> lock(m_ControlLoopMutex);
+	m_ControlLoops.push_back(std::make_pair(id, &timer));
+}
+
+void MessageBus::removeControlLoop(const DeadlineTimer& timer)
+{
+	std::lock_guard<std::mutex> lock(m_ControlLoopMutex);
+	for(auto it = m_ControlLoops.begin(); it != m_ControlLoops.end(); ++it)
+	{
+		if(it->second == &timer)
+		{
+			m_ControlLoops.erase(it);
+			return;
+		}
+	}
+}
+
+void MessageBus::logStatisticsIfDue(std::chrono::steady_clock::time_point& nextDump)
+{
+	unsigned int interval = m_StatisticsIntervalS.load();
+	if(interval == 0)
+	{
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if(now >= nextDump)
+	{
+		logStatistics();
+		nextDump = now + std::chrono::seconds(interval);
+	}
+}
+
+std::vector<MessageBus::NodeStats> MessageBus::nodeStats() const
+{
+	std::vector<NodeStats> stats;
+	for(auto regNode : m_RegisteredNodes)
+	{
+		NodeStats nodeStats;
+		nodeStats.id = regNode->nodeRef.nodeID();
+		nodeStats.queueDepth = regNode->mailboxDepth.load();
+		nodeStats.dropped = regNode->dropped.load(std::memory_order_relaxed);
+		nodeStats.messagesHandled = regNode->handlerTime.count();
+		nodeStats.handlerTimeTotalUs = regNode->handlerTime.total();
+		nodeStats.handlerTimeMaxUs = regNode->handlerTime.max();
+		stats.push_back(nodeStats);
+	}
+	return stats;
 }
 
 //TODO - Jordan: What would cause this to return a null pointer?
@@ -129,116 +590,567 @@ MessageBus::RegisteredNode* MessageBus::getRegisteredNode(Node& node)
 	return newRegNode;
 }
 
-void MessageBus::processMessages()
+void MessageBus::buildDispatchTables()
 {
-	while(m_BackMessages->size() > 0)
+	m_Subscribers.assign(MESSAGE_TYPE_COUNT, std::vector<RegisteredNode*>());
+	m_DirectNodes.assign(NODE_ID_COUNT, NULL);
+	m_ConflationSeen.assign(MESSAGE_TYPE_COUNT * NODE_ID_COUNT * NODE_ID_COUNT, 0);
+	m_ConflationPass = 0;
+
+	// Keep the registration order so nodes receive messages in the same order as before
+	for(auto regNode : m_RegisteredNodes)
 	{
-		// std::cout << "/* Size back message queue " << m_BackMessages->size() << " */" << '\n';
-		MessagePtr msgPtr = std::move(m_BackMessages->front());
-		Message* msg = msgPtr.get();
+		for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+		{
+			if(regNode->isInterested(static_cast<MessageType>(type)))
+			{
+				m_Subscribers[type].push_back(regNode);
+			}
+		}
 
-		logMessage(msg);
+		int id = static_cast<int>(regNode->nodeRef.nodeID());
+		if(id > 0 && id < NODE_ID_COUNT)
+		{
+			m_DirectNodes[id] = regNode;
+		}
+	}
+}
 
-		for(auto node : m_RegisteredNodes)
+bool MessageBus::hasFrontMessages() const
+{
+	for(int lane = 0; lane < MESSAGE_PRIORITY_COUNT; lane++)
+	{
+		if(not m_FrontMessages[lane].empty())
 		{
-			// Distribute to everyone interested
-			if(msg->destinationID() == NodeID::None)
+			return true;
+		}
+	}
+	return false;
+}
+
+void MessageBus::processMessages()
+{
+	const int high = static_cast<int>(MessagePriority::High);
+	const int normal = static_cast<int>(MessagePriority::Normal);
+
+	while(true)
+	{
+		while(not m_BackMessages[high].empty())
+		{
+			MessagePtr msg = std::move(m_BackMessages[high].front());
+			m_BackMessages[high].pop();
+			if(leaveQueue(msg.get()))
 			{
-				if(node->isInterested( msg->messageType() ))
-				{
-					// std::cout << std::endl << "## Before processing " << nodeToString(node->nodeRef.nodeID()) << " Message : " << msgToString(msg->messageType()) << std::endl;
-					node->nodeRef.processMessage(msg);
-					logMessageConsumer(node->nodeRef.nodeID());
+				processMessage(std::move(msg), MessagePriority::High);
+			}
+		}
 
-				}
+		if(m_BackMessages[normal].empty())
+		{
+			break;
+		}
+
+		MessagePtr msg = std::move(m_BackMessages[normal].front());
+		m_BackMessages[normal].pop();
+		if(leaveQueue(msg.get()))
+		{
+			processMessage(std::move(msg), MessagePriority::Normal);
+		}
+
+		// High priority messages sent in the meantime go ahead of the rest
+		if(not m_FrontMessages[high].empty())
+		{
+			m_FrontMessages[high].popAll(m_BackMessages[high]);
+			conflate(m_BackMessages[high]);
+		}
+	}
+}
+
+void MessageBus::processMessage(MessagePtr msgPtr, MessagePriority priority)
+{
+	Message* msg = msgPtr.get();
+
+	uint64_t now = SysClock::monotonicMicros();
+	m_DispatchLatency.record(now - msg->timeEnqueued);
+	m_LaneLatency[static_cast<int>(priority)].record(now - msg->timeEnqueued);
+	traceDispatch(msg, now);
+
+	if(m_Recorder.isOpen())
+	{
+		m_Recorder.record(*msg, msg->timeEnqueued);
+	}
+
+	int type = static_cast<int>(msg->messageType());
+	int destination = static_cast<int>(msg->destinationID());
+	std::shared_ptr<const Message> shared;
+
+	// Distribute to everyone interested
+	if(msg->destinationID() == NodeID::None)
+	{
+		if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+		{
+			for(auto regNode : m_Subscribers[type])
+			{
+				dispatch(regNode, msgPtr, shared);
 			}
-			// Distribute to the node the message is directed at then move onto the next message
-			else
+		}
+	}
+	// Distribute to the node the message is directed at
+	else if(destination > 0 && destination < NODE_ID_COUNT)
+	{
+		RegisteredNode* regNode = m_DirectNodes[destination];
+		if(regNode != NULL)
+		{
+			dispatch(regNode, msgPtr, shared);
+		}
+	}
+
+	// Counted once it is in the mailboxes so pendingMessages() never misses it
+	if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+	{
+		m_Distributed.fetch_add(1, std::memory_order_release);
+	}
+}
+
+bool MessageBus::admit(int type)
+{
+	const QueueLimit& limit = m_QueueLimits[type];
+	std::atomic<size_t>& queued = m_Published[type].queued;
+
+	size_t waiting = queued.fetch_add(1);
+	if(limit.capacity == 0 || waiting < limit.capacity)
+	{
+		return true;
+	}
+
+	if(not m_BusOverloaded[type].exchange(true))
+	{
+		overloadStarted(type);
+	}
+
+	// The bus drops the oldest one when it gets to it, until then they both wait
+	if(limit.policy == OverflowPolicy::DropOldest && waiting < 2 * limit.capacity)
+	{
+		return true;
+	}
+	queued.fetch_sub(1);
+
+	if(limit.policy == OverflowPolicy::Block && waitForRoom(type))
+	{
+		return true;
+	}
+
+	m_Dropped[type].fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+bool MessageBus::waitForRoom(int type)
+{
+	// Nothing would make room
+	if(not m_Running.load() || std::this_thread::get_id() == m_BusThread)
+	{
+		return false;
+	}
+
+	const size_t capacity = m_QueueLimits[type].capacity;
+	std::atomic<size_t>& queued = m_Published[type].queued;
+	auto giveUp = std::chrono::steady_clock::now() + std::chrono::milliseconds(SEND_BLOCK_TIMEOUT_MS);
+	bool admitted = false;
+
+	// Counted before checking the queue so the bus thread can't miss us, see dequeued()
+	m_BlockedSenders.fetch_add(1);
+	{
+		std::unique_lock<std::mutex> lock(m_SpaceMutex);
+		while(m_Running.load())
+		{
+			size_t waiting = queued.load();
+			if(waiting < capacity)
 			{
-				if(node->nodeRef.nodeID() == msg->destinationID())
+				if(queued.compare_exchange_weak(waiting, waiting + 1))
 				{
-					node->nodeRef.processMessage(msg);
-					logMessageConsumer(node->nodeRef.nodeID());
-
-					continue;
+					admitted = true;
+					break;
 				}
 			}
+			else if(m_SpaceCondition.wait_until(lock, giveUp) == std::cv_status::timeout)
+			{
+				break;
+			}
+		}
+	}
+	m_BlockedSenders.fetch_sub(1);
+
+	return admitted;
+}
+
+size_t MessageBus::dequeued(int type)
+{
+	const QueueLimit& limit = m_QueueLimits[type];
+	size_t waiting = m_Published[type].queued.fetch_sub(1) - 1;
+
+	if(limit.capacity == 0)
+	{
+		return waiting;
+	}
+
+	if(m_BlockedSenders.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_SpaceMutex);
+		m_SpaceCondition.notify_all();
+	}
+
+	if(waiting <= limit.capacity / 2 && m_BusOverloaded[type].load(std::memory_order_relaxed) &&
+		m_BusOverloaded[type].exchange(false))
+	{
+		overloadEnded(type);
+	}
+	return waiting;
+}
+
+bool MessageBus::leaveQueue(const Message* msg)
+{
+	int type = static_cast<int>(msg->messageType());
+	if(type < 0 || type >= MESSAGE_TYPE_COUNT)
+	{
+		return true;
+	}
+
+	size_t waiting = dequeued(type);
+
+	// There are enough newer ones behind it
+	const QueueLimit& limit = m_QueueLimits[type];
+	if(limit.capacity > 0 && limit.policy == OverflowPolicy::DropOldest && waiting >= limit.capacity)
+	{
+		m_Dropped[type].fetch_add(1, std::memory_order_relaxed);
+		m_Distributed.fetch_add(1, std::memory_order_release);
+		return false;
+	}
+	return true;
+}
+
+void MessageBus::overloadStarted(int type)
+{
+	if(m_OverloadedQueues[type].fetch_add(1) == 0)
+	{
+		Logger::warning("MessageBus %s overloaded, queue limit %zu",
+			msgToString(static_cast<MessageType>(type)).c_str(), m_QueueLimits[type].capacity);
+	}
+}
+
+void MessageBus::overloadEnded(int type)
+{
+	if(m_OverloadedQueues[type].fetch_sub(1) == 1)
+	{
+		Logger::info("MessageBus %s no longer overloaded", msgToString(static_cast<MessageType>(type)).c_str());
+	}
+}
+
+int MessageBus::conflationKey(const Message* msg) const
+{
+	int type = static_cast<int>(msg->messageType());
+	int source = static_cast<int>(msg->sourceID());
+	int destination = static_cast<int>(msg->destinationID());
+
+	if(type < 0 || type >= MESSAGE_TYPE_COUNT || not m_Conflate[type] ||
+		source < 0 || source >= NODE_ID_COUNT || destination < 0 || destination >= NODE_ID_COUNT)
+	{
+		return -1;
+	}
+	return (type * NODE_ID_COUNT + source) * NODE_ID_COUNT + destination;
+}
+
+void MessageBus::conflate(std::queue<MessagePtr>& messages)
+{
+	if(messages.size() < 2)
+	{
+		return;
+	}
+
+	while(not messages.empty())
+	{
+		m_ConflationScratch.push_back(std::move(messages.front()));
+		messages.pop();
+	}
+
+	// A new pass number saves clearing the table every time
+	m_ConflationPass++;
+	if(m_ConflationPass == 0)
+	{
+		std::fill(m_ConflationSeen.begin(), m_ConflationSeen.end(), 0);
+		m_ConflationPass = 1;
+	}
+
+	// Walk from the newest message, anything older with a key already seen is stale
+	for(auto it = m_ConflationScratch.rbegin(); it != m_ConflationScratch.rend(); ++it)
+	{
+		int key = conflationKey(it->get());
+		if(key < 0)
+		{
+			continue;
 		}
 
-		m_BackMessages->pop();
+		if(m_ConflationSeen[key] == m_ConflationPass)
+		{
+			int type = static_cast<int>((*it)->messageType());
+			m_Conflated[type].fetch_add(1, std::memory_order_relaxed);
+			dequeued(type);
+			m_Distributed.fetch_add(1, std::memory_order_release);
+			it->reset();
+		}
+		else
+		{
+			m_ConflationSeen[key] = m_ConflationPass;
+		}
+	}
+
+	for(auto& msg : m_ConflationScratch)
+	{
+		if(msg)
+		{
+			messages.push(std::move(msg));
+		}
+	}
+	m_ConflationScratch.clear();
+}
 
-		// delete msg; Don't need for unique pointers
+void MessageBus::dispatch(RegisteredNode* regNode, MessagePtr& msg, std::shared_ptr<const Message>& shared)
+{
+	if(m_WorkerCount == 0)
+	{
+		deliver(regNode, msg.get());
+		return;
 	}
 
+	if(not shared)
+	{
+		shared = std::move(msg);
+	}
+	postToMailbox(regNode, shared);
 }
 
-void MessageBus::startMessageLog()
+void MessageBus::deliver(RegisteredNode* regNode, const Message* msg)
 {
-#ifdef LOG_MESSAGES
-	m_LogFile = new std::ofstream("./Messages.log", std::ios::out | std::ios::trunc);
-	if(m_LogFile->is_open())
+	uint64_t start = SysClock::monotonicMicros();
+
+	int type = static_cast<int>(msg->messageType());
+	const Handler* handler = (type >= 0 && type < MESSAGE_TYPE_COUNT) ? regNode->handlers[type].get() : NULL;
+	if(handler != NULL)
 	{
-		Logger::info("Message log file created!");
+		handler->call(regNode->nodeRef, msg);
 	}
 	else
 	{
-		Logger::error("Message log file not created!");
-		delete m_LogFile;
-		m_LogFile = NULL;
+		regNode->nodeRef.processMessage(msg);
 	}
-#endif
+
+	uint64_t end = SysClock::monotonicMicros();
+
+	regNode->handlerTime.record(end - start);
+	traceConsumer(msg, regNode->nodeRef.nodeID(), end, end - start);
 }
 
-void MessageBus::logMessageReceived(Message* msg)
+void MessageBus::postToMailbox(RegisteredNode* regNode, const std::shared_ptr<const Message>& msg)
 {
-#ifdef LOG_MESSAGES
-	msg->timeReceived = SysClock::timeStamp();
-#endif
+	bool needsWorker = false;
+	{
+		std::lock_guard<std::mutex> lock(regNode->mailboxMutex);
+
+		// There is at most one older message with the same key waiting
+		int key = conflationKey(msg.get());
+		int type = static_cast<int>(msg->messageType());
+		if(key >= 0)
+		{
+			for(auto it = regNode->mailbox.begin(); it != regNode->mailbox.end(); ++it)
+			{
+				if(conflationKey(it->get()) == key)
+				{
+					m_Conflated[type].fetch_add(1, std::memory_order_relaxed);
+					regNode->mailbox.erase(it);
+					regNode->mailboxQueued[type]--;
+					break;
+				}
+			}
+		}
+
+		if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+		{
+			const QueueLimit& limit = m_QueueLimits[type];
+			if(limit.capacity > 0 && regNode->mailboxQueued[type] >= limit.capacity)
+			{
+				if(not regNode->mailboxOverloaded[type])
+				{
+					regNode->mailboxOverloaded[type] = true;
+					overloadStarted(type);
+				}
+				m_Dropped[type].fetch_add(1, std::memory_order_relaxed);
+				regNode->dropped.fetch_add(1, std::memory_order_relaxed);
+
+				// The bus thread mustn't wait for a node, a full mailbox of a blocking type
+				// drops the new message
+				if(limit.policy != OverflowPolicy::DropOldest)
+				{
+					return;
+				}
+
+				for(auto it = regNode->mailbox.begin(); it != regNode->mailbox.end(); ++it)
+				{
+					if((*it)->messageType() == msg->messageType())
+					{
+						regNode->mailbox.erase(it);
+						break;
+					}
+				}
+				regNode->mailboxQueued[type]--;
+			}
+			regNode->mailboxQueued[type]++;
+		}
+
+		regNode->mailbox.push_back(msg);
+		regNode->mailboxDepth.store(regNode->mailbox.size());
+
+		if(not regNode->scheduled)
+		{
+			regNode->scheduled = true;
+			needsWorker = true;
+		}
+	}
+
+	if(needsWorker)
+	{
+		std::lock_guard<std::mutex> lock(m_WorkerMutex);
+		m_ReadyNodes.push(regNode);
+		m_WorkerCondition.notify_one();
+	}
 }
 
-void MessageBus::logMessage(Message* msg)
+void MessageBus::runMailbox(RegisteredNode* regNode)
 {
-#ifdef LOG_MESSAGES
-	if(m_LogFile != NULL)
+	for(int i = 0; i < MAILBOX_BATCH; i++)
 	{
-		char buff[256];
+		std::shared_ptr<const Message> msg;
+		{
+			std::lock_guard<std::mutex> lock(regNode->mailboxMutex);
+			if(regNode->mailbox.empty())
+			{
+				regNode->scheduled = false;
+				return;
+			}
+			msg = std::move(regNode->mailbox.front());
+			regNode->mailbox.pop_front();
+			regNode->handling.fetch_add(1);
+			regNode->mailboxDepth.store(regNode->mailbox.size());
 
-		snprintf(buff, 256, "[%s] Type=%s(%d) SourceID=%d Destination=%d Received=%s", 	SysClock::hh_mm_ss_ms().c_str(),
-																						msgToString(msg->messageType()).c_str(),
-																						(int) msg->messageType(), (int) msg->sourceID(),
-																						(int) msg->destinationID(),
-																						SysClock::hh_mm_ss_ms(msg->timeReceived).c_str());
-		*m_LogFile << buff << "\n";
-		m_LogFile->flush();
+			int type = static_cast<int>(msg->messageType());
+			if(type >= 0 && type < MESSAGE_TYPE_COUNT)
+			{
+				regNode->mailboxQueued[type]--;
+				if(regNode->mailboxOverloaded[type] &&
+					regNode->mailboxQueued[type] <= m_QueueLimits[type].capacity / 2)
+				{
+					regNode->mailboxOverloaded[type] = false;
+					overloadEnded(type);
+				}
+			}
+		}
+
+		deliver(regNode, msg.get());
+		regNode->handling.fetch_sub(1);
+	}
+
+	// Still scheduled, give the other nodes a go first
+	std::lock_guard<std::mutex> lock(m_WorkerMutex);
+	m_ReadyNodes.push(regNode);
+	m_WorkerCondition.notify_one();
+}
+
+void MessageBus::workerThread()
+{
+	while(true)
+	{
+		RegisteredNode* regNode;
+		{
+			std::unique_lock<std::mutex> lock(m_WorkerMutex);
+			m_WorkerCondition.wait(lock, [this]() {
+				return not m_ReadyNodes.empty() || not m_WorkersRunning;
+			});
+
+			// Only stop once all the mail has been handed out
+			if(m_ReadyNodes.empty())
+			{
+				return;
+			}
+			regNode = m_ReadyNodes.front();
+			m_ReadyNodes.pop();
+		}
+
+		runMailbox(regNode);
 	}
-#endif
 }
 
-void MessageBus::logMessageConsumer(NodeID id)
+void MessageBus::startWorkers()
 {
-#ifdef LOG_MESSAGES
-	if(m_LogFile != NULL)
+	if(m_WorkerCount == 0)
 	{
-		char buff[256];
+		return;
+	}
 
-		snprintf(buff, 256, "\t%s Consumed by Node: %s(%d)", SysClock::hh_mm_ss_ms().c_str(), nodeToString(id).c_str(), (int) id);
-		*m_LogFile << buff << "\n";
-		m_LogFile->flush();
+	m_WorkersRunning = true;
+	for(unsigned int i = 0; i < m_WorkerCount; i++)
+	{
+		m_Workers.push_back(std::thread(&MessageBus::workerThread, this));
 	}
-#endif
+	Logger::info("MessageBus running node handlers on %d workers", m_WorkerCount);
 }
 
-void MessageBus::messageTimeStamp(unsigned long unixTime, char* buffer)
+void MessageBus::stopWorkers()
 {
-	char buff[9];
-	time_t unix_time = (time_t)unixTime;
-	strftime(buff, 9, "%H:%M:%S", gmtime(&unix_time));
+	{
+		std::lock_guard<std::mutex> lock(m_WorkerMutex);
+		m_WorkersRunning = false;
+		m_WorkerCondition.notify_all();
+	}
 
-	// Get Milliseconds
-	timeval curTime;
-	gettimeofday(&curTime, NULL);
-	int milli = curTime.tv_usec / 1000;
+	for(auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+	m_Workers.clear();
+}
 
-	sprintf(buffer, "%s:%d", buff, milli);
+void MessageBus::startMessageTrace()
+{
+#if MESSAGE_BUS_TRACE == 1
+	m_Trace.start("./Messages.trace");
+#endif
+}
 
+void MessageBus::traceDispatch(const Message* msg, uint64_t now)
+{
+#if MESSAGE_BUS_TRACE == 1
+	// Zeroed so the padding doesn't carry stack contents into the trace file
+	MessageTraceRecord record = {};
+	record.time = now;
+	record.enqueued = msg->timeEnqueued;
+	record.messageType = static_cast<uint16_t>(msg->messageType());
+	record.kind = static_cast<uint8_t>(MessageTraceKind::Dispatch);
+	record.source = static_cast<uint8_t>(msg->sourceID());
+	record.destination = static_cast<uint8_t>(msg->destinationID());
+	m_Trace.record(record);
+#endif
+}
+
+void MessageBus::traceConsumer(const Message* msg, NodeID id, uint64_t end, uint64_t duration)
+{
+#if MESSAGE_BUS_TRACE == 1
+	MessageTraceRecord record = {};
+	record.time = end;
+	record.enqueued = msg->timeEnqueued;
+	record.duration = static_cast<uint32_t>(duration);
+	record.messageType = static_cast<uint16_t>(msg->messageType());
+	record.kind = static_cast<uint8_t>(MessageTraceKind::Consumed);
+	record.source = static_cast<uint8_t>(msg->sourceID());
+	record.destination = static_cast<uint8_t>(msg->destinationID());
+	record.consumer = static_cast<uint8_t>(id);
+	m_Trace.record(record);
+#endif
 }
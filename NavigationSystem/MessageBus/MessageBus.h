@@ -12,26 +12,59 @@
  *		reduce the number of thread locks in place and because once the system has
  *		started its very rare that a node should be registered afterwards on the fly.
  *
+ *		The behaviour for a message type (its priority lane, conflation and queue limit)
+ *		is set before run(), see the setters below. Building with
+ *		MESSAGE_BUS_LOCK_FREE_QUEUE=1 selects the lock free queue, see MessageQueue.h.
+ *		MESSAGE_BUS_TRACE=1 writes every message to Messages.trace, see MessageTrace.h.
+ *
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Node.h"
+#include "MessageBus/Blackboard.h"
+#include "MessageBus/CausalTracer.h"
 #include "MessageBus/Message.h"
+#include "MessageBus/MessagePool.h"
+#include "MessageBus/MessageRecorder.h"
+#include "MessageBus/MessageQueue.h"
+#include "MessageBus/MessageTrace.h"
+#include "MessageBus/TickScheduler.h"
+#include "SystemServices/DeadlineTimer.h"
+#include "SystemServices/LatencyHistogram.h"
 #include <vector>
 #include <queue>
+#include <deque>
 #include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 #include <memory>
-#include <iostream>
-#include <fstream>
 #include <atomic>
 
 
-typedef std::unique_ptr<Message> MessagePtr;
+class Node;
 
 
-class Node;
+enum class MessagePriority {
+	High = 0,
+	Normal
+};
+
+const int MESSAGE_PRIORITY_COUNT = 2;
+
+enum class OverflowPolicy {
+	DropOldest,		// The oldest waiting message of the type makes room
+	DropNewest,		// The message that doesn't fit is dropped
+	Block			// The sender waits for room
+};
+
+#if MESSAGE_BUS_LOCK_FREE_QUEUE == 1
+typedef LockFreeMessageQueue FrontMessageQueue;
+#else
+typedef LockedMessageQueue FrontMessageQueue;
+#endif
 
 
 class MessageBus {
@@ -65,6 +98,36 @@ public:
  	///----------------------------------------------------------------------------------
 	bool registerNode(Node& node, MessageType msgType);
 
+	///----------------------------------------------------------------------------------
+ 	/// Subscribes a node to a message class, its messages are then handed to the
+ 	/// handler instead of Node::processMessage(). Has to be called before run(),
+ 	/// returns false otherwise. For example:
+ 	///
+ 	///		msgBus.subscribe(*this, &WindStateNode::processWindMessage);
+ 	///
+ 	/// where processWindMessage() takes a const WindDataMsg&. Directed messages of the
+ 	/// class go to the handler as well. The handler gets the message with its class
+ 	/// already known, without a cast or a switch on the type in the node. A node can
+ 	/// use typed handlers for some types and processMessage() for the others.
+ 	///
+ 	/// @param node 			The node that should be registered.
+ 	/// @param handler 			The member function the messages are passed to.
+ 	///----------------------------------------------------------------------------------
+	template<class T, class NodeT>
+	bool subscribe(NodeT& node, void (NodeT::*handler)(const T&))
+	{
+		if(m_Running.load())
+		{
+			return false;
+		}
+
+		RegisteredNode* regNode = getRegisteredNode(node);
+		regNode->subscribe(T::TYPE);
+
+		regNode->handlers[static_cast<int>(T::TYPE)].reset(new TypedHandler<NodeT, T>(handler));
+		return true;
+	}
+
 	///----------------------------------------------------------------------------------
  	/// Enqueues a message onto the message queue for distribution through the message
  	/// bus.
@@ -74,22 +137,352 @@ public:
  	///----------------------------------------------------------------------------------
 	void sendMessage(MessagePtr msg);
 
+	///----------------------------------------------------------------------------------
+ 	/// Creates a message using the pool of its message class, the memory goes back to
+ 	/// the pool once the message has been distributed. Use instead of std::make_unique
+ 	/// for messages that are sent often.
+ 	///----------------------------------------------------------------------------------
+	template<class T, class... Args>
+	static MessagePtr make(Args&&... args)
+	{
+		return MessagePool<T>::instance().make(std::forward<Args>(args)...);
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Allocates pooled messages of a class up front, see MessagePool::reserve().
+ 	///----------------------------------------------------------------------------------
+	template<class T>
+	static void reserve(size_t count)
+	{
+		MessagePool<T>::instance().reserve(count);
+	}
+
 	///----------------------------------------------------------------------------------
  	/// Begins running the message bus and distributing messages to nodes that have been
- 	/// registered. This function won't ever return.
+ 	/// registered. This function returns once stop() is called.
+ 	///
+ 	/// The subscriptions are turned into dispatch tables here, a message only touches
+ 	/// the nodes that want it. The bus thread sleeps until sendMessage() wakes it up.
  	///----------------------------------------------------------------------------------
 	void run();
 
+	///----------------------------------------------------------------------------------
+ 	/// Stops the message bus, run() returns once the current messages have been
+ 	/// distributed.
+ 	///----------------------------------------------------------------------------------
 	void stop();
+
+	///----------------------------------------------------------------------------------
+ 	/// Sets how long the message bus waits after being woken up before it distributes
+ 	/// messages. Zero, the default, distributes messages as soon as they arrive. A
+ 	/// larger window reduces the number of wake ups for low power operation.
+ 	///
+ 	/// @param milliseconds 	The length of the batching window.
+ 	///----------------------------------------------------------------------------------
+	void setBatchingWindow(unsigned int milliseconds);
+
+	///----------------------------------------------------------------------------------
+ 	/// Puts a message type into a priority lane. Has to be called before run(), returns
+ 	/// false otherwise.
+ 	///
+ 	/// The high priority lane has its own queue. It is always emptied first and checked
+ 	/// again between the messages of the normal lane, so control commands don't wait
+ 	/// behind a burst of AIS data. The rudder, sail, wingsail and local navigation
+ 	/// commands are high priority by default. With the worker pool a node's mailbox is
+ 	/// still first come first served.
+ 	///
+ 	/// @param msgType 			The message type to move.
+ 	/// @param priority 		The lane its messages go through.
+ 	///----------------------------------------------------------------------------------
+	bool setPriority(MessageType msgType, MessagePriority priority);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the priority lane of a message type.
+ 	///----------------------------------------------------------------------------------
+	MessagePriority priority(MessageType msgType) const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Turns conflation on or off for a message type, only the newest undelivered
+ 	/// message of a type, source and destination is then distributed. Has to be called
+ 	/// before run(), returns false otherwise.
+ 	///
+ 	/// For types that only matter as their newest value. A message waiting in the bus
+ 	/// queues or in a mailbox is dropped once a newer one is queued behind it. Compass,
+ 	/// GPS, wind and vessel state messages are conflated by default.
+ 	///----------------------------------------------------------------------------------
+	bool setConflation(MessageType msgType, bool conflate);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns true if messages of a type are conflated.
+ 	///----------------------------------------------------------------------------------
+	bool conflates(MessageType msgType) const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Limits the number of messages of a type that can wait in the message bus queues,
+ 	/// and in each node's mailbox. Has to be called before run(), returns false
+ 	/// otherwise. The queues are unbounded by default.
+ 	///
+ 	/// With DropOldest the bus drops the oldest messages when it reaches them. While
+ 	/// the bus thread is held up, up to twice the capacity can wait. A sender of a
+ 	/// Block type waits for room for at most SEND_BLOCK_TIMEOUT_MS, then the message
+ 	/// is dropped. Nodes running on the bus thread never wait, and neither does the
+ 	/// bus thread. A full mailbox drops the new message.
+ 	///
+ 	/// @param msgType 			The message type to limit.
+ 	/// @param capacity 		How many of its messages can wait, zero removes the limit.
+ 	/// @param policy 			What happens to a message that doesn't fit.
+ 	///----------------------------------------------------------------------------------
+	bool setQueueLimit(MessageType msgType, size_t capacity, OverflowPolicy policy);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the capacity of a message type's queues, zero if they are unbounded.
+ 	///----------------------------------------------------------------------------------
+	size_t queueLimit(MessageType msgType) const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns true while a queue of the message type is full or still draining, until
+ 	/// it is down to half its capacity. A publisher can hold back messages that can
+ 	/// wait, can be called from any thread.
+ 	///----------------------------------------------------------------------------------
+	bool isOverloaded(MessageType msgType) const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns true while any message type is overloaded.
+ 	///----------------------------------------------------------------------------------
+	bool isOverloaded() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Copies the snapshot() of every message of a type onto the blackboard as it is
+ 	/// sent. T is the message class, its Snapshot is what readers of the blackboard get
+ 	/// back. Has to be called before run(), returns false otherwise. The vessel and
+ 	/// wind state are shared by default.
+ 	///----------------------------------------------------------------------------------
+	template<class T>
+	bool share(MessageType msgType)
+	{
+		if(m_Running.load())
+		{
+			return false;
+		}
+		m_BlackboardWriters[static_cast<int>(msgType)] = &MessageBus::writeSnapshot<T>;
+		return true;
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// The latest value of the shared message types, can be read from any thread. A
+ 	/// node that only needs the current state in its loop reads it here instead of
+ 	/// subscribing, see Blackboard.h.
+ 	///----------------------------------------------------------------------------------
+	const Blackboard& blackboard() const { return m_Blackboard; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the histogram of the time messages spent in the queue, from
+ 	/// sendMessage() until they are distributed.
+ 	///----------------------------------------------------------------------------------
+	const LatencyHistogram& dispatchLatency() const { return m_DispatchLatency; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the histogram of the time messages of one priority lane spent in the
+ 	/// queue.
+ 	///----------------------------------------------------------------------------------
+	const LatencyHistogram& laneLatency(MessagePriority priority) const
+	{
+		return m_LaneLatency[static_cast<int>(priority)];
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Records every message the bus distributes to a file until the bus stops. Has to
+ 	/// be called before run(), returns false otherwise or if the file couldn't be
+ 	/// created. MessageReplay feeds a recording back into a message bus, see
+ 	/// MessageRecorder.h.
+ 	///----------------------------------------------------------------------------------
+	bool startRecording(const std::string& filePath);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the number of messages sent but not yet handled by their nodes, including
+ 	/// the ones waiting in the mailboxes of the worker pool and the ones a worker is
+ 	/// handling. Zero means the nodes are done with everything sent so far.
+ 	///----------------------------------------------------------------------------------
+	uint64_t pendingMessages() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Runs the node handlers on a pool of worker threads, each node gets its own
+ 	/// mailbox. Has to be called before run(), returns false otherwise.
+ 	///
+ 	/// Without it the nodes run on the bus thread, and a node that blocks holds up all
+ 	/// the others. With it the bus thread only fills the mailboxes. A node only runs on
+ 	/// one worker at a time, so it still gets its messages one by one and in order.
+ 	///
+ 	/// @param workerCount 		The number of worker threads, zero keeps the handlers
+ 	///							on the message bus thread.
+ 	///----------------------------------------------------------------------------------
+	bool enableWorkerPool(unsigned int workerCount);
+
+	///----------------------------------------------------------------------------------
+ 	/// The work done for a registered node so far.
+ 	///----------------------------------------------------------------------------------
+	struct NodeStats {
+		NodeID 		id;
+		size_t 		queueDepth;			// Messages waiting in the node's mailbox
+		uint64_t 	dropped;			// Messages that didn't fit into the mailbox
+		uint64_t 	messagesHandled;
+		uint64_t 	handlerTimeTotalUs;	// Time spent in processMessage()
+		uint64_t 	handlerTimeMaxUs;
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the statistics of every registered node, in registration order.
+ 	///----------------------------------------------------------------------------------
+	std::vector<NodeStats> nodeStats() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// How well a control loop keeps to its deadlines.
+ 	///----------------------------------------------------------------------------------
+	struct LoopStats {
+		NodeID 		id;
+		uint64_t 	periodUs;
+		uint64_t 	loops;
+		uint64_t 	missed;				// Loops that finished after their deadline
+		uint64_t 	skipped;			// Deadlines dropped after a missed one
+		uint64_t 	jitterP99Us;		// Start of a loop after its deadline
+		uint64_t 	jitterMaxUs;
+		uint64_t 	missedByMaxUs;		// End of a missed loop after its deadline
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// A snapshot of the message bus load.
+ 	///----------------------------------------------------------------------------------
+	struct Stats {
+		std::vector<uint64_t> 	published;			// Messages sent, indexed by MessageType
+		std::vector<uint64_t> 	conflated;			// Stale messages dropped, indexed by
+													// MessageType. A message dropped from
+													// several mailboxes counts once each.
+		std::vector<uint64_t> 	dropped;			// Messages over the queue limit, indexed
+													// by MessageType. Counts once for each
+													// queue the message was dropped from.
+		std::vector<MessageType> overloaded;		// Types overloaded right now
+		std::vector<NodeStats> 	nodes;
+		size_t 					frontQueueHighWater;	// Most messages waiting to be
+		size_t 					backQueueHighWater;		// picked up / distributed
+		uint64_t 				latencyCount;		// Enqueue to dispatch latency
+		double 					latencyMeanUs;
+		uint64_t 				latencyP50Us;
+		uint64_t 				latencyP90Us;
+		uint64_t 				latencyP99Us;
+		uint64_t 				latencyMaxUs;
+		uint64_t 				laneLatencyP99Us[MESSAGE_PRIORITY_COUNT];	// Indexed by
+		uint64_t 				laneLatencyMaxUs[MESSAGE_PRIORITY_COUNT];	// MessagePriority
+		uint64_t 				poolHits;			// All the message pools together
+		uint64_t 				poolMisses;
+		uint64_t 				traceDropped;		// Message trace records lost
+		std::vector<TickScheduler::TickStats> ticks;	// Periodic nodes
+		std::vector<LoopStats> 	loops;				// Control loops
+		std::vector<CausalTracer::PathStats> causalPaths;	// Sensor to actuator latency
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the current statistics, can be called from any thread.
+ 	///----------------------------------------------------------------------------------
+	Stats statistics() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Writes the current statistics to the Logger.
+ 	///----------------------------------------------------------------------------------
+	void logStatistics() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Makes the message bus write its statistics to the Logger every few seconds.
+ 	///
+ 	/// @param seconds 			Time between two dumps, zero (the default) turns the
+ 	///							dump off.
+ 	///----------------------------------------------------------------------------------
+	void setStatisticsInterval(unsigned int seconds);
+
+	///----------------------------------------------------------------------------------
+ 	/// The scheduler that runs the ticks of periodic active nodes. The nodes started
+ 	/// with ActiveNode::runPeriodic() share it instead of running a thread each.
+ 	///----------------------------------------------------------------------------------
+	TickScheduler& tickScheduler() { return m_TickScheduler; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Keeps the sensor to actuator latency, the actuator nodes record their commands
+ 	/// with it. Every message carries the cause chain it was made from, see Message.h.
+ 	///----------------------------------------------------------------------------------
+	CausalTracer& causalTracer() { return m_CausalTracer; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Adds the deadline timer of a node's control loop to the statistics, until it is
+ 	/// removed again. For the loops that keep a thread of their own. The timer has to
+ 	/// outlive its registration.
+ 	///----------------------------------------------------------------------------------
+	void addControlLoop(NodeID id, const DeadlineTimer& timer);
+	void removeControlLoop(const DeadlineTimer& timer);
 private:
+	typedef void (*BlackboardWriter)(Blackboard& blackboard, const Message* msg);
+
+	template<class T>
+	static void writeSnapshot(Blackboard& blackboard, const Message* msg)
+	{
+		blackboard.write(msg->messageType(), static_cast<const T*>(msg)->snapshot(), msg->asCause());
+	}
+
+	struct Handler {
+		virtual ~Handler() { }
+		virtual void call(Node& node, const Message* msg) const = 0;
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// Holds a handler given to subscribe() with the node and message types it was
+ 	/// given with. One is instantiated per node class and message class.
+ 	///----------------------------------------------------------------------------------
+	template<class NodeT, class T>
+	struct TypedHandler : public Handler {
+		typedef void (NodeT::*Method)(const T&);
+
+		TypedHandler(Method method) : m_Method(method) { }
+
+		void call(Node& node, const Message* msg) const
+		{
+			(static_cast<NodeT&>(node).*m_Method)(*static_cast<const T*>(msg));
+		}
+
+		Method m_Method;
+	};
+
 	///----------------------------------------------------------------------------------
  	/// Stores information about a registered node and the message types it is interested
  	/// in.
  	///----------------------------------------------------------------------------------
 	struct RegisteredNode {
-		RegisteredNode(Node& node) : nodeRef(node) { }
+		RegisteredNode(Node& node) : nodeRef(node), mailboxDepth(0), handling(0), scheduled(false), dropped(0)
+		{
+			for(int type = 0; type < MESSAGE_TYPE_COUNT; type++)
+			{
+				mailboxQueued[type] = 0;
+				mailboxOverloaded[type] = false;
+			}
+		}
 
 		Node& nodeRef;
+		std::unique_ptr<Handler> handlers[MESSAGE_TYPE_COUNT];	// Indexed by MessageType, NULL
+																// if the node uses
+																// processMessage()
+
+		// Only used with the worker pool
+		std::mutex 									mailboxMutex;
+		std::deque<std::shared_ptr<const Message>> 	mailbox;
+		std::atomic<size_t> 						mailboxDepth;
+		std::atomic<size_t> 						handling;		// Taken out of the mailbox
+																	// and not handled yet
+		bool 										scheduled;		// Waiting for or running
+																	// on a worker, guarded
+																	// by mailboxMutex.
+		// Messages of each type in the mailbox and whether the type is overloaded in it,
+		// indexed by MessageType and guarded by mailboxMutex
+		size_t 										mailboxQueued[MESSAGE_TYPE_COUNT];
+		bool 										mailboxOverloaded[MESSAGE_TYPE_COUNT];
+		std::atomic<uint64_t> 						dropped;		// No room in the mailbox
+		LatencyHistogram 							handlerTime;
 
 		///------------------------------------------------------------------------------
  		/// Returns true if a registered node is interested in a message type.
@@ -128,51 +521,197 @@ private:
 	RegisteredNode* getRegisteredNode(Node& node);
 
 	///----------------------------------------------------------------------------------
- 	/// Goes through the back message queue and distributes messages, calling
- 	/// Node::processMessage(Message*) on nodes that are interested in any given message.
+ 	/// Builds the per message type subscriber lists and the per NodeID table used for
+ 	/// directed messages. Registration is closed once the bus runs so this only needs
+ 	/// to be done once.
+ 	///----------------------------------------------------------------------------------
+	void buildDispatchTables();
+
+	///----------------------------------------------------------------------------------
+ 	/// Logs the statistics if the statistics interval has passed since the last time.
+ 	///----------------------------------------------------------------------------------
+	void logStatisticsIfDue(std::chrono::steady_clock::time_point& nextDump);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns true if there are messages waiting in any of the front queues.
+ 	///----------------------------------------------------------------------------------
+	bool hasFrontMessages() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Goes through the back message queues and distributes messages, the high priority
+ 	/// lane first. New high priority messages are picked up between two normal ones.
  	///----------------------------------------------------------------------------------
 	void processMessages();
 
 	///----------------------------------------------------------------------------------
-	/// Creates a log file for the messages.
+ 	/// Distributes a message, calling Node::processMessage(Message*) on nodes that are
+ 	/// interested in it.
+ 	///----------------------------------------------------------------------------------
+	void processMessage(MessagePtr msgPtr, MessagePriority priority);
+
 	///----------------------------------------------------------------------------------
-	void startMessageLog();
+ 	/// Checks a message being sent against the queue limit of its type, waits for room
+ 	/// if the type blocks. Returns false if the message has to be dropped.
+ 	///----------------------------------------------------------------------------------
+	bool admit(int type);
 
 	///----------------------------------------------------------------------------------
-	/// Logs that a message was received.
+ 	/// Waits until a message of a blocking type fits into the queue, or the timeout.
+ 	///----------------------------------------------------------------------------------
+	bool waitForRoom(int type);
+
 	///----------------------------------------------------------------------------------
-	void logMessageReceived(Message* msg);
+ 	/// Takes a message out of the count of its type's waiting messages, wakes up the
+ 	/// blocked senders and ends the overload once the queue has drained. Returns the
+ 	/// number of messages of the type still waiting.
+ 	///----------------------------------------------------------------------------------
+	size_t dequeued(int type);
 
 	///----------------------------------------------------------------------------------
-	/// Logs a message that is being processed.
+ 	/// Called for every message taken off a back queue, returns false if it has to
+ 	/// make room for the newer ones of a DropOldest type waiting behind it.
+ 	///----------------------------------------------------------------------------------
+	bool leaveQueue(const Message* msg);
+
 	///----------------------------------------------------------------------------------
-	void logMessage(Message* msg);
+ 	/// Counts a full queue of a message type, the type is overloaded while there is at
+ 	/// least one.
+ 	///----------------------------------------------------------------------------------
+	void overloadStarted(int type);
+	void overloadEnded(int type);
 
 	///----------------------------------------------------------------------------------
-	/// Logs that a node consumed the current message being processed.
+ 	/// Returns a key made of the message's type, source and destination, or -1 if the
+ 	/// message isn't conflated.
+ 	///----------------------------------------------------------------------------------
+	int conflationKey(const Message* msg) const;
+
 	///----------------------------------------------------------------------------------
-	void logMessageConsumer(NodeID id);
+ 	/// Drops the messages in a back queue that have a newer message with the same
+ 	/// conflation key behind them.
+ 	///----------------------------------------------------------------------------------
+	void conflate(std::queue<MessagePtr>& messages);
 
 	///----------------------------------------------------------------------------------
-	/// Logs that the current message being processed has finished being processed.
+ 	/// Hands a message to a node, either straight away or through its mailbox when the
+ 	/// worker pool is used. The message is turned into a shared message the first time
+ 	/// it goes into a mailbox so all the nodes can hold on to it.
+ 	///----------------------------------------------------------------------------------
+	void dispatch(RegisteredNode* regNode, MessagePtr& msg, std::shared_ptr<const Message>& shared);
+
 	///----------------------------------------------------------------------------------
-	//void logMessageProcessed(Message* msg);
+ 	/// Calls the node's handler for the message type, or its processMessage() if it has
+ 	/// none, and records how long it took.
+ 	///----------------------------------------------------------------------------------
+	void deliver(RegisteredNode* regNode, const Message* msg);
 
 	///----------------------------------------------------------------------------------
-	/// Returns a message time stamp in the format HH:MM:SS:MS, a char buffer of 14
-	/// characters needs to be provided.
+ 	/// Adds a message to a node's mailbox and queues the node up for a worker if it
+ 	/// isn't already.
+ 	///----------------------------------------------------------------------------------
+	void postToMailbox(RegisteredNode* regNode, const std::shared_ptr<const Message>& msg);
+
 	///----------------------------------------------------------------------------------
-	void messageTimeStamp(unsigned long unixTime, char* buffer);
+ 	/// Runs a few messages from the node's mailbox, if there are more left the node goes
+ 	/// to the back of the ready queue so one busy node can't hog a worker.
+ 	///----------------------------------------------------------------------------------
+	void runMailbox(RegisteredNode* regNode);
+
+	///----------------------------------------------------------------------------------
+ 	/// Worker thread loop, runs nodes from the ready queue until the workers are
+ 	/// stopped and the ready queue is empty.
+ 	///----------------------------------------------------------------------------------
+	void workerThread();
+
+	void startWorkers();
+	void stopWorkers();
+
+	///----------------------------------------------------------------------------------
+	/// Creates the message trace file and starts writing to it.
+	///----------------------------------------------------------------------------------
+	void startMessageTrace();
+
+	///----------------------------------------------------------------------------------
+	/// Traces that a message is being distributed.
+	///----------------------------------------------------------------------------------
+	void traceDispatch(const Message* msg, uint64_t now);
+
+	///----------------------------------------------------------------------------------
+	/// Traces that a node consumed a message.
+	///----------------------------------------------------------------------------------
+	void traceConsumer(const Message* msg, NodeID id, uint64_t end, uint64_t duration);
 
 	std::vector<RegisteredNode*> 	m_RegisteredNodes;
-	std::queue<MessagePtr>* 		m_FrontMessages; 	// The forward facing message queue
-													 	// which messages are append to.
-	std::queue<MessagePtr>*			m_BackMessages; 	// The backend message queue which
-														// contains messages to distribute.
-	std::mutex						m_FrontQueueMutex;	// Guards the front message queue.
+	std::vector<std::vector<RegisteredNode*>> m_Subscribers;	// Indexed by MessageType
+	std::vector<RegisteredNode*>	m_DirectNodes;		// Indexed by NodeID
+	// The forward facing message queues which messages are appended to, and the backend
+	// message queues which contain the messages to distribute. One per priority lane.
+	FrontMessageQueue		 		m_FrontMessages[MESSAGE_PRIORITY_COUNT];
+	std::queue<MessagePtr>			m_BackMessages[MESSAGE_PRIORITY_COUNT];
+	MessagePriority					m_Priorities[MESSAGE_TYPE_COUNT];	// Lane of each type
+	bool							m_Conflate[MESSAGE_TYPE_COUNT];
+
+	struct QueueLimit {
+		size_t 						capacity;			// Zero if unbounded
+		OverflowPolicy 				policy;
+	};
+
+	QueueLimit						m_QueueLimits[MESSAGE_TYPE_COUNT];
+	std::atomic<uint64_t>			m_Dropped[MESSAGE_TYPE_COUNT];
+	std::atomic<bool>				m_BusOverloaded[MESSAGE_TYPE_COUNT];	// The bus queues
+	std::atomic<int>				m_OverloadedQueues[MESSAGE_TYPE_COUNT];	// Bus and mailboxes
+	std::mutex						m_SpaceMutex;		// Used with m_SpaceCondition
+	std::condition_variable			m_SpaceCondition;	// Signalled when a message leaves
+														// the queue while senders wait.
+	std::atomic<int>				m_BlockedSenders;
+	std::thread::id					m_BusThread;
+	std::atomic<uint64_t>			m_Conflated[MESSAGE_TYPE_COUNT];
+	BlackboardWriter				m_BlackboardWriters[MESSAGE_TYPE_COUNT];	// NULL if the type
+	Blackboard						m_Blackboard;								// isn't shared
+	std::vector<MessagePtr>			m_ConflationScratch;
+	std::vector<uint32_t>			m_ConflationSeen;	// Pass in which a key was last seen,
+	uint32_t						m_ConflationPass;	// indexed by conflation key
+	std::mutex						m_WakeMutex;		// Used with m_WakeCondition
+	std::condition_variable			m_WakeCondition;	// Signalled when a message is
+														// queued or the bus is stopped.
+	std::atomic<bool>				m_Sleeping;			// The bus thread is about to wait
 	std::atomic<bool>				m_Running;
+	std::atomic<unsigned int>		m_BatchingWindowMs;
+	LatencyHistogram				m_DispatchLatency;	// Enqueue to dispatch latency
+	LatencyHistogram				m_LaneLatency[MESSAGE_PRIORITY_COUNT];
+
+	// Padded so counters of types sent by different threads don't share a cache line
+	struct PublishCounter {
+		std::atomic<uint64_t> 		count;
+		std::atomic<size_t> 		queued;				// In the front and back queues
+		char 						padding[48];
+	};
 
-#ifdef LOG_MESSAGES
-	std::ofstream* 					m_LogFile;
+	PublishCounter					m_Published[MESSAGE_TYPE_COUNT];
+	std::atomic<uint64_t>			m_NextMessageID;
+	std::atomic<uint64_t>			m_Distributed;		// Messages taken off the back
+														// queues, conflated ones too
+	std::atomic<size_t>				m_FrontHighWater;
+	std::atomic<size_t>				m_BackHighWater;
+	std::atomic<unsigned int>		m_StatisticsIntervalS;
+
+	unsigned int					m_WorkerCount;
+	std::vector<std::thread>		m_Workers;
+	std::queue<RegisteredNode*>		m_ReadyNodes;		// Nodes with mail waiting for a
+														// worker.
+	std::mutex						m_WorkerMutex;		// Guards m_ReadyNodes
+	std::condition_variable			m_WorkerCondition;
+	bool							m_WorkersRunning;	// Guarded by m_WorkerMutex
+
+	MessageRecorder					m_Recorder;			// Only written by the bus thread
+
+#if MESSAGE_BUS_TRACE == 1
+	MessageTrace					m_Trace;
 #endif
+
+	TickScheduler					m_TickScheduler;
+	CausalTracer					m_CausalTracer;
+
+	mutable std::mutex				m_ControlLoopMutex;	// Guards m_ControlLoops
+	std::vector<std::pair<NodeID, const DeadlineTimer*>> m_ControlLoops;
 };
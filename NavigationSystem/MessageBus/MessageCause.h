@@ -0,0 +1,65 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageCause.h
+ *
+ * Purpose:
+ *		Describes where the data of a message came from: the message it was made from,
+ *		the chain of message types back to the first message and when that first message
+ *		was sent. A rudder command made from a LocalNavigationMsg, made from a
+ *		StateMessage, made from a CompassDataMsg has the chain
+ *
+ *			CompassData > StateMessage > LocalNavigation
+ *
+ *		and the time the compass data was sent as its origin time.
+ *
+ * Developer Notes:
+ *		Plain old data so it can be kept on the Blackboard next to a value. Only the
+ *		first MAX_CHAIN message types of a chain are kept, chainLength carries on
+ *		counting.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/MessageTypes.h"
+#include <stdint.h>
+
+
+static_assert(MESSAGE_TYPE_COUNT <= 256, "MessageCause keeps message types in a byte");
+
+
+struct MessageCause {
+	static const int MAX_CHAIN = 7;
+
+	MessageCause() : causeID(0), originTime(0), chainLength(0) { }
+
+	///----------------------------------------------------------------------------------
+ 	/// False for a message that hasn't been sent yet and wasn't made from another one.
+ 	///----------------------------------------------------------------------------------
+	bool known() const { return originTime != 0; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the cause that started the earliest, for data made from several
+ 	/// messages. The latency measured from it is how old the oldest input was.
+ 	///----------------------------------------------------------------------------------
+	static const MessageCause& oldest(const MessageCause& a, const MessageCause& b)
+	{
+		if(not a.known())
+		{
+			return b;
+		}
+		if(not b.known())
+		{
+			return a;
+		}
+		return (b.originTime < a.originTime) ? b : a;
+	}
+
+	uint64_t 	causeID;				// Message ID of the message this was made from, zero
+										// if none
+	uint64_t 	originTime;				// Monotonic time in microseconds the first message
+										// of the chain was sent
+	uint8_t 	chain[MAX_CHAIN];		// Message types from the first message to the cause
+	uint8_t 	chainLength;
+};
@@ -13,10 +13,10 @@
 
 
 #include "MessageBus/MessageDeserialiser.h"
-#include <cstring>
+#include "MessageBus/LittleEndian.h"
 
 
-MessageDeserialiser::MessageDeserialiser(uint8_t* data, uint8_t size)
+MessageDeserialiser::MessageDeserialiser(uint8_t* data, uint16_t size)
 	:m_data(data), m_index(0), m_size(size)
 {
 
@@ -29,11 +29,10 @@ MessageDeserialiser::~MessageDeserialiser()
 
 bool MessageDeserialiser::readUint8_t(uint8_t& data)
 {
-	if(m_index + sizeof(uint8_t) <= m_size)
+	const uint8_t* ptr = take(sizeof(data));
+	if(ptr != NULL)
 	{
-
-		data = m_data[m_index];
-		m_index++;
+		data = LittleEndian::readUint8(ptr);
 		return true;
 	}
 
@@ -42,16 +41,10 @@ bool MessageDeserialiser::readUint8_t(uint8_t& data)
 
 bool MessageDeserialiser::readUint16_t(uint16_t& data)
 {
-	if(m_index + sizeof(uint16_t) <= m_size)
+	const uint8_t* ptr = take(sizeof(data));
+	if(ptr != NULL)
 	{
-		data = 0;
-		for(unsigned int i = 0; i < sizeof(uint16_t); i++)
-		{
-			data = data | (m_data[m_index] << (8 * (i)));
-			m_index++;
-
-		}
-
+		data = LittleEndian::readUint16(ptr);
 		return true;
 	}
 
@@ -60,16 +53,10 @@ bool MessageDeserialiser::readUint16_t(uint16_t& data)
 
 bool MessageDeserialiser::readUint32_t(uint32_t& data)
 {
-	if(m_index + sizeof(uint32_t) <= m_size)
+	const uint8_t* ptr = take(sizeof(data));
+	if(ptr != NULL)
 	{
-		data = 0;
-		for(unsigned int i = 0; i < sizeof(uint32_t); i++)
-		{
-			data = data | (m_data[m_index] << (8 * (i)));
-			m_index++;
-
-		}
-
+		data = LittleEndian::readUint32(ptr);
 		return true;
 	}
 
@@ -78,16 +65,10 @@ bool MessageDeserialiser::readUint32_t(uint32_t& data)
 
 bool MessageDeserialiser::readInt(int& data)
 {
-	if(m_index + sizeof(int) <= m_size)
+	const uint8_t* ptr = take(sizeof(data));
+	if(ptr != NULL)
 	{
-		data = 0;
-		for(unsigned int i = 0; i < sizeof(int); i++)
-		{
-			data = data | (m_data[m_index] << (8 * (i)));
-			m_index++;
-
-		}
-
+		data = LittleEndian::readInt(ptr);
 		return true;
 	}
 
@@ -96,13 +77,10 @@ bool MessageDeserialiser::readInt(int& data)
 
 bool MessageDeserialiser::readFloat(float& data)
 {
-	if(m_index + sizeof(float) <= m_size)
+	const uint8_t* ptr = take(sizeof(data));
+	if(ptr != NULL)
 	{
-		data = 0;
-
-		memcpy(&data, m_data + m_index, sizeof(float));
-		m_index+= sizeof(float);
-
+		data = LittleEndian::readFloat(ptr);
 		return true;
 	}
 
@@ -111,12 +89,10 @@ bool MessageDeserialiser::readFloat(float& data)
 
 bool MessageDeserialiser::readDouble(double& data)
 {
-	if(m_index + sizeof(double) <= m_size)
+	const uint8_t* ptr = take(sizeof(data));
+	if(ptr != NULL)
 	{
-		data = 0;
-		memcpy(&data, m_data + m_index, sizeof(double));
-		m_index+= sizeof(double);
-
+		data = LittleEndian::readDouble(ptr);
 		return true;
 	}
 
@@ -125,10 +101,10 @@ bool MessageDeserialiser::readDouble(double& data)
 
 bool MessageDeserialiser::readBool(bool& data)
 {
-	if(m_index + sizeof(data) <= m_size)
+	uint8_t value;
+	if(readUint8_t(value))
 	{
-		data = m_data[m_index];
-		m_index++;
+		data = value;
 		return true;
 	}
 
@@ -137,10 +113,11 @@ bool MessageDeserialiser::readBool(bool& data)
 
 bool MessageDeserialiser::readMessageType(MessageType& data)
 {
-	if(m_index + sizeof(data) <= m_size)
+	// Serialised as a single byte
+	uint8_t value;
+	if(readUint8_t(value))
 	{
-		data = (MessageType)m_data[m_index];
-		m_index++;
+		data = (MessageType)value;
 		return true;
 	}
 
@@ -149,17 +126,30 @@ bool MessageDeserialiser::readMessageType(MessageType& data)
 
 bool MessageDeserialiser::readNodeID(NodeID& data)
 {
-	if(m_index + sizeof(data) <= m_size)
+	// Serialised as a single byte
+	uint8_t value;
+	if(readUint8_t(value))
 	{
-		data = (NodeID)m_data[m_index];
-		m_index++;
+		data = (NodeID)value;
 		return true;
 	}
 
 	return false;
 }
 
-uint8_t MessageDeserialiser::size()
+const uint8_t* MessageDeserialiser::take(uint32_t size)
+{
+	if(m_index + size <= m_size)
+	{
+		const uint8_t* ptr = m_data + m_index;
+		m_index += size;
+		return ptr;
+	}
+
+	return NULL;
+}
+
+uint16_t MessageDeserialiser::size()
 {
 	return m_size;
 }
@@ -7,7 +7,8 @@
  *		Deserialises a message from a block of bytes.
  *
  * Developer Notes:
- *
+ *		Reads the little endian values written by the MessageSerialiser straight out of
+ *		the given block, it isn't copied.
  *
  ***************************************************************************************/
 
@@ -22,7 +23,7 @@
 
 class MessageDeserialiser {
 public:
-	MessageDeserialiser(uint8_t* data, uint8_t size);
+	MessageDeserialiser(uint8_t* data, uint16_t size);
 	~MessageDeserialiser();
 
 	bool readUint8_t(uint8_t& data);
@@ -36,11 +37,22 @@ public:
 	bool readNodeID(NodeID& data);
 
 	void resetInternalPtr() { m_index = 0;}
-	uint8_t size();
+	uint16_t size();
 	uint8_t* data();
-	
+
+	///----------------------------------------------------------------------------------
+	/// Number of bytes left to read.
+	///----------------------------------------------------------------------------------
+	uint16_t remaining() const { return m_size - m_index; }
+
+	///----------------------------------------------------------------------------------
+	/// Takes the next bytes of the message for the caller to read, see LittleEndian.h.
+	/// Returns NULL if there aren't that many left, nothing is taken then.
+	///----------------------------------------------------------------------------------
+	const uint8_t* take(uint32_t size);
+
 private:
 	uint8_t* 	m_data;
-	uint8_t		m_index;
-	uint8_t		m_size;
+	uint16_t	m_index;
+	uint16_t	m_size;
 };
@@ -0,0 +1,149 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageFactory.cpp
+ *
+ * Purpose:
+ *		Turns a serialised message back into a message object of the right class.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageFactory.h"
+#include "MessageBus/MessageView.h"
+#include "Messages/AISDataMsg.h"
+#include "Messages/ArduinoDataMsg.h"
+#include "Messages/ASPireActuatorFeedbackMsg.h"
+#include "Messages/CompassDataMsg.h"
+#include "Messages/CourseDataMsg.h"
+#include "Messages/DataCollectionStartMsg.h"
+#include "Messages/DataCollectionStopMsg.h"
+#include "Messages/DataRequestMsg.h"
+#include "Messages/ExternalControlMsg.h"
+#include "Messages/GPSDataMsg.h"
+#include "Messages/LidarMsg.h"
+#include "Messages/LocalConfigChangeMsg.h"
+#include "Messages/LocalNavigationMsg.h"
+#include "Messages/LocalWaypointChangeMsg.h"
+#include "Messages/MarineSensorDataMsg.h"
+#include "Messages/ObstacleVectorMsg.h"
+#include "Messages/RequestCourseMsg.h"
+#include "Messages/RudderCommandMsg.h"
+#include "Messages/SailCommandMsg.h"
+#include "Messages/ServerConfigsReceivedMsg.h"
+#include "Messages/ServerWaypointsReceivedMsg.h"
+#include "Messages/StateMessage.h"
+#include "Messages/VesselStateMsg.h"
+#include "Messages/WaypointDataMsg.h"
+#include "Messages/WindDataMsg.h"
+#include "Messages/WindStateMsg.h"
+#include "Messages/WingSailCommandMsg.h"
+
+
+MessagePtr MessageFactory::deserialise(uint8_t* data, uint16_t size)
+{
+	MessageView header(data, size);
+	if(not header.isValid())
+	{
+		return NULL;
+	}
+
+	MessageDeserialiser deserialiser(data, size);
+
+	MessagePtr msg;
+	switch(header.messageType())
+	{
+		case MessageType::DataRequest:
+			msg = std::make_unique<DataRequestMsg>(deserialiser);
+			break;
+		case MessageType::WindData:
+			msg = std::make_unique<WindDataMsg>(deserialiser);
+			break;
+		case MessageType::CompassData:
+			msg = std::make_unique<CompassDataMsg>(deserialiser);
+			break;
+		case MessageType::GPSData:
+			msg = std::make_unique<GPSDataMsg>(deserialiser);
+			break;
+		case MessageType::ServerConfigsReceived:
+			msg = std::make_unique<ServerConfigsReceivedMsg>(deserialiser);
+			break;
+		case MessageType::ServerWaypointsReceived:
+			msg = std::make_unique<ServerWaypointsReceivedMsg>(deserialiser);
+			break;
+		case MessageType::LocalConfigChange:
+			msg = std::make_unique<LocalConfigChangeMsg>(deserialiser);
+			break;
+		case MessageType::LocalWaypointChange:
+			msg = std::make_unique<LocalWaypointChangeMsg>(deserialiser);
+			break;
+		case MessageType::ArduinoData:
+			msg = std::make_unique<ArduinoDataMsg>(deserialiser);
+			break;
+		case MessageType::VesselState:
+			msg = std::make_unique<VesselStateMsg>(deserialiser);
+			break;
+		case MessageType::WaypointData:
+			msg = std::make_unique<WaypointDataMsg>(deserialiser);
+			break;
+		case MessageType::ObstacleVector:
+			msg = std::make_unique<ObstacleVectorMsg>(deserialiser);
+			break;
+		case MessageType::LidarData:
+			msg = std::make_unique<LidarMsg>(deserialiser);
+			break;
+		case MessageType::CourseData:
+			msg = std::make_unique<CourseDataMsg>(deserialiser);
+			break;
+		case MessageType::ExternalControl:
+			msg = std::make_unique<ExternalControlMsg>(deserialiser);
+			break;
+		case MessageType::RequestCourse:
+			msg = std::make_unique<RequestCourseMsg>(deserialiser);
+			break;
+		case MessageType::StateMessage:
+			msg = std::make_unique<StateMessage>(deserialiser);
+			break;
+		case MessageType::WindState:
+			msg = std::make_unique<WindStateMsg>(deserialiser);
+			break;
+		case MessageType::LocalNavigation:
+			msg = std::make_unique<LocalNavigationMsg>(deserialiser);
+			break;
+		case MessageType::ASPireActuatorFeedback:
+			msg = std::make_unique<ASPireActuatorFeedbackMsg>(deserialiser);
+			break;
+		case MessageType::MarineSensorData:
+			msg = std::make_unique<MarineSensorDataMsg>(deserialiser);
+			break;
+		case MessageType::AISData:
+			msg = std::make_unique<AISDataMsg>(deserialiser);
+			break;
+		case MessageType::WingSailCommand:
+			msg = std::make_unique<WingSailCommandMsg>(deserialiser);
+			break;
+		case MessageType::RudderCommand:
+			msg = std::make_unique<RudderCommandMsg>(deserialiser);
+			break;
+		case MessageType::SailCommand:
+			msg = std::make_unique<SailCommandMsg>(deserialiser);
+			break;
+		case MessageType::DataCollectionStart:
+			msg = std::make_unique<DataCollectionStartMsg>(deserialiser);
+			break;
+		case MessageType::DataCollectionStop:
+			msg = std::make_unique<DataCollectionStopMsg>(deserialiser);
+			break;
+		default:
+			return NULL;
+	}
+
+	if(not msg->isValid())
+	{
+		return NULL;
+	}
+	return msg;
+}
@@ -0,0 +1,29 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageFactory.h
+ *
+ * Purpose:
+ *		Turns a serialised message back into a message object of the right class, the
+ *		reverse of Message::Serialise().
+ *
+ * Developer Notes:
+ *		MessageFactory.cpp is generated from Messages/messages.json with the message
+ *		classes, a message added to the schema can be replayed, see MessageReplay.h.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/Message.h"
+#include <stdint.h>
+
+
+class MessageFactory {
+public:
+	///----------------------------------------------------------------------------------
+ 	/// Creates a message from the bytes written by Message::Serialise(). Returns NULL
+ 	/// if the message type is unknown or the data doesn't make a valid message.
+ 	///----------------------------------------------------------------------------------
+	static MessagePtr deserialise(uint8_t* data, uint16_t size);
+};
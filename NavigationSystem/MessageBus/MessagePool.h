@@ -0,0 +1,227 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessagePool.h
+ *
+ * Purpose:
+ *		Recycles the memory of bus messages so publishing a message doesn't need a trip
+ *		to the heap every time. There is one pool per message class, use
+ *		MessageBus::make<XxxMsg>(...) to allocate from it.
+ *
+ * Developer Notes:
+ *		Messages are usually created on a node thread and deleted on the message bus
+ *		thread. Each thread keeps its own cache of free blocks, a thread that frees
+ *		more than it allocates hands a batch of blocks over to a shared list and a
+ *		thread that runs out takes a batch from it. The shared list's lock is only taken
+ *		once per batch.
+ *
+ *		A pooled message remembers its pool through MessageRecycler, MessageDeleter
+ *		hands it back when the MessagePtr lets go of it. Messages created with
+ *		std::make_unique still work and are deleted as normal.
+ *
+ *		The pools are never destroyed, messages can still be in flight while the
+ *		program exits.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/Message.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+
+///----------------------------------------------------------------------------------
+/// The part of a message pool that doesn't depend on the message class, keeps track
+/// of all the pools so their counters can be added up.
+///----------------------------------------------------------------------------------
+class MessagePoolBase {
+public:
+	MessagePoolBase() : m_Hits(0), m_Misses(0)
+	{
+		std::lock_guard<std::mutex> lock(registryMutex());
+		registry().push_back(this);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Allocations served from recycled memory.
+	///----------------------------------------------------------------------------------
+	uint64_t hits() const { return m_Hits.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+	/// Allocations that had to go to the heap.
+	///----------------------------------------------------------------------------------
+	uint64_t misses() const { return m_Misses.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+	/// The hits and misses of every message pool together.
+	///----------------------------------------------------------------------------------
+	static void totals(uint64_t& hits, uint64_t& misses)
+	{
+		hits = 0;
+		misses = 0;
+		std::lock_guard<std::mutex> lock(registryMutex());
+		for(auto pool : registry())
+		{
+			hits += pool->hits();
+			misses += pool->misses();
+		}
+	}
+
+protected:
+	std::atomic<uint64_t> m_Hits;
+	std::atomic<uint64_t> m_Misses;
+
+private:
+	static std::vector<MessagePoolBase*>& registry()
+	{
+		static std::vector<MessagePoolBase*>* pools = new std::vector<MessagePoolBase*>();
+		return *pools;
+	}
+
+	static std::mutex& registryMutex()
+	{
+		static std::mutex* mutex = new std::mutex();
+		return *mutex;
+	}
+};
+
+
+template<class T>
+class MessagePool : public MessagePoolBase {
+public:
+	// Number of blocks moved between a thread's cache and the shared list at a time
+	static const size_t BATCH_SIZE = 32;
+
+	// Free blocks above this in the shared list are given back to the heap
+	static const size_t MAX_SHARED_BLOCKS = 256;
+
+	static MessagePool& instance()
+	{
+		static MessagePool* pool = new MessagePool();
+		return *pool;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Constructs a message in a recycled block, or a new one if the pool is empty.
+	///----------------------------------------------------------------------------------
+	template<class... Args>
+	MessagePtr make(Args&&... args)
+	{
+		T* msg = new(acquire()) T(std::forward<Args>(args)...);
+		msg->m_Recycle = &MessagePool::recycle;
+		return MessagePtr(msg);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Fills the shared list up to count free blocks, for a thread that shouldn't go to
+	/// the heap once it is running. The list holds at most MAX_SHARED_BLOCKS.
+	///----------------------------------------------------------------------------------
+	void reserve(size_t count)
+	{
+		if(count > MAX_SHARED_BLOCKS)
+		{
+			count = MAX_SHARED_BLOCKS;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		while(m_SharedBlocks.size() < count)
+		{
+			m_SharedBlocks.push_back(::operator new(sizeof(T)));
+		}
+	}
+
+private:
+	///----------------------------------------------------------------------------------
+	/// The free blocks owned by one thread, handed to the shared list when the thread
+	/// exits.
+	///----------------------------------------------------------------------------------
+	struct ThreadCache {
+		ThreadCache() { blocks.reserve(BATCH_SIZE * 2); }
+		~ThreadCache() { instance().giveBack(blocks, blocks.size()); }
+
+		std::vector<void*> blocks;
+	};
+
+	MessagePool()
+	{
+		m_SharedBlocks.reserve(MAX_SHARED_BLOCKS);
+	}
+
+	static ThreadCache& threadCache()
+	{
+		static thread_local ThreadCache cache;
+		return cache;
+	}
+
+	static void recycle(Message* msg)
+	{
+		T* typedMsg = static_cast<T*>(msg);
+		typedMsg->~T();
+		instance().release(typedMsg);
+	}
+
+	void* acquire()
+	{
+		std::vector<void*>& blocks = threadCache().blocks;
+
+		if(blocks.empty())
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for(size_t i = 0; i < BATCH_SIZE && not m_SharedBlocks.empty(); i++)
+			{
+				blocks.push_back(m_SharedBlocks.back());
+				m_SharedBlocks.pop_back();
+			}
+		}
+
+		if(blocks.empty())
+		{
+			m_Misses.fetch_add(1, std::memory_order_relaxed);
+			return ::operator new(sizeof(T));
+		}
+
+		m_Hits.fetch_add(1, std::memory_order_relaxed);
+		void* block = blocks.back();
+		blocks.pop_back();
+		return block;
+	}
+
+	void release(void* block)
+	{
+		std::vector<void*>& blocks = threadCache().blocks;
+		blocks.push_back(block);
+
+		if(blocks.size() >= BATCH_SIZE * 2)
+		{
+			giveBack(blocks, BATCH_SIZE);
+		}
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Moves count blocks from the back of a thread cache to the shared list.
+	///----------------------------------------------------------------------------------
+	void giveBack(std::vector<void*>& blocks, size_t count)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for(size_t i = 0; i < count; i++)
+		{
+			if(m_SharedBlocks.size() < MAX_SHARED_BLOCKS)
+			{
+				m_SharedBlocks.push_back(blocks.back());
+			}
+			else
+			{
+				::operator delete(blocks.back());
+			}
+			blocks.pop_back();
+		}
+	}
+
+	std::mutex 				m_Mutex;			// Guards m_SharedBlocks
+	std::vector<void*> 		m_SharedBlocks;
+};
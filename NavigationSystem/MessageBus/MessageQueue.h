@@ -0,0 +1,176 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageQueue.h
+ *
+ * Purpose:
+ *		The queues used by the message bus to collect messages from the sending threads.
+ *		Any number of threads can push messages, a single thread takes them out.
+ *
+ *		LockedMessageQueue is the original double buffered design, senders push into a
+ *		std::queue under a mutex and the bus swaps the whole queue out in one go.
+ *
+ *		LockFreeMessageQueue is an intrusive multi producer, single consumer queue. The
+ *		messages are chained through their MessageQueueLink so pushing never allocates
+ *		and never takes a lock, a push is a single atomic exchange.
+ *
+ * Developer Notes:
+ *		The message bus picks one of the two at build time, see MESSAGE_BUS_LOCK_FREE_QUEUE
+ *		in MessageBus.h.
+ *
+ *		Both queues keep the order of the messages pushed by a single thread. Messages
+ *		pushed by different threads at the same time can come out in either order.
+ *
+ *		The lock free queue is the one described by Dmitry Vyukov, "Intrusive MPSC node
+ *		based queue". A push that has swapped the head but not yet linked the previous
+ *		message hides the messages behind it until the link is written, popAll() stops
+ *		there and the remaining messages are picked up on the next call.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/Message.h"
+#include <atomic>
+#include <mutex>
+#include <queue>
+
+
+class LockedMessageQueue {
+public:
+	LockedMessageQueue() : m_Size(0) { }
+
+	///----------------------------------------------------------------------------------
+	/// Adds a message to the back of the queue, can be called from any thread.
+	///----------------------------------------------------------------------------------
+	void push(MessagePtr msg)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Messages.push(std::move(msg));
+		m_Size.store(m_Messages.size(), std::memory_order_seq_cst);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Moves all the queued messages to the back of out. Should only be called by the
+	/// consuming thread.
+	///----------------------------------------------------------------------------------
+	void popAll(std::queue<MessagePtr>& out)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if(out.empty())
+		{
+			out.swap(m_Messages);
+		}
+		else
+		{
+			while(not m_Messages.empty())
+			{
+				out.push(std::move(m_Messages.front()));
+				m_Messages.pop();
+			}
+		}
+		m_Size.store(0, std::memory_order_seq_cst);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Returns true if there are no messages waiting.
+	///----------------------------------------------------------------------------------
+	bool empty() const { return m_Size.load(std::memory_order_seq_cst) == 0; }
+
+private:
+	std::queue<MessagePtr> 	m_Messages;
+	std::mutex 				m_Mutex;
+	std::atomic<size_t>		m_Size;
+};
+
+
+class LockFreeMessageQueue {
+public:
+	LockFreeMessageQueue() : m_Head(&m_Stub), m_Tail(&m_Stub) { }
+
+	~LockFreeMessageQueue()
+	{
+		std::queue<MessagePtr> leftOvers;
+		popAll(leftOvers);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Adds a message to the back of the queue, can be called from any thread. The
+	/// queue owns the message until it is popped.
+	///----------------------------------------------------------------------------------
+	void push(MessagePtr msg)
+	{
+		link(msg.release());
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Moves all the queued messages to the back of out. Should only be called by the
+	/// consuming thread.
+	///----------------------------------------------------------------------------------
+	void popAll(std::queue<MessagePtr>& out)
+	{
+		MessageQueueLink* msg;
+		while((msg = pop()) != NULL)
+		{
+			out.push(MessagePtr(static_cast<Message*>(msg)));
+		}
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Returns true if there are no messages waiting. Should only be called by the
+	/// consuming thread.
+	///----------------------------------------------------------------------------------
+	bool empty() const { return m_Head.load(std::memory_order_seq_cst) == m_Tail; }
+
+private:
+	void link(MessageQueueLink* node)
+	{
+		node->m_QueueNext.store(NULL, std::memory_order_relaxed);
+		MessageQueueLink* prev = m_Head.exchange(node, std::memory_order_seq_cst);
+		prev->m_QueueNext.store(node, std::memory_order_release);
+	}
+
+	MessageQueueLink* pop()
+	{
+		MessageQueueLink* tail = m_Tail;
+		MessageQueueLink* next = tail->m_QueueNext.load(std::memory_order_acquire);
+
+		// Skip over the stub
+		if(tail == &m_Stub)
+		{
+			if(next == NULL)
+			{
+				return NULL;
+			}
+			m_Tail = next;
+			tail = next;
+			next = next->m_QueueNext.load(std::memory_order_acquire);
+		}
+
+		if(next != NULL)
+		{
+			m_Tail = next;
+			return tail;
+		}
+
+		// A sender is halfway through a push
+		if(tail != m_Head.load(std::memory_order_acquire))
+		{
+			return NULL;
+		}
+
+		// The tail is the last message, put the stub behind it so it can be taken out
+		link(&m_Stub);
+		next = tail->m_QueueNext.load(std::memory_order_acquire);
+		if(next != NULL)
+		{
+			m_Tail = next;
+			return tail;
+		}
+		return NULL;
+	}
+
+	std::atomic<MessageQueueLink*> 	m_Head;		// Where senders push, shared
+	MessageQueueLink* 				m_Tail;		// Where the consumer pops
+	MessageQueueLink 				m_Stub;
+};
@@ -0,0 +1,80 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageRecorder.cpp
+ *
+ * Purpose:
+ *		Records the messages going through the message bus to a file.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageRecorder.h"
+#include "MessageBus/MessageSerialiser.h"
+#include "SystemServices/Logger.h"
+#include <string.h>
+
+
+MessageRecorder::MessageRecorder()
+	:m_File(NULL), m_Recorded(0)
+{
+
+}
+
+MessageRecorder::~MessageRecorder()
+{
+	close();
+}
+
+bool MessageRecorder::open(const std::string& filePath)
+{
+	close();
+
+	m_File = fopen(filePath.c_str(), "wb");
+	if(m_File == NULL)
+	{
+		Logger::error("Message recording %s not created!", filePath.c_str());
+		return false;
+	}
+	setvbuf(m_File, NULL, _IOFBF, WRITE_BUFFER_SIZE);
+
+	MessageRecordingHeader header;
+	memcpy(header.magic, MESSAGE_RECORDING_MAGIC, sizeof(header.magic));
+	header.version = MESSAGE_RECORDING_VERSION;
+	header.reserved = 0;
+	fwrite(&header, sizeof(header), 1, m_File);
+
+	m_Recorded.store(0);
+	Logger::info("Recording messages to %s", filePath.c_str());
+	return true;
+}
+
+void MessageRecorder::close()
+{
+	if(m_File != NULL)
+	{
+		fclose(m_File);
+		m_File = NULL;
+		Logger::info("Message recording closed, %llu messages", (unsigned long long)recorded());
+	}
+}
+
+void MessageRecorder::record(const Message& msg, uint64_t time)
+{
+	if(m_File == NULL)
+	{
+		return;
+	}
+
+	MessageSerialiser serialiser;
+	msg.Serialise(serialiser);
+	uint16_t size = serialiser.size();
+
+	fwrite(&time, sizeof(time), 1, m_File);
+	fwrite(&size, sizeof(size), 1, m_File);
+	fwrite(serialiser.data(), size, 1, m_File);
+
+	m_Recorded.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,83 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageRecorder.h
+ *
+ * Purpose:
+ *		Records the messages going through the message bus to a file so they can be fed
+ *		back into a message bus later, see MessageReplay.h.
+ *
+ * Developer Notes:
+ *		A recording starts with a MessageRecordingHeader, followed by one record per
+ *		message:
+ *
+ *			uint64_t 	time 		When the message was sent, monotonic microseconds
+ *			uint16_t 	size 		Number of bytes that follow
+ *			uint8_t 	data[size] 	The message as written by Message::Serialise()
+ *
+ *		The message bus records from its own thread as it distributes the messages, so
+ *		the recording has the order the nodes saw. Messages dropped by conflation are
+ *		not recorded.
+ *
+ *		The records are written in the host's byte order. Version 1 recordings had a
+ *		single byte size, they can still be replayed.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/Message.h"
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+
+#define MESSAGE_RECORDING_MAGIC 	"MSGRECRD"
+#define MESSAGE_RECORDING_VERSION 	2
+
+
+struct MessageRecordingHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+};
+
+
+class MessageRecorder {
+public:
+	MessageRecorder();
+	~MessageRecorder();
+
+	///----------------------------------------------------------------------------------
+ 	/// Creates the recording file, returns false if it couldn't be created.
+ 	///----------------------------------------------------------------------------------
+	bool open(const std::string& filePath);
+
+	///----------------------------------------------------------------------------------
+ 	/// Flushes and closes the recording file.
+ 	///----------------------------------------------------------------------------------
+	void close();
+
+	bool isOpen() const { return m_File != NULL; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Appends a message to the recording. Only one thread may record at a time.
+ 	///
+ 	/// @param msg 				The message to record.
+ 	/// @param time 			When the message was sent, monotonic microseconds.
+ 	///----------------------------------------------------------------------------------
+	void record(const Message& msg, uint64_t time);
+
+	///----------------------------------------------------------------------------------
+ 	/// Number of messages recorded since the file was opened.
+ 	///----------------------------------------------------------------------------------
+	uint64_t recorded() const { return m_Recorded.load(std::memory_order_relaxed); }
+
+private:
+	// Keeps the writes to the SD card in large blocks
+	static const size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+	FILE* 					m_File;
+	std::atomic<uint64_t> 	m_Recorded;
+};
@@ -0,0 +1,152 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageReplay.cpp
+ *
+ * Purpose:
+ *		Feeds a message recording back into a message bus.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageReplay.h"
+#include "MessageBus/MessageFactory.h"
+#include "MessageBus/MessageSerialiser.h"
+#include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
+#include <chrono>
+#include <string.h>
+#include <thread>
+
+
+constexpr double MessageReplay::AS_FAST_AS_POSSIBLE;
+
+
+MessageReplay::MessageReplay(MessageBus& msgBus)
+	:m_MsgBus(msgBus), m_File(NULL), m_Version(0), m_Stopping(false), m_Played(0), m_Skipped(0)
+{
+
+}
+
+MessageReplay::~MessageReplay()
+{
+	if(m_File != NULL)
+	{
+		fclose(m_File);
+	}
+}
+
+bool MessageReplay::open(const std::string& filePath)
+{
+	m_File = fopen(filePath.c_str(), "rb");
+	if(m_File == NULL)
+	{
+		Logger::error("Failed to open message recording %s", filePath.c_str());
+		return false;
+	}
+
+	MessageRecordingHeader header;
+	if(fread(&header, sizeof(header), 1, m_File) != 1 ||
+		memcmp(header.magic, MESSAGE_RECORDING_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version < 1 || header.version > MESSAGE_RECORDING_VERSION)
+	{
+		Logger::error("%s is not a message recording of version %d or older", filePath.c_str(), MESSAGE_RECORDING_VERSION);
+		fclose(m_File);
+		m_File = NULL;
+		return false;
+	}
+
+	m_Version = header.version;
+	return true;
+}
+
+void MessageReplay::play(double speed)
+{
+	if(m_File == NULL)
+	{
+		return;
+	}
+
+	uint8_t data[MAX_MESSAGE_SIZE];
+	uint16_t size;
+	uint64_t time;
+	uint64_t firstTime = 0;
+	uint64_t lastTime = 0;
+	// A simulated time waits for the replay as for any node loop
+	TimeSource& clock = SysClock::timeSource();
+	clock.attachThread();
+	clock.enterThread();
+
+	uint64_t start = clock.monotonicMicros();
+
+	while(not m_Stopping.load() && readRecord(time, data, size))
+	{
+		if(m_Played + m_Skipped == 0)
+		{
+			firstTime = time;
+		}
+
+		if(speed == AS_FAST_AS_POSSIBLE)
+		{
+			waitForBus(MAX_PENDING);
+		}
+		// The high priority lane can put a message ahead of older ones, those go
+		// straight away
+		else if(time > lastTime)
+		{
+			clock.sleepUntil(start + (uint64_t)((time - firstTime) / speed));
+			lastTime = time;
+		}
+
+		MessagePtr msg = MessageFactory::deserialise(data, size);
+		if(msg)
+		{
+			m_MsgBus.sendMessage(std::move(msg));
+			m_Played++;
+		}
+		else
+		{
+			m_Skipped++;
+		}
+	}
+
+	waitForBus(0);
+	clock.leaveThread();
+
+	Logger::info("Replayed %llu messages, skipped %llu", (unsigned long long)m_Played,
+		(unsigned long long)m_Skipped);
+}
+
+bool MessageReplay::readRecord(uint64_t& time, uint8_t* data, uint16_t& size)
+{
+	if(fread(&time, sizeof(time), 1, m_File) != 1)
+	{
+		return false;
+	}
+
+	if(m_Version == 1)
+	{
+		uint8_t shortSize;
+		if(fread(&shortSize, sizeof(shortSize), 1, m_File) != 1)
+		{
+			return false;
+		}
+		size = shortSize;
+	}
+	else if(fread(&size, sizeof(size), 1, m_File) != 1 || size > MAX_MESSAGE_SIZE)
+	{
+		return false;
+	}
+
+	return size == 0 || fread(data, size, 1, m_File) == 1;
+}
+
+void MessageReplay::waitForBus(uint64_t maxPending)
+{
+	while(not m_Stopping.load() && m_MsgBus.pendingMessages() > maxPending)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+}
@@ -0,0 +1,88 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageReplay.h
+ *
+ * Purpose:
+ *		Feeds a recording made with MessageBus::startRecording() back into a message
+ *		bus, so the nodes attached to it can be run and profiled without a boat.
+ *
+ * Developer Notes:
+ *		The messages are sent in the recorded order, keeping the recorded gaps between
+ *		them divided by the playback speed. At AS_FAST_AS_POSSIBLE the replay doesn't
+ *		wait at all but stays at most MAX_PENDING messages ahead of the nodes, so a
+ *		slow node doesn't make the queues grow without bound.
+ *
+ *		The gaps are kept on the SysClock, with a simulated time source the nodes see
+ *		the recorded pace while the replay runs as fast as they can keep up.
+ *
+ *		Messages the MessageFactory can't rebuild are skipped and counted.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/MessageBus.h"
+#include "MessageBus/MessageRecorder.h"
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+
+class MessageReplay {
+public:
+	static constexpr double AS_FAST_AS_POSSIBLE = 0;
+
+	static const uint64_t MAX_PENDING = 64;
+
+	MessageReplay(MessageBus& msgBus);
+	~MessageReplay();
+
+	///----------------------------------------------------------------------------------
+ 	/// Opens a recording, returns false if it can't be read.
+ 	///----------------------------------------------------------------------------------
+	bool open(const std::string& filePath);
+
+	///----------------------------------------------------------------------------------
+ 	/// Sends the recorded messages to the message bus. Returns once all of them have
+ 	/// been handed to their nodes, or stop() is called.
+ 	///
+ 	/// @param speed 			1 plays in real time, 10 ten times faster.
+ 	///							AS_FAST_AS_POSSIBLE doesn't wait between messages.
+ 	///----------------------------------------------------------------------------------
+	void play(double speed);
+
+	///----------------------------------------------------------------------------------
+ 	/// Makes play() return early, can be called from any thread.
+ 	///----------------------------------------------------------------------------------
+	void stop() { m_Stopping.store(true); }
+
+	///----------------------------------------------------------------------------------
+ 	/// Messages sent to the message bus.
+ 	///----------------------------------------------------------------------------------
+	uint64_t played() const { return m_Played; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Records that couldn't be turned back into a message.
+ 	///----------------------------------------------------------------------------------
+	uint64_t skipped() const { return m_Skipped; }
+
+private:
+	///----------------------------------------------------------------------------------
+ 	/// Reads the next record, returns false at the end of the recording.
+ 	///----------------------------------------------------------------------------------
+	bool readRecord(uint64_t& time, uint8_t* data, uint16_t& size);
+
+	///----------------------------------------------------------------------------------
+ 	/// Waits until the message bus has no more than a number of messages waiting.
+ 	///----------------------------------------------------------------------------------
+	void waitForBus(uint64_t maxPending);
+
+	MessageBus& 		m_MsgBus;
+	FILE* 				m_File;
+	uint32_t 			m_Version;			// Of the recording being played
+	std::atomic<bool> 	m_Stopping;
+	uint64_t 			m_Played;
+	uint64_t 			m_Skipped;
+};
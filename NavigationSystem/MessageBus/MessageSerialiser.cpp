@@ -13,49 +13,63 @@
 
 
 #include "MessageBus/MessageSerialiser.h"
+#include "MessageBus/LittleEndian.h"
 #include "SystemServices/Logger.h"
+#include <string.h>
 
 
 void MessageSerialiser::serialise(uint8_t data)
 {
-	if(m_ptr != MAX_MESSAGE_SIZE)
+	uint8_t* ptr = reserve(sizeof(data));
+	if(ptr != NULL)
 	{
-		m_data[m_ptr++] = data;
-	}
-	else
-	{
-		Logger::error("%s Message is full, failed to insert more data", __PRETTY_FUNCTION__);
+		LittleEndian::write(ptr, data);
 	}
 }
 
 void MessageSerialiser::serialise(uint16_t data)
 {
-	uint8_t* ptr = (uint8_t*)&data;
-	serialise(ptr, sizeof(data));
+	uint8_t* ptr = reserve(sizeof(data));
+	if(ptr != NULL)
+	{
+		LittleEndian::write(ptr, data);
+	}
 }
 
 void MessageSerialiser::serialise(uint32_t data)
 {
-	uint8_t* ptr = (uint8_t*)&data;
-	serialise(ptr, sizeof(data));
+	uint8_t* ptr = reserve(sizeof(data));
+	if(ptr != NULL)
+	{
+		LittleEndian::write(ptr, data);
+	}
 }
 
 void MessageSerialiser::serialise(int data)
 {
-	uint8_t* ptr = (uint8_t*)&data;
-	serialise(ptr, sizeof(data));
+	uint8_t* ptr = reserve(sizeof(data));
+	if(ptr != NULL)
+	{
+		LittleEndian::write(ptr, data);
+	}
 }
 
 void MessageSerialiser::serialise(float data)
 {
-	uint8_t* ptr = (uint8_t*)&data;
-	serialise(ptr, sizeof(data));
+	uint8_t* ptr = reserve(sizeof(data));
+	if(ptr != NULL)
+	{
+		LittleEndian::write(ptr, data);
+	}
 }
 
 void MessageSerialiser::serialise(double data)
 {
-	uint8_t* ptr = (uint8_t*)&data;
-	serialise(ptr, sizeof(data));
+	uint8_t* ptr = reserve(sizeof(data));
+	if(ptr != NULL)
+	{
+		LittleEndian::write(ptr, data);
+	}
 }
 
 void MessageSerialiser::serialise(bool data)
@@ -72,19 +86,24 @@ void  MessageSerialiser::serialise(NodeID data)
 	serialise((uint8_t)data);
 }
 
-void MessageSerialiser::serialise(uint8_t* data, uint8_t size)
+void MessageSerialiser::serialise(const uint8_t* data, uint16_t size)
 {
-	if(m_ptr != MAX_MESSAGE_SIZE)
-	{
-		for(unsigned int i = 0; i < size; i++)
-		{
-			m_data[m_ptr++] = data[i];
-		}
-	}
-	else
+	uint8_t* ptr = reserve(size);
+	if(ptr != NULL)
 	{
-		Logger::error("%s Message is full, failed to insert more data", __PRETTY_FUNCTION__);
+		memcpy(ptr, data, size);
 	}
 }
 
+uint8_t* MessageSerialiser::reserve(uint16_t size)
+{
+	if(m_ptr + size <= MAX_MESSAGE_SIZE)
+	{
+		uint8_t* ptr = m_data + m_ptr;
+		m_ptr += size;
+		return ptr;
+	}
 
+	Logger::error("%s Message is full, failed to insert more data", __PRETTY_FUNCTION__);
+	return NULL;
+}
@@ -7,7 +7,9 @@
  *		Serialises a message into a block of bytes.
  *
  * Developer Notes:
- *
+ *		Every value is written little endian whatever the host, floats and doubles as
+ *		their IEEE 754 bits, so a message serialised on the Pi reads the same anywhere.
+ *		A value that doesn't fit into the MAX_MESSAGE_SIZE is not written at all.
  *
  ***************************************************************************************/
 
@@ -20,7 +22,7 @@
 #include "MessageBus/NodeIDs.h"
 #include "MessageBus/MessageTypes.h"
 
-#define MAX_MESSAGE_SIZE 	256
+#define MAX_MESSAGE_SIZE 	4096
 
 
 class MessageSerialiser {
@@ -39,7 +41,13 @@ public:
 	void serialise(bool data);
 	void serialise(MessageType data);
 	void serialise(NodeID data);
-	void serialise(uint8_t* data, uint8_t size);
+	void serialise(const uint8_t* data, uint16_t size);
+
+	///----------------------------------------------------------------------------------
+	/// Reserves the next bytes of the message for the caller to write, see
+	/// LittleEndian.h. Returns NULL if they don't fit, nothing is reserved then.
+	///----------------------------------------------------------------------------------
+	uint8_t* reserve(uint16_t size);
 
 	///----------------------------------------------------------------------------------
 	/// Returns a pointer to the data.
@@ -49,9 +57,9 @@ public:
 	///----------------------------------------------------------------------------------
 	/// Returns the number of bytes the data takes up.
 	///----------------------------------------------------------------------------------
-	uint8_t size() { return m_ptr; }
+	uint16_t size() { return m_ptr; }
 
 private:
 	uint8_t m_data[MAX_MESSAGE_SIZE];
-	uint8_t m_ptr;
+	uint16_t m_ptr;
 };
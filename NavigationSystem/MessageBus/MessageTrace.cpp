@@ -0,0 +1,137 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageTrace.cpp
+ *
+ * Purpose:
+ *		A binary trace of the messages going through the message bus.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageTrace.h"
+#include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
+#include <chrono>
+#include <string.h>
+
+
+const uint64_t MessageTrace::CAPACITY;
+const int MessageTrace::WRITE_INTERVAL_MS;
+
+MessageTrace::MessageTrace()
+	:m_Slots(new Slot[CAPACITY]), m_WritePos(0), m_ReadPos(0), m_Enabled(false), m_Dropped(0),
+	 m_Written(0), m_File(NULL), m_Stopping(false)
+{
+	for(uint64_t i = 0; i < CAPACITY; i++)
+	{
+		m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+MessageTrace::~MessageTrace()
+{
+	stop();
+}
+
+bool MessageTrace::start(const std::string& filePath)
+{
+	m_File = fopen(filePath.c_str(), "wb");
+	if(m_File == NULL)
+	{
+		Logger::error("Message trace file %s not created!", filePath.c_str());
+		return false;
+	}
+
+	MessageTraceHeader header;
+	memcpy(header.magic, MESSAGE_TRACE_MAGIC, sizeof(header.magic));
+	header.version = MESSAGE_TRACE_VERSION;
+	header.recordSize = sizeof(MessageTraceRecord);
+	fwrite(&header, sizeof(header), 1, m_File);
+
+	m_Stopping = false;
+	m_Enabled.store(true);
+	m_Writer = std::thread(&MessageTrace::writerThread, this);
+
+	Logger::info("Message trace file %s created!", filePath.c_str());
+	return true;
+}
+
+void MessageTrace::stop()
+{
+	if(not m_Writer.joinable())
+	{
+		return;
+	}
+
+	m_Enabled.store(false);
+	{
+		std::lock_guard<std::mutex> lock(m_StopMutex);
+		m_Stopping = true;
+		m_StopCondition.notify_one();
+	}
+	m_Writer.join();
+
+	fclose(m_File);
+	m_File = NULL;
+
+	if(dropped() > 0)
+	{
+		Logger::warning("Message trace dropped %llu records", (unsigned long long)dropped());
+	}
+}
+
+void MessageTrace::writerThread()
+{
+	std::unique_lock<std::mutex> lock(m_StopMutex);
+	while(not m_Stopping)
+	{
+		m_StopCondition.wait_for(lock, std::chrono::milliseconds(WRITE_INTERVAL_MS));
+
+		if(drain() > 0)
+		{
+			fflush(m_File);
+		}
+	}
+
+	drain();
+}
+
+int MessageTrace::drain()
+{
+	int count = 0;
+	while(true)
+	{
+		Slot& slot = m_Slots[m_ReadPos & (CAPACITY - 1)];
+		if(slot.sequence.load(std::memory_order_acquire) != m_ReadPos + 1)
+		{
+			break;
+		}
+
+		if(count == 0)
+		{
+			writeClockSync();
+		}
+
+		fwrite(&slot.record, sizeof(MessageTraceRecord), 1, m_File);
+		slot.sequence.store(m_ReadPos + CAPACITY, std::memory_order_release);
+		m_ReadPos++;
+		count++;
+	}
+
+	m_Written.fetch_add(count, std::memory_order_relaxed);
+	return count;
+}
+
+void MessageTrace::writeClockSync()
+{
+	MessageTraceRecord sync;
+	memset(&sync, 0, sizeof(sync));
+	sync.kind = static_cast<uint8_t>(MessageTraceKind::ClockSync);
+	sync.time = SysClock::monotonicMicros();
+	sync.enqueued = (uint64_t)SysClock::unixTime() * 1000000 + SysClock::millis() * 1000;
+
+	fwrite(&sync, sizeof(MessageTraceRecord), 1, m_File);
+}
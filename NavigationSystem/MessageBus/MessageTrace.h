@@ -0,0 +1,170 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageTrace.h
+ *
+ * Purpose:
+ *		A binary trace of the messages going through the message bus. The bus records a
+ *		fixed size record for every message it distributes and for every node that
+ *		consumes one, a background thread writes them to disk.
+ *
+ * Developer Notes:
+ *		Recording is a few atomic operations and a 32 byte copy into a ring buffer, the
+ *		formatting is left to the MessageTraceDecoder tool (make trace_decoder). If the
+ *		writer can't keep up records are dropped and counted, the bus never waits.
+ *
+ *		The ring is the bounded queue described by Dmitry Vyukov, every slot has a
+ *		sequence number which tells producers and the writer whose turn it is. Several
+ *		threads can record at once, which happens with the worker pool.
+ *
+ *		Times are monotonic microseconds. The writer adds a ClockSync record before each
+ *		batch so the decoder can turn them into wall clock times, even after the GPS
+ *		has set the clock.
+ *
+ *		The records are written in the host's byte order.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+
+#define MESSAGE_TRACE_MAGIC 		"MSGTRACE"
+#define MESSAGE_TRACE_VERSION 		1
+
+
+enum class MessageTraceKind : uint8_t {
+	Dispatch = 0,		// A message was taken off the queue to be distributed
+	Consumed,			// A node finished processing a message
+	ClockSync			// Maps monotonic time to wall clock time
+};
+
+struct MessageTraceRecord {
+	uint64_t time;				// Monotonic microseconds
+	uint64_t enqueued;			// When the message was sent, monotonic microseconds. For
+								// ClockSync records the unix time in microseconds.
+	uint32_t duration;			// Time spent in processMessage(), Consumed records only
+	uint16_t messageType;
+	uint8_t kind;				// MessageTraceKind
+	uint8_t source;
+	uint8_t destination;
+	uint8_t consumer;			// The node that processed the message, Consumed records only
+	uint8_t padding[2];
+};
+
+static_assert(sizeof(MessageTraceRecord) == 32, "The trace file format expects 32 byte records");
+
+struct MessageTraceHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+};
+
+
+class MessageTrace {
+public:
+	// Must be a power of two
+	static const uint64_t CAPACITY = 8192;
+
+	// How often the writer drains the ring, in milliseconds
+	static const int WRITE_INTERVAL_MS = 100;
+
+	MessageTrace();
+	~MessageTrace();
+
+	///----------------------------------------------------------------------------------
+ 	/// Creates the trace file and starts the writer thread. Returns false if the file
+ 	/// couldn't be created, records are then ignored.
+ 	///----------------------------------------------------------------------------------
+	bool start(const std::string& filePath);
+
+	///----------------------------------------------------------------------------------
+ 	/// Writes out what is left in the ring, stops the writer thread and closes the file.
+ 	///----------------------------------------------------------------------------------
+	void stop();
+
+	///----------------------------------------------------------------------------------
+ 	/// Adds a record to the ring, can be called from any thread and never blocks.
+ 	///----------------------------------------------------------------------------------
+	void record(const MessageTraceRecord& record)
+	{
+		if(not m_Enabled.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		uint64_t pos = m_WritePos.load(std::memory_order_relaxed);
+		Slot* slot;
+		while(true)
+		{
+			slot = &m_Slots[pos & (CAPACITY - 1)];
+			int64_t diff = (int64_t)slot->sequence.load(std::memory_order_acquire) - (int64_t)pos;
+			if(diff == 0)
+			{
+				if(m_WritePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if(diff < 0)
+			{
+				// The ring is full
+				m_Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				pos = m_WritePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->record = record;
+		slot->sequence.store(pos + 1, std::memory_order_release);
+	}
+
+	///----------------------------------------------------------------------------------
+ 	/// Records that were lost because the ring was full.
+ 	///----------------------------------------------------------------------------------
+	uint64_t dropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+ 	/// Records written to the trace file.
+ 	///----------------------------------------------------------------------------------
+	uint64_t written() const { return m_Written.load(std::memory_order_relaxed); }
+
+private:
+	struct Slot {
+		std::atomic<uint64_t> 	sequence;
+		MessageTraceRecord 		record;
+	};
+
+	void writerThread();
+
+	///----------------------------------------------------------------------------------
+ 	/// Writes all the records that are ready, returns the number written.
+ 	///----------------------------------------------------------------------------------
+	int drain();
+
+	void writeClockSync();
+
+	std::unique_ptr<Slot[]> m_Slots;
+	std::atomic<uint64_t> 	m_WritePos;			// Next slot a producer claims
+	uint64_t 				m_ReadPos;			// Next slot the writer reads
+	std::atomic<bool> 		m_Enabled;
+	std::atomic<uint64_t> 	m_Dropped;
+	std::atomic<uint64_t> 	m_Written;
+
+	FILE* 					m_File;
+	std::thread 			m_Writer;
+	std::mutex 				m_StopMutex;
+	std::condition_variable m_StopCondition;
+	bool 					m_Stopping;			// Guarded by m_StopMutex
+};
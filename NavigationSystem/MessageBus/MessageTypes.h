@@ -49,6 +49,9 @@ enum class MessageType {
     DataCollectionStop
 };
 
+// The number of message types, this relies on DataCollectionStop being the last type.
+const int MESSAGE_TYPE_COUNT = static_cast<int>(MessageType::DataCollectionStop) + 1;
+
 inline std::string msgToString(MessageType msgType)
 {
 	switch(msgType)
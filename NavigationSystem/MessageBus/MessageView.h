@@ -0,0 +1,97 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageView.h
+ *
+ * Purpose:
+ *		Reads a serialised message where it lies, without deserialising it into a
+ *		message object.
+ *
+ * Developer Notes:
+ *		The base view only reads the header, enough to route or drop a message. Every
+ *		message class has a generated view next to it, e.g. WindDataView in
+ *		WindDataMsg.h, that reads the fields straight out of the bytes on each call.
+ *
+ *		A view doesn't copy the bytes, they have to outlive it. The fields of a view
+ *		that isn't valid must not be read, check isValid() first.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/LittleEndian.h"
+#include "MessageBus/MessageTypes.h"
+#include "MessageBus/NodeIDs.h"
+#include <stdint.h>
+
+
+class MessageView {
+public:
+	///----------------------------------------------------------------------------------
+	/// Reads the header of the serialised message.
+	///
+	/// @param data 			The bytes written by Message::Serialise().
+	/// @param size				The number of bytes.
+	///----------------------------------------------------------------------------------
+	MessageView(const uint8_t* data, uint16_t size)
+		:m_Data(data), m_Size(size), m_Valid(data != NULL && size >= HEADER_SIZE)
+	{ }
+
+	///----------------------------------------------------------------------------------
+	/// Indicates that the data holds a whole message of the type of the view.
+	///----------------------------------------------------------------------------------
+	bool isValid() const { return m_Valid; }
+
+	MessageType messageType() const { return (MessageType)LittleEndian::readUint8(m_Data); }
+	NodeID sourceID() const { return (NodeID)LittleEndian::readUint8(m_Data + 1); }
+	NodeID destinationID() const { return (NodeID)LittleEndian::readUint8(m_Data + 2); }
+
+	const uint8_t* data() const { return m_Data; }
+	uint16_t size() const { return m_Size; }
+
+protected:
+	///----------------------------------------------------------------------------------
+	/// Used by the generated views, the view is only valid if the header is of the
+	/// given type.
+	///----------------------------------------------------------------------------------
+	MessageView(const uint8_t* data, uint16_t size, MessageType type)
+		:MessageView(data, size)
+	{
+		m_Valid = m_Valid && messageType() == type;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Moves the offset over a block of fields, the view becomes invalid if the data
+	/// ends before the block does.
+	///----------------------------------------------------------------------------------
+	void skip(uint32_t& offset, uint32_t size)
+	{
+		m_Valid = m_Valid && offset + size <= m_Size;
+		offset += size;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Reads the count of a list and moves the offset over the list. The count is
+	/// zero if the view becomes invalid.
+	///----------------------------------------------------------------------------------
+	void skipList(uint32_t& offset, uint16_t& count, uint32_t elementSize)
+	{
+		count = 0;
+		skip(offset, sizeof(count));
+		if(m_Valid)
+		{
+			count = LittleEndian::readUint16(m_Data + offset - sizeof(count));
+			skip(offset, count * elementSize);
+			if(not m_Valid)
+			{
+				count = 0;
+			}
+		}
+	}
+
+	static const uint32_t HEADER_SIZE = 3;
+
+	const uint8_t* m_Data;
+	uint16_t m_Size;
+	bool m_Valid;
+};
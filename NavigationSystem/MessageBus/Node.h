@@ -36,7 +36,9 @@ public:
 	///----------------------------------------------------------------------------------
  	/// Called by the MessageBus when it has a message the node might be interested in.
  	/// A node should register for messages it wants to receive using
- 	/// MessageBus::registerNode(Node*, MessageType)
+ 	/// MessageBus::registerNode(Node*, MessageType). Messages the node subscribed to
+ 	/// with MessageBus::subscribe() go to their handler instead, a node that only uses
+ 	/// those overrides this with an empty function.
  	///
  	///----------------------------------------------------------------------------------
 	virtual void processMessage(const Message* message) = 0;
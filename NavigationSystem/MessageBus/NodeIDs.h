@@ -53,9 +53,13 @@ enum class NodeID {
 	CANAIS,
 	AISProcessing,
 	MarineSensor,
-    MarineSensorCANTransmission
+    MarineSensorCANTransmission,
+	MessageBridge
 };
 
+// The number of node IDs, this relies on MessageBridge being the last ID.
+const int NODE_ID_COUNT = static_cast<int>(NodeID::MessageBridge) + 1;
+
 inline std::string nodeToString(NodeID id)
 {
 	switch(id)
@@ -128,6 +132,8 @@ inline std::string nodeToString(NodeID id)
 		return "MarineSensor";
         case NodeID::MarineSensorCANTransmission:
             return "MarineSensorCANTransmission";
+		case NodeID::MessageBridge:
+		return "MessageBridge";
 	}
 	return "";
 }
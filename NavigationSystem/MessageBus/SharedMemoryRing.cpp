@@ -0,0 +1,229 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		SharedMemoryRing.cpp
+ *
+ * Purpose:
+ *		A ring buffer of variable sized records in a POSIX shared memory object.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/SharedMemoryRing.h"
+#include "SystemServices/Logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// Smallest buffer a ring is created with
+#define MIN_CAPACITY 	4096
+
+
+static uint32_t alignRecord(uint32_t size)
+{
+	return (size + SharedMemoryRing::RECORD_ALIGNMENT - 1) & ~(SharedMemoryRing::RECORD_ALIGNMENT - 1);
+}
+
+
+SharedMemoryRing::SharedMemoryRing()
+	:m_Header(NULL), m_Buffer(NULL), m_MappedSize(0), m_Created(false)
+{ }
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+	close();
+}
+
+bool SharedMemoryRing::create(const std::string& name, uint32_t capacity)
+{
+	close();
+
+	uint32_t size = MIN_CAPACITY;
+	while(size < capacity)
+	{
+		size *= 2;
+	}
+
+	shm_unlink(name.c_str());
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if(fd < 0)
+	{
+		Logger::error("Shared memory ring %s not created: %s", name.c_str(), strerror(errno));
+		return false;
+	}
+
+	if(ftruncate(fd, sizeof(Header) + size) != 0 || not map(fd, sizeof(Header) + size))
+	{
+		Logger::error("Shared memory ring %s not created: %s", name.c_str(), strerror(errno));
+		::close(fd);
+		shm_unlink(name.c_str());
+		return false;
+	}
+	::close(fd);
+
+	new(m_Header) Header();
+	m_Header->version = SHARED_MEMORY_RING_VERSION;
+	m_Header->capacity = size;
+	m_Header->writePosition.store(0);
+	m_Header->readPosition.store(0);
+	m_Header->dropped.store(0);
+
+	// The magic goes in last, a reader that opens the ring earlier turns it down
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(m_Header->magic, SHARED_MEMORY_RING_MAGIC, sizeof(m_Header->magic));
+
+	m_Name = name;
+	m_Created = true;
+	return true;
+}
+
+bool SharedMemoryRing::open(const std::string& name)
+{
+	close();
+
+	int fd = shm_open(name.c_str(), O_RDWR, 0600);
+	if(fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(Header) || not map(fd, info.st_size))
+	{
+		::close(fd);
+		return false;
+	}
+	::close(fd);
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if(memcmp(m_Header->magic, SHARED_MEMORY_RING_MAGIC, sizeof(m_Header->magic)) != 0 ||
+		m_Header->version != SHARED_MEMORY_RING_VERSION ||
+		sizeof(Header) + m_Header->capacity > m_MappedSize)
+	{
+		close();
+		return false;
+	}
+
+	m_Name = name;
+	m_Created = false;
+	return true;
+}
+
+void SharedMemoryRing::close()
+{
+	if(m_Header != NULL)
+	{
+		munmap(m_Header, m_MappedSize);
+		m_Header = NULL;
+		m_Buffer = NULL;
+		m_MappedSize = 0;
+	}
+
+	if(m_Created)
+	{
+		shm_unlink(m_Name.c_str());
+		m_Created = false;
+	}
+}
+
+bool SharedMemoryRing::map(int fd, size_t size)
+{
+	void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(memory == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_Header = static_cast<Header*>(memory);
+	m_Buffer = static_cast<uint8_t*>(memory) + sizeof(Header);
+	m_MappedSize = size;
+	return true;
+}
+
+bool SharedMemoryRing::write(const uint8_t* data, uint32_t size, uint64_t time)
+{
+	uint32_t capacity = m_Header->capacity;
+	uint32_t recordSize = alignRecord(sizeof(SharedMemoryRecord) + size);
+
+	uint32_t writePosition = m_Header->writePosition.load(std::memory_order_relaxed);
+	uint32_t readPosition = m_Header->readPosition.load(std::memory_order_acquire);
+
+	// A record that doesn't fit before the end also takes up the space it skips
+	uint32_t offset = writePosition & (capacity - 1);
+	uint32_t untilEnd = capacity - offset;
+	uint32_t needed = recordSize + (untilEnd < recordSize ? untilEnd : 0);
+
+	if(recordSize > capacity / 2 || capacity - (writePosition - readPosition) < needed)
+	{
+		m_Header->dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	if(untilEnd < recordSize)
+	{
+		SharedMemoryRecord* padding = reinterpret_cast<SharedMemoryRecord*>(m_Buffer + offset);
+		padding->size = PADDING;
+		writePosition += untilEnd;
+		offset = 0;
+	}
+
+	SharedMemoryRecord* record = reinterpret_cast<SharedMemoryRecord*>(m_Buffer + offset);
+	record->size = size;
+	record->reserved = 0;
+	record->time = time;
+	memcpy(m_Buffer + offset + sizeof(SharedMemoryRecord), data, size);
+
+	m_Header->writePosition.store(writePosition + recordSize, std::memory_order_release);
+	return true;
+}
+
+bool SharedMemoryRing::read(uint8_t* buffer, uint32_t bufferSize, uint32_t& size, uint64_t& time)
+{
+	uint32_t capacity = m_Header->capacity;
+	uint32_t readPosition = m_Header->readPosition.load(std::memory_order_relaxed);
+	uint32_t writePosition = m_Header->writePosition.load(std::memory_order_acquire);
+
+	while(readPosition != writePosition)
+	{
+		uint32_t offset = readPosition & (capacity - 1);
+		const SharedMemoryRecord* record = reinterpret_cast<const SharedMemoryRecord*>(m_Buffer + offset);
+
+		if(record->size == PADDING)
+		{
+			readPosition += capacity - offset;
+			continue;
+		}
+
+		size = record->size;
+		time = record->time;
+		if(size <= bufferSize)
+		{
+			memcpy(buffer, m_Buffer + offset + sizeof(SharedMemoryRecord), size);
+		}
+
+		m_Header->readPosition.store(readPosition + alignRecord(sizeof(SharedMemoryRecord) + size),
+			std::memory_order_release);
+		return true;
+	}
+
+	m_Header->readPosition.store(readPosition, std::memory_order_release);
+	return false;
+}
+
+uint32_t SharedMemoryRing::dropped() const
+{
+	return m_Header->dropped.load(std::memory_order_relaxed);
+}
+
+uint32_t SharedMemoryRing::used() const
+{
+	return m_Header->writePosition.load(std::memory_order_acquire) -
+		m_Header->readPosition.load(std::memory_order_acquire);
+}
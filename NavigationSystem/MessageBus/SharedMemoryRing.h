@@ -0,0 +1,131 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		SharedMemoryRing.h
+ *
+ * Purpose:
+ *		A ring buffer of variable sized records in a POSIX shared memory object, for
+ *		passing serialised messages from one process to another, see BridgeNode.h.
+ *
+ * Developer Notes:
+ *		There is one writer and one reader, each in its own process. The write and read
+ *		positions are free running byte counters in the shared header, the writer only
+ *		moves the write position and the reader only the read position, so neither side
+ *		ever waits on the other. A record that doesn't fit is dropped and counted.
+ *
+ *		Every record starts on a RECORD_ALIGNMENT boundary with a SharedMemoryRecord
+ *		header. A record that doesn't fit before the end of the buffer is written at its
+ *		start instead, behind a padding record that fills up the end.
+ *
+ *		The creator of a ring removes it from the system again when it is closed, a
+ *		reader that still has it open keeps its mapping until it closes it as well.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+
+#define SHARED_MEMORY_RING_MAGIC 	"MSGRING"
+#define SHARED_MEMORY_RING_VERSION 	1
+
+
+struct SharedMemoryRecord {
+	uint32_t size;			// Bytes of data that follow, PADDING for a padding record
+	uint32_t reserved;
+	uint64_t time;			// Given by the writer, monotonic microseconds
+};
+
+
+class SharedMemoryRing {
+public:
+	static const uint32_t RECORD_ALIGNMENT = sizeof(SharedMemoryRecord);
+	static const uint32_t PADDING = 0xFFFFFFFF;
+
+	SharedMemoryRing();
+
+	///----------------------------------------------------------------------------------
+ 	/// Closes the ring, see close().
+ 	///----------------------------------------------------------------------------------
+	~SharedMemoryRing();
+
+	///----------------------------------------------------------------------------------
+ 	/// Creates a new empty ring, replacing an existing one with the same name. Returns
+ 	/// false if the shared memory couldn't be created.
+ 	///
+ 	/// @param name 			Name of the shared memory object, starts with a '/'.
+ 	/// @param capacity 		Size of the buffer in bytes, rounded up to a power of two.
+ 	///----------------------------------------------------------------------------------
+	bool create(const std::string& name, uint32_t capacity);
+
+	///----------------------------------------------------------------------------------
+ 	/// Maps a ring another process created, returns false if there is no such ring.
+ 	///----------------------------------------------------------------------------------
+	bool open(const std::string& name);
+
+	///----------------------------------------------------------------------------------
+ 	/// Unmaps the ring, and removes it from the system if this side created it.
+ 	///----------------------------------------------------------------------------------
+	void close();
+
+	bool isOpen() const { return m_Header != NULL; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Appends a record, returns false if the ring is full and the record was dropped.
+ 	/// Only one thread may write.
+ 	///
+ 	/// @param data 			The bytes to write.
+ 	/// @param size 			Number of bytes.
+ 	/// @param time 			Stored with the record, usually when it was written.
+ 	///----------------------------------------------------------------------------------
+	bool write(const uint8_t* data, uint32_t size, uint64_t time);
+
+	///----------------------------------------------------------------------------------
+ 	/// Takes the oldest record off the ring, returns false if the ring is empty. A
+ 	/// record larger than the buffer is skipped with size set to its real size and
+ 	/// true returned. Only one thread may read.
+ 	///
+ 	/// @param buffer 			Where the record's bytes are copied to.
+ 	/// @param bufferSize 		Size of the buffer.
+ 	/// @param size 			Set to the number of bytes of the record.
+ 	/// @param time 			Set to the time the record was written with.
+ 	///----------------------------------------------------------------------------------
+	bool read(uint8_t* buffer, uint32_t bufferSize, uint32_t& size, uint64_t& time);
+
+	///----------------------------------------------------------------------------------
+ 	/// Number of records dropped because the ring was full, by either side.
+ 	///----------------------------------------------------------------------------------
+	uint32_t dropped() const;
+
+	///----------------------------------------------------------------------------------
+ 	/// Number of bytes waiting to be read.
+ 	///----------------------------------------------------------------------------------
+	uint32_t used() const;
+
+private:
+	struct Header {
+		char 					magic[8];
+		uint32_t 				version;
+		uint32_t 				capacity;
+		char 					padding0[48];
+		std::atomic<uint32_t> 	writePosition;		// Only moved by the writer
+		char 					padding1[60];
+		std::atomic<uint32_t> 	readPosition;		// Only moved by the reader
+		char 					padding2[60];
+		std::atomic<uint32_t> 	dropped;
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// Maps the shared memory object, returns false if it couldn't be.
+ 	///----------------------------------------------------------------------------------
+	bool map(int fd, size_t size);
+
+	Header* 		m_Header;
+	uint8_t* 		m_Buffer;
+	size_t 			m_MappedSize;
+	std::string 	m_Name;
+	bool 			m_Created;
+};
@@ -0,0 +1,286 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		TickScheduler.cpp
+ *
+ * Purpose:
+ *		Runs the periodic work of active nodes on a small shared pool of threads.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/TickScheduler.h"
+#include "SystemServices/SysClock.h"
+#include "SystemServices/TimeSource.h"
+#include <algorithm>
+
+
+// Time covered by one slot of the wheel
+#define RESOLUTION_US 		10000
+
+// Longest an idle pool thread sleeps, newly scheduled ticks are picked up after it
+#define MAX_IDLE_SLEEP_US 	100000
+
+
+const unsigned int TickScheduler::DEFAULT_THREADS;
+const size_t TickScheduler::WHEEL_SLOTS;
+
+TickScheduler::TickScheduler()
+	:m_CurrentSlot(0), m_ThreadCount(DEFAULT_THREADS), m_Started(false), m_Stopping(false)
+{ }
+
+TickScheduler::~TickScheduler()
+{
+	stop();
+
+	for(auto entry : m_Entries)
+	{
+		delete entry;
+	}
+}
+
+bool TickScheduler::setThreads(unsigned int threadCount)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if(m_Started || threadCount == 0)
+	{
+		return false;
+	}
+	m_ThreadCount = threadCount;
+	return true;
+}
+
+int TickScheduler::schedule(NodeID id, std::function<void()> tick, uint64_t periodUs, uint64_t initialDelayUs)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if(not m_Started)
+	{
+		start();
+	}
+
+	Entry* entry = new Entry();
+	entry->id = id;
+	entry->tick = tick;
+	entry->periodUs.store(std::max<uint64_t>(periodUs, RESOLUTION_US));
+	entry->deadline = SysClock::monotonicMicros() + initialDelayUs;
+	entry->running = false;
+	entry->cancelled = false;
+	entry->overruns.store(0);
+	entry->skipped.store(0);
+
+	m_Entries.push_back(entry);
+	insert(entry);
+	return m_Entries.size() - 1;
+}
+
+void TickScheduler::setPeriod(int tickId, uint64_t periodUs)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if(tickId >= 0 && tickId < (int)m_Entries.size() && m_Entries[tickId] != NULL)
+	{
+		m_Entries[tickId]->periodUs.store(std::max<uint64_t>(periodUs, RESOLUTION_US));
+	}
+}
+
+void TickScheduler::cancel(int tickId)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	if(tickId < 0 || tickId >= (int)m_Entries.size() || m_Entries[tickId] == NULL)
+	{
+		return;
+	}
+
+	Entry* entry = m_Entries[tickId];
+	m_Entries[tickId] = NULL;
+	entry->cancelled = true;
+
+	std::vector<Entry*>& bucket = m_Wheel[entry->slot % WHEEL_SLOTS];
+	bucket.erase(std::remove(bucket.begin(), bucket.end(), entry), bucket.end());
+	m_Ready.erase(std::remove(m_Ready.begin(), m_Ready.end(), entry), m_Ready.end());
+
+	while(entry->running)
+	{
+		m_Condition.wait(lock);
+	}
+	delete entry;
+}
+
+std::vector<TickScheduler::TickStats> TickScheduler::statistics() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::vector<TickStats> stats;
+	for(auto entry : m_Entries)
+	{
+		if(entry == NULL)
+		{
+			continue;
+		}
+
+		TickStats tickStats;
+		tickStats.id = entry->id;
+		tickStats.periodUs = entry->periodUs.load();
+		tickStats.ticks = entry->duration.count();
+		tickStats.overruns = entry->overruns.load();
+		tickStats.skipped = entry->skipped.load();
+		tickStats.latenessP99Us = entry->lateness.percentile(99);
+		tickStats.latenessMaxUs = entry->lateness.max();
+		tickStats.durationTotalUs = entry->duration.total();
+		tickStats.durationMaxUs = entry->duration.max();
+		stats.push_back(tickStats);
+	}
+	return stats;
+}
+
+void TickScheduler::threadLoop(TimeSource* clock)
+{
+	clock->enterThread();
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while(not m_Stopping)
+	{
+		if(not m_Ready.empty())
+		{
+			Entry* entry = m_Ready.front();
+			m_Ready.pop_front();
+			entry->running = true;
+
+			lock.unlock();
+			runTick(entry, clock);
+			lock.lock();
+
+			entry->running = false;
+			if(entry->cancelled)
+			{
+				m_Condition.notify_all();
+			}
+			else
+			{
+				insert(entry);
+			}
+			continue;
+		}
+
+		uint64_t wakeUp = nextWakeUp();
+		lock.unlock();
+		clock->sleepUntil(wakeUp);
+		lock.lock();
+		turnWheel(clock->monotonicMicros());
+	}
+
+	lock.unlock();
+	clock->leaveThread();
+}
+
+void TickScheduler::runTick(Entry* entry, TimeSource* clock)
+{
+	uint64_t start = clock->monotonicMicros();
+	entry->lateness.record(start > entry->deadline ? start - entry->deadline : 0);
+
+	entry->tick();
+
+	uint64_t end = clock->monotonicMicros();
+	entry->duration.record(end - start);
+
+	uint64_t period = entry->periodUs.load();
+	entry->deadline += period;
+	if(end >= entry->deadline)
+	{
+		entry->overruns++;
+
+		uint64_t missed = (end - entry->deadline) / period;
+		entry->skipped += missed;
+		entry->deadline += missed * period;
+	}
+}
+
+void TickScheduler::insert(Entry* entry)
+{
+	entry->slot = (entry->deadline + RESOLUTION_US - 1) / RESOLUTION_US;
+	if(entry->slot <= m_CurrentSlot)
+	{
+		m_Ready.push_back(entry);
+	}
+	else
+	{
+		m_Wheel[entry->slot % WHEEL_SLOTS].push_back(entry);
+	}
+}
+
+void TickScheduler::turnWheel(uint64_t now)
+{
+	uint64_t target = now / RESOLUTION_US;
+	if(target <= m_CurrentSlot)
+	{
+		return;
+	}
+
+	// After a long stall every bucket is looked at once
+	uint64_t slots = std::min<uint64_t>(target - m_CurrentSlot, WHEEL_SLOTS);
+	for(uint64_t slot = m_CurrentSlot + 1; slot <= m_CurrentSlot + slots; slot++)
+	{
+		std::vector<Entry*>& bucket = m_Wheel[slot % WHEEL_SLOTS];
+		for(size_t i = 0; i < bucket.size(); )
+		{
+			// Later laps of the wheel stay where they are
+			if(bucket[i]->slot <= target)
+			{
+				m_Ready.push_back(bucket[i]);
+				bucket[i] = bucket.back();
+				bucket.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	m_CurrentSlot = target;
+}
+
+uint64_t TickScheduler::nextWakeUp() const
+{
+	const uint64_t MAX_SLOTS = MAX_IDLE_SLEEP_US / RESOLUTION_US;
+
+	for(uint64_t slot = m_CurrentSlot + 1; slot <= m_CurrentSlot + MAX_SLOTS; slot++)
+	{
+		for(auto entry : m_Wheel[slot % WHEEL_SLOTS])
+		{
+			if(entry->slot == slot)
+			{
+				return slot * RESOLUTION_US;
+			}
+		}
+	}
+	return (m_CurrentSlot + MAX_SLOTS) * RESOLUTION_US;
+}
+
+void TickScheduler::start()
+{
+	TimeSource* clock = &SysClock::timeSource();
+	m_CurrentSlot = clock->monotonicMicros() / RESOLUTION_US;
+
+	for(unsigned int i = 0; i < m_ThreadCount; i++)
+	{
+		clock->attachThread();
+		m_Threads.emplace_back(&TickScheduler::threadLoop, this, clock);
+	}
+	m_Started = true;
+}
+
+void TickScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+
+	for(auto& thread : m_Threads)
+	{
+		thread.join();
+	}
+	m_Threads.clear();
+}
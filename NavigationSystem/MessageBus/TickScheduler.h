@@ -0,0 +1,167 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		TickScheduler.h
+ *
+ * Purpose:
+ *		Runs the periodic work of active nodes on a small shared pool of threads instead
+ *		of one sleeping thread per node, see ActiveNode::runPeriodic().
+ *
+ * Developer Notes:
+ *		The ticks are kept in a timer wheel of WHEEL_SLOTS slots, RESOLUTION_US apart. A
+ *		tick lands in the slot of its deadline and is run by the first free pool thread
+ *		once the wheel has turned past that slot, so a tick starts at most one slot
+ *		after its deadline when a thread is free.
+ *
+ *		Deadlines are absolute. The next deadline is the previous one plus the period,
+ *		so the time spent in the tick doesn't add up into a drift. A tick that finishes
+ *		after its next deadline counts as an overrun and runs again straight away, whole
+ *		periods it fell behind are skipped and counted.
+ *
+ *		The pool threads sleep on the SysClock, the ticks follow a simulated time source
+ *		like the node threads do. A thread that is idle sleeps until the next slot with
+ *		a tick in it, but at most MAX_IDLE_SLEEP_US, which is how late the first tick of
+ *		a newly scheduled node can be.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "MessageBus/NodeIDs.h"
+#include "SystemServices/LatencyHistogram.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+
+class TimeSource;
+
+
+class TickScheduler {
+public:
+	static const unsigned int DEFAULT_THREADS = 2;
+	static const size_t WHEEL_SLOTS = 256;
+
+	TickScheduler();
+
+	///----------------------------------------------------------------------------------
+ 	/// Stops the pool threads, the scheduled ticks are dropped.
+ 	///----------------------------------------------------------------------------------
+	~TickScheduler();
+
+	///----------------------------------------------------------------------------------
+ 	/// Sets the size of the thread pool. The pool starts with the first schedule(),
+ 	/// returns false if it already has.
+ 	///----------------------------------------------------------------------------------
+	bool setThreads(unsigned int threadCount);
+
+	///----------------------------------------------------------------------------------
+ 	/// Calls a function every period until the tick is cancelled. A tick never runs on
+ 	/// two threads at once. Returns the id of the tick.
+ 	///
+ 	/// @param id 				The node the tick belongs to, for the statistics.
+ 	/// @param tick 			The function to call.
+ 	/// @param periodUs 		Time between two deadlines.
+ 	/// @param initialDelayUs 	Time until the first deadline.
+ 	///----------------------------------------------------------------------------------
+	int schedule(NodeID id, std::function<void()> tick, uint64_t periodUs, uint64_t initialDelayUs);
+
+	///----------------------------------------------------------------------------------
+ 	/// Changes the period of a tick, the deadline after the next one uses it.
+ 	///----------------------------------------------------------------------------------
+	void setPeriod(int tickId, uint64_t periodUs);
+
+	///----------------------------------------------------------------------------------
+ 	/// Removes a tick, waits for it to finish if it is running. Must not be called from
+ 	/// the tick itself.
+ 	///----------------------------------------------------------------------------------
+	void cancel(int tickId);
+
+	///----------------------------------------------------------------------------------
+ 	/// Stops the pool threads once their running ticks are done, the ticks that are
+ 	/// still scheduled never run again.
+ 	///----------------------------------------------------------------------------------
+	void stop();
+
+	///----------------------------------------------------------------------------------
+ 	/// How well a tick keeps to its deadlines.
+ 	///----------------------------------------------------------------------------------
+	struct TickStats {
+		NodeID 		id;
+		uint64_t 	periodUs;
+		uint64_t 	ticks;				// Times the tick ran
+		uint64_t 	overruns;			// Ticks that finished after the next deadline
+		uint64_t 	skipped;			// Deadlines dropped after an overrun
+		uint64_t 	latenessP99Us;		// Start of the tick after its deadline
+		uint64_t 	latenessMaxUs;
+		uint64_t 	durationTotalUs;	// Time spent in the tick
+		uint64_t 	durationMaxUs;
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the statistics of every scheduled tick, can be called from any thread.
+ 	///----------------------------------------------------------------------------------
+	std::vector<TickStats> statistics() const;
+
+private:
+	struct Entry {
+		NodeID 					id;
+		std::function<void()> 	tick;
+		std::atomic<uint64_t> 	periodUs;
+		uint64_t 				deadline;	// Monotonic time of the next tick
+		uint64_t 				slot;		// Wheel position of the deadline, not wrapped
+		bool 					running;
+		bool 					cancelled;
+		std::atomic<uint64_t> 	overruns;
+		std::atomic<uint64_t> 	skipped;
+		LatencyHistogram 		lateness;
+		LatencyHistogram 		duration;
+	};
+
+	///----------------------------------------------------------------------------------
+ 	/// Pool thread loop, runs ready ticks and otherwise sleeps until the next slot
+ 	/// that has a tick in it. Whichever thread wakes up first turns the wheel.
+ 	///----------------------------------------------------------------------------------
+	void threadLoop(TimeSource* clock);
+
+	///----------------------------------------------------------------------------------
+ 	/// Calls the tick, records its statistics and works out its next deadline.
+ 	///----------------------------------------------------------------------------------
+	void runTick(Entry* entry, TimeSource* clock);
+
+	///----------------------------------------------------------------------------------
+ 	/// Puts a tick in the slot of its deadline, or in the ready queue if the wheel has
+ 	/// already passed it. Called with m_Mutex held.
+ 	///----------------------------------------------------------------------------------
+	void insert(Entry* entry);
+
+	///----------------------------------------------------------------------------------
+ 	/// Moves the ticks of the slots up to the current time to the ready queue. Called
+ 	/// with m_Mutex held.
+ 	///----------------------------------------------------------------------------------
+	void turnWheel(uint64_t now);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the time an idle thread should sleep until. Called with m_Mutex held.
+ 	///----------------------------------------------------------------------------------
+	uint64_t nextWakeUp() const;
+
+	void start();
+
+	mutable std::mutex 			m_Mutex;
+	std::condition_variable 	m_Condition;		// Signalled when a tick finishes
+	std::vector<Entry*> 		m_Entries;			// Indexed by tick id, NULL once
+													// cancelled
+	std::vector<Entry*> 		m_Wheel[WHEEL_SLOTS];
+	std::deque<Entry*> 			m_Ready;			// Ticks past their deadline
+	uint64_t 					m_CurrentSlot;		// Last slot the wheel turned past
+	unsigned int 				m_ThreadCount;
+	std::vector<std::thread> 	m_Threads;
+	bool 						m_Started;
+	bool 						m_Stopping;			// Guarded by m_Mutex
+};
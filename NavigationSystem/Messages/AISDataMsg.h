@@ -7,152 +7,251 @@
  *		An AISDataMsg contains the nearby vessels found by the AIS
  *
  * Developer Notes:
+ *		The vessel lists are immutable and reference counted, every subscriber reads the
+ *		same lists and a node can keep them or pass them on in a new message without a
+ *		copy. Moving a list into the constructor doesn't copy it either.
  *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
+#include <memory>
 #include <vector>
 
+
 struct AISVessel {
-  uint32_t MMSI;
-  float COG;
-  float SOG;
-  double latitude;
-  double longitude;
+	uint32_t MMSI;
+	float COG;
+	float SOG;
+	double latitude;
+	double longitude;
 };
 
+
 struct AISVesselInfo {
-  uint32_t MMSI;
-  float length;
-  float beam;
+	uint32_t MMSI;
+	float length;
+	float beam;
 };
 
+
 class AISDataMsg : public Message {
 public:
-	AISDataMsg(NodeID destinationID, NodeID sourceID, std::vector<AISVessel>(vesselList), std::vector<AISVesselInfo>(infoList), float posLat, float posLon)
-		:Message(MessageType::AISData, sourceID, destinationID), m_VesselList(vesselList), m_VesselInfoList(infoList), m_PosLat(posLat), m_PosLon(posLon)
+	static const MessageType TYPE = MessageType::AISData;
+
+	typedef std::shared_ptr<const std::vector<AISVessel>> VesselListPtr;
+	typedef std::shared_ptr<const std::vector<AISVesselInfo>> VesselInfoListPtr;
+
+	AISDataMsg(NodeID destinationID, NodeID sourceID, std::vector<AISVessel> vesselList,
+		std::vector<AISVesselInfo> infoList, float posLat, float posLon)
+		:Message(MessageType::AISData, sourceID, destinationID),
+		 m_VesselList(std::make_shared<const std::vector<AISVessel>>(std::move(vesselList))),
+		 m_InfoList(std::make_shared<const std::vector<AISVesselInfo>>(std::move(infoList))),
+		 m_PosLat(posLat), m_PosLon(posLon)
 	{ }
 
-	AISDataMsg(std::vector<AISVessel>(vesselList), std::vector<AISVesselInfo>(infoList), float posLat, float posLon)
-		:Message(MessageType::AISData, NodeID::None, NodeID::None), m_VesselList(vesselList), m_VesselInfoList(infoList), m_PosLat(posLat), m_PosLon(posLon)
+	AISDataMsg(std::vector<AISVessel> vesselList, std::vector<AISVesselInfo> infoList,
+		float posLat, float posLon)
+		:Message(MessageType::AISData, NodeID::None, NodeID::None),
+		 m_VesselList(std::make_shared<const std::vector<AISVessel>>(std::move(vesselList))),
+		 m_InfoList(std::make_shared<const std::vector<AISVesselInfo>>(std::move(infoList))),
+		 m_PosLat(posLat), m_PosLon(posLon)
+	{ }
+
+	///----------------------------------------------------------------------------------
+	/// Shares the lists of another message instead of copying them.
+	///----------------------------------------------------------------------------------
+	AISDataMsg(NodeID destinationID, NodeID sourceID, VesselListPtr vesselList,
+		VesselInfoListPtr infoList, float posLat, float posLon)
+		:Message(MessageType::AISData, sourceID, destinationID), m_VesselList(std::move(vesselList)),
+		 m_InfoList(std::move(infoList)), m_PosLat(posLat), m_PosLon(posLon)
 	{ }
 
 	AISDataMsg(MessageDeserialiser deserialiser)
-		:Message(deserialiser)
+		:Message(deserialiser), m_PosLat(), m_PosLon()
 	{
+		std::vector<AISVessel> vesselList;
+		std::vector<AISVesselInfo> infoList;
 
-    union f_tag {
-       uint8_t b[4];
-       float fval;
-    } union_float;
-
-		union d_tag {
-			 uint8_t b[8];
-			 double fval;
-		} union_double;
-
-    union i_tag {
-       uint8_t b[4];
-       uint32_t fval;
-    } union_int;
-
-		AISVessel vessel;
-		// TypeConst is the constant size of the messagetype
-		int ves = 0, typeConst = 3;
-		while (deserialiser.size() > ves+typeConst) {
-			if (true) {
-				union_int.b[0] = deserialiser.data()[typeConst+ves];
-				union_int.b[1] = deserialiser.data()[typeConst+ves+1];
-				union_int.b[2] = deserialiser.data()[typeConst+ves+2];
-				union_int.b[3] = deserialiser.data()[typeConst+ves+3];
-				vessel.MMSI = union_int.fval;
-
-				union_float.b[0] = deserialiser.data()[typeConst+ves+4];
-				union_float.b[1] = deserialiser.data()[typeConst+ves+5];
-				union_float.b[2] = deserialiser.data()[typeConst+ves+6];
-				union_float.b[3] = deserialiser.data()[typeConst+ves+7];
-				vessel.COG = union_float.fval;
-
-				union_float.b[0] = deserialiser.data()[typeConst+ves+8];
-				union_float.b[1] = deserialiser.data()[typeConst+ves+9];
-				union_float.b[2] = deserialiser.data()[typeConst+ves+10];
-				union_float.b[3] = deserialiser.data()[typeConst+ves+11];
-				vessel.SOG = union_float.fval;
-
-				union_double.b[0] = deserialiser.data()[typeConst+ves+12];
-				union_double.b[1] = deserialiser.data()[typeConst+ves+13];
-				union_double.b[2] = deserialiser.data()[typeConst+ves+14];
-				union_double.b[3] = deserialiser.data()[typeConst+ves+15];
-				union_double.b[4] = deserialiser.data()[typeConst+ves+16];
-				union_double.b[5] = deserialiser.data()[typeConst+ves+17];
-				union_double.b[6] = deserialiser.data()[typeConst+ves+18];
-				union_double.b[7] = deserialiser.data()[typeConst+ves+19];
-				vessel.latitude = union_double.fval;
-
-				union_double.b[0] = deserialiser.data()[typeConst+ves+20];
-				union_double.b[1] = deserialiser.data()[typeConst+ves+21];
-				union_double.b[2] = deserialiser.data()[typeConst+ves+22];
-				union_double.b[3] = deserialiser.data()[typeConst+ves+23];
-				union_double.b[4] = deserialiser.data()[typeConst+ves+24];
-				union_double.b[5] = deserialiser.data()[typeConst+ves+25];
-				union_double.b[6] = deserialiser.data()[typeConst+ves+26];
-				union_double.b[7] = deserialiser.data()[typeConst+ves+27];
-				vessel.longitude = union_double.fval;
-
-				m_VesselList.push_back(vessel);
+		uint16_t vesselListCount = 0;
+		const uint8_t* data = m_valid ? deserialiser.take(sizeof(vesselListCount)) : NULL;
+		if(data != NULL)
+		{
+			vesselListCount = LittleEndian::readUint16(data);
+			data = deserialiser.take(vesselListCount * 28);
+		}
+		if(data != NULL)
+		{
+			vesselList.resize(vesselListCount);
+			for(uint16_t i = 0; i < vesselListCount; i++, data += 28)
+			{
+				vesselList[i].MMSI = LittleEndian::readUint32(data);
+				vesselList[i].COG = LittleEndian::readFloat(data + 4);
+				vesselList[i].SOG = LittleEndian::readFloat(data + 8);
+				vesselList[i].latitude = LittleEndian::readDouble(data + 12);
+				vesselList[i].longitude = LittleEndian::readDouble(data + 20);
 			}
-			else {
-				m_valid = false;
+		}
+		else
+		{
+			m_valid = false;
+		}
+
+		uint16_t infoListCount = 0;
+		data = m_valid ? deserialiser.take(sizeof(infoListCount)) : NULL;
+		if(data != NULL)
+		{
+			infoListCount = LittleEndian::readUint16(data);
+			data = deserialiser.take(infoListCount * 12);
+		}
+		if(data != NULL)
+		{
+			infoList.resize(infoListCount);
+			for(uint16_t i = 0; i < infoListCount; i++, data += 12)
+			{
+				infoList[i].MMSI = LittleEndian::readUint32(data);
+				infoList[i].length = LittleEndian::readFloat(data + 4);
+				infoList[i].beam = LittleEndian::readFloat(data + 8);
 			}
-			// Add the size of the struct AISVessel [bytes]
-			ves += 28;
 		}
+		else
+		{
+			m_valid = false;
+		}
+
+		data = m_valid ? deserialiser.take(16) : NULL;
+		if(data != NULL)
+		{
+			m_PosLat = LittleEndian::readDouble(data);
+			m_PosLon = LittleEndian::readDouble(data + 8);
+		}
+		else
+		{
+			m_valid = false;
+		}
+
+		m_VesselList = std::make_shared<const std::vector<AISVessel>>(std::move(vesselList));
+		m_InfoList = std::make_shared<const std::vector<AISVesselInfo>>(std::move(infoList));
 	}
 
 	virtual ~AISDataMsg() { }
 
-	std::vector<AISVessel> vesselList() { return m_VesselList; }
-	std::vector<AISVesselInfo> vesselInfoList() { return m_VesselInfoList; }
-	uint32_t MMSI(int vessel) { return m_VesselList[vessel].MMSI; }
-	double latitude(int vessel) { return m_VesselList[vessel].latitude; }
-	double longitude(int vessel) { return m_VesselList[vessel].longitude; }
-	float COG(int vessel) { return m_VesselList[vessel].COG; }
-	float SOG(int vessel) { return m_VesselList[vessel].SOG; }
+	const std::vector<AISVessel>& vesselList() const { return *m_VesselList; }
+	const std::vector<AISVesselInfo>& vesselInfoList() const { return *m_InfoList; }
+	const VesselListPtr& sharedVesselList() const { return m_VesselList; }
+	const VesselInfoListPtr& sharedVesselInfoList() const { return m_InfoList; }
+	uint32_t MMSI(int vessel) const { return (*m_VesselList)[vessel].MMSI; }
+	float COG(int vessel) const { return (*m_VesselList)[vessel].COG; }
+	float SOG(int vessel) const { return (*m_VesselList)[vessel].SOG; }
+	double latitude(int vessel) const { return (*m_VesselList)[vessel].latitude; }
+	double longitude(int vessel) const { return (*m_VesselList)[vessel].longitude; }
 	float posLat() const { return m_PosLat; }
 	float posLon() const { return m_PosLon; }
 
-  ///----------------------------------------------------------------------------------
-	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser. Only the first
+	/// MAX_SERIALISED_VESSELS elements of a list fit into a serialised message.
 	///----------------------------------------------------------------------------------
 	virtual void Serialise(MessageSerialiser& serialiser) const
 	{
 		Message::Serialise(serialiser);
-		if (m_VesselList.size()==0) {
-			return;
-		}
-		for (auto &vessel: m_VesselList) {
-			serialiser.serialise(vessel.MMSI);
-			serialiser.serialise(vessel.COG);
-			serialiser.serialise(vessel.SOG);
-			serialiser.serialise(vessel.latitude);
-			serialiser.serialise(vessel.longitude);
-		}
-		for (auto& info: m_VesselInfoList) {
-			serialiser.serialise(info.MMSI);
-			serialiser.serialise(info.length);
-			serialiser.serialise(info.beam);
+
+		uint16_t vesselListCount = (m_VesselList->size() < MAX_SERIALISED_VESSELS) ?
+			m_VesselList->size() : MAX_SERIALISED_VESSELS;
+		uint16_t infoListCount = (m_InfoList->size() < MAX_SERIALISED_VESSELS) ?
+			m_InfoList->size() : MAX_SERIALISED_VESSELS;
+
+		uint8_t* data = serialiser.reserve(sizeof(vesselListCount) + vesselListCount * 28 +
+			sizeof(infoListCount) + infoListCount * 12 + 16);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, vesselListCount);
+			for(uint16_t i = 0; i < vesselListCount; i++)
+			{
+				const AISVessel& element = (*m_VesselList)[i];
+				data = LittleEndian::write(data, element.MMSI);
+				data = LittleEndian::write(data, element.COG);
+				data = LittleEndian::write(data, element.SOG);
+				data = LittleEndian::write(data, element.latitude);
+				data = LittleEndian::write(data, element.longitude);
+			}
+			data = LittleEndian::write(data, infoListCount);
+			for(uint16_t i = 0; i < infoListCount; i++)
+			{
+				const AISVesselInfo& element = (*m_InfoList)[i];
+				data = LittleEndian::write(data, element.MMSI);
+				data = LittleEndian::write(data, element.length);
+				data = LittleEndian::write(data, element.beam);
+			}
+			data = LittleEndian::write(data, m_PosLat);
+			data = LittleEndian::write(data, m_PosLon);
 		}
-		serialiser.serialise(m_PosLat);
-		serialiser.serialise(m_PosLon);
 	}
 
+	// The message header, both counts, the position and this many vessels and vessel infos
+	// fit into MAX_MESSAGE_SIZE
+	static const size_t MAX_SERIALISED_VESSELS = 100;
+
+private:
+	VesselListPtr     m_VesselList;
+	VesselInfoListPtr m_InfoList;
+	double            m_PosLat;
+	double            m_PosLon;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised AISDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class AISDataView : public MessageView {
+public:
+	AISDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::AISData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		m_VesselListOffset = offset + sizeof(m_VesselListCount);
+		skipList(offset, m_VesselListCount, 28);
+		m_InfoListOffset = offset + sizeof(m_InfoListCount);
+		skipList(offset, m_InfoListCount, 12);
+		m_PosLatOffset = offset;
+		skip(offset, 16);
+	}
+
+	uint16_t vesselListCount() const { return m_VesselListCount; }
+	AISVessel vesselListAt(uint16_t index) const
+	{
+		const uint8_t* data = m_Data + m_VesselListOffset + index * 28;
+		AISVessel element;
+		element.MMSI = LittleEndian::readUint32(data);
+		element.COG = LittleEndian::readFloat(data + 4);
+		element.SOG = LittleEndian::readFloat(data + 8);
+		element.latitude = LittleEndian::readDouble(data + 12);
+		element.longitude = LittleEndian::readDouble(data + 20);
+		return element;
+	}
+	uint16_t vesselInfoListCount() const { return m_InfoListCount; }
+	AISVesselInfo vesselInfoListAt(uint16_t index) const
+	{
+		const uint8_t* data = m_Data + m_InfoListOffset + index * 12;
+		AISVesselInfo element;
+		element.MMSI = LittleEndian::readUint32(data);
+		element.length = LittleEndian::readFloat(data + 4);
+		element.beam = LittleEndian::readFloat(data + 8);
+		return element;
+	}
+	float posLat() const { return LittleEndian::readDouble(m_Data + m_PosLatOffset); }
+	float posLon() const { return LittleEndian::readDouble(m_Data + m_PosLatOffset + 8); }
+
 private:
-	std::vector<AISVessel> m_VesselList;
-	std::vector<AISVesselInfo> m_VesselInfoList;
-	double m_PosLat;
-	double m_PosLon;
+	uint32_t m_VesselListOffset;
+	uint16_t m_VesselListCount;
+	uint32_t m_InfoListOffset;
+	uint16_t m_InfoListCount;
+	uint32_t m_PosLatOffset;
 };
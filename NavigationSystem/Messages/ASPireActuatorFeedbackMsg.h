@@ -1,36 +1,113 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		ASPireActuatorFeedbackMsg.h
+ *
+ * Purpose:
+ *		The positions the actuators of ASPire report back.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
+
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class ASPireActuatorFeedbackMsg : public Message {
 public:
-    ASPireActuatorFeedbackMsg(NodeID sourceID, NodeID destinationID, double wingsailFeedback,
-                                double rudderFeedback, double windvaneAngle, double windvaneActuatorPos, bool radioControllerOn)
-    : Message(MessageType::ASPireActuatorFeedback, sourceID, destinationID),
-    m_WingsailFeedback(wingsailFeedback), m_RudderFeedback(rudderFeedback),
-    m_WindvaneSelfSteeringAngle(windvaneAngle), m_WindvaneActuatorPosition(windvaneActuatorPos), m_RadioControllerOn(radioControllerOn)
-    {  }
-
-    ASPireActuatorFeedbackMsg( double wingsailFeedback, double rudderFeedback,
-                                   double windvaneAngle, double windvaneActuatorPos, bool radioControllerOn)
-    : Message(MessageType::ASPireActuatorFeedback, NodeID::None, NodeID::None),
-    m_WingsailFeedback(wingsailFeedback), m_RudderFeedback(rudderFeedback),
-    m_WindvaneSelfSteeringAngle(windvaneAngle), m_WindvaneActuatorPosition(windvaneActuatorPos), m_RadioControllerOn(radioControllerOn)
-    {  }
-
-    virtual ~ASPireActuatorFeedbackMsg() { }
-
-    double wingsailFeedback() const          { return m_WingsailFeedback; }
-    double rudderFeedback() const            { return m_RudderFeedback; }
-    double windvaneSelfSteeringAngle() const { return m_WindvaneSelfSteeringAngle; }
-    double windvaneActuatorPosition()  const { return m_WindvaneActuatorPosition; }
-	bool radioControllerOn() 				   const { return m_RadioControllerOn; }
+	static const MessageType TYPE = MessageType::ASPireActuatorFeedback;
+
+	ASPireActuatorFeedbackMsg(NodeID sourceID, NodeID destinationID, double wingsailFeedback,
+		double rudderFeedback, double windvaneAngle, double windvaneActuatorPos,
+		bool radioControllerOn)
+		:Message(MessageType::ASPireActuatorFeedback, sourceID, destinationID),
+		 m_WingsailFeedback(wingsailFeedback), m_RudderFeedback(rudderFeedback),
+		 m_WindvaneAngle(windvaneAngle), m_WindvaneActuatorPos(windvaneActuatorPos),
+		 m_RadioControllerOn(radioControllerOn)
+	{ }
+
+	ASPireActuatorFeedbackMsg(double wingsailFeedback, double rudderFeedback,
+		double windvaneAngle, double windvaneActuatorPos, bool radioControllerOn)
+		:Message(MessageType::ASPireActuatorFeedback, NodeID::None, NodeID::None),
+		 m_WingsailFeedback(wingsailFeedback), m_RudderFeedback(rudderFeedback),
+		 m_WindvaneAngle(windvaneAngle), m_WindvaneActuatorPos(windvaneActuatorPos),
+		 m_RadioControllerOn(radioControllerOn)
+	{ }
+
+	ASPireActuatorFeedbackMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_WingsailFeedback(), m_RudderFeedback(), m_WindvaneAngle(),
+		 m_WindvaneActuatorPos(), m_RadioControllerOn()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(33) : NULL;
+		if(data != NULL)
+		{
+			m_WingsailFeedback = LittleEndian::readDouble(data);
+			m_RudderFeedback = LittleEndian::readDouble(data + 8);
+			m_WindvaneAngle = LittleEndian::readDouble(data + 16);
+			m_WindvaneActuatorPos = LittleEndian::readDouble(data + 24);
+			m_RadioControllerOn = LittleEndian::readBool(data + 32);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
+
+	virtual ~ASPireActuatorFeedbackMsg() { }
+
+	double wingsailFeedback() const { return m_WingsailFeedback; }
+	double rudderFeedback() const { return m_RudderFeedback; }
+	double windvaneSelfSteeringAngle() const { return m_WindvaneAngle; }
+	double windvaneActuatorPosition() const { return m_WindvaneActuatorPos; }
+	bool radioControllerOn() const { return m_RadioControllerOn; }
+
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(33);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_WingsailFeedback);
+			data = LittleEndian::write(data, m_RudderFeedback);
+			data = LittleEndian::write(data, m_WindvaneAngle);
+			data = LittleEndian::write(data, m_WindvaneActuatorPos);
+			data = LittleEndian::write(data, m_RadioControllerOn);
+		}
+	}
 
 private:
-    double m_WingsailFeedback;          // degree in wing sail reference frame (clockwise from top view)
-    double m_RudderFeedback;            // degree in vessel reference frame (clockwise from top view)
-    double m_WindvaneSelfSteeringAngle; // degree
-    double m_WindvaneActuatorPosition;
+	double m_WingsailFeedback;     // degree in wing sail reference frame (clockwise from top view)
+	double m_RudderFeedback;       // degree in vessel reference frame (clockwise from top view)
+	double m_WindvaneAngle;        // degree
+	double m_WindvaneActuatorPos;
 	bool   m_RadioControllerOn;
 };
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised ASPireActuatorFeedbackMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class ASPireActuatorFeedbackView : public MessageView {
+public:
+	ASPireActuatorFeedbackView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::ASPireActuatorFeedback)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 33);
+	}
+
+	double wingsailFeedback() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE); }
+	double rudderFeedback() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 8); }
+	double windvaneSelfSteeringAngle() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 16); }
+	double windvaneActuatorPosition() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 24); }
+	bool radioControllerOn() const { return LittleEndian::readBool(m_Data + HEADER_SIZE + 32); }
+};
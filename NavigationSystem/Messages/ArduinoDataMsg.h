@@ -7,33 +7,44 @@
  *		An ArduinoDataMsg contains arduino data such as pressure, rudder, sheet, battery.
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class ArduinoDataMsg : public Message {
 public:
-	ArduinoDataMsg(NodeID destinationID, NodeID sourceID, int pressure, int rudder, int sheet, int battery)
-		:Message(MessageType::ArduinoData, sourceID, destinationID), m_pressure(pressure), m_rudder(rudder), m_sheet(sheet), m_battery(battery)
+	static const MessageType TYPE = MessageType::ArduinoData;
+
+	ArduinoDataMsg(NodeID destinationID, NodeID sourceID, int pressure, int rudder, int sheet,
+		int battery)
+		:Message(MessageType::ArduinoData, sourceID, destinationID), m_Pressure(pressure),
+		 m_Rudder(rudder), m_Sheet(sheet), m_Battery(battery)
 	{ }
 
 	ArduinoDataMsg(int pressure, int rudder, int sheet, int battery)
-		:Message(MessageType::ArduinoData, NodeID::None, NodeID::None), m_pressure(pressure), m_rudder(rudder), m_sheet(sheet), m_battery(battery)
+		:Message(MessageType::ArduinoData, NodeID::None, NodeID::None), m_Pressure(pressure),
+		 m_Rudder(rudder), m_Sheet(sheet), m_Battery(battery)
 	{ }
 
 	ArduinoDataMsg(MessageDeserialiser deserialiser)
-		:Message(deserialiser)
+		:Message(deserialiser), m_Pressure(), m_Rudder(), m_Sheet(), m_Battery()
 	{
-		if(	!deserialiser.readInt(m_pressure) ||
-			!deserialiser.readInt(m_rudder) ||
-			!deserialiser.readInt(m_sheet) ||
-			!deserialiser.readInt(m_battery))
-			
+		const uint8_t* data = m_valid ? deserialiser.take(16) : NULL;
+		if(data != NULL)
+		{
+			m_Pressure = LittleEndian::readInt(data);
+			m_Rudder = LittleEndian::readInt(data + 4);
+			m_Sheet = LittleEndian::readInt(data + 8);
+			m_Battery = LittleEndian::readInt(data + 12);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -41,30 +52,50 @@ public:
 
 	virtual ~ArduinoDataMsg() { }
 
-	int pressure() { return m_pressure; }
-	int rudder() { return m_rudder; }
-	int sheet() { return m_sheet; }
-    int battery() { return m_battery; }
-	
+	int pressure() const { return m_Pressure; }
+	int rudder() const { return m_Rudder; }
+	int sheet() const { return m_Sheet; }
+	int battery() const { return m_Battery; }
 
-    ///----------------------------------------------------------------------------------
+	///----------------------------------------------------------------------------------
 	/// Serialises the message into a MessageSerialiser
 	///----------------------------------------------------------------------------------
 	virtual void Serialise(MessageSerialiser& serialiser) const
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_pressure);
-		serialiser.serialise(m_rudder);
-		serialiser.serialise(m_sheet);
-		serialiser.serialise(m_battery);
-		
+		uint8_t* data = serialiser.reserve(16);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_Pressure);
+			data = LittleEndian::write(data, m_Rudder);
+			data = LittleEndian::write(data, m_Sheet);
+			data = LittleEndian::write(data, m_Battery);
+		}
 	}
 
 private:
-	int m_pressure;
-	int m_rudder;
-	int m_sheet;
-  int m_battery;
-	
+	int m_Pressure;
+	int m_Rudder;
+	int m_Sheet;
+	int m_Battery;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised ArduinoDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class ArduinoDataView : public MessageView {
+public:
+	ArduinoDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::ArduinoData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 16);
+	}
+
+	int pressure() const { return LittleEndian::readInt(m_Data + HEADER_SIZE); }
+	int rudder() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 4); }
+	int sheet() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 8); }
+	int battery() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 12); }
 };
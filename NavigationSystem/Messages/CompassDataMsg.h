@@ -7,31 +7,42 @@
  *		A CompassDataMsg contains compass data such as heading, pitch, and roll.
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class CompassDataMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::CompassData;
+
 	CompassDataMsg(NodeID destinationID, NodeID sourceID, int heading, int pitch, int roll)
-		:Message(MessageType::CompassData, sourceID, destinationID), m_Heading(heading), m_Pitch(pitch), m_Roll(roll)
+		:Message(MessageType::CompassData, sourceID, destinationID), m_Heading(heading),
+		 m_Pitch(pitch), m_Roll(roll)
 	{ }
 
 	CompassDataMsg(int heading, int pitch, int roll)
-		:Message(MessageType::CompassData, NodeID::None, NodeID::None), m_Heading(heading), m_Pitch(pitch), m_Roll(roll)
+		:Message(MessageType::CompassData, NodeID::None, NodeID::None), m_Heading(heading),
+		 m_Pitch(pitch), m_Roll(roll)
 	{ }
 
-	CompassDataMsg(MessageDeserialiser& deserialiser)
-		:Message(deserialiser)
+	CompassDataMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_Heading(), m_Pitch(), m_Roll()
 	{
-		if(	!deserialiser.readInt(m_Heading) ||
-			!deserialiser.readInt(m_Pitch) ||
-			!deserialiser.readInt(m_Roll))
+		const uint8_t* data = m_valid ? deserialiser.take(12) : NULL;
+		if(data != NULL)
+		{
+			m_Heading = LittleEndian::readInt(data);
+			m_Pitch = LittleEndian::readInt(data + 4);
+			m_Roll = LittleEndian::readInt(data + 8);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -50,13 +61,35 @@ public:
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_Heading);
-		serialiser.serialise(m_Pitch);
-		serialiser.serialise(m_Roll);
+		uint8_t* data = serialiser.reserve(12);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_Heading);
+			data = LittleEndian::write(data, m_Pitch);
+			data = LittleEndian::write(data, m_Roll);
+		}
 	}
 
 private:
-	int m_Heading;		// degree [0, 360[ in North-East-Down reference frame
-	int m_Pitch;		// degree ]-90, +90] in North-East-Down reference frame
-	int m_Roll;			// degree ]-180, +180] in North-East-Down reference frame
+	int m_Heading;  // degree [0, 360[ in North-East-Down reference frame
+	int m_Pitch;    // degree ]-90, +90] in North-East-Down reference frame
+	int m_Roll;     // degree ]-180, +180] in North-East-Down reference frame
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised CompassDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class CompassDataView : public MessageView {
+public:
+	CompassDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::CompassData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 12);
+	}
+
+	int heading() const { return LittleEndian::readInt(m_Data + HEADER_SIZE); }
+	int pitch() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 4); }
+	int roll() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 8); }
 };
@@ -7,32 +7,43 @@
  *		A CourseDataMsg contains information about the boats current course
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class CourseDataMsg : public Message {
 public:
-	CourseDataMsg(NodeID destinationID, NodeID sourceID, float twd, float distanceToWaypoint, float courseToWaypoint)
-		:Message(MessageType::CourseData, sourceID, destinationID), m_twd(twd), m_dtw(distanceToWaypoint), m_ctw(courseToWaypoint) { }
+	static const MessageType TYPE = MessageType::CourseData;
 
-	CourseDataMsg(float twd, float distanceToWaypoint, float courseToWaypoint)
-		:Message(MessageType::CourseData, NodeID::None, NodeID::None), m_twd(twd), m_dtw(distanceToWaypoint), m_ctw(courseToWaypoint)
-	{
+	CourseDataMsg(NodeID destinationID, NodeID sourceID, float twd, float distanceToWaypoint,
+		float courseToWaypoint)
+		:Message(MessageType::CourseData, sourceID, destinationID), m_Twd(twd),
+		 m_DistanceToWaypoint(distanceToWaypoint), m_CourseToWaypoint(courseToWaypoint)
+	{ }
 
-	}
+	CourseDataMsg(float twd, float distanceToWaypoint, float courseToWaypoint)
+		:Message(MessageType::CourseData, NodeID::None, NodeID::None), m_Twd(twd),
+		 m_DistanceToWaypoint(distanceToWaypoint), m_CourseToWaypoint(courseToWaypoint)
+	{ }
 
 	CourseDataMsg(MessageDeserialiser deserialiser)
-		:Message(deserialiser)
+		:Message(deserialiser), m_Twd(), m_DistanceToWaypoint(), m_CourseToWaypoint()
 	{
-		if(	!deserialiser.readFloat(m_twd) ||
-			!deserialiser.readFloat(m_dtw) ||
-			!deserialiser.readFloat(m_ctw))
+		const uint8_t* data = m_valid ? deserialiser.take(12) : NULL;
+		if(data != NULL)
+		{
+			m_Twd = LittleEndian::readFloat(data);
+			m_DistanceToWaypoint = LittleEndian::readFloat(data + 4);
+			m_CourseToWaypoint = LittleEndian::readFloat(data + 8);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -40,23 +51,46 @@ public:
 
 	virtual ~CourseDataMsg() { }
 
+	float trueWindDir() const { return m_Twd; }
+	float distanceToWP() const { return m_DistanceToWaypoint; }
+	float courseToWP() const { return m_CourseToWaypoint; }
+
 	///----------------------------------------------------------------------------------
 	/// Serialises the message into a MessageSerialiser
 	///----------------------------------------------------------------------------------
 	virtual void Serialise(MessageSerialiser& serialiser) const
 	{
 		Message::Serialise(serialiser);
-		serialiser.serialise(m_twd);
-		serialiser.serialise(m_dtw);
-		serialiser.serialise(m_ctw);
-	}
 
-	float trueWindDir() const { return m_twd; }
-	float distanceToWP() const { return m_dtw; }
-	float courseToWP() const { return m_ctw; }
+		uint8_t* data = serialiser.reserve(12);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_Twd);
+			data = LittleEndian::write(data, m_DistanceToWaypoint);
+			data = LittleEndian::write(data, m_CourseToWaypoint);
+		}
+	}
 
 private:
-	float m_twd; // True wind direction
-	float m_dtw; // Distance to waypoint
-	float m_ctw; // Course to waypoint
+	float m_Twd;                 // True wind direction
+	float m_DistanceToWaypoint;  // Distance to waypoint
+	float m_CourseToWaypoint;    // Course to waypoint
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised CourseDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class CourseDataView : public MessageView {
+public:
+	CourseDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::CourseData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 12);
+	}
+
+	float trueWindDir() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
+	float distanceToWP() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 4); }
+	float courseToWP() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 8); }
 };
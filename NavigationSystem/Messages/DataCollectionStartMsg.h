@@ -7,46 +7,79 @@
  *		A DataCollectionStartMsg starts automatic readings from marine sensors on a certain interval
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
+
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class DataCollectionStartMsg : public Message {
 public:
-    DataCollectionStartMsg(NodeID destinationID, NodeID sourceID, int sensorReadingInterval)
-            :Message(MessageType::DataCollectionStart, sourceID, destinationID), m_sensorReadingInterval(sensorReadingInterval) { }
+	static const MessageType TYPE = MessageType::DataCollectionStart;
 
-    DataCollectionStartMsg(int sensorReadingInterval)
-            :Message(MessageType::DataCollectionStart, NodeID::None, NodeID::None), m_sensorReadingInterval(sensorReadingInterval)
-    {
+	DataCollectionStartMsg(NodeID destinationID, NodeID sourceID, int sensorReadingInterval)
+		:Message(MessageType::DataCollectionStart, sourceID, destinationID),
+		 m_SensorReadingInterval(sensorReadingInterval)
+	{ }
 
-    }
+	DataCollectionStartMsg(int sensorReadingInterval)
+		:Message(MessageType::DataCollectionStart, NodeID::None, NodeID::None),
+		 m_SensorReadingInterval(sensorReadingInterval)
+	{ }
 
-    DataCollectionStartMsg(MessageDeserialiser deserialiser) : Message(deserialiser)
-    {
-        if(	!deserialiser.readInt(m_sensorReadingInterval))
-        {
-            m_valid = false;
-        }
-    }
+	DataCollectionStartMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_SensorReadingInterval()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(4) : NULL;
+		if(data != NULL)
+		{
+			m_SensorReadingInterval = LittleEndian::readInt(data);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
 
-    virtual ~DataCollectionStartMsg() { }
+	virtual ~DataCollectionStartMsg() { }
 
-    ///----------------------------------------------------------------------------------
-    /// Serialises the message into a MessageSerialiser
-    ///----------------------------------------------------------------------------------
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
-        serialiser.serialise(m_sensorReadingInterval);
-    }
+	int getSensorReadingInterval() const { return m_SensorReadingInterval; }
 
-    int getSensorReadingInterval() const { return m_sensorReadingInterval; }
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(4);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_SensorReadingInterval);
+		}
+	}
 
 private:
-    int m_sensorReadingInterval;
+	int m_SensorReadingInterval;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised DataCollectionStartMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class DataCollectionStartView : public MessageView {
+public:
+	DataCollectionStartView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::DataCollectionStart)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 4);
+	}
+
+	int getSensorReadingInterval() const { return LittleEndian::readInt(m_Data + HEADER_SIZE); }
 };
@@ -7,25 +7,43 @@
  *		A DataCollectionStopMsg is used to stop automatic reading from marine sensors
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
+
 
 class DataCollectionStopMsg : public Message {
 public:
-    DataCollectionStopMsg(NodeID destinationID, NodeID sourceID)
-            :Message(MessageType::DataCollectionStop, sourceID, destinationID) { }
+	static const MessageType TYPE = MessageType::DataCollectionStop;
 
-    DataCollectionStopMsg(NodeID destinationID)
-            :Message(MessageType::DataCollectionStop, NodeID::None, destinationID) { }
+	DataCollectionStopMsg(NodeID destinationID, NodeID sourceID)
+		:Message(MessageType::DataCollectionStop, sourceID, destinationID)
+	{ }
 
-    DataCollectionStopMsg(MessageDeserialiser deserialiser)
-            :Message(deserialiser)
-    { }
+	DataCollectionStopMsg(NodeID destinationID)
+		:Message(MessageType::DataCollectionStop, NodeID::None, destinationID)
+	{ }
 
-    virtual ~DataCollectionStopMsg() { }
+	DataCollectionStopMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser)
+	{ }
+
+	virtual ~DataCollectionStopMsg() { }
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised DataCollectionStopMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class DataCollectionStopView : public MessageView {
+public:
+	DataCollectionStopView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::DataCollectionStop)
+	{ }
 };
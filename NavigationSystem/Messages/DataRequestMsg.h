@@ -4,29 +4,36 @@
  * 		DataRequestMsg.h
  *
  * Purpose:
- *		A DataRequestMsg is used to instruct a node to offer up any data it is storing 
+ *		A DataRequestMsg is used to instruct a node to offer up any data it is storing
  *		the message bus.
  *
  * Developer Notes:
- *		If the source id of this message is set, it should be used as
- *		the returen address, otherwise post the returning data message to the message 
- *		bus for general consumption.
+ *		If the source id of this message is set, it should be used as the return
+ *		address, otherwise post the returning data message to the message bus for
+ *		general consumption.
  *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class DataRequestMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::DataRequest;
+
 	DataRequestMsg(NodeID destinationID, NodeID sourceID)
-		:Message(MessageType::DataRequest, sourceID, destinationID) { }
+		:Message(MessageType::DataRequest, sourceID, destinationID)
+	{ }
 
 	DataRequestMsg(NodeID destinationID)
-		:Message(MessageType::DataRequest, NodeID::None, destinationID) { }
+		:Message(MessageType::DataRequest, NodeID::None, destinationID)
+	{ }
 
 	DataRequestMsg(MessageDeserialiser deserialiser)
 		:Message(deserialiser)
@@ -34,3 +41,14 @@ public:
 
 	virtual ~DataRequestMsg() { }
 };
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised DataRequestMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class DataRequestView : public MessageView {
+public:
+	DataRequestView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::DataRequest)
+	{ }
+};
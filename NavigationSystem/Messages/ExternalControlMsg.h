@@ -5,32 +5,43 @@
  *
  * Purpose:
  *		Contains a boolean that will notify the Sailing Logic that an external control
- *      will send actuator messages instead
+ *		will send actuator messages instead
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
-
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class ExternalControlMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::ExternalControl;
+
 	ExternalControlMsg(NodeID destinationID, NodeID sourceID, bool externalControlActive)
-		:Message(MessageType::ExternalControl, sourceID, destinationID), m_externalControlActive(externalControlActive)
+		:Message(MessageType::ExternalControl, sourceID, destinationID),
+		 m_ExternalControlActive(externalControlActive)
 	{ }
 
 	ExternalControlMsg(bool externalControlActive)
-		:Message(MessageType::ExternalControl, NodeID::None, NodeID::None), m_externalControlActive(externalControlActive)
+		:Message(MessageType::ExternalControl, NodeID::None, NodeID::None),
+		 m_ExternalControlActive(externalControlActive)
 	{ }
 
 	ExternalControlMsg(MessageDeserialiser deserialiser)
-	:Message(deserialiser)
+		:Message(deserialiser), m_ExternalControlActive()
 	{
-		if(	!deserialiser.readBool(m_externalControlActive))
+		const uint8_t* data = m_valid ? deserialiser.take(1) : NULL;
+		if(data != NULL)
+		{
+			m_ExternalControlActive = LittleEndian::readBool(data);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -38,20 +49,38 @@ public:
 
 	virtual ~ExternalControlMsg() { }
 
+	bool externalControlActive() const { return m_ExternalControlActive; }
 
-    bool     externalControlActive()            { return m_externalControlActive; }
-
-    ///----------------------------------------------------------------------------------
+	///----------------------------------------------------------------------------------
 	/// Serialises the message into a MessageSerialiser
 	///----------------------------------------------------------------------------------
 	virtual void Serialise(MessageSerialiser& serialiser) const
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_externalControlActive);
+		uint8_t* data = serialiser.reserve(1);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_ExternalControlActive);
+		}
 	}
 
 private:
+	bool m_ExternalControlActive;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised ExternalControlMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class ExternalControlView : public MessageView {
+public:
+	ExternalControlView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::ExternalControl)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 1);
+	}
 
-    bool m_externalControlActive;
-};
\ No newline at end of file
+	bool externalControlActive() const { return LittleEndian::readBool(m_Data + HEADER_SIZE); }
+};
@@ -7,63 +7,67 @@
  *		Contains GPS Data.
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 enum class GPSMode
 {
-	NoUpdate = 0,	// Indicates that a update hasn't occured yet
-	NoFix,			// Indicates that there is no GPS fix
-	LatLonOk,		// Indicates that the latitude/longitude data is good
-	LatLonAltOk		// Indicates that the latitude/longitude/altitude data is good
+	NoUpdate = 0,      // Indicates that a update hasn't occured yet
+	NoFix,             // Indicates that there is no GPS fix
+	LatLonOk,          // Indicates that the latitude/longitude data is good
+	LatLonAltOk        // Indicates that the latitude/longitude/altitude data is good
 };
 
 
 class GPSDataMsg : public Message {
 public:
-	GPSDataMsg(	NodeID destinationID, NodeID sourceID, bool hasFix, bool online, double lat,
-				double lon, double unixTime, double speed, double course, int satCount, GPSMode mode)
+	static const MessageType TYPE = MessageType::GPSData;
 
+	GPSDataMsg(NodeID destinationID, NodeID sourceID, bool hasFix, bool online, double lat,
+		double lon, double unixTime, double speed, double course, int satCount, GPSMode mode)
 		:Message(MessageType::GPSData, sourceID, destinationID), m_HasFix(hasFix), m_Online(online),
 		 m_Lat(lat), m_Lon(lon), m_UnixTime(unixTime), m_Speed(speed), m_Course(course),
 		 m_SatCount(satCount), m_Mode(mode)
 	{ }
 
-	GPSDataMsg(	bool hasFix, bool online, double lat, double lon, double unixTime, double speed,
-				double course, int satCount, GPSMode mode)
-
-		:Message(MessageType::GPSData, NodeID::None, NodeID::None), m_HasFix(hasFix), m_Online(online),
-		 m_Lat(lat), m_Lon(lon), m_UnixTime(unixTime), m_Speed(speed), m_Course(course),
-		 m_SatCount(satCount), m_Mode(mode)
+	GPSDataMsg(bool hasFix, bool online, double lat, double lon, double unixTime, double speed,
+		double course, int satCount, GPSMode mode)
+		:Message(MessageType::GPSData, NodeID::None, NodeID::None), m_HasFix(hasFix),
+		 m_Online(online), m_Lat(lat), m_Lon(lon), m_UnixTime(unixTime), m_Speed(speed),
+		 m_Course(course), m_SatCount(satCount), m_Mode(mode)
 	{ }
 
-
 	GPSDataMsg(MessageDeserialiser deserialiser)
-		:Message(deserialiser)
+		:Message(deserialiser), m_HasFix(), m_Online(), m_Lat(), m_Lon(), m_UnixTime(), m_Speed(),
+		 m_Course(), m_SatCount(), m_Mode()
 	{
-		uint8_t mode = 0;
-		if(	!deserialiser.readBool(m_HasFix) ||
-			!deserialiser.readBool(m_Online) ||
-			!deserialiser.readDouble(m_Lat) ||
-			!deserialiser.readDouble(m_Lon) ||
-			!deserialiser.readDouble(m_UnixTime) ||
-			!deserialiser.readDouble(m_Speed) ||
-			!deserialiser.readDouble(m_Course) ||
-			!deserialiser.readInt(m_SatCount) ||
-			!deserialiser.readUint8_t(mode))
+		const uint8_t* data = m_valid ? deserialiser.take(47) : NULL;
+		if(data != NULL)
+		{
+			m_HasFix = LittleEndian::readBool(data);
+			m_Online = LittleEndian::readBool(data + 1);
+			m_Lat = LittleEndian::readDouble(data + 2);
+			m_Lon = LittleEndian::readDouble(data + 10);
+			m_UnixTime = LittleEndian::readDouble(data + 18);
+			m_Speed = LittleEndian::readDouble(data + 26);
+			m_Course = LittleEndian::readDouble(data + 34);
+			m_SatCount = LittleEndian::readInt(data + 42);
+			m_Mode = (GPSMode)LittleEndian::readUint8(data + 46);
+		}
+		else
 		{
 			m_valid = false;
 		}
-
-		m_Mode = (GPSMode)mode;
 	}
 
-
 	virtual ~GPSDataMsg() { }
 
 	bool hasFix() const { return m_HasFix; }
@@ -83,25 +87,53 @@ public:
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_HasFix);
-		serialiser.serialise(m_Online);
-		serialiser.serialise(m_Lat);
-		serialiser.serialise(m_Lon);
-		serialiser.serialise(m_UnixTime);
-		serialiser.serialise(m_Speed);
-		serialiser.serialise(m_Course);
-		serialiser.serialise(m_SatCount);
-		serialiser.serialise((uint8_t)m_Mode);
+		uint8_t* data = serialiser.reserve(47);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_HasFix);
+			data = LittleEndian::write(data, m_Online);
+			data = LittleEndian::write(data, m_Lat);
+			data = LittleEndian::write(data, m_Lon);
+			data = LittleEndian::write(data, m_UnixTime);
+			data = LittleEndian::write(data, m_Speed);
+			data = LittleEndian::write(data, m_Course);
+			data = LittleEndian::write(data, m_SatCount);
+			data = LittleEndian::write(data, (uint8_t)m_Mode);
+		}
 	}
 
 private:
-	bool	m_HasFix;
-	bool	m_Online;
-	double	m_Lat;
-	double	m_Lon;
-	double	m_UnixTime;
-	double	m_Speed;		// m/s
-	double	m_Course;		// degree [0, 360[ in North-East reference frame (clockwise)
-	int		m_SatCount;
-	GPSMode	m_Mode;
+	bool    m_HasFix;
+	bool    m_Online;
+	double  m_Lat;
+	double  m_Lon;
+	double  m_UnixTime;
+	double  m_Speed;     // m/s
+	double  m_Course;    // degree [0, 360[ in North-East reference frame (clockwise)
+	int     m_SatCount;
+	GPSMode m_Mode;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised GPSDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class GPSDataView : public MessageView {
+public:
+	GPSDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::GPSData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 47);
+	}
+
+	bool hasFix() const { return LittleEndian::readBool(m_Data + HEADER_SIZE); }
+	bool gpsOnline() const { return LittleEndian::readBool(m_Data + HEADER_SIZE + 1); }
+	double latitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 2); }
+	double longitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 10); }
+	double unixTime() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 18); }
+	double speed() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 26); }
+	double course() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 34); }
+	int satelliteCount() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 42); }
+	GPSMode gpsMode() const { return (GPSMode)LittleEndian::readUint8(m_Data + HEADER_SIZE + 46); }
 };
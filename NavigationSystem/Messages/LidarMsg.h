@@ -1,41 +1,48 @@
 /****************************************************************************************
  *
  * File:
- * 		LidarMsg
+ * 		LidarMsg.h
  *
  * Purpose:
  *		Contains a distance in cm
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class LidarMsg : public Message {
 public:
-	LidarMsg(	NodeID destinationID, NodeID sourceID,int distance )
+	static const MessageType TYPE = MessageType::LidarData;
 
-		:Message(MessageType::LidarData, sourceID, destinationID),m_distance(distance)
+	LidarMsg(NodeID destinationID, NodeID sourceID, int distance)
+		:Message(MessageType::LidarData, sourceID, destinationID), m_Distance(distance)
 	{ }
 
-    LidarMsg(NodeID sourceID, int distance)
-
-		:Message(MessageType::LidarData,sourceID, NodeID::None), m_distance(distance)
+	LidarMsg(NodeID sourceID, int distance)
+		:Message(MessageType::LidarData, sourceID, NodeID::None), m_Distance(distance)
 	{ }
 
 	LidarMsg(int distance)
-
-		:Message(MessageType::LidarData, NodeID::None, NodeID::None), m_distance(distance)
+		:Message(MessageType::LidarData, NodeID::None, NodeID::None), m_Distance(distance)
 	{ }
 
 	LidarMsg(MessageDeserialiser deserialiser)
-		:Message(deserialiser)
+		:Message(deserialiser), m_Distance()
 	{
-		if(!deserialiser.readInt(m_distance))
+		const uint8_t* data = m_valid ? deserialiser.take(4) : NULL;
+		if(data != NULL)
+		{
+			m_Distance = LittleEndian::readInt(data);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -43,6 +50,8 @@ public:
 
 	virtual ~LidarMsg() { }
 
+	int distance() const { return m_Distance; }
+
 	///----------------------------------------------------------------------------------
 	/// Serialises the message into a MessageSerialiser
 	///----------------------------------------------------------------------------------
@@ -50,12 +59,29 @@ public:
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_distance);
+		uint8_t* data = serialiser.reserve(4);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_Distance);
+		}
 	}
 
+private:
+	int m_Distance;
+};
 
-	int distance() { return m_distance; }
 
-private:
-	int	m_distance;
+///----------------------------------------------------------------------------------
+/// Reads a serialised LidarMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class LidarView : public MessageView {
+public:
+	LidarView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::LidarData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 4);
+	}
+
+	int distance() const { return LittleEndian::readInt(m_Data + HEADER_SIZE); }
 };
@@ -1,19 +1,27 @@
-
 /****************************************************************************************
+ *
+ * File:
+ * 		LocalConfigChangeMsg.h
+ *
  * Purpose:
  *		Notify receivers that the configuration settings in the local database have changed
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class LocalConfigChangeMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::LocalConfigChange;
+
 	LocalConfigChangeMsg(NodeID destinationID, NodeID sourceID)
 		:Message(MessageType::LocalConfigChange, sourceID, destinationID)
 	{ }
@@ -27,5 +35,15 @@ public:
 	{ }
 
 	virtual ~LocalConfigChangeMsg() { }
+};
+
 
+///----------------------------------------------------------------------------------
+/// Reads a serialised LocalConfigChangeMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class LocalConfigChangeView : public MessageView {
+public:
+	LocalConfigChangeView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::LocalConfigChange)
+	{ }
 };
@@ -1,60 +1,105 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LocalNavigationMsg.h
+ *
+ * Purpose:
+ *		The course and speed the local navigation wants the vessel to sail at.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
+
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class LocalNavigationMsg : public Message {
-
 public:
+	static const MessageType TYPE = MessageType::LocalNavigation;
+
+	LocalNavigationMsg(NodeID sourceID, NodeID destinationID, float targetCourse,
+		float targetSpeed, bool beatingMode, bool targetTackStarboard)
+		:Message(MessageType::LocalNavigation, sourceID, destinationID),
+		 m_TargetCourse(targetCourse), m_TargetSpeed(targetSpeed), m_BeatingMode(beatingMode),
+		 m_TargetTackStarboard(targetTackStarboard)
+	{ }
+
+	LocalNavigationMsg(float targetCourse, float targetSpeed, bool beatingMode,
+		bool targetTackStarboard)
+		:Message(MessageType::LocalNavigation, NodeID::None, NodeID::None),
+		 m_TargetCourse(targetCourse), m_TargetSpeed(targetSpeed), m_BeatingMode(beatingMode),
+		 m_TargetTackStarboard(targetTackStarboard)
+	{ }
+
+	LocalNavigationMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_TargetCourse(), m_TargetSpeed(), m_BeatingMode(),
+		 m_TargetTackStarboard()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(10) : NULL;
+		if(data != NULL)
+		{
+			m_TargetCourse = LittleEndian::readFloat(data);
+			m_TargetSpeed = LittleEndian::readFloat(data + 4);
+			m_BeatingMode = LittleEndian::readBool(data + 8);
+			m_TargetTackStarboard = LittleEndian::readBool(data + 9);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
+
+	virtual ~LocalNavigationMsg() { }
 
-    LocalNavigationMsg(NodeID sourceID, NodeID destinationID, float targetCourse, float targetSpeed, bool beatingMode, bool targetTackStarboard)
-        :Message(MessageType::LocalNavigation, sourceID, destinationID), m_TargetCourse(targetCourse), m_TargetSpeed(targetSpeed),
-        m_BeatingMode(beatingMode), m_TargetTackStarboard(targetTackStarboard)
-    { }
-
-    LocalNavigationMsg(float targetCourse, float targetSpeed, bool beatingMode, bool targetTackStarboard)
-        :Message(MessageType::LocalNavigation, NodeID::None, NodeID::None), m_TargetCourse(targetCourse), m_TargetSpeed(targetSpeed),
-        m_BeatingMode(beatingMode), m_TargetTackStarboard(targetTackStarboard)
-    { }
-
-    LocalNavigationMsg(MessageDeserialiser deserialiser)
-    : Message(deserialiser)
-    {
-        if(!deserialiser.readFloat(m_TargetCourse) ||
-           !deserialiser.readFloat(m_TargetSpeed) ||
-           !deserialiser.readBool(m_BeatingMode) ||
-           !deserialiser.readBool(m_TargetTackStarboard))
-        {
-            m_valid = false;
-        }
-    }
-
-    virtual ~LocalNavigationMsg() { }
-
-
-    float targetCourse() const { return m_TargetCourse; }
-    float targetSpeed() const { return m_TargetSpeed; }
-    bool beatingMode() const { return m_BeatingMode; }
-    bool targetTackStarboard() const { return m_TargetTackStarboard; }
-
-
-    ///----------------------------------------------------------------------------------
-    /// Serialises the message into a MessageSerialiser
-    ///----------------------------------------------------------------------------------
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
-
-        serialiser.serialise(m_TargetCourse);
-        serialiser.serialise(m_TargetSpeed);
-        serialiser.serialise(m_BeatingMode);
-        serialiser.serialise(m_TargetTackStarboard);
-    }
+	float targetCourse() const { return m_TargetCourse; }
+	float targetSpeed() const { return m_TargetSpeed; }
+	bool beatingMode() const { return m_BeatingMode; }
+	bool targetTackStarboard() const { return m_TargetTackStarboard; }
+
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(10);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_TargetCourse);
+			data = LittleEndian::write(data, m_TargetSpeed);
+			data = LittleEndian::write(data, m_BeatingMode);
+			data = LittleEndian::write(data, m_TargetTackStarboard);
+		}
+	}
 
 private:
+	float m_TargetCourse;         // degree [0, 360[ in North-East reference frame (clockwise)
+	float m_TargetSpeed;          // m/s
+	bool  m_BeatingMode;          // True if the vessel is in beating motion (zig-zag motion).
+	bool  m_TargetTackStarboard;  // True if the desired tack of the vessel is starboard.
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised LocalNavigationMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class LocalNavigationView : public MessageView {
+public:
+	LocalNavigationView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::LocalNavigation)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 10);
+	}
 
-    float   m_TargetCourse;         // degree [0, 360[ in North-East reference frame (clockwise)
-    float   m_TargetSpeed;          // m/s
-    bool    m_BeatingMode;          // True if the vessel is in beating motion (zig-zag motion).
-    bool    m_TargetTackStarboard;  // True if the desired tack of the vessel is starboard.
+	float targetCourse() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
+	float targetSpeed() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 4); }
+	bool beatingMode() const { return LittleEndian::readBool(m_Data + HEADER_SIZE + 8); }
+	bool targetTackStarboard() const { return LittleEndian::readBool(m_Data + HEADER_SIZE + 9); }
 };
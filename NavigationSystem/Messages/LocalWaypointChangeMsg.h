@@ -1,19 +1,27 @@
-
 /****************************************************************************************
+ *
+ * File:
+ * 		LocalWaypointChangeMsg.h
+ *
  * Purpose:
  *		Notify receivers that the waypoints in the local database have changed
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class LocalWaypointChangeMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::LocalWaypointChange;
+
 	LocalWaypointChangeMsg(NodeID destinationID, NodeID sourceID)
 		:Message(MessageType::LocalWaypointChange, sourceID, destinationID)
 	{ }
@@ -27,5 +35,15 @@ public:
 	{ }
 
 	virtual ~LocalWaypointChangeMsg() { }
+};
+
 
+///----------------------------------------------------------------------------------
+/// Reads a serialised LocalWaypointChangeMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class LocalWaypointChangeView : public MessageView {
+public:
+	LocalWaypointChangeView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::LocalWaypointChange)
+	{ }
 };
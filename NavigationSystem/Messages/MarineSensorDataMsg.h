@@ -7,33 +7,44 @@
  *		A MarineSensorDataMsg contains MarineSensor data such as temperature, conductivity and ph.
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
-class MarineSensorDataMsg : public Message
-{
+class MarineSensorDataMsg : public Message {
 public:
-	MarineSensorDataMsg(NodeID destinationID, NodeID sourceID, float temperature, float conductivity, float ph, float salinity)
-		:Message(MessageType::MarineSensorData, sourceID, destinationID), m_temperature(temperature), m_conductivity(conductivity), m_ph(ph), m_salinity (salinity)
+	static const MessageType TYPE = MessageType::MarineSensorData;
+
+	MarineSensorDataMsg(NodeID destinationID, NodeID sourceID, float temperature,
+		float conductivity, float ph, float salinity)
+		:Message(MessageType::MarineSensorData, sourceID, destinationID), m_Temperature(temperature),
+		 m_Conductivity(conductivity), m_Ph(ph), m_Salinity(salinity)
 	{ }
 
-	MarineSensorDataMsg(float temperature, float conductivity, float ph , float salinity)
-		:Message(MessageType::MarineSensorData, NodeID::None, NodeID::None), m_temperature(temperature), m_conductivity(conductivity), m_ph(ph), m_salinity(salinity)
+	MarineSensorDataMsg(float temperature, float conductivity, float ph, float salinity)
+		:Message(MessageType::MarineSensorData, NodeID::None, NodeID::None),
+		 m_Temperature(temperature), m_Conductivity(conductivity), m_Ph(ph), m_Salinity(salinity)
 	{ }
 
-	MarineSensorDataMsg(MessageDeserialiser& deserialiser)
-		:Message(deserialiser)
+	MarineSensorDataMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_Temperature(), m_Conductivity(), m_Ph(), m_Salinity()
 	{
-		if(	!deserialiser.readFloat(m_temperature) ||
-			!deserialiser.readFloat(m_conductivity) ||
-			!deserialiser.readFloat(m_ph)||
-			!deserialiser.readFloat(m_salinity))
+		const uint8_t* data = m_valid ? deserialiser.take(16) : NULL;
+		if(data != NULL)
+		{
+			m_Temperature = LittleEndian::readFloat(data);
+			m_Conductivity = LittleEndian::readFloat(data + 4);
+			m_Ph = LittleEndian::readFloat(data + 8);
+			m_Salinity = LittleEndian::readFloat(data + 12);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -41,10 +52,10 @@ public:
 
 	virtual ~MarineSensorDataMsg() { }
 
-	float temperature() const { return m_temperature; }
-	float conductivity() const { return m_conductivity; }
-	float ph() const { return m_ph; }
-	float salinity() const {return m_salinity; }
+	float temperature() const { return m_Temperature; }
+	float conductivity() const { return m_Conductivity; }
+	float ph() const { return m_Ph; }
+	float salinity() const { return m_Salinity; }
 
 	///----------------------------------------------------------------------------------
 	/// Serialises the message into a MessageSerialiser
@@ -53,15 +64,38 @@ public:
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_temperature);
-		serialiser.serialise(m_conductivity);
-		serialiser.serialise(m_ph);
-		serialiser.serialise(m_salinity);
+		uint8_t* data = serialiser.reserve(16);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_Temperature);
+			data = LittleEndian::write(data, m_Conductivity);
+			data = LittleEndian::write(data, m_Ph);
+			data = LittleEndian::write(data, m_Salinity);
+		}
 	}
 
 private:
-	float m_temperature;
-	float m_conductivity;
-	float m_ph;
-	float m_salinity;
+	float m_Temperature;
+	float m_Conductivity;
+	float m_Ph;
+	float m_Salinity;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised MarineSensorDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class MarineSensorDataView : public MessageView {
+public:
+	MarineSensorDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::MarineSensorData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 16);
+	}
+
+	float temperature() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
+	float conductivity() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 4); }
+	float ph() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 8); }
+	float salinity() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 12); }
 };
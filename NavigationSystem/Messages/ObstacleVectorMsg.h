@@ -1,52 +1,170 @@
 /****************************************************************************************
  *
  * File:
- * 		ObstacleVectorMsg
+ * 		ObstacleVectorMsg.h
  *
  * Purpose:
  *		Contains a vector with the angular position and dist of all the detected obstacles
  *
  * Developer Notes:
+ *		The obstacles are immutable and reference counted, like the vessel lists of the
+ *		AISDataMsg, so every subscriber reads the same list.
+ *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
+#include <memory>
+#include <vector>
 
-struct ObstacleData {
-       double minDistanceToObstacle;
-       double maxDistanceToObstacle; // -1 = infinite
-       double LeftBoundheadingRelativeToBoat;
-       double RightBoundheadingRelativeToBoat;
-       double angularCenterPositionX;
-       double angularCenterPositionY;
-   };
 
+struct ObstacleData {
+	double minDistanceToObstacle;
+	double maxDistanceToObstacle; // -1 = infinite
+	double LeftBoundheadingRelativeToBoat;
+	double RightBoundheadingRelativeToBoat;
+	double angularCenterPositionX;
+	double angularCenterPositionY;
+};
 
 
 class ObstacleVectorMsg : public Message {
 public:
-	ObstacleVectorMsg(	NodeID destinationID, NodeID sourceID,std::vector<ObstacleData> obstacles )
+	static const MessageType TYPE = MessageType::ObstacleVector;
 
-		:Message(MessageType::ObstacleVector, sourceID, destinationID),m_obstacles(obstacles)
-	{ }
+	typedef std::shared_ptr<const std::vector<ObstacleData>> ObstacleListPtr;
 
-    ObstacleVectorMsg(NodeID sourceID,std::vector<ObstacleData> obstacles)
+	ObstacleVectorMsg(NodeID destinationID, NodeID sourceID, std::vector<ObstacleData> obstacles)
+		:Message(MessageType::ObstacleVector, sourceID, destinationID),
+		 m_Obstacles(std::make_shared<const std::vector<ObstacleData>>(std::move(obstacles)))
+	{ }
 
-		:Message(MessageType::ObstacleVector,sourceID, NodeID::None), m_obstacles(obstacles)
+	ObstacleVectorMsg(NodeID sourceID, std::vector<ObstacleData> obstacles)
+		:Message(MessageType::ObstacleVector, sourceID, NodeID::None),
+		 m_Obstacles(std::make_shared<const std::vector<ObstacleData>>(std::move(obstacles)))
 	{ }
 
 	ObstacleVectorMsg(std::vector<ObstacleData> obstacles)
+		:Message(MessageType::ObstacleVector, NodeID::None, NodeID::None),
+		 m_Obstacles(std::make_shared<const std::vector<ObstacleData>>(std::move(obstacles)))
+	{ }
 
-		:Message(MessageType::ObstacleVector, NodeID::None, NodeID::None), m_obstacles(obstacles)
+	///----------------------------------------------------------------------------------
+	/// Shares the lists of another message instead of copying them.
+	///----------------------------------------------------------------------------------
+	ObstacleVectorMsg(NodeID destinationID, NodeID sourceID, ObstacleListPtr obstacles)
+		:Message(MessageType::ObstacleVector, sourceID, destinationID),
+		 m_Obstacles(std::move(obstacles))
 	{ }
 
+	ObstacleVectorMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser)
+	{
+		std::vector<ObstacleData> obstacles;
+
+		uint16_t obstaclesCount = 0;
+		const uint8_t* data = m_valid ? deserialiser.take(sizeof(obstaclesCount)) : NULL;
+		if(data != NULL)
+		{
+			obstaclesCount = LittleEndian::readUint16(data);
+			data = deserialiser.take(obstaclesCount * 48);
+		}
+		if(data != NULL)
+		{
+			obstacles.resize(obstaclesCount);
+			for(uint16_t i = 0; i < obstaclesCount; i++, data += 48)
+			{
+				obstacles[i].minDistanceToObstacle = LittleEndian::readDouble(data);
+				obstacles[i].maxDistanceToObstacle = LittleEndian::readDouble(data + 8);
+				obstacles[i].LeftBoundheadingRelativeToBoat = LittleEndian::readDouble(data + 16);
+				obstacles[i].RightBoundheadingRelativeToBoat = LittleEndian::readDouble(data + 24);
+				obstacles[i].angularCenterPositionX = LittleEndian::readDouble(data + 32);
+				obstacles[i].angularCenterPositionY = LittleEndian::readDouble(data + 40);
+			}
+		}
+		else
+		{
+			m_valid = false;
+		}
+
+		m_Obstacles = std::make_shared<const std::vector<ObstacleData>>(std::move(obstacles));
+	}
+
 	virtual ~ObstacleVectorMsg() { }
 
-	std::vector<ObstacleData> obstacles() { return m_obstacles; }
+	const std::vector<ObstacleData>& obstacles() const { return *m_Obstacles; }
+	const ObstacleListPtr& sharedObstacles() const { return m_Obstacles; }
+
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser. Only the first
+	/// MAX_SERIALISED_OBSTACLES elements of a list fit into a serialised message.
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint16_t obstaclesCount = (m_Obstacles->size() < MAX_SERIALISED_OBSTACLES) ?
+			m_Obstacles->size() : MAX_SERIALISED_OBSTACLES;
+
+		uint8_t* data = serialiser.reserve(sizeof(obstaclesCount) + obstaclesCount * 48);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, obstaclesCount);
+			for(uint16_t i = 0; i < obstaclesCount; i++)
+			{
+				const ObstacleData& element = (*m_Obstacles)[i];
+				data = LittleEndian::write(data, element.minDistanceToObstacle);
+				data = LittleEndian::write(data, element.maxDistanceToObstacle);
+				data = LittleEndian::write(data, element.LeftBoundheadingRelativeToBoat);
+				data = LittleEndian::write(data, element.RightBoundheadingRelativeToBoat);
+				data = LittleEndian::write(data, element.angularCenterPositionX);
+				data = LittleEndian::write(data, element.angularCenterPositionY);
+			}
+		}
+	}
+
+	// The message header, the count and this many obstacles fit into MAX_MESSAGE_SIZE
+	static const size_t MAX_SERIALISED_OBSTACLES = 80;
+
+private:
+	ObstacleListPtr m_Obstacles;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised ObstacleVectorMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class ObstacleVectorView : public MessageView {
+public:
+	ObstacleVectorView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::ObstacleVector)
+	{
+		uint32_t offset = HEADER_SIZE;
+		m_ObstaclesOffset = offset + sizeof(m_ObstaclesCount);
+		skipList(offset, m_ObstaclesCount, 48);
+	}
+
+	uint16_t obstaclesCount() const { return m_ObstaclesCount; }
+	ObstacleData obstaclesAt(uint16_t index) const
+	{
+		const uint8_t* data = m_Data + m_ObstaclesOffset + index * 48;
+		ObstacleData element;
+		element.minDistanceToObstacle = LittleEndian::readDouble(data);
+		element.maxDistanceToObstacle = LittleEndian::readDouble(data + 8);
+		element.LeftBoundheadingRelativeToBoat = LittleEndian::readDouble(data + 16);
+		element.RightBoundheadingRelativeToBoat = LittleEndian::readDouble(data + 24);
+		element.angularCenterPositionX = LittleEndian::readDouble(data + 32);
+		element.angularCenterPositionY = LittleEndian::readDouble(data + 40);
+		return element;
+	}
 
 private:
-	std::vector<ObstacleData> m_obstacles;
+	uint32_t m_ObstaclesOffset;
+	uint16_t m_ObstaclesCount;
 };
@@ -4,22 +4,24 @@
  * 		RequestCourseMsg.h
  *
  * Purpose:
+ *		Asks the course regulation for the current course.
  *
- * License:
- *      This file is subject to the terms and conditions defined in the file 
- *      'LICENSE.txt', which is part of this source code package.
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
-
 #pragma once
 
-
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class RequestCourseMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::RequestCourse;
+
 	RequestCourseMsg(NodeID destinationID, NodeID sourceID)
 		:Message(MessageType::RequestCourse, sourceID, destinationID)
 	{ }
@@ -33,5 +35,15 @@ public:
 	{ }
 
 	virtual ~RequestCourseMsg() { }
+};
 
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised RequestCourseMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class RequestCourseView : public MessageView {
+public:
+	RequestCourseView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::RequestCourse)
+	{ }
 };
@@ -1,43 +1,83 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		RudderCommandMsg.h
+ *
+ * Purpose:
+ *		The angle the rudder is set to.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
+
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class RudderCommandMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::RudderCommand;
 
-    RudderCommandMsg(NodeID sourceID, NodeID destinationID, float rudderAngle)
-    : Message(MessageType::RudderCommand, sourceID, destinationID),
-    m_RudderAngle(rudderAngle)
-    {  }
+	RudderCommandMsg(NodeID sourceID, NodeID destinationID, float rudderAngle)
+		:Message(MessageType::RudderCommand, sourceID, destinationID), m_RudderAngle(rudderAngle)
+	{ }
 
-    RudderCommandMsg(float rudderAngle)
-    : Message(MessageType::RudderCommand, NodeID::None, NodeID::None),
-      m_RudderAngle(rudderAngle)
-    {  }  
+	RudderCommandMsg(float rudderAngle)
+		:Message(MessageType::RudderCommand, NodeID::None, NodeID::None), m_RudderAngle(rudderAngle)
+	{ }
 
+	RudderCommandMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_RudderAngle()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(4) : NULL;
+		if(data != NULL)
+		{
+			m_RudderAngle = LittleEndian::readFloat(data);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
 
-    RudderCommandMsg(MessageDeserialiser deserialiser)
-        :Message(deserialiser)
-    {
-        if( !deserialiser.readFloat(m_RudderAngle))
-        {
-            m_valid = false;
-        }
-    }
+	virtual ~RudderCommandMsg() { }
 
-    
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
-        serialiser.serialise(m_RudderAngle);
-    }
+	float rudderAngle() const { return m_RudderAngle; }
 
-    virtual ~RudderCommandMsg() { }
-    float rudderAngle() const { return m_RudderAngle;}
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
 
+		uint8_t* data = serialiser.reserve(4);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_RudderAngle);
+		}
+	}
 
 private:
+	float m_RudderAngle;  // degree [-30, +30[ in vessel reference frame (clockwise from top view)
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised RudderCommandMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class RudderCommandView : public MessageView {
+public:
+	RudderCommandView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::RudderCommand)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 4);
+	}
 
-    float m_RudderAngle; // degree [-30, +30[ in vessel reference frame (clockwise from top view)
+	float rudderAngle() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
 };
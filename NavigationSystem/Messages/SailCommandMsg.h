@@ -1,36 +1,83 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		SailCommandMsg.h
+ *
+ * Purpose:
+ *		The largest angle the sail is let out to.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
+
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class SailCommandMsg : public Message {
 public:
-    SailCommandMsg(NodeID sourceID, NodeID destinationID, float maxSailAngle)
-        :Message(MessageType::SailCommand, sourceID, destinationID), m_MaxSailAngle(maxSailAngle)
-    {  }
-
-    SailCommandMsg(float maxSailAngle)
-        :Message(MessageType::SailCommand, NodeID::None, NodeID::None), m_MaxSailAngle(maxSailAngle)
-    {  }
-
-    SailCommandMsg(MessageDeserialiser deserialiser)
-        :Message(deserialiser)
-    {
-        if( !deserialiser.readFloat(m_MaxSailAngle))
-        {
-            m_valid = false;
-        }
-    }
-
-    virtual ~SailCommandMsg() { }
-    float maxSailAngle() const { return m_MaxSailAngle;}
-
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
-        serialiser.serialise(m_MaxSailAngle);
-    }
+	static const MessageType TYPE = MessageType::SailCommand;
+
+	SailCommandMsg(NodeID sourceID, NodeID destinationID, float maxSailAngle)
+		:Message(MessageType::SailCommand, sourceID, destinationID), m_MaxSailAngle(maxSailAngle)
+	{ }
+
+	SailCommandMsg(float maxSailAngle)
+		:Message(MessageType::SailCommand, NodeID::None, NodeID::None), m_MaxSailAngle(maxSailAngle)
+	{ }
+
+	SailCommandMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_MaxSailAngle()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(4) : NULL;
+		if(data != NULL)
+		{
+			m_MaxSailAngle = LittleEndian::readFloat(data);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
+
+	virtual ~SailCommandMsg() { }
+
+	float maxSailAngle() const { return m_MaxSailAngle; }
+
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(4);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_MaxSailAngle);
+		}
+	}
 
 private:
-    float m_MaxSailAngle; // degrees in boat reference frame. This value is always positive.
+	float m_MaxSailAngle;  // degrees in boat reference frame. This value is always positive.
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised SailCommandMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class SailCommandView : public MessageView {
+public:
+	SailCommandView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::SailCommand)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 4);
+	}
+
+	float maxSailAngle() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
 };
@@ -1,19 +1,27 @@
-
 /****************************************************************************************
+ *
+ * File:
+ * 		ServerConfigsReceivedMsg.h
+ *
  * Purpose:
  *		Notify receivers that new config settings have been downloaded from the server
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class ServerConfigsReceivedMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::ServerConfigsReceived;
+
 	ServerConfigsReceivedMsg(NodeID destinationID, NodeID sourceID)
 		:Message(MessageType::ServerConfigsReceived, sourceID, destinationID)
 	{ }
@@ -27,5 +35,15 @@ public:
 	{ }
 
 	virtual ~ServerConfigsReceivedMsg() { }
+};
+
 
+///----------------------------------------------------------------------------------
+/// Reads a serialised ServerConfigsReceivedMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class ServerConfigsReceivedView : public MessageView {
+public:
+	ServerConfigsReceivedView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::ServerConfigsReceived)
+	{ }
 };
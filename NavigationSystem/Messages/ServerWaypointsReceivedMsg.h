@@ -1,19 +1,27 @@
-
 /****************************************************************************************
+ *
+ * File:
+ * 		ServerWaypointsReceivedMsg.h
+ *
  * Purpose:
  *		Notify receivers that new waypoints have been downloaded from the server
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class ServerWaypointsReceivedMsg : public Message {
 public:
+	static const MessageType TYPE = MessageType::ServerWaypointsReceived;
+
 	ServerWaypointsReceivedMsg(NodeID destinationID, NodeID sourceID)
 		:Message(MessageType::ServerWaypointsReceived, sourceID, destinationID)
 	{ }
@@ -27,5 +35,15 @@ public:
 	{ }
 
 	virtual ~ServerWaypointsReceivedMsg() { }
+};
+
 
+///----------------------------------------------------------------------------------
+/// Reads a serialised ServerWaypointsReceivedMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class ServerWaypointsReceivedView : public MessageView {
+public:
+	ServerWaypointsReceivedView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::ServerWaypointsReceived)
+	{ }
 };
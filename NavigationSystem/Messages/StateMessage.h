@@ -1,76 +1,125 @@
 /****************************************************************************************
-*
-* File:
-* 		StateMessage.h
-*
-* Purpose:
-*		A StateMessage contains contains the state of the vessel at a given time.
-*
-* Developer Notes:
-*
-*
-***************************************************************************************/
+ *
+ * File:
+ * 		StateMessage.h
+ *
+ * Purpose:
+ *		A StateMessage contains contains the state of the vessel at a given time.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class StateMessage : public Message {
 public:
+	static const MessageType TYPE = MessageType::StateMessage;
 
-    StateMessage (NodeID destinationID, NodeID sourceID, float compassHeading,
-    double lat, double lon, double gpsSpeed, double gpsCourse)
-    :Message(MessageType::StateMessage, sourceID, destinationID),
-    m_VesselHeading(compassHeading), m_VesselLat(lat), m_VesselLon(lon), m_VesselSpeed(gpsSpeed), m_VesselCourse(gpsCourse)
-    { }
-
-    StateMessage(float compassHeading, double lat, double lon, double gpsSpeed, double gpsCourse)
-    :Message(MessageType::StateMessage, NodeID::None, NodeID::None),
-    m_VesselHeading(compassHeading), m_VesselLat(lat), m_VesselLon(lon), m_VesselSpeed(gpsSpeed), m_VesselCourse(gpsCourse)
-    { }
-
-    StateMessage(MessageDeserialiser deserialiser)
-    :Message(deserialiser)
-    {
-        if( !deserialiser.readFloat(m_VesselHeading) ||
-        !deserialiser.readDouble(m_VesselLat) ||
-        !deserialiser.readDouble(m_VesselLon) ||
-        !deserialiser.readDouble(m_VesselCourse) ||
-        !deserialiser.readDouble(m_VesselSpeed))
-        {
-            m_valid = false;
-        }
-    }
-
-    virtual ~StateMessage() { }
-
-
-    float heading() const {  return m_VesselHeading; }
-    double latitude() const {  return m_VesselLat; }
-    double longitude() const {  return m_VesselLon; }
-    double speed() const { return m_VesselSpeed; }
-    double course() const {return m_VesselCourse; }
-
-
-    ///----------------------------------------------------------------------------------
-    /// Serialises the message into a MessageSerialiser
-    ///----------------------------------------------------------------------------------
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
-
-        serialiser.serialise(m_VesselHeading);
-        serialiser.serialise(m_VesselLat);
-        serialiser.serialise(m_VesselLon);
-        serialiser.serialise(m_VesselCourse);
-        serialiser.serialise(m_VesselSpeed);
-    }
+	///----------------------------------------------------------------------------------
+	/// The vessel state as kept on the message bus blackboard, see Blackboard.h.
+	///----------------------------------------------------------------------------------
+	struct Snapshot {
+		float	heading;
+		double	latitude;
+		double	longitude;
+		double	speed;
+		double	course;
+	};
+
+	StateMessage(NodeID destinationID, NodeID sourceID, float compassHeading, double lat,
+		double lon, double gpsSpeed, double gpsCourse)
+		:Message(MessageType::StateMessage, sourceID, destinationID),
+		 m_CompassHeading(compassHeading), m_Lat(lat), m_Lon(lon), m_GpsCourse(gpsCourse),
+		 m_GpsSpeed(gpsSpeed)
+	{ }
+
+	StateMessage(float compassHeading, double lat, double lon, double gpsSpeed, double gpsCourse)
+		:Message(MessageType::StateMessage, NodeID::None, NodeID::None),
+		 m_CompassHeading(compassHeading), m_Lat(lat), m_Lon(lon), m_GpsCourse(gpsCourse),
+		 m_GpsSpeed(gpsSpeed)
+	{ }
+
+	StateMessage(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_CompassHeading(), m_Lat(), m_Lon(), m_GpsCourse(), m_GpsSpeed()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(36) : NULL;
+		if(data != NULL)
+		{
+			m_CompassHeading = LittleEndian::readFloat(data);
+			m_Lat = LittleEndian::readDouble(data + 4);
+			m_Lon = LittleEndian::readDouble(data + 12);
+			m_GpsCourse = LittleEndian::readDouble(data + 20);
+			m_GpsSpeed = LittleEndian::readDouble(data + 28);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
+
+	virtual ~StateMessage() { }
+
+	float heading() const { return m_CompassHeading; }
+	double latitude() const { return m_Lat; }
+	double longitude() const { return m_Lon; }
+	double course() const { return m_GpsCourse; }
+	double speed() const { return m_GpsSpeed; }
+
+	Snapshot snapshot() const
+	{
+		Snapshot snapshot = { m_CompassHeading, m_Lat, m_Lon, m_GpsSpeed, m_GpsCourse };
+		return snapshot;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(36);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_CompassHeading);
+			data = LittleEndian::write(data, m_Lat);
+			data = LittleEndian::write(data, m_Lon);
+			data = LittleEndian::write(data, m_GpsCourse);
+			data = LittleEndian::write(data, m_GpsSpeed);
+		}
+	}
 
 private:
-    float 	m_VesselHeading;     // degree [0, 360[ in North-East reference frame (clockwise)
-    double	m_VesselLat;         // degree
-    double	m_VesselLon;         // degree
-    double	m_VesselSpeed;       // m/s
-    double  m_VesselCourse;      // degree [0, 360[ in North-East reference frame (clockwise)
+	float  m_CompassHeading;  // degree [0, 360[ in North-East reference frame (clockwise)
+	double m_Lat;             // degree
+	double m_Lon;             // degree
+	double m_GpsCourse;       // degree [0, 360[ in North-East reference frame (clockwise)
+	double m_GpsSpeed;        // m/s
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised StateMessage where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class StateMessageView : public MessageView {
+public:
+	StateMessageView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::StateMessage)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 36);
+	}
+
+	float heading() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
+	double latitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 4); }
+	double longitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 12); }
+	double course() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 20); }
+	double speed() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 28); }
 };
@@ -1,139 +1,189 @@
-  /****************************************************************************************
-   *
-   * File:
-   * 		VesselStateMsg.h
-   *
-   * Purpose:
-   *		A VesselStateMsg contains the state of the vessel at a given time.
-   *
-   * Developer Notes:
-   *
-   *
-   ***************************************************************************************/
+/****************************************************************************************
+ *
+ * File:
+ * 		VesselStateMsg.h
+ *
+ * Purpose:
+ *		A VesselStateMsg contains the state of the vessel at a given time.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
 
-  #pragma once
+#pragma once
 
-  #include "MessageBus/Message.h"
+#include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
-  class VesselStateMsg : public Message {
-  public:
-  	VesselStateMsg(	NodeID destinationID, NodeID sourceID, int compassHeading, int compassPitch,
-  					int compassRoll, bool gpsFix, bool gpsOnline, double lat, double lon, double unixTime,
-  					double gpsSpeed, int gpsSatellite, double heading, float windDir, float windSpeed, float windTemp,
-  					int arduinoPressure, int arduinoRudder, int arduinoSheet, int arduinoBattery)
-  		:Message(MessageType::VesselState, sourceID, destinationID),
-  		m_CompassHeading(compassHeading), m_CompassPitch(compassPitch), m_CompassRoll(compassRoll),
-  		m_GPSHasFix(gpsFix), m_GPSOnline(gpsOnline), m_GPSLat(lat), m_GPSLon(lon), m_GPSUnixTime(unixTime), m_GPSSpeed(gpsSpeed),
-  		m_GPSCourse(heading), m_GPSSatellite(gpsSatellite) , m_WindDir(windDir), m_WindSpeed(windSpeed), m_WindTemp(windTemp), m_ArduinoPressure(arduinoPressure),
-  		m_ArduinoRudder(arduinoRudder), m_ArduinoSheet(arduinoSheet), m_ArduinoBattery(arduinoBattery)
-  		{ }
+class VesselStateMsg : public Message {
+public:
+	static const MessageType TYPE = MessageType::VesselState;
 
-  	VesselStateMsg(	int compassHeading, int compassPitch, int compassRoll, bool gpsFix, bool gpsOnline, double lat,
-  					double lon, double unixTime, double gpsSpeed, int gpsSatellite, double heading, float windDir,
-  					float windSpeed, float windTemp, int arduinoPressure, int arduinoRudder, int arduinoSheet, int arduinoBattery)
-  		:Message(MessageType::VesselState, NodeID::None, NodeID::None),
-  		m_CompassHeading(compassHeading), m_CompassPitch(compassPitch), m_CompassRoll(compassRoll),
-  		m_GPSHasFix(gpsFix), m_GPSOnline(gpsOnline), m_GPSLat(lat), m_GPSLon(lon), m_GPSUnixTime(unixTime), m_GPSSpeed(gpsSpeed),
-  		m_GPSCourse(heading), m_GPSSatellite(gpsSatellite), m_WindDir(windDir), m_WindSpeed(windSpeed), m_WindTemp(windTemp), m_ArduinoPressure(arduinoPressure),
-  		m_ArduinoRudder(arduinoRudder), m_ArduinoSheet(arduinoSheet), m_ArduinoBattery(arduinoBattery)
-  		{ }
+	VesselStateMsg(NodeID destinationID, NodeID sourceID, int compassHeading, int compassPitch,
+		int compassRoll, bool gpsFix, bool gpsOnline, double lat, double lon, double unixTime,
+		double gpsSpeed, int gpsSatellite, double heading, float windDir, float windSpeed,
+		float windTemp, int arduinoPressure, int arduinoRudder, int arduinoSheet, int arduinoBattery)
+		:Message(MessageType::VesselState, sourceID, destinationID),
+		 m_CompassHeading(compassHeading), m_CompassPitch(compassPitch), m_CompassRoll(compassRoll),
+		 m_GpsFix(gpsFix), m_GpsOnline(gpsOnline), m_Lat(lat), m_Lon(lon), m_UnixTime(unixTime),
+		 m_GpsSpeed(gpsSpeed), m_Heading(heading), m_GpsSatellite(gpsSatellite), m_WindDir(windDir),
+		 m_WindSpeed(windSpeed), m_WindTemp(windTemp), m_ArduinoPressure(arduinoPressure),
+		 m_ArduinoRudder(arduinoRudder), m_ArduinoSheet(arduinoSheet),
+		 m_ArduinoBattery(arduinoBattery)
+	{ }
 
-  	VesselStateMsg(MessageDeserialiser deserialiser)
-  		:Message(deserialiser)
-  	{
-  		if(	!deserialiser.readInt(m_CompassHeading) ||
-  			!deserialiser.readInt(m_CompassPitch) ||
-  			!deserialiser.readInt(m_CompassRoll) ||
-  			!deserialiser.readBool(m_GPSHasFix) ||
-  			!deserialiser.readBool(m_GPSOnline) ||
-  			!deserialiser.readDouble(m_GPSLat) ||
-  			!deserialiser.readDouble(m_GPSLon) ||
-  			!deserialiser.readDouble(m_GPSUnixTime) ||
-  			!deserialiser.readDouble(m_GPSSpeed) ||
-  			!deserialiser.readDouble(m_GPSCourse) ||
-  			!deserialiser.readInt(m_GPSSatellite) ||
-  			!deserialiser.readFloat(m_WindDir) ||
-  			!deserialiser.readFloat(m_WindSpeed) ||
-  			!deserialiser.readFloat(m_WindTemp) ||
-  			!deserialiser.readInt(m_ArduinoPressure) ||
-  			!deserialiser.readInt(m_ArduinoRudder) ||
-  			!deserialiser.readInt(m_ArduinoSheet) ||
-  			!deserialiser.readInt(m_ArduinoBattery))
-  		{
-  			m_valid = false;
-  		}
-  	}
+	VesselStateMsg(int compassHeading, int compassPitch, int compassRoll, bool gpsFix,
+		bool gpsOnline, double lat, double lon, double unixTime, double gpsSpeed, int gpsSatellite,
+		double heading, float windDir, float windSpeed, float windTemp, int arduinoPressure,
+		int arduinoRudder, int arduinoSheet, int arduinoBattery)
+		:Message(MessageType::VesselState, NodeID::None, NodeID::None),
+		 m_CompassHeading(compassHeading), m_CompassPitch(compassPitch), m_CompassRoll(compassRoll),
+		 m_GpsFix(gpsFix), m_GpsOnline(gpsOnline), m_Lat(lat), m_Lon(lon), m_UnixTime(unixTime),
+		 m_GpsSpeed(gpsSpeed), m_Heading(heading), m_GpsSatellite(gpsSatellite), m_WindDir(windDir),
+		 m_WindSpeed(windSpeed), m_WindTemp(windTemp), m_ArduinoPressure(arduinoPressure),
+		 m_ArduinoRudder(arduinoRudder), m_ArduinoSheet(arduinoSheet),
+		 m_ArduinoBattery(arduinoBattery)
+	{ }
 
-  	virtual ~VesselStateMsg() { }
+	VesselStateMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_CompassHeading(), m_CompassPitch(), m_CompassRoll(), m_GpsFix(),
+		 m_GpsOnline(), m_Lat(), m_Lon(), m_UnixTime(), m_GpsSpeed(), m_Heading(), m_GpsSatellite(),
+		 m_WindDir(), m_WindSpeed(), m_WindTemp(), m_ArduinoPressure(), m_ArduinoRudder(),
+		 m_ArduinoSheet(), m_ArduinoBattery()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(86) : NULL;
+		if(data != NULL)
+		{
+			m_CompassHeading = LittleEndian::readInt(data);
+			m_CompassPitch = LittleEndian::readInt(data + 4);
+			m_CompassRoll = LittleEndian::readInt(data + 8);
+			m_GpsFix = LittleEndian::readBool(data + 12);
+			m_GpsOnline = LittleEndian::readBool(data + 13);
+			m_Lat = LittleEndian::readDouble(data + 14);
+			m_Lon = LittleEndian::readDouble(data + 22);
+			m_UnixTime = LittleEndian::readDouble(data + 30);
+			m_GpsSpeed = LittleEndian::readDouble(data + 38);
+			m_Heading = LittleEndian::readDouble(data + 46);
+			m_GpsSatellite = LittleEndian::readInt(data + 54);
+			m_WindDir = LittleEndian::readFloat(data + 58);
+			m_WindSpeed = LittleEndian::readFloat(data + 62);
+			m_WindTemp = LittleEndian::readFloat(data + 66);
+			m_ArduinoPressure = LittleEndian::readInt(data + 70);
+			m_ArduinoRudder = LittleEndian::readInt(data + 74);
+			m_ArduinoSheet = LittleEndian::readInt(data + 78);
+			m_ArduinoBattery = LittleEndian::readInt(data + 82);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
 
-  	int compassHeading() { return m_CompassHeading; }
-  	int compassPitch() { return m_CompassPitch; }
-  	int compassRoll() { return m_CompassRoll; }
+	virtual ~VesselStateMsg() { }
 
-  	bool gpsHasFix() { return m_GPSHasFix; }
-  	bool gpsOnline() { return m_GPSOnline; }
-  	double latitude() { return m_GPSLat; }
-  	double longitude() { return m_GPSLon; }
-  	double unixTime() { return m_GPSUnixTime; }
-  	double speed() { return m_GPSSpeed; }
-  	double gpsHeading() { return m_GPSCourse; }
-  	int gpsSatellite() { return m_GPSSatellite; }
+	int compassHeading() const { return m_CompassHeading; }
+	int compassPitch() const { return m_CompassPitch; }
+	int compassRoll() const { return m_CompassRoll; }
+	bool gpsHasFix() const { return m_GpsFix; }
+	bool gpsOnline() const { return m_GpsOnline; }
+	double latitude() const { return m_Lat; }
+	double longitude() const { return m_Lon; }
+	double unixTime() const { return m_UnixTime; }
+	double speed() const { return m_GpsSpeed; }
+	double gpsHeading() const { return m_Heading; }
+	int gpsSatellite() const { return m_GpsSatellite; }
+	float windDir() const { return m_WindDir; }
+	float windSpeed() const { return m_WindSpeed; }
+	float windTemp() const { return m_WindTemp; }
+	int arduinoPressure() const { return m_ArduinoPressure; }
+	int arduinoRudder() const { return m_ArduinoRudder; }
+	int arduinoSheet() const { return m_ArduinoSheet; }
+	int arduinoBattery() const { return m_ArduinoBattery; }
 
-  	float windDir() { return m_WindDir; }
-  	float windSpeed() { return m_WindSpeed; }
-  	float windTemp() { return m_WindTemp; }
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
 
-  	int arduinoPressure() { return m_ArduinoPressure; }
-  	int arduinoRudder() { return m_ArduinoRudder; }
-  	int arduinoSheet() { return m_ArduinoSheet; }
-  	int arduinoBattery() { return m_ArduinoBattery; }
+		uint8_t* data = serialiser.reserve(86);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_CompassHeading);
+			data = LittleEndian::write(data, m_CompassPitch);
+			data = LittleEndian::write(data, m_CompassRoll);
+			data = LittleEndian::write(data, m_GpsFix);
+			data = LittleEndian::write(data, m_GpsOnline);
+			data = LittleEndian::write(data, m_Lat);
+			data = LittleEndian::write(data, m_Lon);
+			data = LittleEndian::write(data, m_UnixTime);
+			data = LittleEndian::write(data, m_GpsSpeed);
+			data = LittleEndian::write(data, m_Heading);
+			data = LittleEndian::write(data, m_GpsSatellite);
+			data = LittleEndian::write(data, m_WindDir);
+			data = LittleEndian::write(data, m_WindSpeed);
+			data = LittleEndian::write(data, m_WindTemp);
+			data = LittleEndian::write(data, m_ArduinoPressure);
+			data = LittleEndian::write(data, m_ArduinoRudder);
+			data = LittleEndian::write(data, m_ArduinoSheet);
+			data = LittleEndian::write(data, m_ArduinoBattery);
+		}
+	}
 
-  	///----------------------------------------------------------------------------------
-  	/// Serialises the message into a MessageSerialiser
-  	///----------------------------------------------------------------------------------
-  	virtual void Serialise(MessageSerialiser& serialiser) const
-  	{
-  		Message::Serialise(serialiser);
+private:
+	int    m_CompassHeading;
+	int    m_CompassPitch;
+	int    m_CompassRoll;
+	bool   m_GpsFix;
+	bool   m_GpsOnline;
+	double m_Lat;
+	double m_Lon;
+	double m_UnixTime;
+	double m_GpsSpeed;
+	double m_Heading;
+	int    m_GpsSatellite;
+	float  m_WindDir;
+	float  m_WindSpeed;
+	float  m_WindTemp;
+	int    m_ArduinoPressure;
+	int    m_ArduinoRudder;
+	int    m_ArduinoSheet;
+	int    m_ArduinoBattery;
+};
 
-  		serialiser.serialise(m_CompassHeading);
-  		serialiser.serialise(m_CompassPitch);
-  		serialiser.serialise(m_CompassRoll);
-  		serialiser.serialise(m_GPSHasFix);
-  		serialiser.serialise(m_GPSOnline);
-  		serialiser.serialise(m_GPSLat);
-  		serialiser.serialise(m_GPSLon);
-  		serialiser.serialise(m_GPSUnixTime);
-  		serialiser.serialise(m_GPSSpeed);
-  		serialiser.serialise(m_GPSCourse);
-  		serialiser.serialise(m_GPSSatellite);
-  		serialiser.serialise(m_WindDir);
-  		serialiser.serialise(m_WindSpeed);
-  		serialiser.serialise(m_WindTemp);
-  		serialiser.serialise(m_ArduinoPressure);
-  		serialiser.serialise(m_ArduinoRudder);
-  		serialiser.serialise(m_ArduinoSheet);
-  		serialiser.serialise(m_ArduinoBattery);
-  	}
 
+///----------------------------------------------------------------------------------
+/// Reads a serialised VesselStateMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class VesselStateView : public MessageView {
+public:
+	VesselStateView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::VesselState)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 86);
+	}
 
-  private:
-  	int 	m_CompassHeading;
-  	int 	m_CompassPitch;
-  	int 	m_CompassRoll;
-  	bool	m_GPSHasFix;
-  	bool	m_GPSOnline;
-  	double	m_GPSLat;
-  	double	m_GPSLon;
-  	double	m_GPSUnixTime;
-  	double	m_GPSSpeed;
-  	double	m_GPSCourse;
-  	int		m_GPSSatellite;
-  	float	m_WindDir;
-  	float	m_WindSpeed;
-  	float 	m_WindTemp;
-  	int 	m_ArduinoPressure;
-  	int 	m_ArduinoRudder;
-  	int 	m_ArduinoSheet;
-    int 	m_ArduinoBattery;
-  };
+	int compassHeading() const { return LittleEndian::readInt(m_Data + HEADER_SIZE); }
+	int compassPitch() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 4); }
+	int compassRoll() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 8); }
+	bool gpsHasFix() const { return LittleEndian::readBool(m_Data + HEADER_SIZE + 12); }
+	bool gpsOnline() const { return LittleEndian::readBool(m_Data + HEADER_SIZE + 13); }
+	double latitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 14); }
+	double longitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 22); }
+	double unixTime() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 30); }
+	double speed() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 38); }
+	double gpsHeading() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 46); }
+	int gpsSatellite() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 54); }
+	float windDir() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 58); }
+	float windSpeed() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 62); }
+	float windTemp() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 66); }
+	int arduinoPressure() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 70); }
+	int arduinoRudder() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 74); }
+	int arduinoSheet() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 78); }
+	int arduinoBattery() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 82); }
+};
@@ -4,49 +4,66 @@
  * 		WaypointDataMsg.h
  *
  * Purpose:
- *		A WaypointDataMsg contains waypoint data such as id, longitude, latitude, declination and radius
+ *		A WaypointDataMsg contains waypoint data such as id, longitude, latitude, declination
+ *		and radius
  *
  * Developer Notes:
- *
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class WaypointDataMsg : public Message {
 public:
-	WaypointDataMsg(NodeID destinationID, NodeID sourceID, int nextId, double nextLongitude, double nextLatitude, int nextDeclination, int nextRadius, 
-                        int nextStayTime, int prevId, double prevLongitude, double prevLatitude, int prevDeclination, int prevRadius)
-		:Message(MessageType::WaypointData, sourceID, destinationID), m_nextId(nextId), m_nextLongitude(nextLongitude), m_nextLatitude(nextLatitude),
-                         m_nextDeclination(nextDeclination), m_nextRadius(nextRadius), m_nextStayTime(nextStayTime), m_prevId(prevId), 
-                         m_prevLongitude(prevLongitude), m_prevLatitude(prevLatitude), m_prevDeclination(prevDeclination), m_prevRadius(prevRadius)
+	static const MessageType TYPE = MessageType::WaypointData;
+
+	WaypointDataMsg(NodeID destinationID, NodeID sourceID, int nextId, double nextLongitude,
+		double nextLatitude, int nextDeclination, int nextRadius, int nextStayTime, int prevId,
+		double prevLongitude, double prevLatitude, int prevDeclination, int prevRadius)
+		:Message(MessageType::WaypointData, sourceID, destinationID), m_NextId(nextId),
+		 m_NextLongitude(nextLongitude), m_NextLatitude(nextLatitude),
+		 m_NextDeclination(nextDeclination), m_NextRadius(nextRadius), m_NextStayTime(nextStayTime),
+		 m_PrevId(prevId), m_PrevLongitude(prevLongitude), m_PrevLatitude(prevLatitude),
+		 m_PrevDeclination(prevDeclination), m_PrevRadius(prevRadius)
 	{ }
 
-	WaypointDataMsg(int nextId, double nextLongitude, double nextLatitude, int nextDeclination, int nextRadius, int nextStayTime,
-                        int prevId, double prevLongitude, double prevLatitude, int prevDeclination, int prevRadius)
-		:Message(MessageType::WaypointData, NodeID::None, NodeID::None), m_nextId(nextId), m_nextLongitude(nextLongitude), m_nextLatitude(nextLatitude),
-                         m_nextDeclination(nextDeclination), m_nextRadius(nextRadius), m_nextStayTime(nextStayTime), m_prevId(prevId), m_prevLongitude(prevLongitude), 
-                         m_prevLatitude(prevLatitude), m_prevDeclination(prevDeclination), m_prevRadius(prevRadius)
-
+	WaypointDataMsg(int nextId, double nextLongitude, double nextLatitude, int nextDeclination,
+		int nextRadius, int nextStayTime, int prevId, double prevLongitude, double prevLatitude,
+		int prevDeclination, int prevRadius)
+		:Message(MessageType::WaypointData, NodeID::None, NodeID::None), m_NextId(nextId),
+		 m_NextLongitude(nextLongitude), m_NextLatitude(nextLatitude),
+		 m_NextDeclination(nextDeclination), m_NextRadius(nextRadius), m_NextStayTime(nextStayTime),
+		 m_PrevId(prevId), m_PrevLongitude(prevLongitude), m_PrevLatitude(prevLatitude),
+		 m_PrevDeclination(prevDeclination), m_PrevRadius(prevRadius)
 	{ }
 
 	WaypointDataMsg(MessageDeserialiser deserialiser)
-	:Message(deserialiser)
+		:Message(deserialiser), m_NextId(), m_NextLongitude(), m_NextLatitude(), m_NextDeclination(),
+		 m_NextRadius(), m_NextStayTime(), m_PrevId(), m_PrevLongitude(), m_PrevLatitude(),
+		 m_PrevDeclination(), m_PrevRadius()
 	{
-		if(	!deserialiser.readInt(m_nextId) ||
-			!deserialiser.readDouble(m_nextLongitude) ||
-			!deserialiser.readDouble(m_nextLatitude) ||
-			!deserialiser.readInt(m_nextDeclination) ||
-			!deserialiser.readInt(m_nextRadius) ||
-			!deserialiser.readInt(m_nextStayTime) ||
-			!deserialiser.readInt(m_prevId) ||
-			!deserialiser.readDouble(m_prevLongitude) ||
-			!deserialiser.readDouble(m_prevLatitude) ||
-			!deserialiser.readInt(m_prevDeclination) ||
-			!deserialiser.readInt(m_prevRadius))
+		const uint8_t* data = m_valid ? deserialiser.take(60) : NULL;
+		if(data != NULL)
+		{
+			m_NextId = LittleEndian::readInt(data);
+			m_NextLongitude = LittleEndian::readDouble(data + 4);
+			m_NextLatitude = LittleEndian::readDouble(data + 12);
+			m_NextDeclination = LittleEndian::readInt(data + 20);
+			m_NextRadius = LittleEndian::readInt(data + 24);
+			m_NextStayTime = LittleEndian::readInt(data + 28);
+			m_PrevId = LittleEndian::readInt(data + 32);
+			m_PrevLongitude = LittleEndian::readDouble(data + 36);
+			m_PrevLatitude = LittleEndian::readDouble(data + 44);
+			m_PrevDeclination = LittleEndian::readInt(data + 52);
+			m_PrevRadius = LittleEndian::readInt(data + 56);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -54,52 +71,78 @@ public:
 
 	virtual ~WaypointDataMsg() { }
 
+	int nextId() const { return m_NextId; }
+	double nextLongitude() const { return m_NextLongitude; }
+	double nextLatitude() const { return m_NextLatitude; }
+	int nextDeclination() const { return m_NextDeclination; }
+	int nextRadius() const { return m_NextRadius; }
+	int stayTime() const { return m_NextStayTime; }
+	int prevId() const { return m_PrevId; }
+	double prevLongitude() const { return m_PrevLongitude; }
+	double prevLatitude() const { return m_PrevLatitude; }
+	int prevDeclination() const { return m_PrevDeclination; }
+	int prevRadius() const { return m_PrevRadius; }
 
-    int     nextId()            const { return m_nextId; }
-    double  nextLongitude()     const { return m_nextLongitude; }
-    double  nextLatitude()      const { return m_nextLatitude; }
-    int     nextDeclination()   const { return m_nextDeclination; }
-    int     nextRadius()        const { return m_nextRadius; }
-    int     stayTime()          const { return m_nextStayTime; }
-
-    int     prevId()            const { return m_prevId; }
-    double  prevLongitude()     const { return m_prevLongitude; }
-    double  prevLatitude()      const { return m_prevLatitude; }
-    int     prevDeclination()   const { return m_prevDeclination; }
-    int     prevRadius()        const { return m_prevRadius; }
-
-    ///----------------------------------------------------------------------------------
+	///----------------------------------------------------------------------------------
 	/// Serialises the message into a MessageSerialiser
 	///----------------------------------------------------------------------------------
 	virtual void Serialise(MessageSerialiser& serialiser) const
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_nextId);
-		serialiser.serialise(m_nextLongitude);
-		serialiser.serialise(m_nextLatitude);
-		serialiser.serialise(m_nextDeclination);
-		serialiser.serialise(m_nextRadius);
-		serialiser.serialise(m_nextStayTime);
-		serialiser.serialise(m_prevId);
-		serialiser.serialise(m_prevLongitude);
-		serialiser.serialise(m_prevLatitude);
-		serialiser.serialise(m_prevDeclination);
-		serialiser.serialise(m_prevRadius);
+		uint8_t* data = serialiser.reserve(60);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_NextId);
+			data = LittleEndian::write(data, m_NextLongitude);
+			data = LittleEndian::write(data, m_NextLatitude);
+			data = LittleEndian::write(data, m_NextDeclination);
+			data = LittleEndian::write(data, m_NextRadius);
+			data = LittleEndian::write(data, m_NextStayTime);
+			data = LittleEndian::write(data, m_PrevId);
+			data = LittleEndian::write(data, m_PrevLongitude);
+			data = LittleEndian::write(data, m_PrevLatitude);
+			data = LittleEndian::write(data, m_PrevDeclination);
+			data = LittleEndian::write(data, m_PrevRadius);
+		}
 	}
 
 private:
+	int    m_NextId;
+	double m_NextLongitude;    // units : North(+) or South(-) [0-90]
+	double m_NextLatitude;     // units : East(+) or West(-)  [0-180]
+	int    m_NextDeclination;  // units : degrees
+	int    m_NextRadius;       // units : meters
+	int    m_NextStayTime;     // units : seconds
+	int    m_PrevId;
+	double m_PrevLongitude;    // units : North(+) or South(-) [0-90]
+	double m_PrevLatitude;     // units : East(+) or West(-)  [0-180]
+	int    m_PrevDeclination;  // units : degrees
+	int    m_PrevRadius;       // units : meters
+};
+
 
-    int     m_nextId;
-    double  m_nextLongitude;	// units : North(+) or South(-) [0-90]
-    double  m_nextLatitude;		// units : East(+) or West(-)  [0-180]
-    int     m_nextDeclination;	// units : degrees
-    int     m_nextRadius;		// units : meters
-    int     m_nextStayTime;		// units : seconds
+///----------------------------------------------------------------------------------
+/// Reads a serialised WaypointDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class WaypointDataView : public MessageView {
+public:
+	WaypointDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::WaypointData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 60);
+	}
 
-    int     m_prevId;
-    double  m_prevLongitude;	// units : North(+) or South(-) [0-90]
-    double  m_prevLatitude;		// units : East(+) or West(-)  [0-180]
-    int     m_prevDeclination;	// units : degrees
-    int     m_prevRadius;		// units : meters
+	int nextId() const { return LittleEndian::readInt(m_Data + HEADER_SIZE); }
+	double nextLongitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 4); }
+	double nextLatitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 12); }
+	int nextDeclination() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 20); }
+	int nextRadius() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 24); }
+	int stayTime() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 28); }
+	int prevId() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 32); }
+	double prevLongitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 36); }
+	double prevLatitude() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 44); }
+	int prevDeclination() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 52); }
+	int prevRadius() const { return LittleEndian::readInt(m_Data + HEADER_SIZE + 56); }
 };
@@ -8,32 +8,43 @@
  *		Commonly generated by a wind sensor
  *
  * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
  *
  ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class WindDataMsg : public Message {
 public:
-	WindDataMsg(NodeID destinationID, NodeID sourceID, float windDir, float windSpeed, float windTemp)
-		:Message(MessageType::WindData, sourceID, destinationID),
-		m_WindDir(windDir), m_WindSpeed(windSpeed), m_WindTemp(windTemp)
+	static const MessageType TYPE = MessageType::WindData;
+
+	WindDataMsg(NodeID destinationID, NodeID sourceID, float windDir, float windSpeed,
+		float windTemp)
+		:Message(MessageType::WindData, sourceID, destinationID), m_WindDir(windDir),
+		 m_WindSpeed(windSpeed), m_WindTemp(windTemp)
 	{ }
 
 	WindDataMsg(float windDir, float windSpeed, float windTemp)
-		:Message(MessageType::WindData, NodeID::None, NodeID::None),
-		m_WindDir(windDir), m_WindSpeed(windSpeed), m_WindTemp(windTemp)
+		:Message(MessageType::WindData, NodeID::None, NodeID::None), m_WindDir(windDir),
+		 m_WindSpeed(windSpeed), m_WindTemp(windTemp)
 	{ }
 
 	WindDataMsg(MessageDeserialiser deserialiser)
-		:Message(deserialiser)
+		:Message(deserialiser), m_WindDir(), m_WindSpeed(), m_WindTemp()
 	{
-		if(	!deserialiser.readFloat(m_WindDir) ||
-			!deserialiser.readFloat(m_WindSpeed) ||
-			!deserialiser.readFloat(m_WindTemp))
+		const uint8_t* data = m_valid ? deserialiser.take(12) : NULL;
+		if(data != NULL)
+		{
+			m_WindDir = LittleEndian::readFloat(data);
+			m_WindSpeed = LittleEndian::readFloat(data + 4);
+			m_WindTemp = LittleEndian::readFloat(data + 8);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -52,13 +63,35 @@ public:
 	{
 		Message::Serialise(serialiser);
 
-		serialiser.serialise(m_WindDir);
-		serialiser.serialise(m_WindSpeed);
-		serialiser.serialise(m_WindTemp);
+		uint8_t* data = serialiser.reserve(12);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_WindDir);
+			data = LittleEndian::write(data, m_WindSpeed);
+			data = LittleEndian::write(data, m_WindTemp);
+		}
 	}
 
 private:
-	float 	m_WindDir;		// degree [0, 360[ in vessel reference frame (clockwise)
-	float 	m_WindSpeed;	// m/s
-	float	m_WindTemp;		// degree Celsius
+	float m_WindDir;    // degree [0, 360[ in vessel reference frame (clockwise)
+	float m_WindSpeed;  // m/s
+	float m_WindTemp;   // degree Celsius
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised WindDataMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class WindDataView : public MessageView {
+public:
+	WindDataView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::WindData)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 12);
+	}
+
+	float windDirection() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
+	float windSpeed() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 4); }
+	float windTemp() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE + 8); }
 };
@@ -1,33 +1,65 @@
-//
-//	Wind State Message containing True Wind Speed & Direction,
-//   as well as Apparent Wind Speed & Direction
-//
+/****************************************************************************************
+ *
+ * File:
+ * 		WindStateMsg.h
+ *
+ * Purpose:
+ *		Wind State Message containing True Wind Speed & Direction, as well as Apparent
+ *		Wind Speed & Direction
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
 
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class WindStateMsg : public Message {
 public:
-	WindStateMsg(NodeID sourceID, NodeID destinationID, double trueWindSpeed,
-					double trueWindDir, double ApparentWindSpeed, double ApparentWindDir)
-	: Message(MessageType::WindState, sourceID, destinationID), m_trueWindSpeed(trueWindSpeed),
-		m_trueWindDir(trueWindDir), m_apparentWindSpeed(ApparentWindSpeed), m_apparentWindDir(ApparentWindDir)
-	{  }
+	static const MessageType TYPE = MessageType::WindState;
 
-	WindStateMsg(double trueWindSpeed, double trueWindDir, double ApparentWindSpeed, double ApparentWindDir)
-	: Message(MessageType::WindState, NodeID::None, NodeID::None), m_trueWindSpeed(trueWindSpeed),
-		m_trueWindDir(trueWindDir), m_apparentWindSpeed(ApparentWindSpeed), m_apparentWindDir(ApparentWindDir)
-	{  }
+	///----------------------------------------------------------------------------------
+	/// The wind state as kept on the message bus blackboard, see Blackboard.h.
+	///----------------------------------------------------------------------------------
+	struct Snapshot {
+		double	trueWindSpeed;
+		double	trueWindDirection;
+		double	apparentWindSpeed;
+		double	apparentWindDirection;
+	};
+
+	WindStateMsg(NodeID sourceID, NodeID destinationID, double trueWindSpeed, double trueWindDir,
+		double apparentWindSpeed, double apparentWindDir)
+		:Message(MessageType::WindState, sourceID, destinationID), m_TrueWindSpeed(trueWindSpeed),
+		 m_TrueWindDir(trueWindDir), m_ApparentWindSpeed(apparentWindSpeed),
+		 m_ApparentWindDir(apparentWindDir)
+	{ }
+
+	WindStateMsg(double trueWindSpeed, double trueWindDir, double apparentWindSpeed,
+		double apparentWindDir)
+		:Message(MessageType::WindState, NodeID::None, NodeID::None), m_TrueWindSpeed(trueWindSpeed),
+		 m_TrueWindDir(trueWindDir), m_ApparentWindSpeed(apparentWindSpeed),
+		 m_ApparentWindDir(apparentWindDir)
+	{ }
 
 	WindStateMsg(MessageDeserialiser deserialiser)
-	: Message(deserialiser)
+		:Message(deserialiser), m_TrueWindSpeed(), m_TrueWindDir(), m_ApparentWindSpeed(),
+		 m_ApparentWindDir()
 	{
-		if(!deserialiser.readDouble(m_trueWindSpeed) 	 ||
-		   !deserialiser.readDouble(m_trueWindDir)   	 ||
-		   !deserialiser.readDouble(m_apparentWindSpeed) ||	
-		   !deserialiser.readDouble(m_apparentWindDir))
+		const uint8_t* data = m_valid ? deserialiser.take(32) : NULL;
+		if(data != NULL)
+		{
+			m_TrueWindSpeed = LittleEndian::readDouble(data);
+			m_TrueWindDir = LittleEndian::readDouble(data + 8);
+			m_ApparentWindSpeed = LittleEndian::readDouble(data + 16);
+			m_ApparentWindDir = LittleEndian::readDouble(data + 24);
+		}
+		else
 		{
 			m_valid = false;
 		}
@@ -35,27 +67,56 @@ public:
 
 	virtual ~WindStateMsg() { }
 
-	double trueWindSpeed() const  		 { return m_trueWindSpeed; }
-	double trueWindDirection() const	 { return m_trueWindDir;   }
-	double apparentWindSpeed() const	 { return m_apparentWindSpeed; }
-	double apparentWindDirection() const { return m_apparentWindDir;   }
+	double trueWindSpeed() const { return m_TrueWindSpeed; }
+	double trueWindDirection() const { return m_TrueWindDir; }
+	double apparentWindSpeed() const { return m_ApparentWindSpeed; }
+	double apparentWindDirection() const { return m_ApparentWindDir; }
 
-    ///----------------------------------------------------------------------------------
-    /// Serialises the message into a MessageSerialiser
-    ///----------------------------------------------------------------------------------
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
+	Snapshot snapshot() const
+	{
+		Snapshot snapshot = { m_TrueWindSpeed, m_TrueWindDir, m_ApparentWindSpeed, m_ApparentWindDir };
+		return snapshot;
+	}
 
-        serialiser.serialise(m_trueWindSpeed);
-        serialiser.serialise(m_trueWindDir);
-        serialiser.serialise(m_apparentWindSpeed);
-        serialiser.serialise(m_apparentWindDir);
-    }
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(32);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_TrueWindSpeed);
+			data = LittleEndian::write(data, m_TrueWindDir);
+			data = LittleEndian::write(data, m_ApparentWindSpeed);
+			data = LittleEndian::write(data, m_ApparentWindDir);
+		}
+	}
 
 private:
-	double 	m_trueWindSpeed;		// m/s
-	double 	m_trueWindDir;			// degree [0, 360[ in North-East reference frame (clockwise)
-	double 	m_apparentWindSpeed;	// m/s
-	double 	m_apparentWindDir;		// degree [0, 360[ in vessel reference frame (clockwise)
-};
\ No newline at end of file
+	double m_TrueWindSpeed;      // m/s
+	double m_TrueWindDir;        // degree [0, 360[ in North-East reference frame (clockwise)
+	double m_ApparentWindSpeed;  // m/s
+	double m_ApparentWindDir;    // degree [0, 360[ in vessel reference frame (clockwise)
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised WindStateMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class WindStateView : public MessageView {
+public:
+	WindStateView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::WindState)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 32);
+	}
+
+	double trueWindSpeed() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE); }
+	double trueWindDirection() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 8); }
+	double apparentWindSpeed() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 16); }
+	double apparentWindDirection() const { return LittleEndian::readDouble(m_Data + HEADER_SIZE + 24); }
+};
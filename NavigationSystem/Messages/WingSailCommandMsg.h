@@ -1,36 +1,83 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		WingSailCommandMsg.h
+ *
+ * Purpose:
+ *		The angle the tail of the wing sail is set to.
+ *
+ * Developer Notes:
+ *		Generated from Messages/messages.json by Tools/generate_messages.py, change the
+ *		schema and run 'make messages' instead of editing this file.
+ *
+ ***************************************************************************************/
+
 #pragma once
 
 #include "MessageBus/Message.h"
+#include "MessageBus/MessageView.h"
 
 
 class WingSailCommandMsg : public Message {
 public:
-    WingSailCommandMsg(NodeID sourceID, NodeID destinationID, float tailAngle)
-        :Message(MessageType::WingSailCommand, sourceID, destinationID), m_TailAngle(tailAngle)
-    {  }
-
-    WingSailCommandMsg(float tailAngle)
-        :Message(MessageType::WingSailCommand, NodeID::None, NodeID::None), m_TailAngle(tailAngle)
-    {  }
-
-    WingSailCommandMsg(MessageDeserialiser deserialiser)
-        :Message(deserialiser)
-    {
-        if( !deserialiser.readFloat(m_TailAngle))
-        {
-            m_valid = false;
-        }
-    }
-
-    virtual ~WingSailCommandMsg() { }
-    float tailAngle() const { return m_TailAngle;}
-
-    virtual void Serialise(MessageSerialiser& serialiser) const
-    {
-        Message::Serialise(serialiser);
-        serialiser.serialise(m_TailAngle);
-    }
+	static const MessageType TYPE = MessageType::WingSailCommand;
+
+	WingSailCommandMsg(NodeID sourceID, NodeID destinationID, float tailAngle)
+		:Message(MessageType::WingSailCommand, sourceID, destinationID), m_TailAngle(tailAngle)
+	{ }
+
+	WingSailCommandMsg(float tailAngle)
+		:Message(MessageType::WingSailCommand, NodeID::None, NodeID::None), m_TailAngle(tailAngle)
+	{ }
+
+	WingSailCommandMsg(MessageDeserialiser deserialiser)
+		:Message(deserialiser), m_TailAngle()
+	{
+		const uint8_t* data = m_valid ? deserialiser.take(4) : NULL;
+		if(data != NULL)
+		{
+			m_TailAngle = LittleEndian::readFloat(data);
+		}
+		else
+		{
+			m_valid = false;
+		}
+	}
+
+	virtual ~WingSailCommandMsg() { }
+
+	float tailAngle() const { return m_TailAngle; }
+
+	///----------------------------------------------------------------------------------
+	/// Serialises the message into a MessageSerialiser
+	///----------------------------------------------------------------------------------
+	virtual void Serialise(MessageSerialiser& serialiser) const
+	{
+		Message::Serialise(serialiser);
+
+		uint8_t* data = serialiser.reserve(4);
+		if(data != NULL)
+		{
+			data = LittleEndian::write(data, m_TailAngle);
+		}
+	}
 
 private:
-    float m_TailAngle; // degree [-26, +26[ in wing sail reference frame (clockwise from top view)
+	float m_TailAngle;  // degree [-26, +26[ in wing sail reference frame (clockwise from top view)
+};
+
+
+///----------------------------------------------------------------------------------
+/// Reads a serialised WingSailCommandMsg where it lies, see MessageView.h.
+///----------------------------------------------------------------------------------
+class WingSailCommandView : public MessageView {
+public:
+	WingSailCommandView(const uint8_t* data, uint16_t size)
+		:MessageView(data, size, MessageType::WingSailCommand)
+	{
+		uint32_t offset = HEADER_SIZE;
+		skip(offset, 4);
+	}
+
+	float tailAngle() const { return LittleEndian::readFloat(m_Data + HEADER_SIZE); }
 };
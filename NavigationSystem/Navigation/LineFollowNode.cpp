@@ -47,7 +47,10 @@ m_TackDirection(1), m_BeatingMode(false)
     m_TackingDistance = 15;
 }
 
-LineFollowNode::~LineFollowNode() {}
+LineFollowNode::~LineFollowNode()
+{
+    stopPeriodic();
+}
 
 bool LineFollowNode::init()
 {
@@ -58,18 +61,19 @@ bool LineFollowNode::init()
 void LineFollowNode::start()
 {
     m_Running.store(true);
-    runThread(LineFollowNodeThreadFunc);
+    runPeriodic(m_LoopTime, INITIAL_SLEEP);
 }
 
 void LineFollowNode::stop()
 {
     m_Running.store(false);
-    stopThread(this);
+    stopPeriodic();
 }
 
 void LineFollowNode::updateConfigsFromDB()
 {
     m_LoopTime = m_db.retrieveCellAsDouble("config_line_follow","1","loop_time");
+    setTickPeriod(m_LoopTime);
     m_CloseHauledAngle = Utility::degreeToRadian(m_db.retrieveCellAsDouble("config_line_follow","1","close_hauled_angle"));
     m_BroadReachAngle = Utility::degreeToRadian(m_db.retrieveCellAsDouble("config_line_follow","1","broad_reach_angle"));
     m_TackingDistance = m_db.retrieveCellAsDouble("config_line_follow","1","tacking_distance");
@@ -106,6 +110,7 @@ void LineFollowNode::processStateMessage(const StateMessage* vesselStateMsg )
 
     m_VesselLat = vesselStateMsg->latitude();
     m_VesselLon = vesselStateMsg->longitude();
+    m_VesselCause = vesselStateMsg->asCause();
 }
 
 void LineFollowNode::processWindStateMessage(const WindStateMsg* windStateMsg )
@@ -260,27 +265,18 @@ void LineFollowNode::ifBoatPassedOrEnteredWP_setPrevWPToBoatPos()
     }
 }
 
-void LineFollowNode::LineFollowNodeThreadFunc(ActiveNode* nodePtr)
+void LineFollowNode::tick()
 {
-    LineFollowNode* node = dynamic_cast<LineFollowNode*> (nodePtr);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds( INITIAL_SLEEP ));
-
-    Timer timer;
-    timer.start();
-
-
-    while(node->m_Running.load() == true)
+    ifBoatPassedOrEnteredWP_setPrevWPToBoatPos();
+    double targetCourse = calculateTargetCourse();
+    if (targetCourse != DATA_OUT_OF_RANGE)
     {
-        node->ifBoatPassedOrEnteredWP_setPrevWPToBoatPos();
-        double targetCourse = node->calculateTargetCourse();
-        if (targetCourse != DATA_OUT_OF_RANGE)
+        bool targetTackStarboard = getTargetTackStarboard(targetCourse);
+        MessagePtr LocalNavMsg = std::make_unique<LocalNavigationMsg>((float) targetCourse, NO_COMMAND, m_BeatingMode, targetTackStarboard);
         {
-            bool targetTackStarboard = node->getTargetTackStarboard(targetCourse);
-            MessagePtr LocalNavMsg = std::make_unique<LocalNavigationMsg>((float) targetCourse, NO_COMMAND, node->m_BeatingMode, targetTackStarboard);
-            node->m_MsgBus.sendMessage( std::move( LocalNavMsg ) );
+            std::lock_guard<std::mutex> lock_guard(m_lock);
+            LocalNavMsg->setCause(m_VesselCause);
         }
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
+        m_MsgBus.sendMessage( std::move( LocalNavMsg ) );
     }
 }
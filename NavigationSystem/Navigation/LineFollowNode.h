@@ -94,9 +94,10 @@ private:
 	void ifBoatPassedOrEnteredWP_setPrevWPToBoatPos();
 
     ///----------------------------------------------------------------------------------
-    /// Starts the LineFollowNode's thread that pumps out LocalNavigationMsg.
+    /// Pumps out a LocalNavigationMsg, called every loop time by the message bus's tick
+    /// scheduler.
     ///----------------------------------------------------------------------------------
-	static void LineFollowNodeThreadFunc(ActiveNode* nodePtr);
+	void tick();
 
 	DBHandler& m_db;
     std::mutex m_lock;
@@ -121,6 +122,7 @@ private:
 
     double  m_VesselLat;
     double  m_VesselLon;
+    MessageCause m_VesselCause;     // Of the state message the position came from
 
 	double 	m_trueWindSpeed;		// m/s
 	double 	m_trueWindDir;			// degree [0, 360[ in North-East reference frame (clockwise)
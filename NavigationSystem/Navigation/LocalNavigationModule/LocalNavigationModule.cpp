@@ -60,6 +60,12 @@ LocalNavigationModule::LocalNavigationModule( MessageBus& msgBus,DBHandler& dbha
     msgBus.registerNode( *this, MessageType::ServerConfigsReceived );
 }
 
+///----------------------------------------------------------------------------------
+LocalNavigationModule::~LocalNavigationModule()
+{
+    stopPeriodic();
+}
+
 ///----------------------------------------------------------------------------------
 bool LocalNavigationModule::init()
 {
@@ -70,12 +76,15 @@ bool LocalNavigationModule::init()
 ///----------------------------------------------------------------------------------
 void LocalNavigationModule::start()
 {
-    runThread(WakeupThreadFunc);
+	// The initial delay ensures that most if not all the sensor data arrives at the start
+	// before we ask for a course.
+    runPeriodic(m_LoopTime, WAKEUP_INTIAL_SLEEP);
 }
 
 ///----------------------------------------------------------------------------------
 void LocalNavigationModule::updateConfigsFromDB(){
     m_LoopTime = m_db.retrieveCellAsDouble("config_voter_system","1","loop_time");
+    setTickPeriod(m_LoopTime);
 }
 
 ///----------------------------------------------------------------------------------
@@ -90,6 +99,7 @@ void LocalNavigationModule::processMessage( const Message* msg )
             boatState.lat = vesselStateMsg->latitude();
             boatState.lon = vesselStateMsg->longitude();
             boatState.speed = vesselStateMsg->speed();
+            m_BoatStateCause = vesselStateMsg->asCause();
         }
             break;
 
@@ -170,6 +180,7 @@ void LocalNavigationModule::startBallot()
     uint16_t targetCourse = arbiter.getWinner();
     bool targetTackStarboard = getTargetTackStarboard((double) targetCourse);
     MessagePtr msg = std::make_unique<LocalNavigationMsg>((float) targetCourse, NO_COMMAND, 0, targetTackStarboard);
+    msg->setCause(m_BoatStateCause);
     m_MsgBus.sendMessage( std::move( msg ) );
 }
 
@@ -186,25 +197,9 @@ bool LocalNavigationModule::getTargetTackStarboard(double targetCourse)
 ///----------------------------------------------------------------------------------
 /// Just a little hack for waking up the navigation module for now
 ///----------------------------------------------------------------------------------
-void LocalNavigationModule::WakeupThreadFunc( ActiveNode* nodePtr )
+void LocalNavigationModule::tick()
 {
-    LocalNavigationModule* node = dynamic_cast<LocalNavigationModule*> (nodePtr);
-
-	// An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
-	// at the start before we send out the vessel state message.
-	std::this_thread::sleep_for( std::chrono::milliseconds( WAKEUP_INTIAL_SLEEP ) );
-
-    Timer timer;
-    timer.start();
-
-	while(true)
-	{
-        MessagePtr courseRequest = std::make_unique<RequestCourseMsg>();
-		node->m_MsgBus.sendMessage( std::move( courseRequest ) );
-
-        // Controls how often we pump out messages
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
-	}
+    MessagePtr courseRequest = std::make_unique<RequestCourseMsg>();
+    m_MsgBus.sendMessage( std::move( courseRequest ) );
 }
 
@@ -31,13 +31,18 @@ public:
  	///----------------------------------------------------------------------------------
     LocalNavigationModule( MessageBus& msgBus, DBHandler& dbhandler);
 
+    ///----------------------------------------------------------------------------------
+ 	/// Stops the wakeup ticks
+ 	///----------------------------------------------------------------------------------
+    ~LocalNavigationModule();
+
     ///----------------------------------------------------------------------------------
  	/// Does nothing
  	///----------------------------------------------------------------------------------
     bool init();
 
     ///----------------------------------------------------------------------------------
- 	/// Starts the quick hack wakeup thread
+ 	/// Starts the quick hack wakeup ticks
  	///----------------------------------------------------------------------------------
     void start();
 
@@ -74,12 +79,14 @@ private:
     void updateConfigsFromDB();
 
     ///----------------------------------------------------------------------------------
- 	/// Just a little hack for waking up the navigation module for now
+ 	/// Just a little hack for waking up the navigation module for now, called every loop
+    /// time by the message bus's tick scheduler.
  	///----------------------------------------------------------------------------------
-    static void WakeupThreadFunc( ActiveNode* nodePtr );
+    void tick();
 
     std::vector<ASRVoter*> voters;
     BoatState_t boatState;
+    MessageCause m_BoatStateCause;  // Of the state message boatState came from
     ASRArbiter arbiter;
     double m_LoopTime;
     DBHandler& m_db;
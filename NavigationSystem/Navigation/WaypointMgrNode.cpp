@@ -139,8 +139,6 @@ void WaypointMgrNode::sendMessage()
 
         Logger::info("Completed route in %d:%d:%d", hours, minutes, seconds);
     }
-
-    m_db.forceUnlock();
 }
 
 bool WaypointMgrNode::harvestWaypoint()
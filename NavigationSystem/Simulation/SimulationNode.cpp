@@ -48,7 +48,8 @@ SimulationNode::SimulationNode(MessageBus& msgBus, bool boatType, CollidableMgr*
 
 void SimulationNode::start()
 {
-    runThread(SimulationThreadFunc);
+    // Paced by the packets from the simulator
+    runThread(SimulationThreadFunc, false);
 }
 
 bool SimulationNode::init()
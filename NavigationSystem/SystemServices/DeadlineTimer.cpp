@@ -0,0 +1,56 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		DeadlineTimer.cpp
+ *
+ * Purpose:
+ *		Paces a control loop on absolute deadlines.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "SystemServices/DeadlineTimer.h"
+#include "SystemServices/SysClock.h"
+
+
+DeadlineTimer::DeadlineTimer()
+	:m_PeriodUs(0), m_Deadline(0), m_Skipped(0)
+{ }
+
+void DeadlineTimer::start(double periodSeconds)
+{
+	setPeriod(periodSeconds);
+	m_Deadline = SysClock::monotonicMicros() + m_PeriodUs.load();
+}
+
+void DeadlineTimer::setPeriod(double periodSeconds)
+{
+	// A zero period would never skip a missed deadline
+	uint64_t periodUs = periodSeconds * 1000000;
+	m_PeriodUs.store(periodUs > 0 ? periodUs : 1);
+}
+
+void DeadlineTimer::sleepUntilNextDeadline()
+{
+	uint64_t period = m_PeriodUs.load();
+	uint64_t now = SysClock::monotonicMicros();
+
+	if(now < m_Deadline)
+	{
+		SysClock::sleepUntil(m_Deadline);
+		now = SysClock::monotonicMicros();
+	}
+	else
+	{
+		m_Missed.record(now - m_Deadline);
+
+		uint64_t behind = (now - m_Deadline) / period;
+		m_Skipped += behind;
+		m_Deadline += behind * period;
+	}
+
+	m_Jitter.record(now > m_Deadline ? now - m_Deadline : 0);
+	m_Deadline += period;
+}
@@ -0,0 +1,76 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		DeadlineTimer.h
+ *
+ * Purpose:
+ *		Paces a control loop on absolute deadlines and records how well it keeps to
+ *		them: how late each loop started (the jitter) and by how much the loops that
+ *		finished after their deadline missed it.
+ *
+ * Developer Notes:
+ *		The next deadline is the previous one plus the period, so the time spent in the
+ *		loop doesn't add up into a drift. A loop that misses its deadline runs again
+ *		straight away, whole periods it fell behind are skipped and counted, like the
+ *		ticks of the TickScheduler.
+ *
+ *		The timer sleeps on the SysClock, on the real time source that is an absolute
+ *		clock_nanosleep() on the monotonic clock.
+ *
+ *		Only the loop's thread may call start() and sleepUntilNextDeadline(), the
+ *		statistics can be read from any thread.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "SystemServices/LatencyHistogram.h"
+#include <atomic>
+#include <stdint.h>
+
+
+class DeadlineTimer {
+public:
+	DeadlineTimer();
+
+	///----------------------------------------------------------------------------------
+ 	/// Sets the first deadline one period from now.
+ 	///----------------------------------------------------------------------------------
+	void start(double periodSeconds);
+
+	///----------------------------------------------------------------------------------
+ 	/// Changes the period, the deadline after the next one uses it. Can be called from
+ 	/// any thread.
+ 	///----------------------------------------------------------------------------------
+	void setPeriod(double periodSeconds);
+
+	///----------------------------------------------------------------------------------
+ 	/// Sleeps until the next deadline, or returns straight away if it has passed.
+ 	///----------------------------------------------------------------------------------
+	void sleepUntilNextDeadline();
+
+	uint64_t periodUs() const { return m_PeriodUs.load(); }
+
+	///----------------------------------------------------------------------------------
+ 	/// Time between a deadline and the start of its loop, one sample per loop.
+ 	///----------------------------------------------------------------------------------
+	const LatencyHistogram& jitter() const { return m_Jitter; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Time between a deadline and the end of a loop that ran past it, one sample per
+ 	/// missed deadline.
+ 	///----------------------------------------------------------------------------------
+	const LatencyHistogram& missed() const { return m_Missed; }
+
+	///----------------------------------------------------------------------------------
+ 	/// Deadlines dropped after a missed one.
+ 	///----------------------------------------------------------------------------------
+	uint64_t skipped() const { return m_Skipped.load(); }
+
+private:
+	std::atomic<uint64_t> 	m_PeriodUs;
+	uint64_t 				m_Deadline;		// Monotonic time of the next deadline
+	LatencyHistogram 		m_Jitter;
+	LatencyHistogram 		m_Missed;
+	std::atomic<uint64_t> 	m_Skipped;
+};
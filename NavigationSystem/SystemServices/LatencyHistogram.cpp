@@ -0,0 +1,99 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LatencyHistogram.cpp
+ *
+ * Purpose:
+ *		A small thread safe histogram for recording latencies in microseconds.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "SystemServices/LatencyHistogram.h"
+#include <stdio.h>
+
+
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+void LatencyHistogram::record(uint64_t microseconds)
+{
+	// The bucket is the number of significant bits of the sample
+	int bucket = (microseconds == 0) ? 0 : 64 - __builtin_clzll(microseconds);
+	if(bucket >= BUCKET_COUNT)
+	{
+		bucket = BUCKET_COUNT - 1;
+	}
+
+	m_Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	m_Count.fetch_add(1, std::memory_order_relaxed);
+	m_Sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+	uint64_t currentMax = m_Max.load(std::memory_order_relaxed);
+	while(microseconds > currentMax &&
+		not m_Max.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed))
+	{ }
+}
+
+void LatencyHistogram::reset()
+{
+	for(int i = 0; i < BUCKET_COUNT; i++)
+	{
+		m_Buckets[i].store(0, std::memory_order_relaxed);
+	}
+	m_Count.store(0, std::memory_order_relaxed);
+	m_Sum.store(0, std::memory_order_relaxed);
+	m_Max.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const
+{
+	uint64_t samples = count();
+	if(samples == 0)
+	{
+		return 0;
+	}
+	return (double)m_Sum.load(std::memory_order_relaxed) / samples;
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const
+{
+	uint64_t samples = count();
+	if(samples == 0)
+	{
+		return 0;
+	}
+
+	uint64_t target = (uint64_t)(samples * percent / 100.0);
+	if(target >= samples)
+	{
+		target = samples - 1;
+	}
+
+	uint64_t seen = 0;
+	for(int i = 0; i < BUCKET_COUNT; i++)
+	{
+		seen += m_Buckets[i].load(std::memory_order_relaxed);
+		if(seen > target)
+		{
+			// The largest sample can be lower than the bucket's upper bound
+			uint64_t upperBound = (i == 0) ? 0 : ((uint64_t)1 << i) - 1;
+			return (upperBound < max()) ? upperBound : max();
+		}
+	}
+	return max();
+}
+
+std::string LatencyHistogram::toString() const
+{
+	char buff[160];
+	snprintf(buff, sizeof(buff), "n=%llu mean=%.1fus p50=%lluus p90=%lluus p99=%lluus max=%lluus",
+		(unsigned long long)count(), mean(), (unsigned long long)percentile(50),
+		(unsigned long long)percentile(90), (unsigned long long)percentile(99),
+		(unsigned long long)max());
+	return std::string(buff);
+}
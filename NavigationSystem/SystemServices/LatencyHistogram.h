@@ -0,0 +1,79 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LatencyHistogram.h
+ *
+ * Purpose:
+ *		A small thread safe histogram for recording latencies in microseconds. Samples
+ *		are stored in power of two buckets, so percentiles are approximate (the upper
+ *		bound of the bucket the percentile falls into is returned).
+ *
+ * Developer Notes:
+ *		Recording a sample is a handful of relaxed atomic operations, so a histogram can
+ *		be shared by several threads and read while it is being written to.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+
+class LatencyHistogram {
+public:
+	LatencyHistogram();
+
+	///----------------------------------------------------------------------------------
+	/// Records a single sample.
+	///
+	/// @param microseconds 	The latency to record.
+	///----------------------------------------------------------------------------------
+	void record(uint64_t microseconds);
+
+	///----------------------------------------------------------------------------------
+	/// Clears all the recorded samples.
+	///----------------------------------------------------------------------------------
+	void reset();
+
+	///----------------------------------------------------------------------------------
+	/// Returns the number of samples recorded.
+	///----------------------------------------------------------------------------------
+	uint64_t count() const { return m_Count.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+	/// Returns the largest sample recorded, in microseconds.
+	///----------------------------------------------------------------------------------
+	uint64_t max() const { return m_Max.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+	/// Returns the sum of all the samples recorded, in microseconds.
+	///----------------------------------------------------------------------------------
+	uint64_t total() const { return m_Sum.load(std::memory_order_relaxed); }
+
+	///----------------------------------------------------------------------------------
+	/// Returns the mean of the recorded samples, in microseconds.
+	///----------------------------------------------------------------------------------
+	double mean() const;
+
+	///----------------------------------------------------------------------------------
+	/// Returns an upper bound of the given percentile, in microseconds.
+	///
+	/// @param percent 			The percentile to look up, between 0 and 100.
+	///----------------------------------------------------------------------------------
+	uint64_t percentile(double percent) const;
+
+	///----------------------------------------------------------------------------------
+	/// Returns a one line summary of the histogram, for logging purposes.
+	///----------------------------------------------------------------------------------
+	std::string toString() const;
+
+	static const int BUCKET_COUNT = 40;
+
+private:
+	std::atomic<uint64_t> m_Buckets[BUCKET_COUNT];	// Bucket i holds samples < 2^i us
+	std::atomic<uint64_t> m_Count;
+	std::atomic<uint64_t> m_Sum;
+	std::atomic<uint64_t> m_Max;
+};
@@ -0,0 +1,107 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		RealTime.cpp
+ *
+ * Purpose:
+ *		Puts a thread on the real-time scheduler.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "SystemServices/RealTime.h"
+#include "SystemServices/Logger.h"
+#include <errno.h>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+
+
+// Stack touched up front so a real-time thread doesn't page fault on it later
+#define PREFAULT_STACK_BYTES 	(64 * 1024)
+
+
+static void prefaultStack()
+{
+	volatile unsigned char stack[PREFAULT_STACK_BYTES];
+	for(size_t i = 0; i < sizeof(stack); i += 4096)
+	{
+		stack[i] = 0;
+	}
+}
+
+bool RealTime::applyToThisThread(const RealTimeProfile& profile, const std::string& name)
+{
+	bool applied = true;
+
+	if(profile.lockMemory)
+	{
+		applied = lockMemory() && applied;
+		prefaultStack();
+	}
+
+	if(profile.cpu >= 0)
+	{
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(profile.cpu, &cpus);
+
+		int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+		if(error != 0)
+		{
+			Logger::warning("%s: Could not pin the thread to CPU %d: %s", name.c_str(),
+				profile.cpu, strerror(error));
+			applied = false;
+		}
+	}
+
+	if(profile.priority > 0)
+	{
+		sched_param param;
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = profile.priority;
+
+		int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if(error != 0)
+		{
+			Logger::warning("%s: Could not set SCHED_FIFO priority %d: %s", name.c_str(),
+				profile.priority, strerror(error));
+			applied = false;
+		}
+	}
+
+	if(applied)
+	{
+		Logger::info("%s: Real-time profile applied, priority=%d cpu=%d locked memory=%d",
+			name.c_str(), profile.priority, profile.cpu, (int)profile.lockMemory);
+	}
+	return applied;
+}
+
+bool RealTime::lockMemory()
+{
+	static std::once_flag once;
+	static bool locked = false;
+
+	std::call_once(once, []() {
+#ifdef MCL_ONFAULT
+		int result = mlockall(MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT);
+		if(result != 0)
+		{
+			result = mlockall(MCL_CURRENT | MCL_FUTURE);
+		}
+#else
+		int result = mlockall(MCL_CURRENT | MCL_FUTURE);
+#endif
+		if(result != 0)
+		{
+			Logger::warning("Could not lock the process memory: %s", strerror(errno));
+		}
+		locked = (result == 0);
+	});
+	return locked;
+}
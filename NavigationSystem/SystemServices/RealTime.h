@@ -0,0 +1,58 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		RealTime.h
+ *
+ * Purpose:
+ *		Puts a thread on the real-time scheduler so a control loop keeps its rate while
+ *		the rest of the system is busy, see ActiveNode::setRealTimeProfile().
+ *
+ * Developer Notes:
+ *		Everything here needs CAP_SYS_NICE / CAP_IPC_LOCK (or root) and a kernel that
+ *		allows real-time threads. Whatever can't be applied is logged and the thread
+ *		carries on under the default scheduler, a missing permission never stops the
+ *		control system from running.
+ *
+ *		The memory is locked with MCL_ONFAULT where the kernel supports it, so the
+ *		stacks of the other threads are only locked once they are used instead of
+ *		being paged in whole.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <string>
+
+
+struct RealTimeProfile {
+	RealTimeProfile() : priority(0), cpu(-1), lockMemory(false)
+	{ }
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns true if the profile changes anything.
+ 	///----------------------------------------------------------------------------------
+	bool enabled() const { return priority > 0 || cpu >= 0 || lockMemory; }
+
+	int 	priority;		// SCHED_FIFO priority 1-99, 0 keeps the default scheduler
+	int 	cpu;			// CPU the thread is pinned to, -1 for any
+	bool 	lockMemory;		// Locks the memory of the whole process with mlockall
+};
+
+
+class RealTime {
+public:
+	///----------------------------------------------------------------------------------
+ 	/// Applies a profile to the calling thread. Returns false if a part of it couldn't
+ 	/// be applied, the rest still is.
+ 	///
+ 	/// @param profile 		The scheduling to use.
+ 	/// @param name 		Name of the thread, for logging purposes.
+ 	///----------------------------------------------------------------------------------
+	static bool applyToThisThread(const RealTimeProfile& profile, const std::string& name);
+
+	///----------------------------------------------------------------------------------
+ 	/// Locks the current and future memory of the process in RAM, only the first call
+ 	/// does anything. Returns false if the memory couldn't be locked.
+ 	///----------------------------------------------------------------------------------
+	static bool lockMemory();
+};
@@ -15,15 +15,15 @@
 #include "SysClock.h"
 #include <stdio.h>
 #include <ctime>
-#include <sys/time.h>
 
 
-#define GET_UNIX_TIME() static_cast<long int>(std::time(0))
+#define GET_UNIX_TIME() static_cast<long int>(timeSource().unixMicros() / 1000000)
 
 
 unsigned long	SysClock::m_LastUpdated = NEVER_UPDATED;
 unsigned long 	SysClock::m_LastTimeStamp = 0;
 unsigned long 	SysClock::m_LastClockTime = 0;
+std::atomic<TimeSource*> SysClock::m_TimeSource(NULL);
 
 
 void SysClock::setTime(unsigned long unixTime)
@@ -49,9 +49,41 @@ unsigned long SysClock::unixTime()
 unsigned int SysClock::millis()
 {
 	// Get Milliseconds
-	timeval curTime;
-	gettimeofday(&curTime, NULL);
-	return curTime.tv_usec / 1000;
+	return (timeSource().unixMicros() / 1000) % 1000;
+}
+
+uint64_t SysClock::monotonicMicros()
+{
+	return timeSource().monotonicMicros();
+}
+
+void SysClock::setTimeSource(TimeSource* source)
+{
+	m_TimeSource.store(source);
+}
+
+TimeSource& SysClock::timeSource()
+{
+	// Never destroyed, static objects and the threads of a TickScheduler still read the
+	// clock while the other static objects are torn down
+	static RealTimeSource* realTime = new RealTimeSource();
+
+	TimeSource* source = m_TimeSource.load(std::memory_order_acquire);
+	return (source != NULL) ? *source : *realTime;
+}
+
+void SysClock::sleepFor(std::chrono::microseconds duration)
+{
+	TimeSource& clock = timeSource();
+	if(duration.count() > 0)
+	{
+		clock.sleepUntil(clock.monotonicMicros() + duration.count());
+	}
+}
+
+void SysClock::sleepUntil(uint64_t monotonicDeadline)
+{
+	timeSource().sleepUntil(monotonicDeadline);
 }
 
 std::string SysClock::timeStampStr()
@@ -9,13 +9,19 @@
  *		Timestamps are in GMT(UTC) time.
  *
  * Developer Notes:
- *
+ *		All the time keeping goes through a TimeSource, which is the real time unless a
+ *		simulated one has been set with setTimeSource(). Node loops should sleep with
+ *		sleepFor() or a Timer so they follow a simulated time as well.
  *
  ***************************************************************************************/
 
 #pragma once
 
+#include "SystemServices/TimeSource.h"
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <stdint.h>
 //#include <sys/types.h>
 //#include <sys/stat.h>
 
@@ -54,6 +60,30 @@ public:
 	///----------------------------------------------------------------------------------
 	static unsigned int millis();
 
+	///----------------------------------------------------------------------------------
+	/// Returns a monotonic time in microseconds. Only useful for measuring durations, it
+	/// is not related to the unix time and is not affected by setTime().
+	///----------------------------------------------------------------------------------
+	static uint64_t monotonicMicros();
+
+	///----------------------------------------------------------------------------------
+	/// Sets the clock all the time keeping functions use, NULL goes back to the real
+	/// time. The source has to outlive every thread that uses the SysClock or a Timer,
+	/// and should be set before the active nodes are started.
+	///----------------------------------------------------------------------------------
+	static void setTimeSource(TimeSource* source);
+
+	///----------------------------------------------------------------------------------
+	/// Returns the clock currently in use.
+	///----------------------------------------------------------------------------------
+	static TimeSource& timeSource();
+
+	///----------------------------------------------------------------------------------
+	/// Blocks the calling thread for a duration, or until a monotonic time.
+	///----------------------------------------------------------------------------------
+	static void sleepFor(std::chrono::microseconds duration);
+	static void sleepUntil(uint64_t monotonicDeadline);
+
 	///----------------------------------------------------------------------------------
 	/// Returns a string representation of the current time in the format:
 	///			yyyy-mm-dd hh:mm:ss
@@ -103,6 +133,7 @@ private:
 	static unsigned long	m_LastUpdated;
 	static unsigned long 	m_LastTimeStamp;
 	static unsigned long	m_LastClockTime;
+	static std::atomic<TimeSource*> m_TimeSource;
 
 };
 
@@ -0,0 +1,169 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		TimeSource.cpp
+ *
+ * Purpose:
+ *		The clock behind SysClock and Timer.
+ *
+ * Developer Notes:
+ *
+ *
+ ***************************************************************************************/
+
+#include "SystemServices/TimeSource.h"
+#include <chrono>
+#include <errno.h>
+#include <sys/time.h>
+#include <time.h>
+
+
+// How often a sleeping thread looks whether it can move the simulated time forward,
+// the idle checks can't wake it up
+#define POLL_INTERVAL_US 	200
+
+// The simulated clock the calling thread has entered, if any
+static thread_local SimulatedTimeSource* t_EnteredClock = NULL;
+
+
+uint64_t RealTimeSource::monotonicMicros()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+uint64_t RealTimeSource::unixMicros()
+{
+	timeval curTime;
+	gettimeofday(&curTime, NULL);
+	return (uint64_t)curTime.tv_sec * 1000000 + curTime.tv_usec;
+}
+
+void RealTimeSource::sleepUntil(uint64_t monotonicDeadline)
+{
+	// An absolute sleep, being preempted before it starts doesn't make it any longer
+	timespec deadline;
+	deadline.tv_sec = monotonicDeadline / 1000000;
+	deadline.tv_nsec = (monotonicDeadline % 1000000) * 1000;
+
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+	{ }
+}
+
+
+SimulatedTimeSource::SimulatedTimeSource()
+	:m_Threads(0)
+{
+	RealTimeSource realTime;
+	m_Now.store(realTime.monotonicMicros());
+	m_UnixOffset = realTime.unixMicros() - m_Now.load();
+}
+
+uint64_t SimulatedTimeSource::monotonicMicros()
+{
+	return m_Now.load(std::memory_order_acquire);
+}
+
+uint64_t SimulatedTimeSource::unixMicros()
+{
+	return monotonicMicros() + m_UnixOffset;
+}
+
+void SimulatedTimeSource::sleepUntil(uint64_t monotonicDeadline)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	if(monotonicDeadline <= m_Now.load())
+	{
+		return;
+	}
+
+	// Other threads only take part while they sleep
+	bool attached = (t_EnteredClock == this);
+	if(not attached)
+	{
+		m_Threads++;
+	}
+	auto deadline = m_Deadlines.insert(monotonicDeadline);
+
+	while(m_Now.load() < monotonicDeadline)
+	{
+		if(canAdvance())
+		{
+			m_Now.store(*m_Deadlines.upper_bound(m_Now.load()), std::memory_order_release);
+			m_Condition.notify_all();
+		}
+		else
+		{
+			m_Condition.wait_for(lock, std::chrono::microseconds(POLL_INTERVAL_US));
+		}
+	}
+
+	m_Deadlines.erase(deadline);
+	if(not attached)
+	{
+		m_Threads--;
+	}
+}
+
+void SimulatedTimeSource::attachThread()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Threads++;
+}
+
+void SimulatedTimeSource::enterThread()
+{
+	t_EnteredClock = this;
+}
+
+void SimulatedTimeSource::leaveThread()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Threads--;
+	t_EnteredClock = NULL;
+	m_Condition.notify_all();
+}
+
+void SimulatedTimeSource::addIdleCheck(std::function<bool()> isIdle)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_IdleChecks.push_back(isIdle);
+}
+
+void SimulatedTimeSource::advance(uint64_t micros)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Now.fetch_add(micros, std::memory_order_release);
+	m_Condition.notify_all();
+}
+
+unsigned int SimulatedTimeSource::attachedThreads()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Threads;
+}
+
+bool SimulatedTimeSource::canAdvance()
+{
+	// A thread whose deadline has passed is running, even if it hasn't woken up yet
+	unsigned int sleeping = 0;
+	for(auto it = m_Deadlines.upper_bound(m_Now.load()); it != m_Deadlines.end(); ++it)
+	{
+		sleeping++;
+	}
+
+	if(sleeping < m_Threads)
+	{
+		return false;
+	}
+
+	for(auto& isIdle : m_IdleChecks)
+	{
+		if(not isIdle())
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,120 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		TimeSource.h
+ *
+ * Purpose:
+ *		The clock behind SysClock and Timer. The real time source follows the system
+ *		clocks, the simulated one only moves forward once every thread that loops on it
+ *		is waiting for a later time, so the whole system can run as fast as the CPU
+ *		allows while the nodes still see their usual loop times.
+ *
+ * Developer Notes:
+ *		A thread takes part in the simulated time when it is attached to it, active
+ *		nodes do this for their thread, see ActiveNode::runThread(). Any other thread
+ *		that sleeps on the clock only takes part while it sleeps.
+ *
+ *		An attached thread that blocks on anything else than the clock (a socket, a
+ *		condition variable) stops the simulated time until it wakes up.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <stdint.h>
+#include <vector>
+
+
+class TimeSource {
+public:
+	virtual ~TimeSource() {}
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns a monotonic time in microseconds.
+ 	///----------------------------------------------------------------------------------
+	virtual uint64_t monotonicMicros() = 0;
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the number of microseconds since the unix epoch.
+ 	///----------------------------------------------------------------------------------
+	virtual uint64_t unixMicros() = 0;
+
+	///----------------------------------------------------------------------------------
+ 	/// Blocks the calling thread until monotonicMicros() reaches the deadline.
+ 	///----------------------------------------------------------------------------------
+	virtual void sleepUntil(uint64_t monotonicDeadline) = 0;
+
+	///----------------------------------------------------------------------------------
+ 	/// Counts a thread that is about to be started as one that loops on this clock.
+ 	/// The new thread calls enterThread() first and leaveThread() when it is done.
+ 	///----------------------------------------------------------------------------------
+	virtual void attachThread() {}
+	virtual void enterThread() {}
+	virtual void leaveThread() {}
+};
+
+
+class RealTimeSource : public TimeSource {
+public:
+	uint64_t monotonicMicros() override;
+	uint64_t unixMicros() override;
+	void sleepUntil(uint64_t monotonicDeadline) override;
+};
+
+
+class SimulatedTimeSource : public TimeSource {
+public:
+	///----------------------------------------------------------------------------------
+ 	/// The simulated time starts at the current real time.
+ 	///----------------------------------------------------------------------------------
+	SimulatedTimeSource();
+
+	uint64_t monotonicMicros() override;
+	uint64_t unixMicros() override;
+	void sleepUntil(uint64_t monotonicDeadline) override;
+
+	void attachThread() override;
+	void enterThread() override;
+	void leaveThread() override;
+
+	///----------------------------------------------------------------------------------
+ 	/// Adds a check that has to pass before the time moves forward, for work that is
+ 	/// done outside of the attached threads. For example:
+ 	///
+ 	///		clock.addIdleCheck([&msgBus]() { return msgBus.pendingMessages() == 0; });
+ 	///
+ 	/// Only add checks before the clock is used.
+ 	///----------------------------------------------------------------------------------
+	void addIdleCheck(std::function<bool()> isIdle);
+
+	///----------------------------------------------------------------------------------
+ 	/// Moves the time forward by hand and wakes up the threads that are due.
+ 	///----------------------------------------------------------------------------------
+	void advance(uint64_t micros);
+
+	///----------------------------------------------------------------------------------
+ 	/// Returns the number of threads attached to the clock.
+ 	///----------------------------------------------------------------------------------
+	unsigned int attachedThreads();
+
+private:
+	///----------------------------------------------------------------------------------
+ 	/// Returns true if every attached thread is waiting for a later time and the idle
+ 	/// checks pass. Called with m_Mutex held.
+ 	///----------------------------------------------------------------------------------
+	bool canAdvance();
+
+	std::atomic<uint64_t> 				m_Now;
+	uint64_t 							m_UnixOffset;
+
+	std::mutex 							m_Mutex;
+	std::condition_variable 			m_Condition;
+	std::multiset<uint64_t> 			m_Deadlines;
+	unsigned int 						m_Threads;
+	std::vector<std::function<bool()>> 	m_IdleChecks;
+};
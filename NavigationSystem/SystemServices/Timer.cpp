@@ -1,12 +1,8 @@
 #include "Timer.h"
-#include <thread>
-
-#define STEADY_CLOCK std::chrono::steady_clock
-#define DURATION_CAST std::chrono::duration_cast
-#define DURATION std::chrono::duration
+#include "SysClock.h"
 
 Timer::Timer() :
-	m_start(STEADY_CLOCK::now()),
+	m_start(SysClock::monotonicMicros()),
 	m_running(false),
 	m_timePassed( 0 )
 {}
@@ -15,14 +11,14 @@ void Timer::start()
 {
 	if (!m_running)
 	{
-		m_start = STEADY_CLOCK::now();
+		m_start = SysClock::monotonicMicros();
 		m_running = true;
 	}
 }
 
 void Timer::reset()
 {
-	m_start = STEADY_CLOCK::now();	
+	m_start = SysClock::monotonicMicros();	
 	m_running = true;
 }
 
@@ -36,13 +32,9 @@ double Timer::timePassed()
 {
 	if(m_running)
 	{
-		STEADY_CLOCK::time_point end;
-		DURATION<double> time_span;
-
 		// the time to count the difference is not included
-		end = STEADY_CLOCK::now();
-		time_span = DURATION_CAST<DURATION<double>>(end - m_start);
-		return time_span.count();
+		uint64_t end = SysClock::monotonicMicros();
+		return (end - m_start) / 1000000.0;
 	}
 	else
 	{
@@ -61,7 +53,7 @@ void Timer::sleepUntil(double seconds)
 	int toMicro = 1000*1000;
 
 	microseconds = timeUntil(seconds) * toMicro;
-	std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
+	SysClock::sleepFor(std::chrono::microseconds(microseconds));
 }
 
 bool Timer::timeReached(double seconds)
@@ -1,7 +1,7 @@
 #ifndef __TIMER_H__
 #define __TIMER_H__
 
-#include <chrono>
+#include <stdint.h>
 
 class Timer {
 
@@ -35,7 +35,7 @@ public:
 	 */
 	double timeUntil(double seconds);
 	/*
-	 * sleeps until timer reaches provided time 
+	 * sleeps until timer reaches provided time, on the SysClock time source
 	 */
 	void sleepUntil(double seconds);
 
@@ -47,7 +47,7 @@ public:
 	bool started() { return m_running; }
 
 private:
-	std::chrono::steady_clock::time_point m_start;
+	uint64_t m_start;	// SysClock::monotonicMicros()
 	bool m_running;
 	double m_timePassed;
 };
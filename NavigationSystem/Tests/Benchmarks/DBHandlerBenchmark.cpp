@@ -0,0 +1,101 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		DBHandlerBenchmark.cpp
+ *
+ * Purpose:
+ *		Measures how many queries a second the DBHandler answers for the calls the
+ *		nodes make most, reading a config value and looking up the last id of a log
+ *		table.
+ *
+ * Developer Notes:
+ *		Runs on a database of its own in the working directory, with the tables from
+ *		createtablesASPire.sql the queries use. On the boat the database is on the SD
+ *		card, expect lower numbers there.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/DBHandler.h"
+
+#include <chrono>
+#include <sqlite3.h>
+#include <stdio.h>
+
+
+#define BENCHMARK_DB 		"./dbhandler_benchmark.db"
+#define QUERY_COUNT 		20000
+#define LOG_ROWS 			1000
+
+
+static bool createDatabase()
+{
+	remove(BENCHMARK_DB);
+
+	sqlite3* db = NULL;
+	bool success = (sqlite3_open(BENCHMARK_DB, &db) == SQLITE_OK) &&
+		(sqlite3_exec(db,
+			"CREATE TABLE config_course_regulator (id INTEGER PRIMARY KEY AUTOINCREMENT, loop_time DOUBLE, "
+				"max_rudder_angle INTEGER, p_gain DOUBLE, i_gain DOUBLE, d_gain DOUBLE);"
+			"INSERT INTO config_course_regulator VALUES(1, 0.5, 30, 1, 1, 1);"
+			"CREATE TABLE dataLogs_compass (id INTEGER PRIMARY KEY AUTOINCREMENT, heading DOUBLE, "
+				"pitch DOUBLE, roll DOUBLE, t_timestamp TIMESTAMP);",
+			NULL, NULL, NULL) == SQLITE_OK);
+
+	success = success && (sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, NULL) == SQLITE_OK);
+	for(int i = 0; success && i < LOG_ROWS; i++)
+	{
+		success = (sqlite3_exec(db, "INSERT INTO dataLogs_compass VALUES(NULL, 10, 1, 2, '2017-01-01 12:00:00');",
+			NULL, NULL, NULL) == SQLITE_OK);
+	}
+	success = success && (sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK);
+
+	sqlite3_close(db);
+	return success;
+}
+
+///----------------------------------------------------------------------------------
+/// Runs a query QUERY_COUNT times and returns the queries per second.
+///----------------------------------------------------------------------------------
+template<class Query>
+static double queriesPerSecond(Query query)
+{
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < QUERY_COUNT; i++)
+	{
+		query();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return QUERY_COUNT / seconds;
+}
+
+int main()
+{
+	if(not createDatabase())
+	{
+		printf("Failed to create %s\n", BENCHMARK_DB);
+		return 1;
+	}
+
+	DBHandler dbHandler(BENCHMARK_DB);
+	if(not dbHandler.initialise())
+	{
+		printf("Failed to open %s\n", BENCHMARK_DB);
+		return 1;
+	}
+
+	volatile double sink = 0;
+
+	double cellRate = queriesPerSecond([&]() {
+		sink = sink + dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain");
+	});
+	double idRate = queriesPerSecond([&]() {
+		sink = sink + dbHandler.getIdFromTable("dataLogs_compass", true).size();
+	});
+
+	printf("%d queries each\n", QUERY_COUNT);
+	printf("retrieveCellAsDouble: %10.0f queries/s\n", cellRate);
+	printf("getIdFromTable:       %10.0f queries/s\n", idRate);
+
+	remove(BENCHMARK_DB);
+	return 0;
+}
@@ -0,0 +1,145 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		DBInsertLogsBenchmark.cpp
+ *
+ * Purpose:
+ *		Measures how fast DBHandler::insertDataLogs writes the batches of the DBLogger,
+ *		and what it costs in CPU time and writes to the disk.
+ *
+ * Developer Notes:
+ *		Creates a database of its own in the working directory from the schema of the
+ *		boat, by default ../createtablesASPire.sql, give another one as the first
+ *		argument. Give "wal" as the second argument to run in the WAL access mode, see
+ *		DBAccessMode. The bytes written are what the process passed to write() according to
+ *		/proc/self/io, the journal included.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/DBHandler.h"
+
+#include <chrono>
+#include <fstream>
+#include <sqlite3.h>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+#define BENCHMARK_DB 		"./dbinsert_benchmark.db"
+#define BATCH_COUNT 		100
+#define BATCH_SIZE 			20
+
+
+static bool createDatabase(const char* schemaFile)
+{
+	std::ifstream file(schemaFile);
+	if(not file)
+	{
+		return false;
+	}
+	std::stringstream schema;
+	schema << file.rdbuf();
+
+	remove(BENCHMARK_DB);
+
+	sqlite3* db = NULL;
+	bool success = (sqlite3_open(BENCHMARK_DB, &db) == SQLITE_OK) &&
+		(sqlite3_exec(db, schema.str().c_str(), NULL, NULL, NULL) == SQLITE_OK);
+	sqlite3_close(db);
+	return success;
+}
+
+static double cpuSeconds()
+{
+	timespec time;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+///----------------------------------------------------------------------------------
+/// Returns the bytes the process has passed to write() so far, zero if unknown.
+///----------------------------------------------------------------------------------
+static unsigned long long bytesWritten()
+{
+	std::ifstream io("/proc/self/io");
+	std::string key;
+	unsigned long long value = 0;
+	while(io >> key >> value)
+	{
+		if(key == "wchar:")
+		{
+			return value;
+		}
+	}
+	return 0;
+}
+
+static LogItem logItem(int i)
+{
+	LogItem item = LogItem();
+	item.m_rudderPosition = 12.345678 + i;
+	item.m_wingsailPosition = -3.14159;
+	item.m_compassHeading = 271.123456 + i * 0.01;
+	item.m_gpsHasFix = true;
+	item.m_gpsOnline = true;
+	item.m_gpsLat = 60.1071234 + i * 1e-6;
+	item.m_gpsLon = 19.9212345 + i * 1e-6;
+	item.m_gpsSatellite = 9;
+	item.m_temperature = 12.5f;
+	item.m_vesselHeading = 270.98765;
+	item.m_trueWindSpeed = 6.54321;
+	item.m_windDir = 123.4f;
+	item.m_timestamp_str = "2017-06-01 12:00:00";
+	return item;
+}
+
+int main(int argc, char** argv)
+{
+	const char* schemaFile = (argc > 1) ? argv[1] : "../createtablesASPire.sql";
+	if(not createDatabase(schemaFile))
+	{
+		printf("Failed to create %s from %s\n", BENCHMARK_DB, schemaFile);
+		return 1;
+	}
+
+	bool wal = (argc > 2) && (strcmp(argv[2], "wal") == 0);
+	DBHandler dbHandler(BENCHMARK_DB, wal ? DBAccessMode::WAL : DBAccessMode::Exclusive);
+	if(not dbHandler.initialise())
+	{
+		printf("Failed to open %s\n", BENCHMARK_DB);
+		return 1;
+	}
+
+	std::vector<LogItem> batch;
+	for(int i = 0; i < BATCH_SIZE; i++)
+	{
+		batch.push_back(logItem(i));
+	}
+
+	unsigned long long bytesBefore = bytesWritten();
+	double cpuBefore = cpuSeconds();
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < BATCH_COUNT; i++)
+	{
+		dbHandler.insertDataLogs(batch);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double cpu = cpuSeconds() - cpuBefore;
+	unsigned long long bytes = bytesWritten() - bytesBefore;
+	const int logs = BATCH_COUNT * BATCH_SIZE;
+
+	printf("%d batches of %d logs, %s mode\n", BATCH_COUNT, BATCH_SIZE, wal ? "WAL" : "exclusive");
+	printf("Throughput:      %10.0f logs/s\n", logs / seconds);
+	printf("CPU time:        %10.1f us/log\n", cpu * 1e6 / logs);
+	printf("Bytes written:   %10.0f bytes/log\n", (double)bytes / logs);
+	printf("Rows written:    %10d\n", dbHandler.getRows("dataLogs_system"));
+
+	remove(BENCHMARK_DB);
+	remove(BENCHMARK_DB "-wal");
+	remove(BENCHMARK_DB "-shm");
+	return 0;
+}
@@ -0,0 +1,191 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogStoreBenchmark.cpp
+ *
+ * Purpose:
+ *		Compares what a logged sample costs in the database and in the LogStore, in CPU
+ *		time and in bytes written to the disk.
+ *
+ * Developer Notes:
+ *		Creates a database and a store of its own in the working directory, the database
+ *		from the schema of the boat, by default ../createtablesASPire.sql, give another
+ *		one as the first argument.
+ *
+ *		The bytes are the ones the process sent to the disk according to write_bytes of
+ *		/proc/self/io, that counts the pages dirtied through a memory mapping as well as
+ *		write(). The write amplification is those bytes over the bytes of a record of the
+ *		store, what a sample holds.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/DBHandler.h"
+#include "DataBase/LogStore.h"
+
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <sqlite3.h>
+#include <sstream>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define BENCHMARK_DB 		"./logstore_benchmark.db"
+#define BENCHMARK_STORE 	"./logstore_benchmark.datalogs"
+#define SAMPLE_COUNT 		2560
+
+
+static bool createDatabase(const char* schemaFile)
+{
+	std::ifstream file(schemaFile);
+	if(not file)
+	{
+		return false;
+	}
+	std::stringstream schema;
+	schema << file.rdbuf();
+
+	remove(BENCHMARK_DB);
+	remove(BENCHMARK_DB "-wal");
+	remove(BENCHMARK_DB "-shm");
+
+	sqlite3* db = NULL;
+	bool success = (sqlite3_open(BENCHMARK_DB, &db) == SQLITE_OK) &&
+		(sqlite3_exec(db, schema.str().c_str(), NULL, NULL, NULL) == SQLITE_OK);
+	sqlite3_close(db);
+	return success;
+}
+
+static void removeStore()
+{
+	DIR* directory = opendir(BENCHMARK_STORE);
+	if(directory != NULL)
+	{
+		while(dirent* entry = readdir(directory))
+		{
+			remove((std::string(BENCHMARK_STORE "/") + entry->d_name).c_str());
+		}
+		closedir(directory);
+	}
+	rmdir(BENCHMARK_STORE);
+}
+
+static double cpuSeconds()
+{
+	timespec time;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+///----------------------------------------------------------------------------------
+/// Returns the bytes the process has sent to the disk so far, zero if unknown.
+///----------------------------------------------------------------------------------
+static unsigned long long bytesWritten()
+{
+	std::ifstream io("/proc/self/io");
+	std::string key;
+	unsigned long long value = 0;
+	while(io >> key >> value)
+	{
+		if(key == "write_bytes:")
+		{
+			return value;
+		}
+	}
+	return 0;
+}
+
+static LogItem logItem(int i)
+{
+	LogItem item = LogItem();
+	item.m_rudderPosition = 12.345678 + i;
+	item.m_wingsailPosition = -3.14159;
+	item.m_compassHeading = 271.123456 + i * 0.01;
+	item.m_gpsHasFix = true;
+	item.m_gpsOnline = true;
+	item.m_gpsLat = 60.1071234 + i * 1e-6;
+	item.m_gpsLon = 19.9212345 + i * 1e-6;
+	item.m_gpsSatellite = 9;
+	item.m_temperature = 12.5f;
+	item.m_conductivity = 38.2f;
+	item.m_vesselHeading = 270.98765;
+	item.m_trueWindSpeed = 6.54321;
+	item.m_windDir = 123.4f;
+	item.m_timestamp_str = "2017-06-01 12:00:00.123";
+	return item;
+}
+
+///----------------------------------------------------------------------------------
+/// Logs SAMPLE_COUNT samples in batches and prints what a sample cost.
+///----------------------------------------------------------------------------------
+static void measure(const char* name, unsigned int batchSize, unsigned int recordWidth,
+	std::function<void(std::vector<LogItem>&)> writeBatch)
+{
+	std::vector<LogItem> batch;
+	for(unsigned int i = 0; i < batchSize; i++)
+	{
+		batch.push_back(logItem(i));
+	}
+
+	unsigned long long bytesBefore = bytesWritten();
+	double cpuBefore = cpuSeconds();
+	auto start = std::chrono::steady_clock::now();
+
+	for(unsigned int i = 0; i < SAMPLE_COUNT / batchSize; i++)
+	{
+		writeBatch(batch);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double cpu = cpuSeconds() - cpuBefore;
+	double bytes = (double)(bytesWritten() - bytesBefore) / SAMPLE_COUNT;
+
+	printf("%-24s batch %3u %10.0f samples/s %8.1f us/sample %8.0f bytes/sample %6.1fx\n",
+		name, batchSize, SAMPLE_COUNT / seconds, cpu * 1e6 / SAMPLE_COUNT, bytes, bytes / recordWidth);
+}
+
+int main(int argc, char** argv)
+{
+	const char* schemaFile = (argc > 1) ? argv[1] : "../createtablesASPire.sql";
+
+	removeStore();
+	LogStore logStore(BENCHMARK_STORE);
+	if(not logStore.open())
+	{
+		printf("Failed to open %s\n", BENCHMARK_STORE);
+		return 1;
+	}
+	const unsigned int recordWidth = logStore.recordWidth();
+
+	printf("%d samples, a record of the store is %u bytes, amplification is bytes/sample over it\n",
+		SAMPLE_COUNT, recordWidth);
+
+	for(DBAccessMode mode : { DBAccessMode::Exclusive, DBAccessMode::WAL })
+	{
+		if(not createDatabase(schemaFile))
+		{
+			printf("Failed to create %s from %s\n", BENCHMARK_DB, schemaFile);
+			return 1;
+		}
+		DBHandler dbHandler(BENCHMARK_DB, mode);
+		dbHandler.initialise();
+
+		measure((mode == DBAccessMode::WAL) ? "SQLite, WAL" : "SQLite, exclusive", 20, recordWidth,
+			[&dbHandler](std::vector<LogItem>& batch) { dbHandler.insertDataLogs(batch); });
+	}
+
+	for(unsigned int batchSize : { 1u, 20u, (unsigned int)LOG_STORE_BLOCK_RECORDS })
+	{
+		measure("LogStore", batchSize, recordWidth,
+			[&logStore](std::vector<LogItem>& batch) { logStore.append(batch); });
+	}
+
+	remove(BENCHMARK_DB);
+	remove(BENCHMARK_DB "-wal");
+	remove(BENCHMARK_DB "-shm");
+	removeStore();
+	return 0;
+}
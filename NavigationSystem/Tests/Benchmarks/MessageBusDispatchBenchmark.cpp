@@ -0,0 +1,129 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageBusDispatchBenchmark.cpp
+ *
+ * Purpose:
+ *		Measures how much it costs the message bus to distribute a message as the number
+ *		of registered nodes grows.
+ *
+ * Developer Notes:
+ *		All the messages are queued before the bus is started, so the measured time is
+ *		only the time spent distributing them. Each node subscribes to two message types
+ *		which is close to what the nodes of the control system do.
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageBus.h"
+#include "SystemServices/Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+
+#define MESSAGE_COUNT 		200000
+
+
+class BenchmarkNode : public Node {
+public:
+	BenchmarkNode(NodeID id, MessageBus& msgBus)
+		:Node(id, msgBus), m_Received(0)
+	{ }
+
+	bool init() { return true; }
+
+	void processMessage(const Message* message) { m_Received++; }
+
+	unsigned long m_Received;
+};
+
+
+class SentinelNode : public Node {
+public:
+	SentinelNode(MessageBus& msgBus)
+		:Node(NodeID::None, msgBus), m_Done(false)
+	{
+		msgBus.registerNode(*this, MessageType::DataCollectionStop);
+	}
+
+	bool init() { return true; }
+
+	void processMessage(const Message* message) { m_Done.store(true); }
+
+	std::atomic<bool> m_Done;
+};
+
+
+static void runBus(MessageBus* msgBus)
+{
+	msgBus->run();
+}
+
+///----------------------------------------------------------------------------------
+/// Distributes MESSAGE_COUNT messages to nodeCount nodes and prints the time per
+/// message.
+///----------------------------------------------------------------------------------
+static void benchmark(int nodeCount)
+{
+	MessageBus msgBus;
+	std::vector<std::unique_ptr<BenchmarkNode>> nodes;
+
+	// Message types used by the sentinel are left out
+	const int usableTypes = MESSAGE_TYPE_COUNT - 1;
+
+	for(int i = 0; i < nodeCount; i++)
+	{
+		nodes.push_back(std::unique_ptr<BenchmarkNode>(new BenchmarkNode(static_cast<NodeID>(i + 1), msgBus)));
+		msgBus.registerNode(*nodes.back(), static_cast<MessageType>(i % usableTypes));
+		msgBus.registerNode(*nodes.back(), static_cast<MessageType>((i + 7) % usableTypes));
+	}
+	SentinelNode sentinel(msgBus);
+
+	for(int i = 0; i < MESSAGE_COUNT; i++)
+	{
+		msgBus.sendMessage(std::make_unique<Message>(static_cast<MessageType>(i % usableTypes)));
+	}
+	msgBus.sendMessage(std::make_unique<Message>(MessageType::DataCollectionStop));
+
+	auto start = std::chrono::steady_clock::now();
+	std::thread busThread(runBus, &msgBus);
+
+	while(not sentinel.m_Done.load())
+	{
+		std::this_thread::yield();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	msgBus.stop();
+	busThread.join();
+
+	unsigned long deliveries = 0;
+	for(auto& node : nodes)
+	{
+		deliveries += node->m_Received;
+	}
+
+	double nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	printf("%6d nodes  %10lu deliveries  %8.1f ns/message  %8.1f ns/delivery\n", nodeCount,
+		deliveries, nanoseconds / MESSAGE_COUNT, deliveries ? nanoseconds / deliveries : 0);
+}
+
+
+int main(int argc, char* argv[])
+{
+	Logger::DisableLogging();
+
+	printf("MessageBus dispatch benchmark, %d messages per run\n", MESSAGE_COUNT);
+
+	int nodeCounts[] = { 5, 10, 20, 40, 80, 160 };
+	for(int nodeCount : nodeCounts)
+	{
+		benchmark(nodeCount);
+	}
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessagePoolBenchmark.cpp
+ *
+ * Purpose:
+ *		Compares allocating messages with MessageBus::make against std::make_unique,
+ *		see MessagePool.h.
+ *
+ * Developer Notes:
+ *		The first run creates and deletes messages on the same thread. The second one is
+ *		closer to the real thing, messages are created on one thread and deleted on
+ *		another like a node thread sending to the message bus thread. The sender waits
+ *		when MAX_QUEUED messages are waiting, the nodes send a lot slower than the bus
+ *		distributes so the queue never grows far.
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageBus.h"
+#include "MessageBus/MessagePool.h"
+#include "MessageBus/MessageQueue.h"
+#include "Messages/WindStateMsg.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+
+
+#define MESSAGE_COUNT 		1000000
+#define IN_FLIGHT 			16
+#define MAX_QUEUED 			128
+
+
+struct HeapAllocator {
+	static MessagePtr make(int i) { return std::make_unique<WindStateMsg>(i, i, i, i); }
+};
+
+struct PoolAllocator {
+	static MessagePtr make(int i) { return MessageBus::make<WindStateMsg>(i, i, i, i); }
+};
+
+
+static double nanosecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+///----------------------------------------------------------------------------------
+/// Keeps a few messages alive at a time, like a node that sends faster than the bus
+/// distributes. Returns the time per message in nanoseconds.
+///----------------------------------------------------------------------------------
+template<class Allocator>
+static double sameThread()
+{
+	MessagePtr inFlight[IN_FLIGHT];
+
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < MESSAGE_COUNT; i++)
+	{
+		inFlight[i % IN_FLIGHT] = Allocator::make(i);
+	}
+	return nanosecondsSince(start) / MESSAGE_COUNT;
+}
+
+template<class Allocator>
+static void sender(LockedMessageQueue* queue, std::atomic<int>* queued)
+{
+	for(int i = 0; i < MESSAGE_COUNT; i++)
+	{
+		while(queued->load() >= MAX_QUEUED)
+		{
+			std::this_thread::yield();
+		}
+		queued->fetch_add(1);
+		queue->push(Allocator::make(i));
+	}
+}
+
+///----------------------------------------------------------------------------------
+/// Creates the messages on one thread and deletes them on this one. Returns the time
+/// per message in nanoseconds.
+///----------------------------------------------------------------------------------
+template<class Allocator>
+static double crossThread()
+{
+	LockedMessageQueue queue;
+	std::atomic<int> queued(0);
+	std::queue<MessagePtr> batch;
+	int received = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	std::thread senderThread(sender<Allocator>, &queue, &queued);
+
+	while(received < MESSAGE_COUNT)
+	{
+		queue.popAll(batch);
+		if(batch.empty())
+		{
+			std::this_thread::yield();
+		}
+		while(not batch.empty())
+		{
+			batch.pop();
+			queued.fetch_sub(1);
+			received++;
+		}
+	}
+
+	senderThread.join();
+	return nanosecondsSince(start) / MESSAGE_COUNT;
+}
+
+
+int main(int argc, char* argv[])
+{
+	printf("Message allocation benchmark, %d messages per run\n", MESSAGE_COUNT);
+
+	printf("Same thread   make_unique %6.1f ns/message\n", sameThread<HeapAllocator>());
+	printf("Same thread   pool        %6.1f ns/message\n", sameThread<PoolAllocator>());
+	printf("Cross thread  make_unique %6.1f ns/message\n", crossThread<HeapAllocator>());
+	printf("Cross thread  pool        %6.1f ns/message\n", crossThread<PoolAllocator>());
+
+	MessagePool<WindStateMsg>& pool = MessagePool<WindStateMsg>::instance();
+	printf("Pool hits %llu misses %llu\n", (unsigned long long)pool.hits(),
+		(unsigned long long)pool.misses());
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageQueueContentionBenchmark.cpp
+ *
+ * Purpose:
+ *		Compares the mutex guarded double buffered queue with the lock free queue when
+ *		several threads send messages at the same time, see MessageQueue.h.
+ *
+ * Developer Notes:
+ *		The messages are allocated before the clock starts so only the queue is measured.
+ *		The consumer checks that the messages of every sender come out in order, the
+ *		sequence number is carried in Message::timeEnqueued.
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+
+#define MESSAGES_PER_SENDER 	200000
+
+
+template<class Queue>
+static void producer(Queue* queue, std::vector<MessagePtr>* messages, std::atomic<bool>* go)
+{
+	while(not go->load())
+	{
+		std::this_thread::yield();
+	}
+
+	for(auto& msg : *messages)
+	{
+		queue->push(std::move(msg));
+	}
+}
+
+///----------------------------------------------------------------------------------
+/// Pushes MESSAGES_PER_SENDER messages from each sender thread while one thread
+/// takes them out. Returns the time it took in nanoseconds, or a negative value if
+/// the messages of a sender came out of order.
+///----------------------------------------------------------------------------------
+template<class Queue>
+static double benchmark(int senders)
+{
+	Queue queue;
+	std::atomic<bool> go(false);
+	std::vector<std::vector<MessagePtr>> messages(senders);
+	std::vector<std::thread> threads;
+
+	for(int s = 0; s < senders; s++)
+	{
+		for(int i = 0; i < MESSAGES_PER_SENDER; i++)
+		{
+			MessagePtr msg = std::make_unique<Message>(MessageType::WindData, static_cast<NodeID>(s));
+			msg->timeEnqueued = i;
+			messages[s].push_back(std::move(msg));
+		}
+		threads.push_back(std::thread(producer<Queue>, &queue, &messages[s], &go));
+	}
+
+	std::vector<uint64_t> nextSequence(senders, 0);
+	bool inOrder = true;
+	long received = 0;
+	const long total = (long)senders * MESSAGES_PER_SENDER;
+	std::queue<MessagePtr> batch;
+
+	auto start = std::chrono::steady_clock::now();
+	go.store(true);
+
+	while(received < total)
+	{
+		queue.popAll(batch);
+		while(not batch.empty())
+		{
+			Message* msg = batch.front().get();
+			int sender = static_cast<int>(msg->sourceID());
+			if(msg->timeEnqueued != nextSequence[sender])
+			{
+				inOrder = false;
+			}
+			nextSequence[sender] = msg->timeEnqueued + 1;
+			batch.pop();
+			received++;
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	if(not inOrder)
+	{
+		return -1;
+	}
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+template<class Queue>
+static void report(const char* name, int senders)
+{
+	double nanoseconds = benchmark<Queue>(senders);
+	if(nanoseconds < 0)
+	{
+		printf("%-12s %2d senders  FAILED, messages out of order\n", name, senders);
+		return;
+	}
+
+	double messages = (double)senders * MESSAGES_PER_SENDER;
+	printf("%-12s %2d senders  %8.1f ns/message  %6.2f million messages/s\n", name, senders,
+		nanoseconds / messages, messages / nanoseconds * 1000);
+}
+
+
+int main(int argc, char* argv[])
+{
+	printf("Message queue contention benchmark, %d messages per sender\n", MESSAGES_PER_SENDER);
+
+	int senderCounts[] = { 1, 2, 4, 8, 16 };
+	for(int senders : senderCounts)
+	{
+		report<LockedMessageQueue>("Locked", senders);
+		report<LockFreeMessageQueue>("Lock free", senders);
+	}
+
+	return 0;
+}
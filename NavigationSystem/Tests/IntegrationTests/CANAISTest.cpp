@@ -19,6 +19,7 @@
 #include "MessageBus/MessageBus.h"
 #include "MessageBus/ActiveNode.h"
 #include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
 #include "WorldState/AISProcessing.h"
 #include "WorldState/CollidableMgr/CollidableMgr.h"
 
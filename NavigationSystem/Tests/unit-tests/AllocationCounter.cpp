@@ -0,0 +1,44 @@
+/****************************************************************************************
+*
+* File:
+* 		AllocationCounter.cpp
+*
+* Purpose:
+*		Replaces the global operator new and delete of the unit test runner, counting
+*		the allocations for AllocationCounter.
+*
+* Developer Notes:
+*		Has to be linked into the test runner only, once.
+*
+***************************************************************************************/
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+
+void* operator new(std::size_t size)
+{
+	if(AllocationCounting::enabled())
+	{
+		AllocationCounting::count()++;
+	}
+
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if(memory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
@@ -0,0 +1,45 @@
+/****************************************************************************************
+*
+* File:
+* 		AllocationCounter.h
+*
+* Purpose:
+*		Counts the heap allocations a piece of code makes, for tests that check a path
+*		doesn't copy or allocate.
+*
+* Developer Notes:
+*		The replacements of the global operator new and delete that do the counting are
+*		in AllocationCounter.cpp, which is linked into the unit test runner only. Only
+*		the allocations of the thread that created the AllocationCounter are counted, so
+*		the threads of other nodes don't disturb a count.
+*
+***************************************************************************************/
+
+#pragma once
+
+
+namespace AllocationCounting {
+	inline bool& enabled() { static thread_local bool counting = false; return counting; }
+	inline unsigned long& count() { static thread_local unsigned long allocations = 0; return allocations; }
+}
+
+
+class AllocationCounter {
+public:
+	AllocationCounter()
+	{
+		AllocationCounting::count() = 0;
+		AllocationCounting::enabled() = true;
+	}
+
+	~AllocationCounter()
+	{
+		AllocationCounting::enabled() = false;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Number of allocations made by this thread since the counter was created.
+	///----------------------------------------------------------------------------------
+	unsigned long allocations() const { return AllocationCounting::count(); }
+};
+
@@ -0,0 +1,432 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		DBHandlerSuite.h
+ *
+ * Purpose:
+ *		Tests the queries of the DBHandler against a small database of its own.
+ *
+ * Developer Notes:
+ *		The database is created from scratch by setUp() in the working directory, with
+ *		only the tables the tests use. The tests run in the access mode of the build,
+ *		the WAL tests pick the mode themselves.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "DataBase/DBHandler.h"
+#include "DataBase/LogStoreExporter.h"
+#include "../cxxtest/cxxtest/TestSuite.h"
+
+#include <dirent.h>
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+#define DBHANDLER_TEST_DB 		"./dbhandler_test.db"
+#define DBHANDLER_TEST_STORE 	"./dbhandler_test.datalogs"
+
+
+class DBHandlerSuite : public CxxTest::TestSuite {
+public:
+	void setUp()
+	{
+		tearDown();
+		TS_ASSERT(execute(
+			"CREATE TABLE config_course_regulator (id INTEGER PRIMARY KEY AUTOINCREMENT, loop_time DOUBLE, "
+				"max_rudder_angle INTEGER, p_gain DOUBLE, i_gain DOUBLE, d_gain DOUBLE);"
+			"INSERT INTO config_course_regulator VALUES(1, 0.5, 30, 1.25, 0.5, 2);"
+			"CREATE TABLE dataLogs_compass (id INTEGER PRIMARY KEY AUTOINCREMENT, heading DOUBLE, "
+				"pitch DOUBLE, roll DOUBLE, t_timestamp TIMESTAMP);"
+			"INSERT INTO dataLogs_compass VALUES(NULL, 10, 1, 2, '2017-01-01 12:00:00');"));
+	}
+
+	void tearDown()
+	{
+		remove(DBHANDLER_TEST_DB);
+		remove(DBHANDLER_TEST_DB "-wal");
+		remove(DBHANDLER_TEST_DB "-shm");
+
+		DIR* store = opendir(DBHANDLER_TEST_STORE);
+		if(store != NULL)
+		{
+			while(dirent* entry = readdir(store))
+			{
+				remove((std::string(DBHANDLER_TEST_STORE "/") + entry->d_name).c_str());
+			}
+			closedir(store);
+			rmdir(DBHANDLER_TEST_STORE);
+		}
+	}
+
+	void test_RetrieveCell()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		TS_ASSERT(dbHandler.initialise());
+
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 1.25, 1e-9);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("config_course_regulator", "1", "max_rudder_angle"), 30);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCell("config_course_regulator", "2", "p_gain"), "");
+		TS_ASSERT_EQUALS(dbHandler.getIdFromTable("dataLogs_compass", true), "1");
+	}
+
+	void test_IdIsBoundAsAValue()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+
+		TS_ASSERT_EQUALS(dbHandler.retrieveCell("config_course_regulator", "1 OR 1=1", "p_gain"), "");
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 1.25, 1e-9);
+	}
+
+	void test_SeesChangesFromOtherConnections()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 1.25, 1e-9);
+
+		TS_ASSERT(execute("UPDATE config_course_regulator SET p_gain = 3 WHERE id = 1;"
+			"INSERT INTO dataLogs_compass VALUES(NULL, 11, 1, 2, '2017-01-01 12:00:01');"));
+
+		TS_ASSERT_EQUALS(dbHandler.getIdFromTable("dataLogs_compass", true), "2");
+
+		// The configs come from the snapshot until it is reloaded
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 1.25, 1e-9);
+		TS_ASSERT(dbHandler.reloadConfigs());
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 3, 1e-9);
+	}
+
+	void test_MoreQueriesThanCachedStatements()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+
+		for(int i = 0; i < 100; i++)
+		{
+			std::string column = "p_gain + " + std::to_string(i);
+			TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", column), 1.25 + i, 1e-9);
+		}
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain + 99"), 100.25, 1e-9);
+	}
+
+	void test_MissingDatabase()
+	{
+		DBHandler dbHandler("./dbhandler_missing.db");
+		TS_ASSERT(not dbHandler.initialise());
+		TS_ASSERT_EQUALS(dbHandler.retrieveCell("config_course_regulator", "1", "p_gain"), "");
+
+		FILE* file = fopen("./dbhandler_missing.db", "r");
+		TS_ASSERT(file == NULL);
+		if(file != NULL)
+		{
+			fclose(file);
+			remove("./dbhandler_missing.db");
+		}
+	}
+
+	void test_InsertDataLogs()
+	{
+		TS_ASSERT(createLogTables());
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+
+		std::vector<LogItem> logs(3, logItem());
+		logs[1].m_gpsLat = 60.1234567891234;
+		logs[2].m_compassHeading = 271.5;
+		dbHandler.insertDataLogs(logs);
+
+		TS_ASSERT_EQUALS(dbHandler.getRows("dataLogs_system"), 3);
+		TS_ASSERT_EQUALS(dbHandler.getRows("dataLogs_gps"), 3);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsDouble("dataLogs_gps", "2", "latitude"), 60.1234567891234);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_gps", "2", "satellites_used"), 7);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_gps", "2", "has_fix"), 1);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCell("dataLogs_gps", "2", "t_timestamp"), "2017-01-01 12:00:00");
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_system", "3", "compass_id"), 4);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_system", "3", "current_mission_id"), 5);
+	}
+
+	void test_InsertDataLogsAfterClearing()
+	{
+		TS_ASSERT(createLogTables());
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+
+		std::vector<LogItem> logs(2, logItem());
+		dbHandler.insertDataLogs(logs);
+		dbHandler.clearLogs();
+		dbHandler.insertDataLogs(logs);
+
+		// The ids carry on after the clear, the system rows have to point at the new rows
+		TS_ASSERT_EQUALS(dbHandler.getRows("dataLogs_system"), 2);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_system", "4", "gps_id"), 4);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_system", "4", "compass_id"), 5);
+	}
+
+	void test_LogStoreExportsTheSameJson()
+	{
+		TS_ASSERT(createLogTables());
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		LogStore logStore(DBHANDLER_TEST_STORE);
+		TS_ASSERT(logStore.open());
+
+		std::vector<LogItem> logs(1, logItem());
+		logs[0].m_gpsLat = 60.1234567891234;
+		logs[0].m_compassHeading = 271.5;
+		logs[0].m_temperature = 0.1f;
+		logs[0].m_windSpeed = -2000;
+		dbHandler.insertDataLogs(logs);
+		TS_ASSERT(logStore.append(logs));
+
+		LogRecord latest;
+		TS_ASSERT(logStore.readLatest(latest));
+		Json fromDatabase = Json::parse(dbHandler.getLogs(true));
+		Json fromStore = Json::parse(LogStoreExporter::toJson({ latest }, 5));
+
+		// the same rows apart from the ids
+		TS_ASSERT_EQUALS(fromStore.size(), fromDatabase.size());
+		for(auto table : Json::iterator_wrapper(fromDatabase))
+		{
+			Json row = table.value()[0];
+			for(auto column : Json::iterator_wrapper(row))
+			{
+				const std::string& name = column.key();
+				if(name != "id" && (name.size() < 3 || name.compare(name.size() - 3, 3, "_id") != 0))
+				{
+					TS_ASSERT_EQUALS(fromStore[table.key()][0][name], column.value());
+				}
+			}
+		}
+		TS_ASSERT_EQUALS(fromStore["dataLogs_system"][0]["current_mission_id"], "5");
+	}
+
+	void test_LogStoreExportToDatabase()
+	{
+		TS_ASSERT(createLogTables());
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		LogStore logStore(DBHANDLER_TEST_STORE);
+		TS_ASSERT(logStore.open());
+
+		std::vector<LogItem> logs(3, logItem());
+		logs[2].m_gpsLat = 60.5;
+		TS_ASSERT(logStore.append(logs));
+
+		TS_ASSERT(LogStoreExporter::toDatabase(logStore, dbHandler));
+		TS_ASSERT_EQUALS(logStore.count(), 0u);
+		TS_ASSERT_EQUALS(dbHandler.getRows("dataLogs_system"), 3);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsDouble("dataLogs_gps", "3", "latitude"), 60.5);
+		TS_ASSERT_EQUALS(dbHandler.retrieveCellAsInt("dataLogs_system", "3", "current_mission_id"), 5);
+	}
+
+	void test_WALModeReadsAndWrites()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB, DBAccessMode::WAL);
+		TS_ASSERT(dbHandler.initialise());
+		TS_ASSERT_EQUALS(journalMode(), "wal");
+
+		TS_ASSERT(dbHandler.updateTable("config_course_regulator", "p_gain", "4", "1"));
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 4, 1e-9);
+		TS_ASSERT(dbHandler.writeWait().count() >= 2);
+		TS_ASSERT(dbHandler.readWait().count() >= 1);
+	}
+
+	void test_WALReadsDontWaitForWrites()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB, DBAccessMode::WAL);
+		TS_ASSERT(dbHandler.initialise());
+
+		// Another connection in the middle of a write, it holds the write lock of the file
+		sqlite3* writer = NULL;
+		TS_ASSERT_EQUALS(sqlite3_open(DBHANDLER_TEST_DB, &writer), SQLITE_OK);
+		TS_ASSERT_EQUALS(sqlite3_exec(writer, "BEGIN EXCLUSIVE; UPDATE dataLogs_compass SET heading = 5 WHERE id = 1;",
+			NULL, NULL, NULL), SQLITE_OK);
+
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("dataLogs_compass", "1", "heading"), 10, 1e-9);
+
+		TS_ASSERT_EQUALS(sqlite3_exec(writer, "COMMIT;", NULL, NULL, NULL), SQLITE_OK);
+		sqlite3_close(writer);
+
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("dataLogs_compass", "1", "heading"), 5, 1e-9);
+	}
+
+	void test_WALConcurrentReads()
+	{
+		const int THREADS = 6;
+		const int READS = 200;
+		DBHandler dbHandler(DBHANDLER_TEST_DB, DBAccessMode::WAL);
+		TS_ASSERT(dbHandler.initialise());
+		const uint64_t readsBefore = dbHandler.readWait().count();
+
+		std::vector<int> correct(THREADS, 0);
+		std::vector<std::thread> readers;
+		for(int t = 0; t < THREADS; t++)
+		{
+			readers.emplace_back([&dbHandler, &correct, t, READS]() {
+				for(int i = 0; i < READS; i++)
+				{
+					if(dbHandler.retrieveCellAsInt("dataLogs_compass", "1", "heading") == 10)
+					{
+						correct[t]++;
+					}
+				}
+			});
+		}
+		for(std::thread& reader : readers)
+		{
+			reader.join();
+		}
+
+		for(int t = 0; t < THREADS; t++)
+		{
+			TS_ASSERT_EQUALS(correct[t], READS);
+		}
+		TS_ASSERT_EQUALS(dbHandler.readWait().count() - readsBefore, THREADS * READS);
+	}
+
+	void test_ConfigSnapshot()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		TS_ASSERT(dbHandler.initialise());
+
+		std::shared_ptr<const ConfigSnapshot> configs = dbHandler.configs();
+		TS_ASSERT_EQUALS(configs->version(), 1u);
+		TS_ASSERT_DELTA(configs->getDouble("config_course_regulator", "p_gain"), 1.25, 1e-9);
+		TS_ASSERT_EQUALS(configs->getInt("config_course_regulator", "max_rudder_angle"), 30);
+		TS_ASSERT_EQUALS(configs->getString("config_course_regulator", "loop_time"), "0.5");
+		TS_ASSERT_EQUALS(configs->getInt("config_course_regulator", "no_such_column", -1), -1);
+		TS_ASSERT_EQUALS(configs->getDouble("config_no_such_table", "p_gain", 4), 4);
+		TS_ASSERT_EQUALS(configs->columns("config_course_regulator").size(), 6u);
+
+		// Only the config tables are in the snapshot
+		TS_ASSERT(configs->columns("dataLogs_compass").empty());
+	}
+
+	void test_ConfigSnapshotReloadsOnUpdate()
+	{
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		TS_ASSERT(dbHandler.initialise());
+		std::shared_ptr<const ConfigSnapshot> before = dbHandler.configs();
+
+		TS_ASSERT(dbHandler.updateTable("config_course_regulator", "p_gain", "2.5", "1"));
+
+		std::shared_ptr<const ConfigSnapshot> after = dbHandler.configs();
+		TS_ASSERT_EQUALS(after->version(), before->version() + 1);
+		TS_ASSERT_DELTA(after->getDouble("config_course_regulator", "p_gain"), 2.5, 1e-9);
+		TS_ASSERT_DELTA(dbHandler.retrieveCellAsDouble("config_course_regulator", "1", "p_gain"), 2.5, 1e-9);
+
+		// A node still holding the old snapshot sees it unchanged
+		TS_ASSERT_DELTA(before->getDouble("config_course_regulator", "p_gain"), 1.25, 1e-9);
+
+		// and it is freed once nothing holds it
+		std::weak_ptr<const ConfigSnapshot> old = before;
+		before.reset();
+		TS_ASSERT(old.expired());
+
+		// Other tables don't reload it
+		TS_ASSERT(dbHandler.updateTable("dataLogs_compass", "heading", "20", "1"));
+		TS_ASSERT_EQUALS(dbHandler.configs()->version(), after->version());
+	}
+
+	void test_UpdateConfigs()
+	{
+		TS_ASSERT(execute(
+			"CREATE TABLE config_voter_system (id INTEGER PRIMARY KEY AUTOINCREMENT, max_vote INTEGER, "
+				"waypoint_voter_weight DOUBLE);"
+			"INSERT INTO config_voter_system VALUES(1, 25, 1);"));
+		DBHandler dbHandler(DBHANDLER_TEST_DB);
+		TS_ASSERT(dbHandler.initialise());
+		uint64_t version = dbHandler.configs()->version();
+
+		dbHandler.updateConfigs("{\"config_course_regulator\":{\"id\":\"1\",\"loop_time\":\"0.7\","
+			"\"max_rudder_angle\":\"25\",\"p_gain\":\"2\",\"i_gain\":\"0.25\",\"d_gain\":\"1\"},"
+			"\"config_voter_system\":{\"id\":\"1\",\"max_vote\":\"50\",\"waypoint_voter_weight\":\"0.5\"},"
+			"\"config_no_such_table\":{\"id\":\"1\",\"value\":\"1\"}}");
+
+		std::shared_ptr<const ConfigSnapshot> configs = dbHandler.configs();
+		TS_ASSERT_EQUALS(configs->version(), version + 1);
+		TS_ASSERT_DELTA(configs->getDouble("config_course_regulator", "loop_time"), 0.7, 1e-9);
+		TS_ASSERT_EQUALS(configs->getInt("config_course_regulator", "max_rudder_angle"), 25);
+		TS_ASSERT_DELTA(configs->getDouble("config_course_regulator", "i_gain"), 0.25, 1e-9);
+		TS_ASSERT_EQUALS(configs->getInt("config_voter_system", "max_vote"), 50);
+		TS_ASSERT_DELTA(configs->getDouble("config_voter_system", "waypoint_voter_weight"), 0.5, 1e-9);
+
+		// Written to the database, not only to the snapshot
+		DBHandler other(DBHANDLER_TEST_DB);
+		TS_ASSERT_EQUALS(other.retrieveCellAsInt("config_voter_system", "1", "max_vote"), 50);
+	}
+
+private:
+	///----------------------------------------------------------------------------------
+	/// Adds the tables DBHandler::insertDataLogs writes to, the same columns as the
+	/// schema of the boat but without the foreign keys.
+	///----------------------------------------------------------------------------------
+	bool createLogTables()
+	{
+		return execute(
+			"CREATE TABLE current_Mission (id INTEGER PRIMARY KEY);"
+			"INSERT INTO current_Mission VALUES(5);"
+			"CREATE TABLE dataLogs_actuator_feedback (id INTEGER PRIMARY KEY AUTOINCREMENT, rudder_position DOUBLE, "
+				"wingsail_position DOUBLE, rc_on BOOLEAN, wind_vane_angle DOUBLE, t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_course_calculation (id INTEGER PRIMARY KEY AUTOINCREMENT, distance_to_waypoint DOUBLE, "
+				"bearing_to_waypoint DOUBLE, course_to_steer DOUBLE, tack BOOLEAN, going_starboard BOOLEAN, "
+				"t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_current_sensors (id INTEGER PRIMARY KEY AUTOINCREMENT, actuator_unit DOUBLE, "
+				"navigation_unit DOUBLE, wind_vane_angle DOUBLE, wind_vane_clutch DOUBLE, sailboat_drive DOUBLE, "
+				"t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_gps (id INTEGER PRIMARY KEY AUTOINCREMENT, has_fix BOOLEAN, online BOOLEAN, "
+				"time TIME, latitude DOUBLE, longitude DOUBLE, speed DOUBLE, course DOUBLE, satellites_used INTEGER, "
+				"route_started BOOLEAN, t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_marine_sensors (id INTEGER PRIMARY KEY AUTOINCREMENT, temperature DOUBLE, "
+				"conductivity DOUBLE, ph DOUBLE, salinity DOUBLE, t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_vessel_state (id INTEGER PRIMARY KEY AUTOINCREMENT, heading DOUBLE, latitude DOUBLE, "
+				"longitude DOUBLE, speed DOUBLE, course DOUBLE, t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_wind_state (id INTEGER PRIMARY KEY AUTOINCREMENT, true_wind_speed DOUBLE, "
+				"true_wind_direction DOUBLE, apparent_wind_speed DOUBLE, apparent_wind_direction DOUBLE, "
+				"t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_windsensor (id INTEGER PRIMARY KEY AUTOINCREMENT, direction DOUBLE, speed DOUBLE, "
+				"temperature DOUBLE, t_timestamp TIMESTAMP);"
+			"CREATE TABLE dataLogs_system (id INTEGER PRIMARY KEY AUTOINCREMENT, actuator_feedback_id INTEGER, "
+				"compass_id INTEGER, course_calculation_id INTEGER, current_sensors_id INTEGER, gps_id INTEGER, "
+				"marine_sensors_id INTEGER, vessel_state_id INTEGER, wind_state_id INTEGER, windsensor_id INTEGER, "
+				"current_mission_id INTEGER);");
+	}
+
+	LogItem logItem()
+	{
+		LogItem item = LogItem();
+		item.m_gpsHasFix = true;
+		item.m_gpsSatellite = 7;
+		item.m_timestamp_str = "2017-01-01 12:00:00";
+		return item;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Returns the journal mode the database file is in.
+	///----------------------------------------------------------------------------------
+	std::string journalMode()
+	{
+		sqlite3* db = NULL;
+		sqlite3_stmt* statement = NULL;
+		std::string mode;
+		if(sqlite3_open(DBHANDLER_TEST_DB, &db) == SQLITE_OK &&
+			sqlite3_prepare_v2(db, "PRAGMA journal_mode;", -1, &statement, NULL) == SQLITE_OK &&
+			sqlite3_step(statement) == SQLITE_ROW)
+		{
+			mode = reinterpret_cast<const char*>(sqlite3_column_text(statement, 0));
+		}
+		sqlite3_finalize(statement);
+		sqlite3_close(db);
+		return mode;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Runs SQL on a connection of its own, like another process would.
+	///----------------------------------------------------------------------------------
+	bool execute(const char* sql)
+	{
+		sqlite3* db = NULL;
+		bool success = (sqlite3_open(DBHANDLER_TEST_DB, &db) == SQLITE_OK) &&
+			(sqlite3_exec(db, sql, NULL, NULL, NULL) == SQLITE_OK);
+		sqlite3_close(db);
+		return success;
+	}
+};
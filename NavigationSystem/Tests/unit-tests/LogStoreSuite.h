@@ -0,0 +1,265 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		LogStoreSuite.h
+ *
+ * Purpose:
+ *		Tests the LogStore against a store directory of its own.
+ *
+ * Developer Notes:
+ *		The directory is emptied by setUp() and tearDown(). The tests that look at the
+ *		time of the records run on a SimulatedTimeSource they move forward by hand.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "DataBase/LogStore.h"
+#include "DataBase/LogStoreExporter.h"
+#include "SystemServices/SysClock.h"
+#include "../cxxtest/cxxtest/TestSuite.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+#define LOG_STORE_TEST_DIR 		"./logstore_test"
+
+
+class LogStoreSuite : public CxxTest::TestSuite {
+public:
+	void setUp()
+	{
+		tearDown();
+	}
+
+	void tearDown()
+	{
+		SysClock::setTimeSource(NULL);
+
+		for(const std::string& name : files())
+		{
+			remove((std::string(LOG_STORE_TEST_DIR "/") + name).c_str());
+		}
+		rmdir(LOG_STORE_TEST_DIR);
+	}
+
+	void test_AppendAndRead()
+	{
+		LogStore logStore(LOG_STORE_TEST_DIR);
+		TS_ASSERT(logStore.open());
+		TS_ASSERT(logStore.append({ logItem(1), logItem(2), logItem(3) }));
+		TS_ASSERT_EQUALS(logStore.count(), 3u);
+
+		std::vector<LogRecord> records;
+		logStore.read(records);
+		TS_ASSERT_EQUALS(records.size(), 3u);
+		for(unsigned int i = 0; i < records.size(); i++)
+		{
+			const LogItem& item = records[i].item;
+			TS_ASSERT_EQUALS(records[i].sequence, i + 1);
+			TS_ASSERT_EQUALS(item.m_compassHeading, 10.5 + i + 1);
+			TS_ASSERT_EQUALS(item.m_temperature, 12.25f);
+			TS_ASSERT_EQUALS(item.m_gpsSatellite, (int)(i + 1));
+			TS_ASSERT_EQUALS(item.m_gpsHasFix, true);
+			TS_ASSERT_EQUALS(item.m_tack, false);
+			TS_ASSERT_EQUALS(item.m_timestamp_str, "2017-06-01 12:00:0" + std::to_string(i + 1));
+		}
+
+		LogRecord latest;
+		TS_ASSERT(logStore.readLatest(latest));
+		TS_ASSERT_EQUALS(latest.sequence, 3u);
+	}
+
+	void test_ReopenKeepsRecords()
+	{
+		{
+			LogStore logStore(LOG_STORE_TEST_DIR);
+			TS_ASSERT(logStore.open());
+			TS_ASSERT(logStore.append({ logItem(1), logItem(2) }));
+		}
+
+		LogStore logStore(LOG_STORE_TEST_DIR);
+		TS_ASSERT(logStore.open());
+		TS_ASSERT_EQUALS(logStore.count(), 2u);
+		TS_ASSERT(logStore.append({ logItem(3) }));
+
+		std::vector<LogRecord> records;
+		logStore.read(records);
+		TS_ASSERT_EQUALS(records.size(), 3u);
+		TS_ASSERT_EQUALS(records.back().sequence, 3u);
+		TS_ASSERT_EQUALS(records.back().item.m_gpsSatellite, 3);
+	}
+
+	void test_SegmentsRollOver()
+	{
+		LogStore logStore(LOG_STORE_TEST_DIR, LOG_STORE_BLOCK_RECORDS);
+		TS_ASSERT(logStore.open());
+
+		std::vector<LogItem> logs;
+		for(int i = 1; i <= 150; i++)
+		{
+			logs.push_back(logItem(i));
+		}
+		TS_ASSERT(logStore.append(logs));
+		TS_ASSERT_EQUALS(files().size(), 3u);
+
+		std::vector<LogRecord> records;
+		logStore.read(records);
+		TS_ASSERT_EQUALS(records.size(), 150u);
+		for(unsigned int i = 0; i < records.size(); i++)
+		{
+			TS_ASSERT_EQUALS(records[i].sequence, i + 1);
+			TS_ASSERT_EQUALS(records[i].item.m_gpsSatellite, (int)(i + 1));
+		}
+	}
+
+	void test_ReadBatch()
+	{
+		LogStore logStore(LOG_STORE_TEST_DIR, LOG_STORE_BLOCK_RECORDS);
+		TS_ASSERT(logStore.open());
+
+		std::vector<LogItem> logs(150, logItem(1));
+		TS_ASSERT(logStore.append(logs));
+		logStore.remove(11);
+
+		// across the end of a segment
+		std::vector<LogRecord> records;
+		logStore.readBatch(records, 0, 100);
+		TS_ASSERT_EQUALS(records.size(), 100u);
+		TS_ASSERT_EQUALS(records.front().sequence, 11u);
+		TS_ASSERT_EQUALS(records.back().sequence, 110u);
+
+		records.clear();
+		logStore.readBatch(records, 111, 100);
+		TS_ASSERT_EQUALS(records.size(), 40u);
+		TS_ASSERT_EQUALS(records.front().sequence, 111u);
+
+		records.clear();
+		logStore.readBatch(records, 151, 100);
+		TS_ASSERT(records.empty());
+	}
+
+	void test_ReadTimeRange()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		LogStore logStore(LOG_STORE_TEST_DIR, LOG_STORE_BLOCK_RECORDS);
+		TS_ASSERT(logStore.open());
+
+		// a segment a second
+		std::vector<LogItem> logs(LOG_STORE_BLOCK_RECORDS, logItem(1));
+		int64_t start = clock.unixMicros();
+		for(int second = 0; second < 3; second++)
+		{
+			TS_ASSERT(logStore.append(logs));
+			clock.advance(1000000);
+		}
+
+		std::vector<LogRecord> records;
+		logStore.read(records, start + 500000, start + 1500000);
+		TS_ASSERT_EQUALS(records.size(), (size_t)LOG_STORE_BLOCK_RECORDS);
+		TS_ASSERT_EQUALS(records.front().sequence, LOG_STORE_BLOCK_RECORDS + 1u);
+		TS_ASSERT_EQUALS(records.front().time, start + 1000000);
+	}
+
+	void test_RemoveDeletesSegments()
+	{
+		LogStore logStore(LOG_STORE_TEST_DIR, LOG_STORE_BLOCK_RECORDS);
+		TS_ASSERT(logStore.open());
+
+		std::vector<LogItem> logs(150, logItem(1));
+		TS_ASSERT(logStore.append(logs));
+
+		logStore.remove(100);
+		TS_ASSERT_EQUALS(logStore.count(), 51u);
+		TS_ASSERT_EQUALS(files().size(), 2u);
+
+		std::vector<LogRecord> records;
+		logStore.read(records);
+		TS_ASSERT_EQUALS(records.front().sequence, 100u);
+
+		// the last segment stays for the sequence numbers
+		logStore.remove(151);
+		TS_ASSERT_EQUALS(logStore.count(), 0u);
+		TS_ASSERT_EQUALS(files().size(), 1u);
+
+		LogRecord latest;
+		TS_ASSERT(not logStore.readLatest(latest));
+		TS_ASSERT(logStore.append({ logItem(1) }));
+		TS_ASSERT(logStore.readLatest(latest));
+		TS_ASSERT_EQUALS(latest.sequence, 151u);
+	}
+
+	void test_ForeignSegmentIsNotRead()
+	{
+		LogStore logStore(LOG_STORE_TEST_DIR);
+		TS_ASSERT(logStore.open());
+
+		FILE* file = fopen(LOG_STORE_TEST_DIR "/datalogs-000000000001.seg", "w");
+		fputs("not a segment", file);
+		fclose(file);
+
+		LogStore reopened(LOG_STORE_TEST_DIR);
+		TS_ASSERT(reopened.open());
+		TS_ASSERT_EQUALS(reopened.count(), 0u);
+	}
+
+	void test_JsonExport()
+	{
+		LogStore logStore(LOG_STORE_TEST_DIR);
+		TS_ASSERT(logStore.open());
+		TS_ASSERT(logStore.append({ logItem(1), logItem(2) }));
+
+		std::vector<LogRecord> records;
+		logStore.read(records);
+		Json js = Json::parse(LogStoreExporter::toJson(records, 5));
+
+		TS_ASSERT_EQUALS(js["dataLogs_compass"].size(), 2u);
+		TS_ASSERT_EQUALS(js["dataLogs_compass"][1]["id"], "2");
+		TS_ASSERT_EQUALS(js["dataLogs_compass"][1]["heading"], "12.5");
+		TS_ASSERT_EQUALS(js["dataLogs_gps"][0]["satellites_used"], "1");
+		TS_ASSERT_EQUALS(js["dataLogs_gps"][0]["has_fix"], "1");
+		TS_ASSERT_EQUALS(js["dataLogs_gps"][0]["time"], "2017-06-01 12:00:01");
+		TS_ASSERT_EQUALS(js["dataLogs_marine_sensors"][0]["temperature"], "12.25");
+		TS_ASSERT_EQUALS(js["dataLogs_system"][1]["compass_id"], "2");
+		TS_ASSERT_EQUALS(js["dataLogs_system"][1]["current_mission_id"], "5");
+	}
+
+private:
+	LogItem logItem(int i)
+	{
+		LogItem item = LogItem();
+		item.m_compassHeading = 10.5 + i;
+		item.m_temperature = 12.25f;
+		item.m_gpsSatellite = i;
+		item.m_gpsHasFix = true;
+		item.m_timestamp_str = "2017-06-01 12:00:0" + std::to_string(i);
+		return item;
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Returns the files in the store directory.
+	///----------------------------------------------------------------------------------
+	std::vector<std::string> files()
+	{
+		std::vector<std::string> names;
+		DIR* directory = opendir(LOG_STORE_TEST_DIR);
+		if(directory != NULL)
+		{
+			while(dirent* entry = readdir(directory))
+			{
+				if(entry->d_name[0] != '.')
+				{
+					names.push_back(entry->d_name);
+				}
+			}
+			closedir(directory);
+		}
+		return names;
+	}
+};
@@ -0,0 +1,1720 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageBusSuite.h
+ *
+ * Purpose:
+ *		Unit tests for the message bus internals: wake up on send, batching, the dispatch
+ *		latency histogram, the message queues, the worker pool, the message pools, the
+ *		message trace, the statistics, the priority lanes, conflation, the blackboard,
+ *		record and replay, running on a simulated time, the tick scheduler, the control
+ *		loop timing, the typed subscriptions, the shared memory bridge, the queue
+ *		limits and the causal tracing.
+ *
+ * Developer Notes:
+ *		Every test uses its own message bus so the bus settings don't leak between tests.
+ *
+ ***************************************************************************************/
+
+#pragma once
+
+#include "Tests/cxxtest/cxxtest/TestSuite.h"
+#include "TestMocks/MockNode.h"
+#include "MessageBus/ActiveNode.h"
+#include "MessageBus/BridgeNode.h"
+#include "MessageBus/CausalTracer.h"
+#include "MessageBus/MessageBus.h"
+#include "MessageBus/Blackboard.h"
+#include "MessageBus/MessagePool.h"
+#include "MessageBus/MessageFactory.h"
+#include "MessageBus/MessageQueue.h"
+#include "MessageBus/MessageReplay.h"
+#include "MessageBus/MessageTrace.h"
+#include "MessageBus/SharedMemoryRing.h"
+#include "MessageBus/TickScheduler.h"
+#include "SystemServices/DeadlineTimer.h"
+#include "SystemServices/LatencyHistogram.h"
+#include "SystemServices/Logger.h"
+#include "SystemServices/RealTime.h"
+#include "SystemServices/SysClock.h"
+#include "SystemServices/TimeSource.h"
+#include "SystemServices/Timer.h"
+#include "MessageBusTestHelper.h"
+#include "Messages/RudderCommandMsg.h"
+#include "Messages/StateMessage.h"
+#include "Messages/WingSailCommandMsg.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sched.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+
+///----------------------------------------------------------------------------------
+/// Keeps the wind speed of every WindData message it gets, optionally taking its time
+/// over each one.
+///----------------------------------------------------------------------------------
+class RecordingNode : public Node {
+public:
+	RecordingNode(NodeID id, MessageBus& msgBus, int delayMs)
+		:Node(id, msgBus), m_DelayMs(delayMs), m_Received(0)
+	{
+		msgBus.registerNode(*this, MessageType::WindData);
+	}
+
+	bool init() { return true; }
+
+	void processMessage(const Message* message)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(m_DelayMs));
+		m_Speeds.push_back(static_cast<const WindDataMsg*>(message)->windSpeed());
+		m_Times.push_back(SysClock::monotonicMicros());
+		m_Received++;
+	}
+
+	int m_DelayMs;
+	std::vector<float> m_Speeds;
+	std::vector<uint64_t> m_Times;
+	std::atomic<int> m_Received;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Plays a sensor to actuator chain on its own: makes a StateMessage from every
+/// WindData message, a RudderCommand from every StateMessage, taking its time over it,
+/// and acts on the RudderCommand like an actuator.
+///----------------------------------------------------------------------------------
+class CausalChainNode : public Node {
+public:
+	CausalChainNode(MessageBus& msgBus, int delayMs)
+		:Node(NodeID::RudderActuator, msgBus), m_DelayMs(delayMs), m_Actuations(0)
+	{
+		msgBus.registerNode(*this, MessageType::WindData);
+		msgBus.registerNode(*this, MessageType::StateMessage);
+		msgBus.registerNode(*this, MessageType::RudderCommand);
+	}
+
+	bool init() { return true; }
+
+	void processMessage(const Message* message)
+	{
+		m_Received.push_back(message->asCause());
+
+		if(message->messageType() == MessageType::WindData)
+		{
+			MessagePtr state = std::make_unique<StateMessage>(1, 2, 3, 4, 5);
+			state->setCause(*message);
+			m_MsgBus.sendMessage(std::move(state));
+		}
+		else if(message->messageType() == MessageType::StateMessage)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(m_DelayMs));
+			MessagePtr command = std::make_unique<RudderCommandMsg>(10);
+			command->setCause(*message);
+			m_MsgBus.sendMessage(std::move(command));
+		}
+		else
+		{
+			m_MsgBus.causalTracer().record(*message, nodeID());
+			m_Actuations++;
+		}
+	}
+
+	int m_DelayMs;
+	std::vector<MessageCause> m_Received;	// As a cause of the next message
+	std::atomic<int> m_Actuations;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Sends a WindData message every half a second, like the node loops do, and stops
+/// after a number of ticks.
+///----------------------------------------------------------------------------------
+class TickingNode : public ActiveNode {
+public:
+	TickingNode(MessageBus& msgBus, int ticks)
+		:ActiveNode(NodeID::SailingLogic, msgBus), m_Ticks(ticks)
+	{ }
+
+	bool init() { return true; }
+	void start() { runThread(TickingThreadFunc); }
+	void join() { stopThread(this); }
+	void processMessage(const Message*) { }
+
+	static void TickingThreadFunc(ActiveNode* nodePtr)
+	{
+		TickingNode* node = static_cast<TickingNode*>(nodePtr);
+		Timer timer;
+		timer.start();
+		for(int tick = 0; tick < node->m_Ticks; tick++)
+		{
+			node->m_SendTimes.push_back(SysClock::monotonicMicros());
+			node->m_MsgBus.sendMessage(std::make_unique<WindDataMsg>(0, tick, 0));
+			timer.sleepUntil(0.5);
+			timer.reset();
+		}
+	}
+
+	int m_Ticks;
+	std::vector<uint64_t> m_SendTimes;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Sends a WindData message from the tick scheduler every half a second.
+///----------------------------------------------------------------------------------
+class PeriodicNode : public ActiveNode {
+public:
+	PeriodicNode(MessageBus& msgBus)
+		:ActiveNode(NodeID::SailingLogic, msgBus), m_Ticks(0)
+	{ }
+
+	~PeriodicNode() { stopPeriodic(); }
+
+	bool init() { return true; }
+	void start() { runPeriodic(0.5, 2000); }
+	void stop() { stopPeriodic(); }
+	void processMessage(const Message*) { }
+
+	void tick()
+	{
+		m_MsgBus.sendMessage(std::make_unique<WindDataMsg>(0, m_Ticks.load(), 0));
+		m_Ticks++;
+	}
+
+	std::atomic<int> m_Ticks;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Keeps the type of every message it gets, in the order they arrive.
+///----------------------------------------------------------------------------------
+class TypeRecordingNode : public Node {
+public:
+	TypeRecordingNode(MessageBus& msgBus)
+		:Node(NodeID::SailingLogic, msgBus), m_Received(0)
+	{
+		msgBus.registerNode(*this, MessageType::WindData);
+		msgBus.registerNode(*this, MessageType::CompassData);
+		msgBus.registerNode(*this, MessageType::RudderCommand);
+	}
+
+	bool init() { return true; }
+
+	void processMessage(const Message* message)
+	{
+		m_Types.push_back(message->messageType());
+		m_Received++;
+	}
+
+	std::vector<MessageType> m_Types;
+	std::atomic<int> m_Received;
+};
+
+
+///----------------------------------------------------------------------------------
+/// Takes the wind and compass messages through typed handlers and everything else
+/// through processMessage().
+///----------------------------------------------------------------------------------
+class TypedNode : public Node {
+public:
+	TypedNode(MessageBus& msgBus)
+		:Node(NodeID::SailingLogic, msgBus), m_Received(0)
+	{
+		msgBus.subscribe(*this, &TypedNode::processWindData);
+		msgBus.subscribe(*this, &TypedNode::processCompassData);
+		msgBus.registerNode(*this, MessageType::RudderCommand);
+	}
+
+	bool init() { return true; }
+
+	void processWindData(const WindDataMsg& msg)
+	{
+		m_WindSpeeds.push_back(msg.windSpeed());
+		m_Received++;
+	}
+
+	void processCompassData(const CompassDataMsg& msg)
+	{
+		m_Headings.push_back(msg.heading());
+		m_Received++;
+	}
+
+	void processMessage(const Message* message)
+	{
+		m_Others.push_back(message->messageType());
+		m_Received++;
+	}
+
+	std::vector<float> m_WindSpeeds;
+	std::vector<int> m_Headings;
+	std::vector<MessageType> m_Others;
+	std::atomic<int> m_Received;
+};
+
+
+class MessageBusSuite : public CxxTest::TestSuite {
+public:
+	const int WAIT_FOR_MESSAGE = 300;
+
+	void setUp()
+	{
+		Logger::DisableLogging();
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Polls the node until it received a message or the timeout expired, returns the
+	/// time it took in milliseconds.
+	///----------------------------------------------------------------------------------
+	int waitForMessage(MockNode& node, int timeoutMs)
+	{
+		auto start = std::chrono::steady_clock::now();
+		int elapsed = 0;
+		while(not node.m_MessageReceived && elapsed < timeoutMs)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - start).count();
+		}
+		return elapsed;
+	}
+
+	void test_LatencyHistogramPercentiles()
+	{
+		LatencyHistogram histogram;
+		TS_ASSERT_EQUALS(histogram.percentile(50), 0);
+
+		for(int i = 1; i <= 100; i++)
+		{
+			histogram.record(i * 10);
+		}
+
+		TS_ASSERT_EQUALS(histogram.count(), 100);
+		TS_ASSERT_EQUALS(histogram.max(), 1000);
+		TS_ASSERT_DELTA(histogram.mean(), 505, 0.01);
+
+		// Buckets are powers of two, the percentile is the bucket's upper bound
+		TS_ASSERT(histogram.percentile(50) >= 500);
+		TS_ASSERT(histogram.percentile(50) < 1024);
+		TS_ASSERT_EQUALS(histogram.percentile(100), 1000);
+
+		histogram.reset();
+		TS_ASSERT_EQUALS(histogram.count(), 0);
+	}
+
+	void test_MessageWakesUpBus()
+	{
+		MessageBus messageBus;
+		bool registered = false;
+		MockNode node(messageBus, registered);
+		MessageBusTestHelper helper(messageBus);
+		std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_FOR_MESSAGE));
+
+		for(int i = 0; i < 5; i++)
+		{
+			node.clearMessageReceived();
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+			waitForMessage(node, WAIT_FOR_MESSAGE);
+			TS_ASSERT(node.m_MessageReceived);
+		}
+
+		// The bus used to poll every 50ms, messages should now go through a lot faster
+		TS_ASSERT_EQUALS(messageBus.dispatchLatency().count(), 5);
+		TS_ASSERT(messageBus.dispatchLatency().percentile(50) < 50000);
+	}
+
+	void test_BatchingWindowDelaysDispatch()
+	{
+		MessageBus messageBus;
+		bool registered = false;
+		MockNode node(messageBus, registered);
+		messageBus.setBatchingWindow(150);
+		MessageBusTestHelper helper(messageBus);
+		std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_FOR_MESSAGE));
+
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		TS_ASSERT(not node.m_MessageReceived);
+
+		waitForMessage(node, WAIT_FOR_MESSAGE * 2);
+		TS_ASSERT(node.m_MessageReceived);
+		TS_ASSERT(messageBus.dispatchLatency().max() >= 100000);
+	}
+
+	template<class Queue>
+	static void sendSequence(Queue* queue, int sender, int count)
+	{
+		for(int i = 0; i < count; i++)
+		{
+			MessagePtr msg = std::make_unique<Message>(MessageType::WindData, static_cast<NodeID>(sender));
+			msg->timeEnqueued = i;
+			queue->push(std::move(msg));
+		}
+	}
+
+	template<class Queue>
+	void checkSenderOrder()
+	{
+		const int SENDERS = 4;
+		const int COUNT = 5000;
+		Queue queue;
+		std::vector<std::thread> threads;
+
+		TS_ASSERT(queue.empty());
+
+		for(int s = 0; s < SENDERS; s++)
+		{
+			threads.push_back(std::thread(sendSequence<Queue>, &queue, s, COUNT));
+		}
+
+		std::vector<uint64_t> next(SENDERS, 0);
+		std::queue<MessagePtr> batch;
+		int received = 0;
+		while(received < SENDERS * COUNT)
+		{
+			queue.popAll(batch);
+			while(not batch.empty())
+			{
+				int sender = static_cast<int>(batch.front()->sourceID());
+				TS_ASSERT_EQUALS(batch.front()->timeEnqueued, next[sender]);
+				next[sender] = batch.front()->timeEnqueued + 1;
+				batch.pop();
+				received++;
+			}
+		}
+
+		for(auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_LockedQueueKeepsSenderOrder()
+	{
+		checkSenderOrder<LockedMessageQueue>();
+	}
+
+	void test_LockFreeQueueKeepsSenderOrder()
+	{
+		checkSenderOrder<LockFreeMessageQueue>();
+	}
+
+	void test_LockFreeQueueReleasesLeftOverMessages()
+	{
+		LockFreeMessageQueue* queue = new LockFreeMessageQueue();
+		queue->push(std::make_unique<WindDataMsg>(0, 0, 0));
+		queue->push(std::make_unique<WindDataMsg>(0, 0, 0));
+		TS_ASSERT(not queue->empty());
+		delete queue;
+	}
+
+	void test_WorkerPoolKeepsNodeOrder()
+	{
+		const int COUNT = 2000;
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		RecordingNode first(NodeID::HTTPSync, messageBus, 0);
+		RecordingNode second(NodeID::xBeeSync, messageBus, 0);
+		TS_ASSERT(messageBus.enableWorkerPool(3));
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			for(int i = 0; i < COUNT; i++)
+			{
+				messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+			}
+
+			for(int i = 0; i < WAIT_FOR_MESSAGE && second.m_Received < COUNT; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		TS_ASSERT_EQUALS(first.m_Speeds.size(), COUNT);
+		TS_ASSERT_EQUALS(second.m_Speeds.size(), COUNT);
+		for(int i = 0; i < COUNT && i < (int)first.m_Speeds.size(); i++)
+		{
+			TS_ASSERT_EQUALS(first.m_Speeds[i], i);
+			TS_ASSERT_EQUALS(second.m_Speeds[i], i);
+		}
+
+		std::vector<MessageBus::NodeStats> stats = messageBus.nodeStats();
+		TS_ASSERT_EQUALS(stats.size(), 2);
+		TS_ASSERT_EQUALS(stats[0].id, NodeID::HTTPSync);
+		TS_ASSERT_EQUALS(stats[0].messagesHandled, COUNT);
+		TS_ASSERT_EQUALS(stats[0].queueDepth, 0);
+	}
+
+	void test_SlowNodeDoesNotStallWorkerPool()
+	{
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		RecordingNode slowNode(NodeID::HTTPSync, messageBus, WAIT_FOR_MESSAGE);
+		bool registered = false;
+		MockNode node(messageBus, registered);
+		messageBus.enableWorkerPool(2);
+		MessageBusTestHelper helper(messageBus);
+
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 1, 0));
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 2, 0));
+
+		// The slow node was registered first, without the pool this would take 600ms
+		int elapsed = waitForMessage(node, WAIT_FOR_MESSAGE);
+		TS_ASSERT(node.m_MessageReceived);
+		TS_ASSERT(elapsed < WAIT_FOR_MESSAGE / 2);
+
+		std::vector<MessageBus::NodeStats> stats = messageBus.nodeStats();
+		TS_ASSERT_EQUALS(stats[0].id, NodeID::HTTPSync);
+		TS_ASSERT_EQUALS(stats[0].queueDepth, 1);
+
+		for(int i = 0; i < WAIT_FOR_MESSAGE * 3 && slowNode.m_Received < 2; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		stats = messageBus.nodeStats();
+		TS_ASSERT_EQUALS(stats[0].messagesHandled, 2);
+		TS_ASSERT(stats[0].handlerTimeMaxUs >= (uint64_t)WAIT_FOR_MESSAGE * 1000);
+		TS_ASSERT(stats[0].handlerTimeTotalUs >= 2 * (uint64_t)WAIT_FOR_MESSAGE * 1000);
+	}
+
+	void test_MessagePoolRecyclesMessages()
+	{
+		MessagePool<WindDataMsg>& pool = MessagePool<WindDataMsg>::instance();
+
+		MessagePtr msg = MessageBus::make<WindDataMsg>(1, 2, 3);
+		Message* address = msg.get();
+		msg.reset();
+
+		uint64_t hits = pool.hits();
+		uint64_t misses = pool.misses();
+		msg = MessageBus::make<WindDataMsg>(4, 5, 6);
+		TS_ASSERT_EQUALS(msg.get(), address);
+		TS_ASSERT_EQUALS(pool.hits(), hits + 1);
+		TS_ASSERT_EQUALS(pool.misses(), misses);
+		TS_ASSERT_EQUALS(static_cast<WindDataMsg*>(msg.get())->windSpeed(), 5);
+
+		uint64_t totalHits, totalMisses;
+		MessagePoolBase::totals(totalHits, totalMisses);
+		TS_ASSERT(totalHits >= pool.hits());
+
+		// Messages from the heap still go back to the heap
+		MessagePtr heapMsg = std::make_unique<WindDataMsg>(0, 0, 0);
+		TS_ASSERT(heapMsg->m_Recycle == NULL);
+	}
+
+	void test_PooledMessagesThroughWorkerPool()
+	{
+		const int COUNT = 500;
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		RecordingNode first(NodeID::HTTPSync, messageBus, 0);
+		RecordingNode second(NodeID::xBeeSync, messageBus, 0);
+		messageBus.enableWorkerPool(2);
+		uint64_t misses = MessagePool<WindDataMsg>::instance().misses();
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			for(int i = 0; i < COUNT; i++)
+			{
+				messageBus.sendMessage(MessageBus::make<WindDataMsg>(0, i, 0));
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+
+			for(int i = 0; i < WAIT_FOR_MESSAGE && second.m_Received < COUNT; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		TS_ASSERT_EQUALS(first.m_Received.load(), COUNT);
+		TS_ASSERT_EQUALS(second.m_Received.load(), COUNT);
+
+		// The messages are freed on the workers, they should still find their way back
+		TS_ASSERT(MessagePool<WindDataMsg>::instance().misses() - misses < COUNT / 2);
+	}
+
+	void test_MessageTraceWritesRecords()
+	{
+		const char* TRACE_FILE = "./MessageBusSuite.trace";
+		MessageTrace trace;
+		MessageTraceRecord record = {};
+		record.kind = static_cast<uint8_t>(MessageTraceKind::Consumed);
+
+		// Not started yet, the record is ignored
+		trace.record(record);
+
+		TS_ASSERT(trace.start(TRACE_FILE));
+		for(int i = 0; i < 3; i++)
+		{
+			record.time = i;
+			record.consumer = static_cast<uint8_t>(NodeID::HTTPSync);
+			trace.record(record);
+		}
+		trace.stop();
+		TS_ASSERT_EQUALS(trace.written(), 3);
+		TS_ASSERT_EQUALS(trace.dropped(), 0);
+
+		FILE* file = fopen(TRACE_FILE, "rb");
+		TS_ASSERT(file != NULL);
+		if(file == NULL)
+		{
+			return;
+		}
+
+		MessageTraceHeader header;
+		TS_ASSERT_EQUALS(fread(&header, sizeof(header), 1, file), 1);
+		TS_ASSERT_EQUALS(header.version, MESSAGE_TRACE_VERSION);
+		TS_ASSERT_EQUALS(header.recordSize, sizeof(MessageTraceRecord));
+
+		// The writer puts a clock sync in front of each batch
+		int syncs = 0;
+		int consumed = 0;
+		while(fread(&record, sizeof(record), 1, file) == 1)
+		{
+			if(record.kind == static_cast<uint8_t>(MessageTraceKind::ClockSync))
+			{
+				syncs++;
+			}
+			else
+			{
+				TS_ASSERT_EQUALS(record.time, consumed);
+				TS_ASSERT_EQUALS(record.consumer, static_cast<uint8_t>(NodeID::HTTPSync));
+				consumed++;
+			}
+		}
+		fclose(file);
+		remove(TRACE_FILE);
+
+		TS_ASSERT(syncs >= 1);
+		TS_ASSERT_EQUALS(consumed, 3);
+	}
+
+	void test_MessageTraceDropsWhenFull()
+	{
+		MessageTrace trace;
+		MessageTraceRecord record = {};
+		TS_ASSERT(trace.start("./MessageBusSuite.trace"));
+
+		// The writer only wakes up every WRITE_INTERVAL_MS, this fills the ring before that
+		for(uint64_t i = 0; i < MessageTrace::CAPACITY + 10; i++)
+		{
+			trace.record(record);
+		}
+		TS_ASSERT(trace.dropped() > 0);
+
+		trace.stop();
+		TS_ASSERT_EQUALS(trace.written() + trace.dropped(), MessageTrace::CAPACITY + 10);
+		remove("./MessageBusSuite.trace");
+	}
+
+	void test_StatisticsSnapshot()
+	{
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		bool registered = false;
+		MockNode node(messageBus, registered);
+
+		// Queued before the bus runs so they are all picked up at once
+		for(int i = 0; i < 3; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+		}
+		messageBus.sendMessage(std::make_unique<CompassDataMsg>(0, 0, 0));
+		messageBus.sendMessage(std::make_unique<Message>(MessageType::DataCollectionStop));
+
+		MessageBus::Stats stats = messageBus.statistics();
+		TS_ASSERT_EQUALS(stats.published.size(), MESSAGE_TYPE_COUNT);
+		TS_ASSERT_EQUALS(stats.published[static_cast<int>(MessageType::WindData)], 3);
+		TS_ASSERT_EQUALS(stats.latencyCount, 0);
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			waitForMessage(node, WAIT_FOR_MESSAGE);
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			stats = messageBus.statistics();
+		}
+
+		TS_ASSERT_EQUALS(stats.published[static_cast<int>(MessageType::WindData)], 3);
+		TS_ASSERT_EQUALS(stats.published[static_cast<int>(MessageType::CompassData)], 1);
+		TS_ASSERT_EQUALS(stats.published[static_cast<int>(MessageType::DataCollectionStop)], 1);
+		TS_ASSERT_EQUALS(stats.frontQueueHighWater, 5);
+		TS_ASSERT_EQUALS(stats.backQueueHighWater, 5);
+		TS_ASSERT_EQUALS(stats.latencyCount, 5);
+		TS_ASSERT(stats.latencyP50Us <= stats.latencyMaxUs);
+
+		// The mock node isn't subscribed to DataCollectionStop
+		TS_ASSERT_EQUALS(stats.nodes.size(), 1);
+		TS_ASSERT_EQUALS(stats.nodes[0].id, NodeID::MessageLogger);
+		TS_ASSERT_EQUALS(stats.nodes[0].messagesHandled, 4);
+	}
+
+	void test_StatisticsIntervalWakesBus()
+	{
+		MessageBus messageBus;
+		bool registered = false;
+		MockNode node(messageBus, registered);
+		messageBus.setStatisticsInterval(1);
+		MessageBusTestHelper helper(messageBus);
+
+		// The bus still sleeps between dumps and wakes up for messages
+		std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_FOR_MESSAGE));
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+		waitForMessage(node, WAIT_FOR_MESSAGE);
+		TS_ASSERT(node.m_MessageReceived);
+
+		messageBus.setStatisticsInterval(0);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Queues count messages of the normal type and then one of the urgent type before
+	/// the bus runs, returns the order the node got them in.
+	///----------------------------------------------------------------------------------
+	std::vector<MessageType> runBurst(MessageBus& messageBus, TypeRecordingNode& node, int count,
+		MessagePtr urgent)
+	{
+		messageBus.setConflation(MessageType::WindData, false);
+		for(int i = 0; i < count; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+		}
+		messageBus.sendMessage(std::move(urgent));
+
+		MessageBusTestHelper helper(messageBus);
+		for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < count + 1; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return node.m_Types;
+	}
+
+	void test_HighPriorityLaneGoesFirst()
+	{
+		const int COUNT = 100;
+		MessageBus messageBus;
+		TypeRecordingNode node(messageBus);
+		TS_ASSERT_EQUALS(messageBus.priority(MessageType::RudderCommand), MessagePriority::High);
+		TS_ASSERT_EQUALS(messageBus.priority(MessageType::WindData), MessagePriority::Normal);
+
+		std::vector<MessageType> types = runBurst(messageBus, node, COUNT,
+			std::make_unique<RudderCommandMsg>(0.1));
+
+		TS_ASSERT_EQUALS(types.size(), COUNT + 1);
+		TS_ASSERT_EQUALS(types.front(), MessageType::RudderCommand);
+		TS_ASSERT_EQUALS(messageBus.laneLatency(MessagePriority::High).count(), 1);
+		TS_ASSERT_EQUALS(messageBus.laneLatency(MessagePriority::Normal).count(), COUNT);
+
+		MessageBus::Stats stats = messageBus.statistics();
+		TS_ASSERT(stats.laneLatencyMaxUs[static_cast<int>(MessagePriority::High)] <=
+			stats.laneLatencyMaxUs[static_cast<int>(MessagePriority::Normal)]);
+	}
+
+	void test_PriorityMappingIsConfigurable()
+	{
+		const int COUNT = 20;
+		MessageBus messageBus;
+		TypeRecordingNode node(messageBus);
+		TS_ASSERT(messageBus.setPriority(MessageType::RudderCommand, MessagePriority::Normal));
+		TS_ASSERT(messageBus.setPriority(MessageType::CompassData, MessagePriority::High));
+
+		std::vector<MessageType> types = runBurst(messageBus, node, COUNT,
+			std::make_unique<CompassDataMsg>(0, 0, 0));
+		TS_ASSERT_EQUALS(types.size(), COUNT + 1);
+		TS_ASSERT_EQUALS(types.front(), MessageType::CompassData);
+	}
+
+	void test_NormalLaneKeepsOrderWithoutPriorities()
+	{
+		const int COUNT = 20;
+		MessageBus messageBus;
+		TypeRecordingNode node(messageBus);
+		TS_ASSERT(messageBus.setPriority(MessageType::RudderCommand, MessagePriority::Normal));
+
+		std::vector<MessageType> types = runBurst(messageBus, node, COUNT,
+			std::make_unique<RudderCommandMsg>(0.1));
+		TS_ASSERT_EQUALS(types.size(), COUNT + 1);
+		TS_ASSERT_EQUALS(types.back(), MessageType::RudderCommand);
+	}
+
+	void test_ConflationKeepsNewestValue()
+	{
+		MessageBus messageBus;
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+		TS_ASSERT(messageBus.conflates(MessageType::WindData));
+		TS_ASSERT(not messageBus.conflates(MessageType::RudderCommand));
+
+		// Queued before the bus runs, as if the bus had stalled
+		for(int i = 0; i < 10; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+		}
+		// A different source is a different value
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(NodeID::None, NodeID::WindSensor, 0, 100, 0));
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < 2; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+
+		TS_ASSERT_EQUALS(node.m_Speeds.size(), 2);
+		if(node.m_Speeds.size() == 2)
+		{
+			TS_ASSERT_EQUALS(node.m_Speeds[0], 9);
+			TS_ASSERT_EQUALS(node.m_Speeds[1], 100);
+		}
+		TS_ASSERT_EQUALS(messageBus.statistics().conflated[static_cast<int>(MessageType::WindData)], 9);
+	}
+
+	void test_ConflationInMailbox()
+	{
+		MessageBus messageBus;
+		RecordingNode slowNode(NodeID::HTTPSync, messageBus, 100);
+		messageBus.enableWorkerPool(1);
+		MessageBusTestHelper helper(messageBus);
+
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		// The node is busy with the first message, these pile up in its mailbox
+		for(int i = 1; i <= 10; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		TS_ASSERT(messageBus.nodeStats()[0].queueDepth <= 1);
+
+		for(int i = 0; i < WAIT_FOR_MESSAGE && slowNode.m_Received < 2; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+		TS_ASSERT_EQUALS(slowNode.m_Received.load(), 2);
+		TS_ASSERT_EQUALS(messageBus.statistics().conflated[static_cast<int>(MessageType::WindData)], 9);
+	}
+
+	void test_BlackboardKeepsLatestState()
+	{
+		MessageBus messageBus;
+		StateMessage::Snapshot vessel = {};
+		TS_ASSERT(not messageBus.blackboard().read(MessageType::StateMessage, vessel));
+
+		messageBus.sendMessage(std::make_unique<StateMessage>(10, 60.1, 19.9, 2, 20));
+		messageBus.sendMessage(std::make_unique<StateMessage>(11, 60.2, 19.8, 3, 30));
+
+		TS_ASSERT(messageBus.blackboard().read(MessageType::StateMessage, vessel));
+		TS_ASSERT_EQUALS(vessel.heading, 11);
+		TS_ASSERT_EQUALS(vessel.latitude, 60.2);
+		TS_ASSERT_EQUALS(vessel.longitude, 19.8);
+		TS_ASSERT_EQUALS(vessel.speed, 3);
+		TS_ASSERT_EQUALS(vessel.course, 30);
+		TS_ASSERT_EQUALS(messageBus.blackboard().version(MessageType::StateMessage), 2);
+
+		// Only shared types go on the blackboard
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(1, 2, 3));
+		TS_ASSERT_EQUALS(messageBus.blackboard().version(MessageType::WindData), 0);
+	}
+
+	void test_BlackboardShareIsClosedWhileRunning()
+	{
+		MessageBus messageBus;
+		MessageBusTestHelper helper(messageBus);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		TS_ASSERT(not messageBus.share<StateMessage>(MessageType::StateMessage));
+	}
+
+	void test_BlackboardReadsAreConsistent()
+	{
+		struct Value {
+			uint64_t fields[6];
+		};
+
+		Blackboard blackboard;
+		std::atomic<bool> done(false);
+
+		std::thread writer([&]() {
+			for(uint64_t i = 1; i <= 20000; i++)
+			{
+				Value value;
+				for(auto& field : value.fields) { field = i; }
+				blackboard.write(MessageType::StateMessage, value);
+			}
+			done.store(true);
+		});
+
+		int torn = 0;
+		uint64_t last = 0;
+		bool backwards = false;
+		while(not done.load())
+		{
+			Value value = {};
+			if(blackboard.read(MessageType::StateMessage, value))
+			{
+				for(auto field : value.fields)
+				{
+					if(field != value.fields[0]) { torn++; }
+				}
+				backwards = backwards || value.fields[0] < last;
+				last = value.fields[0];
+			}
+		}
+		writer.join();
+
+		Value value = {};
+		TS_ASSERT(blackboard.read(MessageType::StateMessage, value));
+		TS_ASSERT_EQUALS(value.fields[5], 20000);
+		TS_ASSERT_EQUALS(torn, 0);
+		TS_ASSERT(not backwards);
+		TS_ASSERT_EQUALS(blackboard.version(MessageType::StateMessage), 20000);
+	}
+
+	void test_MessageFactoryRebuildsMessages()
+	{
+		StateMessage msg(NodeID::None, NodeID::StateEstimation, 10, 60.1, 19.9, 2, 20);
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+
+		MessagePtr copy = MessageFactory::deserialise(serialiser.data(), serialiser.size());
+		TS_ASSERT(copy != NULL);
+		if(copy != NULL)
+		{
+			TS_ASSERT_EQUALS(copy->messageType(), MessageType::StateMessage);
+			TS_ASSERT_EQUALS(copy->sourceID(), NodeID::StateEstimation);
+			TS_ASSERT_EQUALS(static_cast<StateMessage*>(copy.get())->latitude(), 60.1);
+		}
+
+		// Cut short
+		TS_ASSERT(MessageFactory::deserialise(serialiser.data(), serialiser.size() - 1) == NULL);
+
+		uint8_t unknownType[3] = { 200, 0, 0 };
+		TS_ASSERT(MessageFactory::deserialise(unknownType, sizeof(unknownType)) == NULL);
+	}
+
+	void test_RecordAndReplay()
+	{
+		const char* RECORDING_FILE = "./MessageBusSuite.rec";
+		{
+			MessageBus messageBus;
+			messageBus.setConflation(MessageType::WindData, false);
+			RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+			TS_ASSERT(messageBus.startRecording(RECORDING_FILE));
+			MessageBusTestHelper helper(messageBus);
+
+			for(int i = 0; i < 20; i++)
+			{
+				messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+			}
+			messageBus.sendMessage(std::make_unique<RudderCommandMsg>(5));
+
+			for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < 20; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			TS_ASSERT(not messageBus.startRecording(RECORDING_FILE));
+		}
+
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+		MessageBusTestHelper helper(messageBus);
+
+		MessageReplay replay(messageBus);
+		TS_ASSERT(replay.open(RECORDING_FILE));
+		replay.play(MessageReplay::AS_FAST_AS_POSSIBLE);
+		remove(RECORDING_FILE);
+
+		TS_ASSERT_EQUALS(replay.played(), 21);
+		TS_ASSERT_EQUALS(replay.skipped(), 0);
+		TS_ASSERT_EQUALS(messageBus.pendingMessages(), 0);
+		TS_ASSERT_EQUALS(node.m_Speeds.size(), 20);
+		for(size_t i = 0; i < node.m_Speeds.size(); i++)
+		{
+			TS_ASSERT_EQUALS(node.m_Speeds[i], i);
+		}
+	}
+
+	void test_ReplayKeepsRecordedPace()
+	{
+		const char* RECORDING_FILE = "./MessageBusSuite.rec";
+		MessageRecorder recorder;
+		TS_ASSERT(recorder.open(RECORDING_FILE));
+		for(int i = 0; i < 5; i++)
+		{
+			WindDataMsg msg(0, i, 0);
+			recorder.record(msg, i * 50000);
+		}
+		recorder.close();
+		TS_ASSERT_EQUALS(recorder.recorded(), 5);
+
+		MessageBus messageBus;
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+		MessageBusTestHelper helper(messageBus);
+
+		// 200 ms recorded, played twice as fast
+		MessageReplay replay(messageBus);
+		TS_ASSERT(replay.open(RECORDING_FILE));
+		auto start = std::chrono::steady_clock::now();
+		replay.play(2);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+		remove(RECORDING_FILE);
+
+		TS_ASSERT_EQUALS(node.m_Received.load(), 5);
+		TS_ASSERT(elapsed >= 95);
+		TS_ASSERT(elapsed < 180);
+	}
+
+	void test_SimulatedTimeSleepsWithoutWaiting()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		uint64_t start = SysClock::monotonicMicros();
+		unsigned long unixStart = SysClock::unixTime();
+		auto realStart = std::chrono::steady_clock::now();
+
+		SysClock::sleepFor(std::chrono::seconds(60));
+
+		auto realElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - realStart).count();
+		TS_ASSERT_EQUALS(SysClock::monotonicMicros() - start, 60000000);
+		TS_ASSERT_EQUALS(SysClock::unixTime() - unixStart, 60);
+		TS_ASSERT(realElapsed < 100);
+
+		clock.advance(1500);
+		TS_ASSERT_EQUALS(SysClock::monotonicMicros() - start, 60001500);
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_SimulatedTimeRunsNodeLoops()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		clock.addIdleCheck([&messageBus]() { return messageBus.pendingMessages() == 0; });
+
+		// Slow enough that the time would run away from it without the idle check
+		RecordingNode receiver(NodeID::HTTPSync, messageBus, 2);
+		TickingNode node(messageBus, 40);
+		MessageBusTestHelper helper(messageBus);
+
+		auto realStart = std::chrono::steady_clock::now();
+		node.start();
+		TS_ASSERT_EQUALS(clock.attachedThreads(), 1);
+		node.join();
+
+		auto realElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - realStart).count();
+
+		// 20 s of node loops
+		TS_ASSERT_EQUALS(node.m_SendTimes.size(), 40);
+		TS_ASSERT_EQUALS(node.m_SendTimes.back() - node.m_SendTimes.front(), 19500000);
+		TS_ASSERT(realElapsed < 5000);
+		TS_ASSERT_EQUALS(clock.attachedThreads(), 0);
+
+		// Every message was handled before the time moved on
+		while(receiver.m_Received.load() < 40)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		for(size_t i = 0; i < receiver.m_Times.size(); i++)
+		{
+			TS_ASSERT_EQUALS(receiver.m_Times[i], node.m_SendTimes[i]);
+		}
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_ReplayOnSimulatedTime()
+	{
+		const char* RECORDING_FILE = "./MessageBusSuite.rec";
+		MessageRecorder recorder;
+		TS_ASSERT(recorder.open(RECORDING_FILE));
+		for(int i = 0; i < 5; i++)
+		{
+			WindDataMsg msg(0, i, 0);
+			recorder.record(msg, i * 60000000ULL);
+		}
+		recorder.close();
+
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		MessageBus messageBus;
+		clock.addIdleCheck([&messageBus]() { return messageBus.pendingMessages() == 0; });
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+		MessageBusTestHelper helper(messageBus);
+
+		// Four minutes recorded, played in real time
+		MessageReplay replay(messageBus);
+		TS_ASSERT(replay.open(RECORDING_FILE));
+		auto realStart = std::chrono::steady_clock::now();
+		uint64_t start = SysClock::monotonicMicros();
+		replay.play(1);
+		auto realElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - realStart).count();
+		remove(RECORDING_FILE);
+
+		TS_ASSERT_EQUALS(node.m_Received.load(), 5);
+		TS_ASSERT_EQUALS(SysClock::monotonicMicros() - start, 240000000);
+		for(size_t i = 0; i < node.m_Times.size(); i++)
+		{
+			TS_ASSERT_EQUALS(node.m_Times[i] - start, i * 60000000ULL);
+		}
+		TS_ASSERT(realElapsed < 1000);
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_TickSchedulerKeepsAbsoluteDeadlines()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		std::vector<uint64_t> starts;
+		uint64_t first;
+		{
+			TickScheduler scheduler;
+			first = SysClock::monotonicMicros() + 100000;
+
+			// Each tick takes 30 ms, a relative sleep would add that to every period
+			int tickId = scheduler.schedule(NodeID::SailingLogic, [&]() {
+				starts.push_back(SysClock::monotonicMicros());
+				clock.advance(30000);
+			}, 100000, 100000);
+
+			SysClock::sleepFor(std::chrono::milliseconds(5050));
+			scheduler.cancel(tickId);
+			TS_ASSERT(scheduler.statistics().empty());
+		}
+
+		TS_ASSERT_EQUALS(starts.size(), 50);
+		for(size_t i = 0; i < starts.size(); i++)
+		{
+			// Ticks start on the first wheel slot after their deadline
+			TS_ASSERT(starts[i] >= first + i * 100000);
+			TS_ASSERT(starts[i] < first + i * 100000 + 10000);
+		}
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_TickSchedulerCountsOverruns()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		TickScheduler scheduler;
+		TS_ASSERT(scheduler.setThreads(1));
+		std::atomic<int> ticks(0);
+
+		// The first five ticks take two and a half periods, the later ones no time
+		int tickId = scheduler.schedule(NodeID::SailingLogic, [&]() {
+			if(ticks.load() < 5)
+			{
+				clock.advance(250000);
+			}
+			ticks++;
+		}, 100000, 0);
+		TS_ASSERT(not scheduler.setThreads(2));
+
+		SysClock::sleepFor(std::chrono::seconds(2));
+		std::vector<TickScheduler::TickStats> stats = scheduler.statistics();
+		scheduler.cancel(tickId);
+
+		TS_ASSERT_EQUALS(stats.size(), 1);
+		TS_ASSERT_EQUALS(stats[0].id, NodeID::SailingLogic);
+		TS_ASSERT_EQUALS(stats[0].periodUs, 100000);
+		TS_ASSERT(stats[0].ticks > 5);
+		TS_ASSERT_EQUALS(stats[0].overruns, 5);
+		TS_ASSERT(stats[0].skipped >= 5);
+		TS_ASSERT_EQUALS(stats[0].durationMaxUs, 250000);
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_PeriodicNodeRunsOnTickScheduler()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		clock.addIdleCheck([&messageBus]() { return messageBus.pendingMessages() == 0; });
+		RecordingNode receiver(NodeID::HTTPSync, messageBus, 0);
+		MessageBusTestHelper helper(messageBus);
+
+		// 2 s initial delay then a tick every 0.5 s
+		PeriodicNode node(messageBus);
+		node.start();
+		SysClock::sleepFor(std::chrono::milliseconds(6900));
+		node.stop();
+		int ticks = node.m_Ticks.load();
+		SysClock::sleepFor(std::chrono::seconds(2));
+
+		TS_ASSERT_EQUALS(ticks, 10);
+		TS_ASSERT_EQUALS(node.m_Ticks.load(), 10);
+		TS_ASSERT_EQUALS(receiver.m_Received.load(), 10);
+		TS_ASSERT(messageBus.statistics().ticks.empty());
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_DeadlineTimerKeepsAbsoluteDeadlines()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		DeadlineTimer timer;
+		timer.start(0.1);
+		uint64_t first = SysClock::monotonicMicros() + 100000;
+
+		// Each loop takes 30 ms, a relative sleep would add that to every period
+		std::vector<uint64_t> starts;
+		for(int i = 0; i < 20; i++)
+		{
+			timer.sleepUntilNextDeadline();
+			starts.push_back(SysClock::monotonicMicros());
+			clock.advance(30000);
+		}
+
+		for(size_t i = 0; i < starts.size(); i++)
+		{
+			TS_ASSERT_EQUALS(starts[i], first + i * 100000);
+		}
+		TS_ASSERT_EQUALS(timer.jitter().count(), 20);
+		TS_ASSERT_EQUALS(timer.jitter().max(), 0);
+		TS_ASSERT_EQUALS(timer.missed().count(), 0);
+		TS_ASSERT_EQUALS(timer.skipped(), 0);
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_DeadlineTimerCountsMissedDeadlines()
+	{
+		SimulatedTimeSource clock;
+		SysClock::setTimeSource(&clock);
+
+		MessageBus messageBus;
+		DeadlineTimer timer;
+		messageBus.addControlLoop(NodeID::CourseRegulatorNode, timer);
+		timer.start(0.1);
+
+		// Takes two and a half periods
+		for(int i = 0; i < 5; i++)
+		{
+			clock.advance(250000);
+			timer.sleepUntilNextDeadline();
+		}
+
+		std::vector<MessageBus::LoopStats> loops = messageBus.statistics().loops;
+		TS_ASSERT_EQUALS(loops.size(), 1);
+		TS_ASSERT_EQUALS(loops[0].id, NodeID::CourseRegulatorNode);
+		TS_ASSERT_EQUALS(loops[0].periodUs, 100000);
+		TS_ASSERT_EQUALS(loops[0].loops, 5);
+		TS_ASSERT_EQUALS(loops[0].missed, 5);
+		TS_ASSERT_EQUALS(loops[0].missedByMaxUs, 200000);
+		TS_ASSERT_EQUALS(loops[0].skipped, 7);
+		TS_ASSERT(loops[0].jitterMaxUs < 100000);
+
+		messageBus.removeControlLoop(timer);
+		TS_ASSERT(messageBus.statistics().loops.empty());
+
+		SysClock::setTimeSource(NULL);
+	}
+
+	void test_ReservedMessagesComeFromThePool()
+	{
+		MessageBus::reserve<WingSailCommandMsg>(MessagePool<WingSailCommandMsg>::BATCH_SIZE);
+		MessagePool<WingSailCommandMsg>& pool = MessagePool<WingSailCommandMsg>::instance();
+		uint64_t misses = pool.misses();
+
+		// A new thread starts with an empty cache, as a control loop does
+		std::thread loop([]() {
+			for(size_t i = 0; i < MessagePool<WingSailCommandMsg>::BATCH_SIZE; i++)
+			{
+				MessagePtr msg = MessageBus::make<WingSailCommandMsg>(1.0f);
+			}
+		});
+		loop.join();
+
+		TS_ASSERT_EQUALS(pool.misses(), misses);
+	}
+
+	void test_RealTimeProfilePinsThread()
+	{
+		Logger::DisableLogging();
+		TS_ASSERT(not RealTimeProfile().enabled());
+
+		RealTimeProfile profile;
+		profile.cpu = 0;
+		TS_ASSERT(profile.enabled());
+
+		int cpu = -1;
+		bool applied = false;
+		std::thread loop([&]() {
+			applied = RealTime::applyToThisThread(profile, "test");
+			cpu = sched_getcpu();
+		});
+		loop.join();
+
+		TS_ASSERT(applied);
+		TS_ASSERT_EQUALS(cpu, 0);
+	}
+
+	///----------------------------------------------------------------------------------
+	/// Sends a broadcast wind, compass and rudder message and a compass message directed
+	/// at the typed node, and checks each went to the right handler.
+	///----------------------------------------------------------------------------------
+	void checkTypedHandlers(unsigned int workers)
+	{
+		MessageBus messageBus;
+		TypedNode node(messageBus);
+		if(workers > 0)
+		{
+			messageBus.enableWorkerPool(workers);
+		}
+		MessageBusTestHelper helper(messageBus);
+
+		messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 7, 0));
+		messageBus.sendMessage(std::make_unique<CompassDataMsg>(90, 0, 0));
+		messageBus.sendMessage(std::make_unique<RudderCommandMsg>(10));
+		messageBus.sendMessage(std::make_unique<CompassDataMsg>(NodeID::SailingLogic, NodeID::None, 180, 0, 0));
+
+		for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < 4; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		TS_ASSERT_EQUALS(node.m_Received.load(), 4);
+		TS_ASSERT_EQUALS(node.m_WindSpeeds.size(), 1);
+		TS_ASSERT_EQUALS(node.m_WindSpeeds[0], 7);
+		TS_ASSERT_EQUALS(node.m_Headings.size(), 2);
+		TS_ASSERT_EQUALS(node.m_Headings[0], 90);
+		TS_ASSERT_EQUALS(node.m_Headings[1], 180);
+		TS_ASSERT_EQUALS(node.m_Others.size(), 1);
+		TS_ASSERT_EQUALS(node.m_Others[0], MessageType::RudderCommand);
+		TS_ASSERT_EQUALS(messageBus.nodeStats()[0].messagesHandled, 4);
+	}
+
+	void test_TypedHandlersGetTheirMessages()
+	{
+		checkTypedHandlers(0);
+	}
+
+	void test_TypedHandlersOnWorkerPool()
+	{
+		checkTypedHandlers(2);
+	}
+
+	void test_SubscribeAfterRunFails()
+	{
+		MessageBus messageBus;
+		TypeRecordingNode other(messageBus);
+		MessageBusTestHelper helper(messageBus);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		TypedNode node(messageBus);
+		TS_ASSERT(not messageBus.subscribe(node, &TypedNode::processWindData));
+	}
+
+	void test_SharedMemoryRingWrapsAndDrops()
+	{
+		const char* RING_NAME = "/MessageBusSuite.ring";
+		SharedMemoryRing writer;
+		SharedMemoryRing reader;
+		TS_ASSERT(not reader.open(RING_NAME));
+		TS_ASSERT(writer.create(RING_NAME, 4096));
+		TS_ASSERT(reader.open(RING_NAME));
+
+		// 224 bytes a record, 18 fit and leave 64 bytes before the end
+		uint8_t data[200] = {};
+		int written = 0;
+		for(int i = 0; i < 19; i++)
+		{
+			data[0] = i;
+			written += writer.write(data, sizeof(data), 1000 + i);
+		}
+		TS_ASSERT_EQUALS(written, 18);
+		TS_ASSERT_EQUALS(reader.dropped(), 1);
+
+		uint8_t buffer[256];
+		uint32_t size;
+		uint64_t time;
+		for(int i = 0; i < 2; i++)
+		{
+			TS_ASSERT(reader.read(buffer, sizeof(buffer), size, time));
+			TS_ASSERT_EQUALS(buffer[0], i);
+		}
+
+		// Goes to the start of the buffer behind a padding record
+		data[0] = 18;
+		TS_ASSERT(writer.write(data, sizeof(data), 1018));
+		TS_ASSERT(not writer.write(data, 3000, 0));
+		TS_ASSERT_EQUALS(writer.dropped(), 2);
+
+		for(int i = 2; i < 19; i++)
+		{
+			TS_ASSERT(reader.read(buffer, sizeof(buffer), size, time));
+			TS_ASSERT_EQUALS(size, sizeof(data));
+			TS_ASSERT_EQUALS(buffer[0], i);
+			TS_ASSERT_EQUALS(time, 1000 + i);
+		}
+		TS_ASSERT(not reader.read(buffer, sizeof(buffer), size, time));
+		TS_ASSERT_EQUALS(reader.used(), 0);
+
+		writer.close();
+		SharedMemoryRing other;
+		TS_ASSERT(not other.open(RING_NAME));
+	}
+
+	void test_BridgeMirrorsMessages()
+	{
+		MessageBus parentBus;
+		MessageBus childBus;
+		parentBus.setConflation(MessageType::WindData, false);
+		childBus.setConflation(MessageType::WindData, false);
+
+		BridgeNode parent(parentBus, "MessageBusSuite", BridgeNode::Side::Parent, { MessageType::WindData });
+		BridgeNode child(childBus, "MessageBusSuite", BridgeNode::Side::Child, { MessageType::RudderCommand });
+		TS_ASSERT(parent.init());
+		TS_ASSERT(child.init());
+
+		TypeRecordingNode parentNode(parentBus);
+		TypeRecordingNode childNode(childBus);
+		MessageBusTestHelper parentHelper(parentBus);
+		MessageBusTestHelper childHelper(childBus);
+		parent.start();
+		child.start();
+
+		for(int i = 0; i < 20; i++)
+		{
+			parentBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+		}
+		childBus.sendMessage(std::make_unique<RudderCommandMsg>(10));
+
+		for(int i = 0; i < WAIT_FOR_MESSAGE && (childNode.m_Received < 21 || parentNode.m_Received < 21); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		// Both buses also have the message sent on them
+		TS_ASSERT_EQUALS(childNode.m_Received.load(), 21);
+		TS_ASSERT_EQUALS(parentNode.m_Received.load(), 21);
+		// The mirrored message can arrive in between the ones sent on the parent bus
+		TS_ASSERT_EQUALS(std::count(parentNode.m_Types.begin(), parentNode.m_Types.end(), MessageType::RudderCommand), 1);
+
+		// A mirrored type coming back and a message that isn't one are not sent on
+		SharedMemoryRing up;
+		TS_ASSERT(up.open("/MessageBusSuite.up"));
+		WindDataMsg wind(0, 1, 0);
+		MessageSerialiser serialiser;
+		wind.Serialise(serialiser);
+		uint8_t garbage[3] = { 200, 0, 0 };
+		up.write(serialiser.data(), serialiser.size(), 0);
+		up.write(garbage, sizeof(garbage), 0);
+
+		for(int i = 0; i < WAIT_FOR_MESSAGE && parent.statistics().rejected < 2; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		child.stop();
+		parent.stop();
+
+		BridgeNode::BridgeStats parentStats = parent.statistics();
+		BridgeNode::BridgeStats childStats = child.statistics();
+		TS_ASSERT_EQUALS(parentStats.sent, 20);
+		TS_ASSERT_EQUALS(parentStats.dropped, 0);
+		TS_ASSERT_EQUALS(parentStats.received, 1);
+		TS_ASSERT_EQUALS(parentStats.rejected, 2);
+		TS_ASSERT_EQUALS(childStats.received, 20);
+		TS_ASSERT_EQUALS(childStats.sent, 1);
+		TS_ASSERT(childStats.latencyMaxUs > 0);
+		TS_ASSERT(childStats.latencyP50Us <= childStats.latencyP99Us);
+		TS_ASSERT_EQUALS(parentNode.m_Received.load(), 21);
+	}
+
+	void test_ReplayReadsVersion1Recordings()
+	{
+		const char* RECORDING_FILE = "./MessageBusSuite.rec";
+		FILE* file = fopen(RECORDING_FILE, "wb");
+		MessageRecordingHeader header;
+		memcpy(header.magic, MESSAGE_RECORDING_MAGIC, sizeof(header.magic));
+		header.version = 1;
+		header.reserved = 0;
+		fwrite(&header, sizeof(header), 1, file);
+
+		// Version 1 has a single byte size
+		WindDataMsg wind(0, 5, 0);
+		MessageSerialiser serialiser;
+		wind.Serialise(serialiser);
+		uint64_t time = 0;
+		uint8_t size = serialiser.size();
+		fwrite(&time, sizeof(time), 1, file);
+		fwrite(&size, sizeof(size), 1, file);
+		fwrite(serialiser.data(), size, 1, file);
+		fclose(file);
+
+		MessageBus messageBus;
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+		MessageBusTestHelper helper(messageBus);
+
+		MessageReplay replay(messageBus);
+		TS_ASSERT(replay.open(RECORDING_FILE));
+		replay.play(MessageReplay::AS_FAST_AS_POSSIBLE);
+		remove(RECORDING_FILE);
+
+		TS_ASSERT_EQUALS(replay.played(), 1);
+		TS_ASSERT_EQUALS(node.m_Speeds.size(), 1);
+	}
+
+	void test_ReplayRejectsOtherFiles()
+	{
+		const char* RECORDING_FILE = "./MessageBusSuite.rec";
+		FILE* file = fopen(RECORDING_FILE, "wb");
+		fputs("Not a recording", file);
+		fclose(file);
+
+		MessageBus messageBus;
+		MessageReplay replay(messageBus);
+		TS_ASSERT(not replay.open(RECORDING_FILE));
+		TS_ASSERT(not replay.open("./MessageBusSuite.missing"));
+		remove(RECORDING_FILE);
+	}
+
+	void test_QueueLimitDropsNewest()
+	{
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		TS_ASSERT(messageBus.setQueueLimit(MessageType::WindData, 5, OverflowPolicy::DropNewest));
+		TS_ASSERT_EQUALS(messageBus.queueLimit(MessageType::WindData), 5);
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+
+		// Nothing is taken out until the bus runs
+		for(int i = 0; i < 8; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+		}
+		TS_ASSERT(messageBus.isOverloaded(MessageType::WindData));
+		TS_ASSERT(messageBus.isOverloaded());
+		TS_ASSERT(not messageBus.isOverloaded(MessageType::CompassData));
+
+		MessageBus::Stats stats = messageBus.statistics();
+		TS_ASSERT_EQUALS(stats.published[static_cast<int>(MessageType::WindData)], 5);
+		TS_ASSERT_EQUALS(stats.dropped[static_cast<int>(MessageType::WindData)], 3);
+		TS_ASSERT_EQUALS(stats.overloaded.size(), 1);
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < 5; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			TS_ASSERT(not messageBus.setQueueLimit(MessageType::WindData, 0, OverflowPolicy::DropNewest));
+		}
+
+		TS_ASSERT_EQUALS(node.m_Speeds, std::vector<float>({ 0, 1, 2, 3, 4 }));
+		TS_ASSERT(not messageBus.isOverloaded());
+	}
+
+	void test_QueueLimitDropsOldest()
+	{
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		messageBus.setQueueLimit(MessageType::WindData, 5, OverflowPolicy::DropOldest);
+		RecordingNode node(NodeID::HTTPSync, messageBus, 0);
+
+		for(int i = 0; i < 8; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+		}
+		TS_ASSERT(messageBus.isOverloaded(MessageType::WindData));
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < 5; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		TS_ASSERT_EQUALS(node.m_Speeds, std::vector<float>({ 3, 4, 5, 6, 7 }));
+		TS_ASSERT_EQUALS(messageBus.statistics().dropped[static_cast<int>(MessageType::WindData)], 3);
+		TS_ASSERT_EQUALS(messageBus.pendingMessages(), 0);
+		TS_ASSERT(not messageBus.isOverloaded());
+
+		// While the bus is held up no more than twice the limit wait
+		for(int i = 0; i < 20; i++)
+		{
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+		}
+		TS_ASSERT_EQUALS(messageBus.pendingMessages(), 10);
+	}
+
+	void test_MailboxLimitDropsOldest()
+	{
+		const int COUNT = 10;
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		messageBus.setQueueLimit(MessageType::WindData, 3, OverflowPolicy::DropOldest);
+		RecordingNode slowNode(NodeID::HTTPSync, messageBus, 20);
+		RecordingNode node(NodeID::xBeeSync, messageBus, 0);
+		messageBus.enableWorkerPool(2);
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			for(int i = 0; i < COUNT; i++)
+			{
+				messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			for(int i = 0; i < WAIT_FOR_MESSAGE && (slowNode.m_Speeds.empty() ||
+				slowNode.m_Speeds.back() != COUNT - 1); i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		// The fast node kept up, the slow one got the first and the newest ones
+		TS_ASSERT_EQUALS(node.m_Speeds.size(), COUNT);
+		TS_ASSERT(slowNode.m_Speeds.size() < COUNT);
+		TS_ASSERT_EQUALS(slowNode.m_Speeds.back(), COUNT - 1);
+		for(size_t i = 1; i < slowNode.m_Speeds.size(); i++)
+		{
+			TS_ASSERT(slowNode.m_Speeds[i - 1] < slowNode.m_Speeds[i]);
+		}
+
+		std::vector<MessageBus::NodeStats> stats = messageBus.nodeStats();
+		TS_ASSERT_EQUALS(stats[0].id, NodeID::HTTPSync);
+		TS_ASSERT_EQUALS(stats[0].dropped, COUNT - slowNode.m_Speeds.size());
+		TS_ASSERT_EQUALS(stats[1].dropped, 0);
+		TS_ASSERT_EQUALS(messageBus.statistics().dropped[static_cast<int>(MessageType::WindData)],
+			COUNT - slowNode.m_Speeds.size());
+		TS_ASSERT(not messageBus.isOverloaded());
+	}
+
+	void test_QueueLimitBlocksSender()
+	{
+		const int COUNT = 6;
+		MessageBus messageBus;
+		messageBus.setConflation(MessageType::WindData, false);
+		messageBus.setQueueLimit(MessageType::WindData, 2, OverflowPolicy::Block);
+		RecordingNode node(NodeID::HTTPSync, messageBus, 50);
+
+		{
+			MessageBusTestHelper helper(messageBus);
+
+			// A sender only waits for a running bus
+			messageBus.sendMessage(std::make_unique<WindDataMsg>(0, 0, 0));
+			for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Received < 1; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			uint64_t start = SysClock::monotonicMicros();
+			for(int i = 1; i < COUNT; i++)
+			{
+				messageBus.sendMessage(std::make_unique<WindDataMsg>(0, i, 0));
+			}
+			uint64_t sent = SysClock::monotonicMicros();
+
+			// The node holds up the bus thread, so the sender had to wait for it
+			TS_ASSERT(sent - start >= 2 * 50 * 1000);
+
+			for(int i = 0; i < WAIT_FOR_MESSAGE * 2 && node.m_Received < COUNT; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		TS_ASSERT_EQUALS(node.m_Speeds, std::vector<float>({ 0, 1, 2, 3, 4, 5 }));
+		TS_ASSERT_EQUALS(messageBus.statistics().dropped[static_cast<int>(MessageType::WindData)], 0);
+	}
+
+	void test_MessagesCarryTheirCause()
+	{
+		const int DELAY_MS = 20;
+		MessageBus messageBus;
+		CausalChainNode node(messageBus, DELAY_MS);
+
+		MessagePtr wind = std::make_unique<WindDataMsg>(0, 5, 0);
+		TS_ASSERT_EQUALS(wind->messageID(), 0);
+		TS_ASSERT(not wind->cause().known());
+
+		{
+			MessageBusTestHelper helper(messageBus);
+			messageBus.sendMessage(std::move(wind));
+			for(int i = 0; i < WAIT_FOR_MESSAGE && node.m_Actuations < 1; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+		TS_ASSERT_EQUALS(node.m_Received.size(), 3);
+		if(node.m_Received.size() != 3)
+		{
+			return;
+		}
+
+		// Every message points at the one before and keeps the origin of the first
+		const MessageCause& windCause = node.m_Received[0];
+		const MessageCause& stateCause = node.m_Received[1];
+		const MessageCause& commandCause = node.m_Received[2];
+		TS_ASSERT(windCause.causeID != 0);
+		TS_ASSERT(windCause.known());
+		TS_ASSERT_EQUALS(windCause.chainLength, 1);
+		TS_ASSERT_EQUALS(stateCause.originTime, windCause.originTime);
+		TS_ASSERT_EQUALS(commandCause.originTime, windCause.originTime);
+		TS_ASSERT_EQUALS(commandCause.chainLength, 3);
+		TS_ASSERT_EQUALS(commandCause.chain[0], static_cast<uint8_t>(MessageType::WindData));
+		TS_ASSERT_EQUALS(commandCause.chain[1], static_cast<uint8_t>(MessageType::StateMessage));
+		TS_ASSERT_EQUALS(commandCause.chain[2], static_cast<uint8_t>(MessageType::RudderCommand));
+		TS_ASSERT(stateCause.causeID != windCause.causeID);
+
+		// The blackboard keeps the cause with the state
+		StateMessage::Snapshot vessel;
+		MessageCause vesselCause;
+		TS_ASSERT(messageBus.blackboard().read(MessageType::StateMessage, vessel, vesselCause));
+		TS_ASSERT_EQUALS(vesselCause.causeID, stateCause.causeID);
+		TS_ASSERT_EQUALS(vesselCause.originTime, windCause.originTime);
+		TS_ASSERT_EQUALS(vesselCause.chainLength, 2);
+
+		std::vector<CausalTracer::PathStats> paths = messageBus.causalTracer().statistics();
+		TS_ASSERT_EQUALS(paths.size(), 1);
+		if(paths.size() == 1)
+		{
+			TS_ASSERT_EQUALS(paths[0].path, "WindData > StateMessage > RudderCommand > " +
+				nodeToString(NodeID::RudderActuator));
+			TS_ASSERT_EQUALS(paths[0].count, 1);
+			TS_ASSERT(paths[0].latencyMaxUs >= DELAY_MS * 1000);
+		}
+		TS_ASSERT_EQUALS(messageBus.statistics().causalPaths.size(), 1);
+	}
+
+	void test_OldestCauseWins()
+	{
+		MessageCause unknown;
+		MessageCause early;
+		early.originTime = 100;
+		MessageCause late;
+		late.originTime = 200;
+
+		TS_ASSERT_EQUALS(MessageCause::oldest(early, late).originTime, 100);
+		TS_ASSERT_EQUALS(MessageCause::oldest(late, early).originTime, 100);
+		TS_ASSERT_EQUALS(MessageCause::oldest(unknown, late).originTime, 200);
+		TS_ASSERT_EQUALS(MessageCause::oldest(late, unknown).originTime, 200);
+	}
+};
@@ -34,6 +34,11 @@
 #include "Messages/LocalWaypointChangeMsg.h"
 #include "Messages/StateMessage.h"
 #include "Messages/AISDataMsg.h"
+#include "Messages/ObstacleVectorMsg.h"
+#include "Messages/ASPireActuatorFeedbackMsg.h"
+#include "AllocationCounter.h"
+#include "Messages/RequestCourseMsg.h"
+#include "MessageBus/MessageView.h"
 
 
 class MessageSuite : public CxxTest::TestSuite {
@@ -398,5 +403,249 @@ public:
 		TS_ASSERT_DELTA(msgTwo.longitude(2), 18.7f, 1e-7);
 		TS_ASSERT_EQUALS(msgTwo.COG(2), 80);
 		TS_ASSERT_EQUALS(msgTwo.SOG(2), 7);
+		TS_ASSERT_EQUALS(msgTwo.vesselList().size(), 3);
+		TS_ASSERT_EQUALS(msgTwo.vesselInfoList().size(), 1);
+		TS_ASSERT_EQUALS(msgTwo.vesselInfoList()[0].MMSI, 1);
+		TS_ASSERT_EQUALS(msgTwo.vesselInfoList()[0].length, 15);
+		TS_ASSERT_EQUALS(msgTwo.vesselInfoList()[0].beam, 4);
+		TS_ASSERT_DELTA(msgTwo.posLat(), 60.1f, 1e-7);
+		TS_ASSERT_DELTA(msgTwo.posLon(), 19.1f, 1e-7);
+
+		// Cut short
+		MessageDeserialiser shortDeserialiser(serialiser.data(), serialiser.size() - 1);
+		AISDataMsg msgThree(shortDeserialiser);
+		TS_ASSERT(not msgThree.isValid());
+	}
+
+	void test_AISDataMsgLargerThan256Bytes()
+	{
+		std::vector<AISVessel> AISList;
+		for(uint32_t i = 0; i < 40; i++)
+		{
+			AISVessel vessel = { i, 10.0f + i, 2.0f, 60.0 + i / 100.0, 19.0 };
+			AISList.push_back(vessel);
+		}
+		AISDataMsg msg(AISList, std::vector<AISVesselInfo>(), 60, 19);
+
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+		TS_ASSERT(serialiser.size() > 1000);
+
+		MessageDeserialiser deserialiser(serialiser.data(), serialiser.size());
+		AISDataMsg msgTwo(deserialiser);
+
+		TS_ASSERT(msgTwo.isValid());
+		TS_ASSERT_EQUALS(msgTwo.vesselList().size(), 40);
+		TS_ASSERT_EQUALS(msgTwo.MMSI(39), 39);
+		TS_ASSERT_EQUALS(msgTwo.COG(39), 49);
+		TS_ASSERT_EQUALS(msgTwo.latitude(39), 60.39);
+	}
+
+	void test_AISDataMsgSharesItsLists()
+	{
+		AISVessel vessel = { 1, 200, 10, 60.2, 19.1 };
+		AISVesselInfo info = { 1, 15, 4 };
+		std::vector<AISVessel> AISList(50, vessel);
+		std::vector<AISVesselInfo> AISInfo(20, info);
+		const AISVessel* vessels = AISList.data();
+
+		std::unique_ptr<AISDataMsg> msg;
+		unsigned long allocations;
+		{
+			AllocationCounter counter;
+			msg.reset(new AISDataMsg(std::move(AISList), std::move(AISInfo), 60.1, 19.1));
+			allocations = counter.allocations();
+		}
+
+		// The message and the two shared lists, the vessels themselves are not copied
+		TS_ASSERT_EQUALS(allocations, 3);
+		TS_ASSERT_EQUALS(msg->vesselList().data(), vessels);
+
+		// Any number of readers, and passing the lists on, don't allocate
+		double latitudes = 0;
+		{
+			AllocationCounter counter;
+			for(int reader = 0; reader < 5; reader++)
+			{
+				for(const AISVessel& v : msg->vesselList())
+				{
+					latitudes += v.latitude;
+				}
+				latitudes += msg->vesselInfoList().size();
+			}
+			AISDataMsg forwarded(NodeID::None, NodeID::AISProcessing, msg->sharedVesselList(),
+				msg->sharedVesselInfoList(), msg->posLat(), msg->posLon());
+			TS_ASSERT_EQUALS(forwarded.vesselList().data(), vessels);
+			allocations = counter.allocations();
+		}
+		TS_ASSERT_EQUALS(allocations, 0);
+		TS_ASSERT_DELTA(latitudes, 5 * (50 * 60.2 + 20), 1e-6);
+		TS_ASSERT_EQUALS(msg->sharedVesselList().use_count(), 1);
+	}
+
+	void test_SerialiserIsLittleEndian()
+	{
+		MessageSerialiser serialiser;
+		serialiser.serialise((uint16_t)0x0102);
+		serialiser.serialise((uint32_t)0x01020304);
+		serialiser.serialise(-2);
+		serialiser.serialise(1.0f);
+		serialiser.serialise(-2.0);
+
+		const uint8_t expected[] = { 0x02, 0x01, 0x04, 0x03, 0x02, 0x01, 0xFE, 0xFF, 0xFF, 0xFF,
+			0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0 };
+		TS_ASSERT_EQUALS(serialiser.size(), sizeof(expected));
+		TS_ASSERT_SAME_DATA(serialiser.data(), expected, sizeof(expected));
+
+		MessageDeserialiser deserialiser(serialiser.data(), serialiser.size());
+		uint16_t u16;
+		uint32_t u32;
+		int i;
+		float f;
+		double d;
+		TS_ASSERT(deserialiser.readUint16_t(u16) && deserialiser.readUint32_t(u32) && deserialiser.readInt(i));
+		TS_ASSERT(deserialiser.readFloat(f) && deserialiser.readDouble(d));
+		TS_ASSERT_EQUALS(u16, 0x0102);
+		TS_ASSERT_EQUALS(u32, 0x01020304);
+		TS_ASSERT_EQUALS(i, -2);
+		TS_ASSERT_EQUALS(f, 1.0f);
+		TS_ASSERT_EQUALS(d, -2.0);
+		TS_ASSERT_EQUALS(deserialiser.remaining(), 0);
+		TS_ASSERT(not deserialiser.readUint8_t(*(uint8_t*)&u16));
+	}
+
+	void test_SerialiserDropsWhatDoesNotFit()
+	{
+		uint8_t block[MAX_MESSAGE_SIZE] = {};
+		MessageSerialiser serialiser;
+		serialiser.serialise(block, MAX_MESSAGE_SIZE - 2);
+		serialiser.serialise((uint32_t)1);
+		TS_ASSERT_EQUALS(serialiser.size(), MAX_MESSAGE_SIZE - 2);
+		serialiser.serialise((uint16_t)1);
+		TS_ASSERT_EQUALS(serialiser.size(), MAX_MESSAGE_SIZE);
+	}
+
+	void test_ObstacleVectorMsg()
+	{
+		std::vector<ObstacleData> obstacles;
+		for(int i = 0; i < 90; i++)
+		{
+			ObstacleData obstacle = { 10.0 + i, 20.0 + i, -5.0, 5.0, 1.5, 2.5 };
+			obstacles.push_back(obstacle);
+		}
+		ObstacleVectorMsg msg(NodeID::None, NodeID::HTTPSync, obstacles);
+
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+
+		MessageDeserialiser deserialiser(serialiser.data(), serialiser.size());
+		ObstacleVectorMsg msgTwo(deserialiser);
+
+		// Only the first few fit into a serialised message
+		TS_ASSERT(msgTwo.isValid());
+		TS_ASSERT_EQUALS(msgTwo.messageType(), MessageType::ObstacleVector);
+		TS_ASSERT_EQUALS(msgTwo.sourceID(), NodeID::HTTPSync);
+		TS_ASSERT_EQUALS(msgTwo.obstacles().size(), ObstacleVectorMsg::MAX_SERIALISED_OBSTACLES);
+		TS_ASSERT_EQUALS(msgTwo.obstacles()[79].minDistanceToObstacle, 89);
+		TS_ASSERT_EQUALS(msgTwo.obstacles()[79].maxDistanceToObstacle, 99);
+		TS_ASSERT_EQUALS(msgTwo.obstacles()[79].LeftBoundheadingRelativeToBoat, -5);
+		TS_ASSERT_EQUALS(msgTwo.obstacles()[79].RightBoundheadingRelativeToBoat, 5);
+		TS_ASSERT_EQUALS(msgTwo.obstacles()[79].angularCenterPositionX, 1.5);
+		TS_ASSERT_EQUALS(msgTwo.obstacles()[79].angularCenterPositionY, 2.5);
+	}
+
+	void test_ASPireActuatorFeedbackMsg()
+	{
+		ASPireActuatorFeedbackMsg msg(12.5, -3.5, 40, 1200, true);
+
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+
+		MessageDeserialiser deserialiser(serialiser.data(), serialiser.size());
+		ASPireActuatorFeedbackMsg msgTwo(deserialiser);
+
+		TS_ASSERT(msgTwo.isValid());
+		TS_ASSERT_EQUALS(msgTwo.messageType(), MessageType::ASPireActuatorFeedback);
+		TS_ASSERT_EQUALS(msgTwo.wingsailFeedback(), 12.5);
+		TS_ASSERT_EQUALS(msgTwo.rudderFeedback(), -3.5);
+		TS_ASSERT_EQUALS(msgTwo.windvaneSelfSteeringAngle(), 40);
+		TS_ASSERT_EQUALS(msgTwo.windvaneActuatorPosition(), 1200);
+		TS_ASSERT(msgTwo.radioControllerOn());
+	}
+
+	void test_RequestCourseMsg()
+	{
+		RequestCourseMsg msg(NodeID::SailingLogic, NodeID::HTTPSync);
+
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+
+		MessageDeserialiser deserialiser(serialiser.data(), serialiser.size());
+		RequestCourseMsg msgTwo(deserialiser);
+
+		TS_ASSERT(msgTwo.isValid());
+		TS_ASSERT_EQUALS(msgTwo.messageType(), MessageType::RequestCourse);
+		TS_ASSERT_EQUALS(msgTwo.sourceID(), NodeID::HTTPSync);
+		TS_ASSERT_EQUALS(msgTwo.destinationID(), NodeID::SailingLogic);
+	}
+
+	void test_MessageViewReadsTheSerialisedFields()
+	{
+		WindDataMsg msg(NodeID::None, NodeID::WindSensor, 120.5f, 6.25f, 18);
+
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+
+		MessageView header(serialiser.data(), serialiser.size());
+		TS_ASSERT(header.isValid());
+		TS_ASSERT_EQUALS(header.messageType(), MessageType::WindData);
+		TS_ASSERT_EQUALS(header.sourceID(), NodeID::WindSensor);
+		TS_ASSERT_EQUALS(header.destinationID(), NodeID::None);
+
+		WindDataView view(serialiser.data(), serialiser.size());
+		TS_ASSERT(view.isValid());
+		TS_ASSERT_EQUALS(view.windDirection(), 120.5f);
+		TS_ASSERT_EQUALS(view.windSpeed(), 6.25f);
+		TS_ASSERT_EQUALS(view.windTemp(), 18);
+
+		// Not the type of the view, or cut short
+		TS_ASSERT(not CompassDataView(serialiser.data(), serialiser.size()).isValid());
+		TS_ASSERT(not WindDataView(serialiser.data(), serialiser.size() - 1).isValid());
+		TS_ASSERT(not MessageView(serialiser.data(), 2).isValid());
+
+		MessageDeserialiser deserialiser(serialiser.data(), serialiser.size() - 1);
+		TS_ASSERT(not WindDataMsg(deserialiser).isValid());
+	}
+
+	void test_MessageViewReadsTheLists()
+	{
+		std::vector<AISVessel> vessels;
+		for(uint32_t i = 0; i < 3; i++)
+		{
+			AISVessel vessel = { 100 + i, 10.0f * i, 2.5f, 60.0 + i, 19.0 - i };
+			vessels.push_back(vessel);
+		}
+		std::vector<AISVesselInfo> infos(2, AISVesselInfo{ 7, 25, 6 });
+		AISDataMsg msg(vessels, infos, 60.5, 19.5);
+
+		MessageSerialiser serialiser;
+		msg.Serialise(serialiser);
+
+		AISDataView view(serialiser.data(), serialiser.size());
+		TS_ASSERT(view.isValid());
+		TS_ASSERT_EQUALS(view.vesselListCount(), 3);
+		TS_ASSERT_EQUALS(view.vesselListAt(2).MMSI, 102);
+		TS_ASSERT_EQUALS(view.vesselListAt(2).COG, 20);
+		TS_ASSERT_EQUALS(view.vesselListAt(2).latitude, 62);
+		TS_ASSERT_EQUALS(view.vesselListAt(2).longitude, 17);
+		TS_ASSERT_EQUALS(view.vesselInfoListCount(), 2);
+		TS_ASSERT_EQUALS(view.vesselInfoListAt(1).length, 25);
+		TS_ASSERT_EQUALS(view.posLat(), 60.5);
+		TS_ASSERT_EQUALS(view.posLon(), 19.5);
+
+		// A count that runs past the end of the data
+		AISDataView cutShort(serialiser.data(), serialiser.size() - 17);
+		TS_ASSERT(not cutShort.isValid());
+		TS_ASSERT_EQUALS(cutShort.vesselInfoListCount(), 0);
 	}
 };
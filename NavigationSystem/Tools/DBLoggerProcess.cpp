@@ -0,0 +1,99 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		DBLoggerProcess.cpp
+ *
+ * Purpose:
+ *		Runs the DBLoggerNode in a process of its own, on a message bus that gets its
+ *		messages from the navigation system over a BridgeNode. The database writes
+ *		then can't hold up the control loops of the navigation system.
+ *
+ *		Usage: db-logger <bridge name> [database]
+ *
+ * Developer Notes:
+ *		Started by the navigation system when it is built with USE_DB_PROCESS=1, see
+ *		main_ASPire.cpp. Stops when the navigation system stops.
+ *
+ ***************************************************************************************/
+
+#include "DataBase/DBHandler.h"
+#include "DataBase/DBLoggerNode.h"
+#include "MessageBus/BridgeNode.h"
+#include "MessageBus/MessageBus.h"
+#include "SystemServices/Logger.h"
+
+#include <chrono>
+#include <signal.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+
+#define DEFAULT_DATABASE 	"../asr.db"
+#define DB_LOGGER_QUEUE_SIZE 	5
+
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int)
+{
+	stopRequested = 1;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <bridge name> [database]\n", argv[0]);
+		return 1;
+	}
+
+	std::string dbPath = (argc > 2 ? argv[2] : DEFAULT_DATABASE);
+
+	signal(SIGTERM, requestStop);
+	signal(SIGINT, requestStop);
+
+	Logger::init("DBLogger.log");
+
+	DBHandler dbHandler(dbPath);
+	if(not dbHandler.initialise())
+	{
+		Logger::error("Database Handler init\t\t[FAILED]");
+		Logger::shutdown();
+		return 1;
+	}
+
+	MessageBus messageBus;
+	DBLoggerNode dbLoggerNode(messageBus, dbHandler, DB_LOGGER_QUEUE_SIZE);
+
+	// Nothing goes back to the navigation system
+	BridgeNode bridge(messageBus, argv[1], BridgeNode::Side::Child, {});
+
+	if(not dbLoggerNode.init() || not bridge.init())
+	{
+		Logger::error("DBLogger process init\t\t[FAILED]");
+		Logger::shutdown();
+		return 1;
+	}
+
+	dbLoggerNode.start();
+	bridge.start();
+
+	std::thread busThread(&MessageBus::run, &messageBus);
+
+	while(bridge.isRunning() && not stopRequested)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	bridge.stop();
+	messageBus.stop();
+	busThread.join();
+
+	Logger::info("DBLogger process stopped");
+	Logger::shutdown();
+
+	// The DBLoggerNode thread doesn't stop, same as in the navigation system
+	exit(0);
+}
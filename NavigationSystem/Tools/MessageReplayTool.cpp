@@ -0,0 +1,250 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageReplayTool.cpp
+ *
+ * Purpose:
+ *		Replays a message recording into a message bus with a chosen set of nodes, so
+ *		navigation and logging can be profiled and compared between builds without a
+ *		boat. Prints the CPU time used and the message bus statistics at the end.
+ *
+ *		Usage: replay-messages [-s speed] [-v] [-n nodes] [-d database] <recording>
+ *
+ *		-s 	Playback speed, 1 is real time (default), 10 ten times faster and 0 as fast
+ *			as possible.
+ *		-v 	Runs on a simulated time, the nodes loop at their usual rate compared to the
+ *			recording but the replay only takes as long as the processing.
+ *		-n 	Comma separated nodes to attach, out of course, sail, wingsail, linefollow,
+ *			lnm, dblogger, waypoint, windstate and stateestimation.
+ *			Default: course,wingsail,linefollow
+ *		-d 	Database to read the node configuration from. Default: ../asr.db
+ *
+ * Developer Notes:
+ *		Recordings are made by passing a file name as the second argument to the
+ *		navigation system, see MessageBus::startRecording().
+ *
+ ***************************************************************************************/
+
+#include "DataBase/DBHandler.h"
+#include "DataBase/DBLoggerNode.h"
+#include "LowLevelControllers/CourseRegulatorNode.h"
+#include "LowLevelControllers/SailControlNode.h"
+#include "LowLevelControllers/WingsailControlNode.h"
+#include "MessageBus/MessageBus.h"
+#include "MessageBus/MessageReplay.h"
+#include "Navigation/LineFollowNode.h"
+#include "Navigation/WaypointMgrNode.h"
+#include "Navigation/LocalNavigationModule/LocalNavigationModule.h"
+#include "Navigation/LocalNavigationModule/Voters/ChannelVoter.h"
+#include "Navigation/LocalNavigationModule/Voters/MidRangeVoter.h"
+#include "Navigation/LocalNavigationModule/Voters/ProximityVoter.h"
+#include "Navigation/LocalNavigationModule/Voters/WaypointVoter.h"
+#include "Navigation/LocalNavigationModule/Voters/WindVoter.h"
+#include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
+#include "SystemServices/TimeSource.h"
+#include "WorldState/CollidableMgr/CollidableMgr.h"
+#include "WorldState/StateEstimationNode.h"
+#include "WorldState/WindStateNode.h"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+#define DEFAULT_NODES 		"course,wingsail,linefollow"
+#define DEFAULT_DATABASE 	"../asr.db"
+
+
+///----------------------------------------------------------------------------------
+/// Returns true if a node name is in the comma separated list.
+///----------------------------------------------------------------------------------
+static bool wanted(const std::string& nodes, const std::string& name)
+{
+	return ("," + nodes + ",").find("," + name + ",") != std::string::npos;
+}
+
+///----------------------------------------------------------------------------------
+/// Returns the user and system CPU time used by the process, in seconds.
+///----------------------------------------------------------------------------------
+static double cpuTime()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+		(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static void printUsage(const char* program)
+{
+	fprintf(stderr, "Usage: %s [-s speed] [-v] [-n nodes] [-d database] <recording>\n", program);
+	fprintf(stderr, "\t-s speed     1 real time (default), 0 as fast as possible\n");
+	fprintf(stderr, "\t-v           Simulated time, follows the recording as fast as the nodes can\n");
+	fprintf(stderr, "\t-n nodes     Out of course, sail, wingsail, linefollow, lnm, dblogger,\n");
+	fprintf(stderr, "\t             waypoint, windstate, stateestimation. Default: %s\n", DEFAULT_NODES);
+	fprintf(stderr, "\t-d database  Default: %s\n", DEFAULT_DATABASE);
+}
+
+
+int main(int argc, char* argv[])
+{
+	double speed = 1;
+	bool simulatedTime = false;
+	std::string nodeList = DEFAULT_NODES;
+	std::string dbPath = DEFAULT_DATABASE;
+
+	int option;
+	while((option = getopt(argc, argv, "s:vn:d:")) != -1)
+	{
+		switch(option)
+		{
+			case 's': speed = atof(optarg); break;
+			case 'v': simulatedTime = true; break;
+			case 'n': nodeList = optarg; break;
+			case 'd': dbPath = optarg; break;
+			default:
+				printUsage(argv[0]);
+				return 1;
+		}
+	}
+
+	if(optind >= argc || speed < 0)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	Logger::init("Replay.log");
+
+	DBHandler dbHandler(dbPath);
+	if(not dbHandler.initialise())
+	{
+		fprintf(stderr, "Failed to open the database %s\n", dbPath.c_str());
+		return 1;
+	}
+
+	MessageBus messageBus;
+	MessageReplay replay(messageBus);
+
+	// Has to be in place before the nodes start their threads
+	SimulatedTimeSource simulatedClock;
+	if(simulatedTime)
+	{
+		simulatedClock.addIdleCheck([&messageBus]() { return messageBus.pendingMessages() == 0; });
+		SysClock::setTimeSource(&simulatedClock);
+	}
+	if(not replay.open(argv[optind]))
+	{
+		fprintf(stderr, "Failed to open the recording %s\n", argv[optind]);
+		return 1;
+	}
+
+	// Declare nodes
+	//-------------------------------------------------------------------------------
+
+	std::vector<std::unique_ptr<Node>> nodes;
+	CollidableMgr collidableMgr;
+
+	if(wanted(nodeList, "course")) 			{ nodes.emplace_back(new CourseRegulatorNode(messageBus, dbHandler)); }
+	if(wanted(nodeList, "sail")) 			{ nodes.emplace_back(new SailControlNode(messageBus, dbHandler)); }
+	if(wanted(nodeList, "wingsail")) 		{ nodes.emplace_back(new WingsailControlNode(messageBus, dbHandler)); }
+	if(wanted(nodeList, "linefollow")) 		{ nodes.emplace_back(new LineFollowNode(messageBus, dbHandler)); }
+	if(wanted(nodeList, "dblogger")) 		{ nodes.emplace_back(new DBLoggerNode(messageBus, dbHandler, 5)); }
+	if(wanted(nodeList, "waypoint")) 		{ nodes.emplace_back(new WaypointMgrNode(messageBus, dbHandler)); }
+	if(wanted(nodeList, "windstate")) 		{ nodes.emplace_back(new WindStateNode(messageBus)); }
+	if(wanted(nodeList, "stateestimation")) { nodes.emplace_back(new StateEstimationNode(messageBus, dbHandler)); }
+
+	const int16_t MAX_VOTES = dbHandler.retrieveCellAsInt("config_voter_system","1","max_vote");
+	WaypointVoter waypointVoter(MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","waypoint_voter_weight"));
+	WindVoter windVoter(MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","wind_voter_weight"));
+	ChannelVoter channelVoter(MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","channel_voter_weight"));
+	MidRangeVoter midRangeVoter(MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","midrange_voter_weight"), collidableMgr);
+	ProximityVoter proximityVoter(MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","proximity_voter_weight"), collidableMgr);
+
+	if(wanted(nodeList, "lnm"))
+	{
+		LocalNavigationModule* lnm = new LocalNavigationModule(messageBus, dbHandler);
+		lnm->registerVoter(&waypointVoter);
+		lnm->registerVoter(&windVoter);
+		lnm->registerVoter(&channelVoter);
+		lnm->registerVoter(&proximityVoter);
+		lnm->registerVoter(&midRangeVoter);
+		nodes.emplace_back(lnm);
+		collidableMgr.startGC();
+	}
+
+	// Initialise and start the nodes
+	//-------------------------------------------------------------------------------
+
+	for(auto& node : nodes)
+	{
+		if(not node->init())
+		{
+			fprintf(stderr, "Node %s failed to initialise\n", nodeToString(node->nodeID()).c_str());
+			return 1;
+		}
+	}
+
+	for(auto& node : nodes)
+	{
+		ActiveNode* activeNode = dynamic_cast<ActiveNode*>(node.get());
+		if(activeNode != NULL)
+		{
+			activeNode->start();
+		}
+	}
+
+	// Replay
+	//-------------------------------------------------------------------------------
+
+	std::thread busThread(&MessageBus::run, &messageBus);
+
+	double cpuStart = cpuTime();
+	uint64_t simulatedStart = simulatedClock.monotonicMicros();
+	auto wallStart = std::chrono::steady_clock::now();
+
+	replay.play(speed);
+	uint64_t simulatedEnd = simulatedClock.monotonicMicros();
+
+	double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	double cpuSeconds = cpuTime() - cpuStart;
+
+	messageBus.stop();
+	busThread.join();
+
+	MessageBus::Stats stats = messageBus.statistics();
+
+	printf("Replayed %llu messages, skipped %llu\n", (unsigned long long)replay.played(),
+		(unsigned long long)replay.skipped());
+	printf("Wall time %.3f s, CPU time %.3f s\n", wallSeconds, cpuSeconds);
+	if(simulatedTime)
+	{
+		printf("Simulated time %.3f s\n", (simulatedEnd - simulatedStart) / 1e6);
+	}
+	printf("Dispatch latency mean %.1f us p99 %llu us max %llu us\n", stats.latencyMeanUs,
+		(unsigned long long)stats.latencyP99Us, (unsigned long long)stats.latencyMaxUs);
+
+	for(auto& node : stats.nodes)
+	{
+		printf("  %-28s %8llu messages %10llu us handling, max %llu us\n",
+			nodeToString(node.id).c_str(), (unsigned long long)node.messagesHandled,
+			(unsigned long long)node.handlerTimeTotalUs, (unsigned long long)node.handlerTimeMaxUs);
+	}
+
+	for(auto& tick : stats.ticks)
+	{
+		printf("  %-28s %8llu ticks %10llu overruns, lateness max %llu us\n",
+			nodeToString(tick.id).c_str(), (unsigned long long)tick.ticks,
+			(unsigned long long)tick.overruns, (unsigned long long)tick.latenessMaxUs);
+	}
+
+	// The node threads don't stop, same as the navigation system
+	Logger::shutdown();
+	exit(0);
+}
@@ -0,0 +1,131 @@
+/****************************************************************************************
+ *
+ * File:
+ * 		MessageTraceDecoder.cpp
+ *
+ * Purpose:
+ *		Turns a binary message trace written by the message bus (Messages.trace) back
+ *		into the readable message log format.
+ *
+ *		Usage: decode-message-trace [-d] <trace file>
+ *
+ *		-d adds the time each node spent processing the message to the consumer lines.
+ *
+ * Developer Notes:
+ *		The trace has to be decoded on a machine with the same byte order as the one
+ *		that recorded it, see MessageTrace.h.
+ *
+ ***************************************************************************************/
+
+#include "MessageBus/MessageTrace.h"
+#include "MessageBus/MessageTypes.h"
+#include "MessageBus/NodeIDs.h"
+#include "SystemServices/SysClock.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+///----------------------------------------------------------------------------------
+/// Returns a monotonic trace time as HH:MM:SS:MS using the last clock sync.
+///----------------------------------------------------------------------------------
+static std::string wallClock(uint64_t time, int64_t clockOffset)
+{
+	uint64_t unixMicros = time + clockOffset;
+	return SysClock::hh_mm_ss_ms(TimeStamp(unixMicros / 1000000, (unixMicros / 1000) % 1000));
+}
+
+
+int main(int argc, char* argv[])
+{
+	bool showDurations = false;
+	const char* filePath = NULL;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-d") == 0)
+		{
+			showDurations = true;
+		}
+		else
+		{
+			filePath = argv[i];
+		}
+	}
+
+	if(filePath == NULL)
+	{
+		fprintf(stderr, "Usage: %s [-d] <trace file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE* file = fopen(filePath, "rb");
+	if(file == NULL)
+	{
+		fprintf(stderr, "Failed to open %s\n", filePath);
+		return 1;
+	}
+
+	MessageTraceHeader header;
+	if(fread(&header, sizeof(header), 1, file) != 1 ||
+		memcmp(header.magic, MESSAGE_TRACE_MAGIC, sizeof(header.magic)) != 0)
+	{
+		fprintf(stderr, "%s is not a message trace\n", filePath);
+		fclose(file);
+		return 1;
+	}
+
+	if(header.version != MESSAGE_TRACE_VERSION || header.recordSize != sizeof(MessageTraceRecord))
+	{
+		fprintf(stderr, "Unsupported trace version %u with %u byte records\n", header.version,
+			header.recordSize);
+		fclose(file);
+		return 1;
+	}
+
+	MessageTraceRecord record;
+	int64_t clockOffset = 0;
+	unsigned long messages = 0;
+
+	while(fread(&record, sizeof(record), 1, file) == 1)
+	{
+		switch(static_cast<MessageTraceKind>(record.kind))
+		{
+			case MessageTraceKind::ClockSync:
+				clockOffset = (int64_t)record.enqueued - (int64_t)record.time;
+				break;
+
+			case MessageTraceKind::Dispatch:
+			{
+				MessageType type = static_cast<MessageType>(record.messageType);
+				printf("[%s] Type=%s(%d) SourceID=%d Destination=%d Received=%s\n",
+					wallClock(record.time, clockOffset).c_str(), msgToString(type).c_str(),
+					(int) record.messageType, (int) record.source, (int) record.destination,
+					wallClock(record.enqueued, clockOffset).c_str());
+				messages++;
+			}
+			break;
+
+			case MessageTraceKind::Consumed:
+			{
+				NodeID id = static_cast<NodeID>(record.consumer);
+				printf("\t%s Consumed by Node: %s(%d)", wallClock(record.time, clockOffset).c_str(),
+					nodeToString(id).c_str(), (int) record.consumer);
+				if(showDurations)
+				{
+					printf(" in %uus", record.duration);
+				}
+				printf("\n");
+			}
+			break;
+
+			default:
+				fprintf(stderr, "Skipping a record of unknown kind %d\n", (int) record.kind);
+				break;
+		}
+	}
+
+	fclose(file);
+	fprintf(stderr, "Decoded %lu messages\n", messages);
+	return 0;
+}
@@ -0,0 +1,619 @@
+#!/usr/bin/python3
+
+# Generates the message classes from Messages/messages.json
+#
+# Writes for every message of the schema
+#   Messages/<Name>.h           the message class, its serialiser and its view
+# and
+#   MessageBus/MessageFactory.cpp       the switch that deserialises every message
+#   DataBase/LogItemMapping.cpp         copies the logged fields into a LogItem
+#
+# Run from the NavigationSystem directory, or with 'make messages'. The fields of a
+# message are serialised in the order of the schema, reordering them changes the
+# format of the recordings and of the bridge between the processes.
+
+import json
+import os
+import re
+import sys
+import textwrap
+
+SCHEMA = 'Messages/messages.json'
+MESSAGE_TYPES = 'MessageBus/MessageTypes.h'
+MAX_MESSAGE_SIZE = 4096
+HEADER_SIZE = 3
+COUNT_SIZE = 2
+
+GENERATED_NOTE = [
+    'Generated from Messages/messages.json by Tools/generate_messages.py, change the',
+    'schema and run \'make messages\' instead of editing this file.'
+]
+
+# size, LittleEndian read function
+SCALARS = {
+    'bool':     (1, 'readBool'),
+    'uint8_t':  (1, 'readUint8'),
+    'uint16_t': (2, 'readUint16'),
+    'uint32_t': (4, 'readUint32'),
+    'int':      (4, 'readInt'),
+    'float':    (4, 'readFloat'),
+    'double':   (8, 'readDouble'),
+}
+
+
+def fail(message):
+    sys.exit('generate_messages.py: ' + message)
+
+
+def capitalise(name):
+    return name[0].upper() + name[1:]
+
+
+def member(field):
+    return 'm_' + capitalise(field['name'])
+
+
+def getter(field):
+    return field.get('get', field['name'])
+
+
+def view_name(name):
+    if name.endswith('Msg'):
+        return name[:-3] + 'View'
+    return name + 'View'
+
+
+def banner(filename, purpose, notes):
+    lines = ['/****************************************************************************************',
+             ' *',
+             ' * File:',
+             ' * \t\t' + filename,
+             ' *',
+             ' * Purpose:']
+    lines += [' *\t\t' + line for line in purpose]
+    lines += [' *', ' * Developer Notes:']
+    for line in notes:
+        lines.append(' *\t\t' + line if line else ' *')
+    lines += [' *',
+              ' ***************************************************************************************/']
+    return lines
+
+
+# Joins the items with commas, carrying on over as many lines as it takes
+def wrap(first, items, last, indent):
+    lines = [first]
+    for i, item in enumerate(items):
+        item += ',' if i < len(items) - 1 else last
+        if len(lines[-1]) + len(item) > 95 and lines[-1] != first:
+            lines[-1] = lines[-1].rstrip()
+            lines.append(indent)
+        lines[-1] += item + ' '
+    if not items:
+        lines[-1] += last
+    return [line.rstrip() for line in lines]
+
+
+def comment(text, indent):
+    return [indent + '// ' + line for line in textwrap.wrap(text, 85)]
+
+
+def doc_comment(text, indent='\t'):
+    return [indent + '///----------------------------------------------------------------------------------',
+            indent + '/// ' + text,
+            indent + '///----------------------------------------------------------------------------------']
+
+
+class Message:
+    def __init__(self, name, spec):
+        self.name = name
+        self.spec = spec
+        self.type = spec['type']
+        self.fields = spec['fields']
+        self.enums = dict((enum['name'], enum) for enum in spec.get('enums', []))
+        self.structs = dict((struct['name'], struct) for struct in spec.get('structs', []))
+        self.limits = dict((limit['name'], limit) for limit in spec.get('limits', []))
+        self.constructors = spec.get('constructors', ['ids', 'none'])
+        self.fieldsByName = dict((field['name'], field) for field in self.fields)
+        self.args = [self.fieldsByName[name] for name in spec.get('args', [f['name'] for f in self.fields])]
+        self.lists = [field for field in self.fields if field['type'] == 'list']
+        self.check()
+
+    def check(self):
+        for field in self.fields:
+            if field['type'] == 'list':
+                if field['of'] not in self.structs:
+                    fail(self.name + '.' + field['name'] + ' is a list of an unknown struct')
+                if field['max'] not in self.limits:
+                    fail(self.name + '.' + field['name'] + ' has no limit')
+                if 'ptr' not in field or 'shared' not in field:
+                    fail(self.name + '.' + field['name'] + ' doesn\'t name its shared list type and accessor')
+            elif field['type'] not in SCALARS and field['type'] not in self.enums:
+                fail(self.name + '.' + field['name'] + ' has an unknown type ' + field['type'])
+        for struct in self.structs.values():
+            for field in struct['fields']:
+                if field['type'] not in SCALARS:
+                    fail(self.name + '.' + struct['name'] + '.' + field['name'] + ' is not a scalar')
+        if sorted(f['name'] for f in self.args) != sorted(f['name'] for f in self.fields):
+            fail(self.name + ' args don\'t name every field once')
+        if self.maxSize() > MAX_MESSAGE_SIZE:
+            fail(self.name + ' doesn\'t fit into MAX_MESSAGE_SIZE')
+
+    def size(self, type):
+        if type in self.enums:
+            return 1
+        if type in self.structs:
+            return sum(self.size(field['type']) for field in self.structs[type]['fields'])
+        return SCALARS[type][0]
+
+    def maxSize(self):
+        size = HEADER_SIZE
+        for field in self.fields:
+            if field['type'] == 'list':
+                size += COUNT_SIZE + self.limits[field['max']]['value'] * self.size(field['of'])
+            else:
+                size += self.size(field['type'])
+        return size
+
+    # The fields split up into blocks of scalars and lists, in wire order
+    def segments(self):
+        segments = []
+        for field in self.fields:
+            if field['type'] == 'list':
+                segments.append(field)
+            elif segments and isinstance(segments[-1], list):
+                segments[-1].append(field)
+            else:
+                segments.append([field])
+        return segments
+
+    def fixedSize(self, segment):
+        return sum(self.size(field['type']) for field in segment)
+
+    def returnType(self, field):
+        if field['type'] == 'list':
+            return 'const std::vector<' + field['of'] + '>&'
+        return field.get('returns', field['type'])
+
+    def paramType(self, field, shared):
+        if field['type'] == 'list':
+            return field['ptr'] if shared else 'std::vector<' + field['of'] + '>'
+        return field.get('param', field['type'])
+
+    def write(self, ptr, expression, type):
+        if type in self.enums:
+            expression = '(uint8_t)' + expression
+        return 'LittleEndian::write(' + ptr + ', ' + expression + ')'
+
+    def read(self, ptr, type):
+        if type in self.enums:
+            return '(' + type + ')LittleEndian::readUint8(' + ptr + ')'
+        return 'LittleEndian::' + SCALARS[type][1] + '(' + ptr + ')'
+
+    def offsetExpression(self, base, offset):
+        return base + (' + ' + str(offset) if offset else '')
+
+    # Header
+    def header(self):
+        notes = self.spec.get('notes', [])
+        notes = notes + [''] + GENERATED_NOTE if notes else GENERATED_NOTE
+        lines = banner(self.name + '.h', self.spec['purpose'], notes)
+        lines += ['', '#pragma once', '', '#include "MessageBus/Message.h"', '#include "MessageBus/MessageView.h"']
+        if self.lists:
+            lines += ['', '#include <memory>', '#include <vector>']
+        lines += ['', '']
+
+        for enum in self.enums.values():
+            lines += self.enumDeclaration(enum)
+        for struct in self.structs.values():
+            lines += self.structDeclaration(struct)
+
+        lines += self.messageClass()
+        lines += ['', '']
+        lines += self.viewClass()
+        return '\n'.join(lines) + '\n'
+
+    def enumDeclaration(self, enum):
+        lines = ['enum class ' + enum['name'], '{']
+        values = enum['values']
+        for i, value in enumerate(values):
+            text = '\t' + value['name'] + (' = 0' if i == 0 else '') + (',' if i < len(values) - 1 else '')
+            if 'comment' in value:
+                text = text.ljust(20) + '// ' + value['comment']
+            lines.append(text)
+        return lines + ['};', '', '']
+
+    def structDeclaration(self, struct):
+        lines = ['struct ' + struct['name'] + ' {']
+        for field in struct['fields']:
+            text = '\t' + field['type'] + ' ' + field['name'] + ';'
+            if 'comment' in field:
+                text += ' // ' + field['comment']
+            lines.append(text)
+        return lines + ['};', '', '']
+
+    # Message class
+    def messageClass(self):
+        lines = ['class ' + self.name + ' : public Message {', 'public:',
+                 '\tstatic const MessageType TYPE = MessageType::' + self.type + ';']
+
+        if self.lists:
+            lines.append('')
+            for field in self.lists:
+                lines.append('\ttypedef std::shared_ptr<const std::vector<' + field['of'] + '>> ' + field['ptr'] + ';')
+
+        if 'snapshot' in self.spec:
+            lines += self.snapshotDeclaration()
+
+        for constructor in self.constructors:
+            lines.append('')
+            lines += self.constructor(constructor, False)
+
+        if self.lists:
+            lines.append('')
+            lines += doc_comment('Shares the lists of another message instead of copying them.')
+            lines += self.constructor('ids', True)
+
+        lines.append('')
+        lines += self.deserialisingConstructor()
+
+        lines += ['', '\tvirtual ~' + self.name + '() { }']
+
+        if self.fields:
+            lines.append('')
+            lines += self.accessors()
+
+        if 'snapshot' in self.spec:
+            lines.append('')
+            lines += self.snapshotFunction()
+
+        if self.fields:
+            lines.append('')
+            lines += self.serialiseFunction()
+
+        for limit in self.limits.values():
+            lines += [''] + comment(limit['comment'], '\t')
+            lines.append('\tstatic const size_t ' + limit['name'] + ' = ' + str(limit['value']) + ';')
+
+        if self.fields:
+            lines += ['', 'private:']
+            types = [field['ptr'] if field['type'] == 'list' else field['type'] for field in self.fields]
+            declarations = [type.ljust(max(len(t) for t in types)) + ' ' + member(field) + ';'
+                            for type, field in zip(types, self.fields)]
+            width = max(len(declaration) for declaration in declarations) + 2
+            for declaration, field in zip(declarations, self.fields):
+                if 'comment' in field:
+                    declaration = declaration.ljust(width) + '// ' + field['comment']
+                lines.append('\t' + declaration)
+
+        return lines + ['};']
+
+    def constructor(self, kind, shared):
+        ids = {
+            'ids':          (['NodeID destinationID', 'NodeID sourceID'], 'sourceID, destinationID'),
+            'source_first': (['NodeID sourceID', 'NodeID destinationID'], 'sourceID, destinationID'),
+            'source':       (['NodeID sourceID'], 'sourceID, NodeID::None'),
+            'destination':  (['NodeID destinationID'], 'NodeID::None, destinationID'),
+            'none':         ([], 'NodeID::None, NodeID::None'),
+        }
+        if kind not in ids:
+            fail(self.name + ' has an unknown constructor ' + kind)
+        params, base = ids[kind]
+        params = params + [self.paramType(field, shared) + ' ' + field['name'] for field in self.args]
+
+        initialisers = ['Message(MessageType::' + self.type + ', ' + base + ')']
+        for field in self.fields:
+            value = field['name']
+            if field['type'] == 'list':
+                if shared:
+                    value = 'std::move(' + value + ')'
+                else:
+                    value = 'std::make_shared<const std::vector<' + field['of'] + '>>(std::move(' + value + '))'
+            initialisers.append(member(field) + '(' + value + ')')
+
+        return (wrap('\t' + self.name + '(', params, ')', '\t\t') +
+                wrap('\t\t:', initialisers, '', '\t\t ') + ['\t{ }'])
+
+    def deserialisingConstructor(self):
+        initialisers = ['Message(deserialiser)'] + [member(field) + '()' for field in self.fields
+                                                    if field['type'] != 'list']
+        lines = ['\t' + self.name + '(MessageDeserialiser deserialiser)']
+        lines += wrap('\t\t:', initialisers, '', '\t\t ')
+        if not self.fields:
+            return lines + ['\t{ }']
+
+        lines.append('\t{')
+        for field in self.lists:
+            lines.append('\t\tstd::vector<' + field['of'] + '> ' + field['name'] + ';')
+        if self.lists:
+            lines.append('')
+
+        declaration = '\t\tconst uint8_t* data = '
+        for i, segment in enumerate(self.segments()):
+            if i > 0:
+                lines.append('')
+            if isinstance(segment, list):
+                lines += [(declaration if i == 0 else '\t\tdata = ') + 'm_valid ? deserialiser.take(' +
+                          str(self.fixedSize(segment)) + ') : NULL;',
+                          '\t\tif(data != NULL)', '\t\t{']
+                offset = 0
+                for field in segment:
+                    lines.append('\t\t\t' + member(field) + ' = ' +
+                                 self.read(self.offsetExpression('data', offset), field['type']) + ';')
+                    offset += self.size(field['type'])
+            else:
+                field = segment
+                count = field['name'] + 'Count'
+                size = self.size(field['of'])
+                lines += ['\t\tuint16_t ' + count + ' = 0;',
+                          (declaration if i == 0 else '\t\tdata = ') + 'm_valid ? deserialiser.take(sizeof(' +
+                          count + ')) : NULL;',
+                          '\t\tif(data != NULL)', '\t\t{',
+                          '\t\t\t' + count + ' = LittleEndian::readUint16(data);',
+                          '\t\t\tdata = deserialiser.take(' + count + ' * ' + str(size) + ');',
+                          '\t\t}',
+                          '\t\tif(data != NULL)', '\t\t{',
+                          '\t\t\t' + field['name'] + '.resize(' + count + ');',
+                          '\t\t\tfor(uint16_t i = 0; i < ' + count + '; i++, data += ' + str(size) + ')',
+                          '\t\t\t{']
+                lines += self.readStruct('\t\t\t\t', field['name'] + '[i]', field['of'], 'data')
+                lines.append('\t\t\t}')
+            lines += ['\t\t}', '\t\telse', '\t\t{', '\t\t\tm_valid = false;', '\t\t}']
+
+        if self.lists:
+            lines.append('')
+            for field in self.lists:
+                lines.append('\t\t' + member(field) + ' = std::make_shared<const std::vector<' + field['of'] +
+                             '>>(std::move(' + field['name'] + '));')
+        return lines + ['\t}']
+
+    def readStruct(self, indent, target, struct, ptr):
+        lines = []
+        offset = 0
+        for field in self.structs[struct]['fields']:
+            lines.append(indent + target + '.' + field['name'] + ' = ' +
+                         self.read(self.offsetExpression(ptr, offset), field['type']) + ';')
+            offset += self.size(field['type'])
+        return lines
+
+    def accessors(self):
+        lines = []
+        for field in self.fields:
+            if field['type'] == 'list':
+                lines.append('\t' + self.returnType(field) + ' ' + getter(field) + '() const { return *' +
+                             member(field) + '; }')
+        for field in self.lists:
+            lines.append('\tconst ' + field['ptr'] + '& ' + field['shared'] + '() const { return ' +
+                         member(field) + '; }')
+        for field in self.lists:
+            index = field.get('element_accessors')
+            if index:
+                for element in self.structs[field['of']]['fields']:
+                    lines.append('\t' + element['type'] + ' ' + element['name'] + '(int ' + index +
+                                 ') const { return (*' + member(field) + ')[' + index + '].' +
+                                 element['name'] + '; }')
+        for field in self.fields:
+            if field['type'] != 'list':
+                lines.append('\t' + self.returnType(field) + ' ' + getter(field) + '() const { return ' +
+                             member(field) + '; }')
+        return lines
+
+    def snapshotDeclaration(self):
+        snapshot = self.spec['snapshot']
+        getters = dict((getter(field), field) for field in self.fields)
+        lines = [''] + doc_comment(snapshot['comment']) + ['\tstruct Snapshot {']
+        for name in snapshot['fields']:
+            if name not in getters:
+                fail(self.name + ' snapshot field ' + name + ' is not an accessor')
+            lines.append('\t\t' + self.returnType(getters[name]) + '\t' + name + ';')
+        return lines + ['\t};']
+
+    def snapshotFunction(self):
+        getters = dict((getter(field), field) for field in self.fields)
+        values = [member(getters[name]) for name in self.spec['snapshot']['fields']]
+        return ['\tSnapshot snapshot() const', '\t{',
+                '\t\tSnapshot snapshot = { ' + ', '.join(values) + ' };',
+                '\t\treturn snapshot;', '\t}']
+
+    def serialiseFunction(self):
+        if self.lists:
+            limits = ' and '.join(sorted(set(field['max'] for field in self.lists)))
+            lines = doc_comment('Serialises the message into a MessageSerialiser. Only the first')
+            lines.insert(2, '\t/// ' + limits + ' elements of a list fit into a serialised message.')
+        else:
+            lines = doc_comment('Serialises the message into a MessageSerialiser')
+        lines += ['\tvirtual void Serialise(MessageSerialiser& serialiser) const', '\t{',
+                  '\t\tMessage::Serialise(serialiser);', '']
+
+        size = []
+        for segment in self.segments():
+            if isinstance(segment, list):
+                size.append(str(self.fixedSize(segment)))
+            else:
+                count = segment['name'] + 'Count'
+                lines += ['\t\tuint16_t ' + count + ' = (' + member(segment) + '->size() < ' + segment['max'] + ') ?',
+                          '\t\t\t' + member(segment) + '->size() : ' + segment['max'] + ';']
+                size.append('sizeof(' + count + ') + ' + count + ' * ' + str(self.size(segment['of'])))
+        if self.lists:
+            lines.append('')
+
+        lines += [line.replace(',', ' +') for line in
+                  wrap('\t\tuint8_t* data = serialiser.reserve(', size, ');', '\t\t\t')]
+        lines += ['\t\tif(data != NULL)', '\t\t{']
+        for segment in self.segments():
+            if isinstance(segment, list):
+                for field in segment:
+                    lines.append('\t\t\tdata = ' + self.write('data', member(field), field['type']) + ';')
+            else:
+                count = segment['name'] + 'Count'
+                lines += ['\t\t\tdata = LittleEndian::write(data, ' + count + ');',
+                          '\t\t\tfor(uint16_t i = 0; i < ' + count + '; i++)',
+                          '\t\t\t{',
+                          '\t\t\t\tconst ' + segment['of'] + '& element = (*' + member(segment) + ')[i];']
+                for element in self.structs[segment['of']]['fields']:
+                    lines.append('\t\t\t\tdata = ' + self.write('data', 'element.' + element['name'],
+                                                                element['type']) + ';')
+                lines.append('\t\t\t}')
+        return lines + ['\t\t}', '\t}']
+
+    # View class
+    def viewClass(self):
+        name = view_name(self.name)
+        lines = doc_comment('Reads a serialised ' + self.name + ' where it lies, see MessageView.h.', '')
+        lines += ['class ' + name + ' : public MessageView {', 'public:',
+                  '\t' + name + '(const uint8_t* data, uint16_t size)',
+                  '\t\t:MessageView(data, size, MessageType::' + self.type + ')']
+        if not self.fields:
+            return lines + ['\t{ }', '};']
+
+        # Where each field lies, relative to the header or to where the block of fields
+        # after a list starts
+        locations = {}
+        body = ['\t{', '\t\tuint32_t offset = HEADER_SIZE;']
+        members = []
+        base = 'HEADER_SIZE'
+        for segment in self.segments():
+            if isinstance(segment, list):
+                if base != 'HEADER_SIZE':
+                    # After a list, found when the view is made
+                    base = member(segment[0]) + 'Offset'
+                    members.append('\tuint32_t ' + base + ';')
+                    body.append('\t\t' + base + ' = offset;')
+                offset = 0
+                for field in segment:
+                    locations[field['name']] = (base, offset)
+                    offset += self.size(field['type'])
+                body.append('\t\tskip(offset, ' + str(offset) + ');')
+            else:
+                base = member(segment) + 'Offset'
+                members += ['\tuint32_t ' + base + ';', '\tuint16_t ' + member(segment) + 'Count;']
+                body += ['\t\t' + base + ' = offset + sizeof(' + member(segment) + 'Count);',
+                         '\t\tskipList(offset, ' + member(segment) + 'Count, ' + str(self.size(segment['of'])) + ');']
+        lines += body + ['\t}', '']
+
+        for field in self.fields:
+            if field['type'] == 'list':
+                count = member(field) + 'Count'
+                offset = member(field) + 'Offset'
+                size = str(self.size(field['of']))
+                lines += ['\tuint16_t ' + getter(field) + 'Count() const { return ' + count + '; }',
+                          '\t' + field['of'] + ' ' + getter(field) + 'At(uint16_t index) const',
+                          '\t{',
+                          '\t\tconst uint8_t* data = m_Data + ' + offset + ' + index * ' + size + ';',
+                          '\t\t' + field['of'] + ' element;']
+                lines += self.readStruct('\t\t', 'element', field['of'], 'data')
+                lines += ['\t\treturn element;', '\t}']
+            else:
+                base, offset = locations[field['name']]
+                ptr = 'm_Data + ' + self.offsetExpression(base, offset)
+                lines.append('\t' + self.returnType(field) + ' ' + getter(field) + '() const { return ' +
+                             self.read(ptr, field['type']) + '; }')
+
+        if members:
+            lines += ['', 'private:'] + members
+        return lines + ['};']
+
+    # Log item mapping
+    def logged(self):
+        return [field for field in self.fields if 'log' in field]
+
+
+def factory(messages):
+    lines = banner('MessageFactory.cpp',
+                   ['Turns a serialised message back into a message object of the right class.'],
+                   GENERATED_NOTE)
+    lines += ['', '#include "MessageBus/MessageFactory.h"', '#include "MessageBus/MessageView.h"']
+    lines += ['#include "Messages/' + name + '.h"' for name in sorted(messages, key=str.lower)]
+    lines += ['', '',
+              'MessagePtr MessageFactory::deserialise(uint8_t* data, uint16_t size)',
+              '{',
+              '\tMessageView header(data, size);',
+              '\tif(not header.isValid())',
+              '\t{',
+              '\t\treturn NULL;',
+              '\t}',
+              '',
+              '\tMessageDeserialiser deserialiser(data, size);',
+              '',
+              '\tMessagePtr msg;',
+              '\tswitch(header.messageType())',
+              '\t{']
+    for message in messages.values():
+        lines += ['\t\tcase MessageType::' + message.type + ':',
+                  '\t\t\tmsg = std::make_unique<' + message.name + '>(deserialiser);',
+                  '\t\t\tbreak;']
+    lines += ['\t\tdefault:',
+              '\t\t\treturn NULL;',
+              '\t}',
+              '',
+              '\tif(not msg->isValid())',
+              '\t{',
+              '\t\treturn NULL;',
+              '\t}',
+              '\treturn msg;',
+              '}']
+    return '\n'.join(lines) + '\n'
+
+
+def log_item_mapping(messages):
+    logged = [message for message in messages.values() if message.logged()]
+    lines = banner('LogItemMapping.cpp',
+                   ['Copies the logged fields of the messages into a LogItem.'],
+                   GENERATED_NOTE + ['', 'The "log" of a field in the schema names the LogItem member it goes to.'])
+    lines += ['', '#include "DataBase/LogItemMapping.h"']
+    lines += ['#include "Messages/' + message.name + '.h"' for message in sorted(logged, key=lambda m: m.name.lower())]
+    lines += ['', '',
+              'bool LogItemMapping::update(LogItem& item, const Message* msg)',
+              '{',
+              '\tswitch(msg->messageType())',
+              '\t{']
+    for message in logged:
+        variable = 'message'
+        lines += ['\t\tcase MessageType::' + message.type + ':',
+                  '\t\t{',
+                  '\t\t\tconst ' + message.name + '* ' + variable + ' = static_cast<const ' + message.name +
+                  '*>(msg);']
+        for field in message.logged():
+            lines.append('\t\t\titem.' + field['log'] + ' = ' + variable + '->' + getter(field) + '();')
+        lines += ['\t\t}', '\t\treturn true;', '']
+    lines += ['\t\tdefault:',
+              '\t\treturn false;',
+              '\t}',
+              '}',
+              '',
+              'const std::vector<MessageType>& LogItemMapping::messageTypes()',
+              '{',
+              '\tstatic const std::vector<MessageType> types = {']
+    types = ['MessageType::' + message.type for message in logged]
+    for i, type in enumerate(types):
+        lines.append('\t\t' + type + (',' if i < len(types) - 1 else ''))
+    lines += ['\t};', '\treturn types;', '}']
+    return '\n'.join(lines) + '\n'
+
+
+def write_file(path, text):
+    if os.path.exists(path) and open(path).read() == text:
+        return
+    with open(path, 'w') as out:
+        out.write(text)
+    print('Generated ' + path)
+
+
+if not os.path.exists(SCHEMA):
+    sys.exit('Run from the NavigationSystem directory')
+
+schema = json.load(open(SCHEMA))
+known_types = re.findall(r'^\s*(\w+)(?:\s*=\s*\d+)?,?\s*$',
+                         open(MESSAGE_TYPES).read().split('enum class MessageType {')[1].split('};')[0],
+                         re.MULTILINE)
+
+messages = {}
+for name, spec in schema.items():
+    message = Message(name, spec)
+    if message.type not in known_types:
+        fail(name + ' has a type that is missing from ' + MESSAGE_TYPES)
+    messages[name] = message
+
+for message in messages.values():
+    write_file('Messages/' + message.name + '.h', message.header())
+write_file('MessageBus/MessageFactory.cpp', factory(messages))
+write_file('DataBase/LogItemMapping.cpp', log_item_mapping(messages))
@@ -41,7 +41,7 @@ AISProcessing::AISProcessing(MessageBus& msgBus, DBHandler& dbhandler, Collidabl
     MessageType type = msg->messageType();
     switch (type) {
       case MessageType::AISData :
-        processAISMessage((AISDataMsg*) msg);
+        processAISMessage(static_cast<const AISDataMsg*>(msg));
         break;
       case MessageType::ServerConfigsReceived :
         updateConfigsFromDB();
@@ -51,19 +51,20 @@ AISProcessing::AISProcessing(MessageBus& msgBus, DBHandler& dbhandler, Collidabl
     }
   }
 
-  void AISProcessing::processAISMessage(AISDataMsg* msg) {
-    std::vector<AISVessel> list = msg->vesselList();
-    std::vector<AISVesselInfo> tmp_info = msg->vesselInfoList();
+  void AISProcessing::processAISMessage(const AISDataMsg* msg) {
+    // Read in place, the lists are shared with the other subscribers
+    const std::vector<AISVessel>& list = msg->vesselList();
+    const std::vector<AISVesselInfo>& tmp_info = msg->vesselInfoList();
     double dist;
     m_latitude = msg->posLat();
     m_longitude = msg->posLon();
-    for (auto vessel: list) {
+    for (const auto& vessel: list) {
       dist = CourseMath::calculateDTW(m_latitude, m_longitude, vessel.latitude, vessel.longitude);
       if (dist < m_Radius && vessel.MMSI != m_MMSI) {
         m_Vessels.push_back(vessel);
       }
     }
-    for (auto tmp: tmp_info) {
+    for (const auto& tmp: tmp_info) {
       for (auto info: m_InfoList) {
         if (tmp.MMSI == info.MMSI) {
           break;
@@ -72,7 +72,7 @@ private:
   /*
   * Gets to process the message if the message received is an AISDataMsg
   */
-  void processAISMessage(AISDataMsg* msg);
+  void processAISMessage(const AISDataMsg* msg);
 
   /*
   * The function that thread works on
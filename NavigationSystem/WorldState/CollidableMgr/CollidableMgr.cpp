@@ -222,7 +222,7 @@ void CollidableMgr::ContactGC(CollidableMgr* ptr)
 {
     while(true)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(LOOP_TIME));
+        SysClock::sleepFor(std::chrono::milliseconds(LOOP_TIME));
         ptr->removeOldAISContacts();
         ptr->removeOldVisualField();
     }
@@ -37,7 +37,10 @@ m_VesselCourse(DATA_OUT_OF_RANGE)
     msgBus.registerNode(*this, MessageType::ServerConfigsReceived);
 }
 
-StateEstimationNode::~StateEstimationNode() {}
+StateEstimationNode::~StateEstimationNode()
+{
+    stopPeriodic();
+}
 
 bool StateEstimationNode::init()
 {
@@ -48,18 +51,21 @@ bool StateEstimationNode::init()
 void StateEstimationNode::start()
 {
     m_Running.store(true);
-    runThread(StateEstimationNodeThreadFunc);
+    // The initial delay ensures that most if not all the sensor data arrives at the start
+    // before we send out the vessel state message.
+    runPeriodic(m_LoopTime, INITIAL_SLEEP);
 }
 
 void StateEstimationNode::stop()
 {
     m_Running.store(false);
-    stopThread(this);
+    stopPeriodic();
 }
 
 void StateEstimationNode::updateConfigsFromDB()
 {
     m_LoopTime = m_dbHandler.retrieveCellAsDouble("config_vessel_state","1","loop_time");
+    setTickPeriod(m_LoopTime);
     m_speed_1 = m_dbHandler.retrieveCellAsDouble("config_vessel_state","1","course_config_speed_1");
     m_speed_2 = m_dbHandler.retrieveCellAsDouble("config_vessel_state","1","course_config_speed_2");
 }
@@ -90,6 +96,7 @@ void StateEstimationNode::processCompassMessage(const CompassDataMsg* msg)
 {
     std::lock_guard<std::mutex> lock_guard(m_lock);
     m_CompassHeading = msg->heading();
+    m_CompassCause = msg->asCause();
 }
 
 void StateEstimationNode::processGPSMessage(const GPSDataMsg* msg)
@@ -100,6 +107,7 @@ void StateEstimationNode::processGPSMessage(const GPSDataMsg* msg)
     m_GPSLon = msg->longitude();
     m_GPSSpeed = msg->speed();
     m_GPSCourse = msg->course();
+    m_GPSCause = msg->asCause();
     Logger::logWRSC(m_GPSLat, m_GPSLon);
 }
 
@@ -120,6 +128,7 @@ bool StateEstimationNode::estimateVesselState()
         m_VesselLon = m_GPSLon;
         m_VesselSpeed = m_GPSSpeed;
         m_VesselCourse = estimateVesselCourse();
+        m_VesselCause = MessageCause::oldest(m_CompassCause, m_GPSCause);
         return true;
     }
     else
@@ -157,26 +166,13 @@ float StateEstimationNode::estimateVesselCourse()
     }
 }
 
-void StateEstimationNode::StateEstimationNodeThreadFunc(ActiveNode* nodePtr)
+void StateEstimationNode::tick()
 {
-    StateEstimationNode* node = dynamic_cast<StateEstimationNode*> (nodePtr);
-
-    // An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
-    // at the start before we send out the vessel state message.
-    std::this_thread::sleep_for(std::chrono::milliseconds(INITIAL_SLEEP));
-
-    Timer timer;
-    timer.start();
-
-    while(node->m_Running.load() == true)
+    if(estimateVesselState())
     {
-        if(node->estimateVesselState())
-        {
-            MessagePtr stateMessage = std::make_unique<StateMessage>(node->m_VesselHeading, node->m_VesselLat,
-                node->m_VesselLon, node->m_VesselSpeed, node->m_VesselCourse);
-            node->m_MsgBus.sendMessage(std::move(stateMessage));
-        }
-        timer.sleepUntil(node->m_LoopTime);
-        timer.reset();
+        MessagePtr stateMessage = MessageBus::make<StateMessage>(m_VesselHeading, m_VesselLat,
+            m_VesselLon, m_VesselSpeed, m_VesselCourse);
+        stateMessage->setCause(m_VesselCause);
+        m_MsgBus.sendMessage(std::move(stateMessage));
     }
 }
@@ -84,10 +84,10 @@ private:
     float estimateVesselCourse();
 
     ///----------------------------------------------------------------------------------
-    /// Starts the StateEstimationNode's thread that pumps out VesselStateMsg corresponding
-    /// at the estimated state of the vessel.
+    /// Pumps out a StateMessage corresponding at the estimated state of the vessel, called
+    /// every loop time by the message bus's tick scheduler.
     ///----------------------------------------------------------------------------------
-    static void StateEstimationNodeThreadFunc(ActiveNode* nodePtr);
+    void tick();
 
 
     DBHandler& m_dbHandler;
@@ -113,4 +113,8 @@ private:
     float   m_VesselSpeed;          // m/s
     float   m_VesselCourse;         // degree [0, 360[ in North-East reference frame (clockwise)
 
+    MessageCause m_CompassCause;
+    MessageCause m_GPSCause;
+    MessageCause m_VesselCause;     // The older of the two, the state is as old as its oldest input
+
 };
@@ -21,6 +21,7 @@
 #include "Messages/VesselStateMsg.h"
 #include "Math/CourseMath.h"
 #include "SystemServices/Logger.h"
+#include "SystemServices/SysClock.h"
 #include "SystemServices/Timer.h"
 
 
@@ -140,7 +141,7 @@ void VesselStateNode::VesselStateThreadFunc(ActiveNode* nodePtr)
 
 	// An initial sleep, its purpose is to ensure that most if not all the sensor data arrives
 	// at the start before we send out the vessel state message.
-	std::this_thread::sleep_for(std::chrono::milliseconds(node->VESSEL_STATE_INITIAL_SLEEP));
+	SysClock::sleepFor(std::chrono::milliseconds(node->VESSEL_STATE_INITIAL_SLEEP));
 
 	char buffer[1024];
 
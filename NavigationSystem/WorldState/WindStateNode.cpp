@@ -22,8 +22,8 @@
 WindStateNode::WindStateNode(MessageBus& msgBus)
 : Node(NodeID::WindStateNode, msgBus)
 {
-    msgBus.registerNode(*this, MessageType::StateMessage);
-    msgBus.registerNode(*this, MessageType::WindData);
+    msgBus.subscribe(*this, &WindStateNode::processVesselStateMessage);
+    msgBus.subscribe(*this, &WindStateNode::processWindMessage);
 }
 
 WindStateNode::~WindStateNode(){}
@@ -34,38 +34,25 @@ bool WindStateNode::init()
     return true;
 }
 
-void WindStateNode::processMessage(const Message* message)
+void WindStateNode::processVesselStateMessage(const StateMessage& msg)
 {
-    MessageType type = message->messageType();
+    m_vesselHeading = msg.heading();
+    m_vesselSpeed   = msg.speed();
+    m_vesselCourse  = msg.course();
 
-    if(type == MessageType::StateMessage)
-    {
-        processVesselStateMessage(dynamic_cast< const StateMessage*> (message));
-        WindStateNode::calculateTrueWind();
-        sendMessage();
-    }
-    else if(type == MessageType::WindData)
-    {
-        processWindMessage(dynamic_cast< const WindDataMsg*> (message));
-    }
+    calculateTrueWind();
+    sendMessage();
 }
 
-void WindStateNode::processVesselStateMessage(const StateMessage* msg)
+void WindStateNode::processWindMessage(const WindDataMsg& msg)
 {
-    m_vesselHeading = msg->heading();
-    m_vesselSpeed   = msg->speed();
-    m_vesselCourse  = msg->course();
-}
-
-void WindStateNode::processWindMessage(const WindDataMsg* msg)
-{
-    m_apparentWindSpeed     = msg->windSpeed();
-    m_apparentWindDirection = msg->windDirection();
+    m_apparentWindSpeed     = msg.windSpeed();
+    m_apparentWindDirection = msg.windDirection();
 }
 
 void WindStateNode::sendMessage()
 {
-    MessagePtr windState = std::make_unique<WindStateMsg>(m_trueWindSpeed, m_trueWindDirection,
+    MessagePtr windState = MessageBus::make<WindStateMsg>(m_trueWindSpeed, m_trueWindDirection,
         m_apparentWindSpeed, m_apparentWindDirection);
     m_MsgBus.sendMessage(std::move(windState));
 }
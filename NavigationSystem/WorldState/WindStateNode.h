@@ -35,19 +35,23 @@ public:
     ~WindStateNode();
 
     bool init();
-    void processMessage(const Message* message);
+
+    ///----------------------------------------------------------------------------------
+    /// Every message the node takes goes to a typed handler.
+    ///----------------------------------------------------------------------------------
+    void processMessage(const Message*) { }
 
 private:
 
     ///----------------------------------------------------------------------------------
-    /// Stores vessel state datas from a StateMessage.
+    /// Stores vessel state datas from a StateMessage, then sends the new wind state.
     ///----------------------------------------------------------------------------------
-    void processVesselStateMessage(const StateMessage* msg);
+    void processVesselStateMessage(const StateMessage& msg);
 
     ///----------------------------------------------------------------------------------
     /// Stores apparent wind datas from a WindDataMsg.
     ///----------------------------------------------------------------------------------
-    void processWindMessage(const WindDataMsg* msg);
+    void processWindMessage(const WindDataMsg& msg);
 
     ///----------------------------------------------------------------------------------
     /// Sends windStateMsg.
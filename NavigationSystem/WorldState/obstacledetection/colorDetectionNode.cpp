@@ -281,7 +281,7 @@ void colorDetectionNode::colorDetectionThreadFunc(void* nodePtr)
 
         computeObstaclesAnglePosition(node->m_imgOriginal, obstacles, rotated_bounding_rects_merged_list );
 
-		MessagePtr msg = std::make_unique<ObstacleVectorMsg>(NodeID::Lidar, NodeID::ColorDetection ,obstacles);
+		MessagePtr msg = std::make_unique<ObstacleVectorMsg>(NodeID::Lidar, NodeID::ColorDetection, std::move(obstacles));
 		node->m_MsgBus.sendMessage(std::move(msg));
 
         rotated_bounding_rects_several_captures.erase(rotated_bounding_rects_several_captures.begin(),rotated_bounding_rects_several_captures.end());
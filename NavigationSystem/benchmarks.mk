@@ -0,0 +1,54 @@
+###############################################################################
+#
+# Makefile for building the benchmarks.
+#
+# This makefile cannot be run directly. Use the master makefile instead.
+#
+# Every file in Tests/Benchmarks is a standalone program, each one is built
+# into its own <name>.run executable. The benchmarks are built with
+# optimisations in their own build folder.
+#
+###############################################################################
+
+
+###############################################################################
+# Files
+###############################################################################
+
+BENCHMARK_BUILD_DIR = $(BUILD_DIR)/benchmarks
+
+# Source files
+BENCHMARK_SRC 	= $(wildcard Tests/Benchmarks/*.cpp)
+
+SRC 			= $(CORE_SRC)
+
+# Object files
+OBJECTS 		= $(addprefix $(BENCHMARK_BUILD_DIR)/, $(SRC:.cpp=.o))
+
+BENCHMARK_EXECS = $(notdir $(BENCHMARK_SRC:.cpp=.run))
+
+BENCHMARK_FLAGS = -O2 -DNDEBUG
+
+
+###############################################################################
+# Rules
+###############################################################################
+
+
+all: $(BENCHMARK_EXECS)
+
+# Keep the benchmark object files around between builds
+.SECONDARY:
+
+# Link and build
+%.run: $(BENCHMARK_BUILD_DIR)/Tests/Benchmarks/%.o $(OBJECTS)
+	rm -f $(OBJECT_FILE)
+	@echo -n " " $(OBJECTS) >> $(OBJECT_FILE)
+	@echo Linking object files
+	$(CXX) $(LDFLAGS) $< @$(OBJECT_FILE) -Wl,-rpath=./ -o $@ $(LIBS)
+
+# Compile CPP files into the build folder
+$(BENCHMARK_BUILD_DIR)/%.o:$(SRC_DIR)/%.cpp
+	@mkdir -p $(dir $@)
+	@echo Compiling CPP File: $@
+	@$(CXX) -c $(CPPFLAGS) $(BENCHMARK_FLAGS) $(INC_DIR) -o ./$@ $< $(DEFINES) $(LIBS)
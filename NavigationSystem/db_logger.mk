@@ -0,0 +1,41 @@
+###############################################################################
+#
+# Makefile for building the db-logger process.
+#
+# This makefile cannot be run directly. Use the master makefile instead.
+#
+###############################################################################
+
+
+###############################################################################
+# Files
+###############################################################################
+
+# Source files
+MAIN_DB_LOGGER 			= Tools/DBLoggerProcess.cpp
+
+SRC 					= $(MAIN_DB_LOGGER) $(CORE_SRC)
+
+
+# Object files
+OBJECTS = $(addprefix $(BUILD_DIR)/, $(SRC:.cpp=.o))
+
+
+###############################################################################
+# Rules
+###############################################################################
+
+all: $(DB_LOGGER_EXEC)
+
+# Link and build
+$(DB_LOGGER_EXEC): $(OBJECTS)
+	rm -f $(OBJECT_FILE)
+	@echo -n " " $(OBJECTS) >> $(OBJECT_FILE)
+	@echo Linking object files
+	$(CXX) $(LDFLAGS) @$(OBJECT_FILE) -Wl,-rpath=./ -o $@ $(LIBS)
+
+# Compile CPP files into the build folder
+$(BUILD_DIR)/%.o:$(SRC_DIR)/%.cpp
+	@mkdir -p $(dir $@)
+	@echo Compiling CPP File: $@
+	@$(CXX) -c $(CPPFLAGS) $(INC_DIR) -o ./$@ $< $(DEFINES)
@@ -1,10 +1,14 @@
 #include <string>
+#include <thread>
 #include "DataBase/DBHandler.h"
 #include "DataBase/DBLoggerNode.h"
+#include "DataBase/LogStore.h"
 #include "HTTPSync/HTTPSyncNode.h"
+#include "MessageBus/BridgeNode.h"
 #include "MessageBus/MessageBus.h"
 #include "Messages/DataRequestMsg.h"
 #include "SystemServices/Logger.h"
+#include "SystemServices/RealTime.h"
 
 #include "Navigation/WaypointMgrNode.h"
 #include "WorldState/StateEstimationNode.h"
@@ -75,7 +79,9 @@ void initialiseNode(Node& node, const char* nodeName, NodeImportance importance)
 
 
 ///----------------------------------------------------------------------------------
-/// Entry point, can accept one argument containing a relative path to the database.
+/// Entry point, can accept one argument containing a relative path to the database
+/// and a second one naming a file to record the message bus traffic to, which
+/// replay-messages can play back later.
 ///
 ///----------------------------------------------------------------------------------
 int main(int argc, char *argv[])
@@ -133,13 +139,56 @@ int main(int argc, char *argv[])
 		exit(1);
 	}
 
+	#if DB_LOG_STORE == 1
+		#if DB_LOGGER_PROCESS == 1
+			#error "The log store is written in the navigation system, it can't be used with USE_DB_PROCESS=1"
+		#endif
+
+		// The datalogs go to the log store next to the database, HTTPSync pushes them from there
+		LogStore logStore(db_path + ".datalogs");
+		if(logStore.open())
+		{
+			Logger::info("Log store init\t\t[OK]");
+		}
+		else
+		{
+			Logger::error("Log store init\t\t[FAILED]");
+			Logger::shutdown();
+			exit(1);
+		}
+	#endif
+
+
+	// The messages that are only logged can wait in the queues, bound them so a slow
+	// database can't use up the memory. Only the newest of them are kept.
+	messageBus.setQueueLimit(MessageType::AISData, 8, OverflowPolicy::DropOldest);
+	messageBus.setQueueLimit(MessageType::ASPireActuatorFeedback, 32, OverflowPolicy::DropOldest);
+	messageBus.setQueueLimit(MessageType::MarineSensorData, 32, OverflowPolicy::DropOldest);
+	messageBus.setQueueLimit(MessageType::CourseData, 32, OverflowPolicy::DropOldest);
+
 
 	// Declare nodes
 	//-------------------------------------------------------------------------------
 
-	int dbLoggerQueueSize = 5; 			// how many messages to log to the databse at a time
-	DBLoggerNode dbLoggerNode(messageBus, dbHandler, dbLoggerQueueSize);
-	HTTPSyncNode httpsync(messageBus, &dbHandler);
+	#if DB_LOGGER_PROCESS == 1
+		// The database writes run in the db-logger process, it gets the messages it logs
+		// over a shared memory bridge
+		BridgeNode dbLoggerNode(messageBus, "sailingrobot-db", BridgeNode::Side::Parent,
+			DBLoggerNode::messageTypes());
+		dbLoggerNode.setChildProcess("./db-logger", { "sailingrobot-db", db_path });
+	#elif DB_LOG_STORE == 1
+		// an item for every sensor message, written a block of the store at a time
+		int dbLoggerQueueSize = LOG_STORE_BLOCK_RECORDS;
+		DBLoggerNode dbLoggerNode(messageBus, dbHandler, logStore, dbLoggerQueueSize);
+	#else
+		int dbLoggerQueueSize = 5; 			// how many messages to log to the databse at a time
+		DBLoggerNode dbLoggerNode(messageBus, dbHandler, dbLoggerQueueSize);
+	#endif
+	#if DB_LOG_STORE == 1
+		HTTPSyncNode httpsync(messageBus, &dbHandler, &logStore);
+	#else
+		HTTPSyncNode httpsync(messageBus, &dbHandler);
+	#endif
 
 	StateEstimationNode stateEstimationNode(messageBus, dbHandler);
 	WindStateNode windStateNode(messageBus);
@@ -152,12 +201,13 @@ int main(int argc, char *argv[])
   	#if LOCAL_NAVIGATION_MODULE == 1
 		LocalNavigationModule lnm	( messageBus, dbHandler );
 
-		const int16_t MAX_VOTES = dbHandler.retrieveCellAsInt("config_voter_system","1","max_vote");
-		WaypointVoter waypointVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","waypoint_voter_weight")); // weight = 1
-		WindVoter windVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","wind_voter_weight")); // weight = 1
-		ChannelVoter channelVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","channel_voter_weight")); // weight = 1
-		MidRangeVoter midRangeVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","midrange_voter_weight"), collidableMgr );
-		ProximityVoter proximityVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","proximity_voter_weight"), collidableMgr);
+		std::shared_ptr<const ConfigSnapshot> configs = dbHandler.configs();
+		const int16_t MAX_VOTES = configs->getInt("config_voter_system","max_vote");
+		WaypointVoter waypointVoter( MAX_VOTES, configs->getDouble("config_voter_system","waypoint_voter_weight")); // weight = 1
+		WindVoter windVoter( MAX_VOTES, configs->getDouble("config_voter_system","wind_voter_weight")); // weight = 1
+		ChannelVoter channelVoter( MAX_VOTES, configs->getDouble("config_voter_system","channel_voter_weight")); // weight = 1
+		MidRangeVoter midRangeVoter( MAX_VOTES, configs->getDouble("config_voter_system","midrange_voter_weight"), collidableMgr );
+		ProximityVoter proximityVoter( MAX_VOTES, configs->getDouble("config_voter_system","proximity_voter_weight"), collidableMgr);
 
 		lnm.registerVoter( &waypointVoter );
 		lnm.registerVoter( &windVoter );
@@ -214,6 +264,20 @@ int main(int argc, char *argv[])
 		initialiseNode(marineSensors, "Marine Sensors", NodeImportance::NOT_CRITICAL);
 	#endif
 
+	#if CONTROL_LOOP_REAL_TIME == 1
+		// The rudder and sail loops run before everything else, on the last CPU
+		RealTimeProfile controlLoopProfile;
+		controlLoopProfile.priority = 80;
+		controlLoopProfile.cpu = std::thread::hardware_concurrency() - 1;
+		controlLoopProfile.lockMemory = true;
+
+		wingSailControlNode.setRealTimeProfile(controlLoopProfile);
+		courseRegulatorNode.setRealTimeProfile(controlLoopProfile);
+
+		// Logs how well they keep their deadlines along with the bus statistics
+		messageBus.setStatisticsInterval(60);
+	#endif
+
 	// Start active nodes
 	//-------------------------------------------------------------------------------
 
@@ -244,6 +308,11 @@ int main(int argc, char *argv[])
 
 	// Begins running the message bus
 	//-------------------------------------------------------------------------------
+	if (argc > 2)
+	{
+		messageBus.startRecording(argv[2]);
+	}
+
 	Logger::info("Message bus started!");
 	messageBus.run();
 
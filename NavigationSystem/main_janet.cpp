@@ -1,10 +1,12 @@
 #include <string>
+#include <thread>
 #include "DataBase/DBHandler.h"
 #include "DataBase/DBLoggerNode.h"
 #include "HTTPSync/HTTPSyncNode.h"
 #include "MessageBus/MessageBus.h"
 #include "Messages/DataRequestMsg.h"
 #include "SystemServices/Logger.h"
+#include "SystemServices/RealTime.h"
 
 #include "Navigation/WaypointMgrNode.h"
 #include "WorldState/StateEstimationNode.h"
@@ -76,7 +78,9 @@ void initialiseNode(Node& node, const char* nodeName, NodeImportance importance)
 
 
 ///----------------------------------------------------------------------------------
-/// Entry point, can accept one argument containing a relative path to the database.
+/// Entry point, can accept one argument containing a relative path to the database
+/// and a second one naming a file to record the message bus traffic to, which
+/// replay-messages can play back later.
 ///
 ///----------------------------------------------------------------------------------
 int main(int argc, char *argv[])
@@ -154,12 +158,13 @@ int main(int argc, char *argv[])
   	#if LOCAL_NAVIGATION_MODULE == 1
         LocalNavigationModule lnm	( messageBus, dbHandler );
 
-        const int16_t MAX_VOTES = dbHandler.retrieveCellAsInt("config_voter_system","1","max_vote");
-		WaypointVoter waypointVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","waypoint_voter_weight")); // weight = 1
-		WindVoter windVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","wind_voter_weight")); // weight = 1
-		ChannelVoter channelVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","channel_voter_weight")); // weight = 1
-		MidRangeVoter midRangeVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","midrange_voter_weight"), collidableMgr );
-		ProximityVoter proximityVoter( MAX_VOTES, dbHandler.retrieveCellAsDouble("config_voter_system","1","proximity_voter_weight"), collidableMgr);
+        std::shared_ptr<const ConfigSnapshot> configs = dbHandler.configs();
+        const int16_t MAX_VOTES = configs->getInt("config_voter_system","max_vote");
+		WaypointVoter waypointVoter( MAX_VOTES, configs->getDouble("config_voter_system","waypoint_voter_weight")); // weight = 1
+		WindVoter windVoter( MAX_VOTES, configs->getDouble("config_voter_system","wind_voter_weight")); // weight = 1
+		ChannelVoter channelVoter( MAX_VOTES, configs->getDouble("config_voter_system","channel_voter_weight")); // weight = 1
+		MidRangeVoter midRangeVoter( MAX_VOTES, configs->getDouble("config_voter_system","midrange_voter_weight"), collidableMgr );
+		ProximityVoter proximityVoter( MAX_VOTES, configs->getDouble("config_voter_system","proximity_voter_weight"), collidableMgr);
 
 		lnm.registerVoter( &waypointVoter );
 		lnm.registerVoter( &windVoter );
@@ -226,6 +231,20 @@ int main(int argc, char *argv[])
 		initialiseNode(xbee, "Xbee Sync", NodeImportance::NOT_CRITICAL);
 	#endif
 
+	#if CONTROL_LOOP_REAL_TIME == 1
+		// The rudder and sail loops run before everything else, on the last CPU
+		RealTimeProfile controlLoopProfile;
+		controlLoopProfile.priority = 80;
+		controlLoopProfile.cpu = std::thread::hardware_concurrency() - 1;
+		controlLoopProfile.lockMemory = true;
+
+		sailControlNode.setRealTimeProfile(controlLoopProfile);
+		courseRegulatorNode.setRealTimeProfile(controlLoopProfile);
+
+		// Logs how well they keep their deadlines along with the bus statistics
+		messageBus.setStatisticsInterval(60);
+	#endif
+
 	// Start active nodes
 	//-------------------------------------------------------------------------------
 
@@ -255,6 +274,11 @@ int main(int argc, char *argv[])
 
 	// Begins running the message bus
 	//-------------------------------------------------------------------------------
+	if (argc > 2)
+	{
+		messageBus.startRecording(argv[2]);
+	}
+
 	Logger::info("Message bus started!");
 	messageBus.run();
 
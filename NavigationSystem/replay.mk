@@ -0,0 +1,42 @@
+###############################################################################
+#
+# Makefile for building the message replay tool.
+#
+# This makefile cannot be run directly. Use the master makefile instead.
+#
+###############################################################################
+
+
+###############################################################################
+# Files
+###############################################################################
+
+# Source files
+MAIN_REPLAY 			= Tools/MessageReplayTool.cpp
+
+SRC 					= $(MAIN_REPLAY) $(CORE_SRC) $(COLLIDABLE_MGR_SRC) $(LNM_SRC) \
+							$(LINE_FOLLOW_SRC)
+
+
+# Object files
+OBJECTS = $(addprefix $(BUILD_DIR)/, $(SRC:.cpp=.o))
+
+
+###############################################################################
+# Rules
+###############################################################################
+
+all: $(REPLAY_EXEC)
+
+# Link and build
+$(REPLAY_EXEC): $(OBJECTS)
+	rm -f $(OBJECT_FILE)
+	@echo -n " " $(OBJECTS) >> $(OBJECT_FILE)
+	@echo Linking object files
+	$(CXX) $(LDFLAGS) @$(OBJECT_FILE) -Wl,-rpath=./ -o $@ $(LIBS)
+
+# Compile CPP files into the build folder
+$(BUILD_DIR)/%.o:$(SRC_DIR)/%.cpp
+	@mkdir -p $(dir $@)
+	@echo Compiling CPP File: $@
+	@$(CXX) -c $(CPPFLAGS) $(INC_DIR) -o ./$@ $< $(DEFINES)
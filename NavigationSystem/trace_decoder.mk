@@ -0,0 +1,39 @@
+###############################################################################
+#
+# Makefile for building the message trace decoder.
+#
+# This makefile cannot be run directly. Use the master makefile instead.
+#
+###############################################################################
+
+
+###############################################################################
+# Files
+###############################################################################
+
+# Source files
+MAIN_TRACE_DECODER 		= Tools/MessageTraceDecoder.cpp
+
+SRC 					= $(MAIN_TRACE_DECODER) SystemServices/SysClock.cpp SystemServices/TimeSource.cpp
+
+
+# Object files
+OBJECTS = $(addprefix $(BUILD_DIR)/, $(SRC:.cpp=.o))
+
+
+###############################################################################
+# Rules
+###############################################################################
+
+all: $(TRACE_DECODER_EXEC)
+
+# Link and build
+$(TRACE_DECODER_EXEC): $(OBJECTS)
+	@echo Linking object files
+	$(CXX) $(LDFLAGS) $(OBJECTS) -o $@
+
+# Compile CPP files into the build folder
+$(BUILD_DIR)/%.o:$(SRC_DIR)/%.cpp
+	@mkdir -p $(dir $@)
+	@echo Compiling CPP File: $@
+	@$(CXX) -c $(CPPFLAGS) $(INC_DIR) -o ./$@ $< $(DEFINES)
@@ -34,7 +34,7 @@ $(UNIT_TEST_EXEC): $(OBJECTS) Tests/runner.o
 	rm -f $(OBJECT_FILE)
 	@echo -n " " $(OBJECTS) >> $(OBJECT_FILE)
 	@echo Linking object files
-	$(CXX) $(LDFLAGS) Tests/runner.o @$(OBJECT_FILE) -Wl,-rpath=./ -o $@ $(LIBS)
+	$(CXX) $(LDFLAGS) Tests/runner.o Tests/AllocationCounter.o @$(OBJECT_FILE) -Wl,-rpath=./ -o $@ $(LIBS)
 
 $(UNIT_TEST_HW_EXEC): $(OBJECTS) Tests/runner.o
 	rm -f $(OBJECT_FILE)